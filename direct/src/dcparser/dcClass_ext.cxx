@@ -107,11 +107,22 @@ get_owner_class_def() const {
  */
 void Extension<DCClass>::
 receive_update(PyObject *distobj, DatagramIterator &di) const {
+  const char *data = (const char *)di.get_datagram().get_data();
+  di.skip_bytes(receive_update(distobj, data + di.get_current_index(),
+                               di.get_remaining_size()));
+}
+
+/**
+ * Extracts the update message out of the indicated buffer and applies it to
+ * the indicated object by calling the appropriate method.  The data is read
+ * in place; it need not be copied into a Datagram first.  Returns the number
+ * of bytes consumed.
+ */
+size_t Extension<DCClass>::
+receive_update(PyObject *distobj, const char *data, size_t length) const {
   PStatTimer timer(_this->_class_update_pcollector);
   DCPacker packer;
-  const char *data = (const char *)di.get_datagram().get_data();
-  packer.set_unpack_data(data + di.get_current_index(),
-                         di.get_remaining_size(), false);
+  packer.set_unpack_data(data, length, false);
 
   int field_id = packer.raw_unpack_uint16();
   DCField *field = _this->get_field_by_index(field_id);
@@ -121,14 +132,14 @@ receive_update(PyObject *distobj, DatagramIterator &di) const {
         << "Received update for field " << field_id << ", not in class "
         << _this->get_name();
     nassert_raise(strm.str());
-    return;
+    return 0;
   }
 
   packer.begin_unpack(field);
   invoke_extension(field).receive_update(packer, distobj);
   packer.end_unpack();
 
-  di.skip_bytes(packer.get_num_unpacked_bytes());
+  return packer.get_num_unpacked_bytes();
 }
 
 /**
@@ -37,6 +37,7 @@ public:
   PyObject *get_owner_class_def() const;
 
   void receive_update(PyObject *distobj, DatagramIterator &di) const;
+  size_t receive_update(PyObject *distobj, const char *data, size_t length) const;
   void receive_update_broadcast_required(PyObject *distobj, DatagramIterator &di) const;
   void receive_update_broadcast_required_owner(PyObject *distobj, DatagramIterator &di) const;
   void receive_update_all_required(PyObject *distobj, DatagramIterator &di) const;
@@ -248,6 +248,15 @@ set_name(const std::string &name) {
   }
 }
 
+/**
+ * Compiles the field's pack/unpack plan; see get_pack_plan().  This is called
+ * for each field after the .dc file has been read.
+ */
+void DCField::
+compile_pack_plan() {
+  _pack_plan.compile(this);
+}
+
 /**
  * Recomputes the default value of the field by repacking it.
  */
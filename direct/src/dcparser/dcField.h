@@ -17,6 +17,7 @@
 #include "dcbase.h"
 #include "dcPackerInterface.h"
 #include "dcKeywordList.h"
+#include "dcPackPlan.h"
 
 #ifdef WITHIN_PANDA
 #include "pStatCollector.h"
@@ -100,6 +101,9 @@ public:
   INLINE void set_class(DCClass *dclass);
   INLINE void set_default_value(vector_uchar default_value);
 
+  INLINE const DCPackPlan &get_pack_plan() const;
+  void compile_pack_plan();
+
 protected:
   void refresh_default_value();
 
@@ -112,6 +116,7 @@ protected:
 
 private:
   vector_uchar _default_value;
+  DCPackPlan _pack_plan;
 
 #ifdef WITHIN_PANDA
   PStatCollector _field_update_pcollector;
@@ -20,6 +20,129 @@
 
 #ifdef HAVE_PYTHON
 
+namespace {
+
+/**
+ * Supplies the arguments of a field from a Python tuple or list to
+ * DCPacker::pack_plan().  Each value is packed through its parameter exactly
+ * as Extension<DCPacker>::pack_object() would pack it.
+ */
+class SequenceSource {
+public:
+  SequenceSource(PyObject *sequence) : _sequence(sequence) {}
+
+  static bool can_pack(PyObject *sequence, const DCPackPlan &plan);
+
+  void pack_op(const DCPackPlan::Op &op, size_t n, DCPackData &pack_data,
+               bool &pack_error, bool &range_error) const;
+
+private:
+  PyObject *_sequence;
+};
+
+/**
+ * Collects the arguments unpacked by DCPacker::unpack_plan() into a tuple,
+ * making the same Python objects as Extension<DCPacker>::unpack_object().
+ */
+class TupleVisitor {
+public:
+  TupleVisitor(size_t num_args) : _tuple(PyTuple_New(num_args)) {}
+
+  void unpack_int(const DCPackPlan::Op &op, size_t n, int64_t value) {
+    PyTuple_SET_ITEM(_tuple, n, PyLong_FromLongLong(value));
+  }
+  void unpack_uint(const DCPackPlan::Op &op, size_t n, uint64_t value) {
+    PyTuple_SET_ITEM(_tuple, n, PyLong_FromUnsignedLongLong(value));
+  }
+  void unpack_double(const DCPackPlan::Op &op, size_t n, double value) {
+    PyTuple_SET_ITEM(_tuple, n, PyFloat_FromDouble(value));
+  }
+  void unpack_string(const DCPackPlan::Op &op, size_t n,
+                     const char *data, size_t length) {
+    if (op._pack_type == PT_blob) {
+      PyTuple_SET_ITEM(_tuple, n, PyBytes_FromStringAndSize(data, length));
+    } else {
+      PyTuple_SET_ITEM(_tuple, n, PyUnicode_FromStringAndSize(data, length));
+    }
+  }
+
+  PyObject *_tuple;
+};
+
+/**
+ * Returns true if the indicated object is a tuple or list with one plain
+ * value per argument of the plan.  Anything else goes through pack_object(),
+ * which knows how to report it.
+ */
+bool SequenceSource::
+can_pack(PyObject *sequence, const DCPackPlan &plan) {
+  if (!PyTuple_Check(sequence) && !PyList_Check(sequence)) {
+    return false;
+  }
+  size_t num_ops = plan.get_num_ops();
+  if ((size_t)PySequence_Fast_GET_SIZE(sequence) != num_ops) {
+    return false;
+  }
+  for (size_t n = 0; n < num_ops; ++n) {
+    PyObject *item = PySequence_Fast_GET_ITEM(sequence, n);
+    if (!PyLong_Check(item) && !PyFloat_Check(item) &&
+        !PyUnicode_Check(item) && !PyBytes_Check(item)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Packs the nth item of the sequence.
+ */
+void SequenceSource::
+pack_op(const DCPackPlan::Op &op, size_t n, DCPackData &pack_data,
+        bool &pack_error, bool &range_error) const {
+  PyObject *item = PySequence_Fast_GET_ITEM(_sequence, n);
+  const DCPackerInterface *param = op._param;
+
+  if (PyLong_Check(item)) {
+    switch (op._pack_type) {
+    case PT_int64:
+      param->pack_int64(pack_data, PyLong_AsLongLong(item), pack_error, range_error);
+      break;
+
+    case PT_uint64:
+      param->pack_uint64(pack_data, PyLong_AsUnsignedLongLong(item), pack_error, range_error);
+      break;
+
+    case PT_uint:
+      param->pack_uint(pack_data, PyLong_AsUnsignedLong(item), pack_error, range_error);
+      break;
+
+    default:
+      param->pack_int(pack_data, PyLong_AsLong(item), pack_error, range_error);
+      break;
+    }
+
+  } else if (PyFloat_Check(item)) {
+    param->pack_double(pack_data, PyFloat_AS_DOUBLE(item), pack_error, range_error);
+
+  } else if (PyUnicode_Check(item)) {
+    Py_ssize_t length;
+    const char *buffer = PyUnicode_AsUTF8AndSize(item, &length);
+    if (buffer) {
+      param->pack_string(pack_data, std::string(buffer, length), pack_error, range_error);
+    }
+
+  } else {
+    char *buffer;
+    Py_ssize_t length;
+    PyBytes_AsStringAndSize(item, &buffer, &length);
+    param->pack_blob(pack_data, vector_uchar((const unsigned char *)buffer,
+                                             (const unsigned char *)buffer + length),
+                     pack_error, range_error);
+  }
+}
+
+}  // namespace
+
 /**
  * Packs the Python arguments from the indicated tuple into the packer.
  * Returns true on success, false on failure.
@@ -31,7 +154,14 @@ pack_args(DCPacker &packer, PyObject *sequence) const {
   nassertr(!packer.had_error(), false);
   nassertr(packer.get_current_field() == _this, false);
 
-  invoke_extension(&packer).pack_object(sequence);
+  const DCPackPlan &plan = _this->get_pack_plan();
+  if (plan.is_valid() && SequenceSource::can_pack(sequence, plan)) {
+    SequenceSource source(sequence);
+    packer.pack_plan(plan, source);
+  } else {
+    invoke_extension(&packer).pack_object(sequence);
+  }
+
   if (!packer.had_error()) {
     /*
     cerr << "pack " << _this->get_name() << get_pystr(sequence) << "\n";
@@ -98,7 +228,26 @@ unpack_args(DCPacker &packer) const {
   nassertr(packer.get_current_field() == _this, nullptr);
 
   size_t start_byte = packer.get_num_unpacked_bytes();
-  PyObject *object = invoke_extension(&packer).unpack_object();
+  PyObject *object;
+
+  const DCPackPlan &plan = _this->get_pack_plan();
+  if (plan.is_valid()) {
+    TupleVisitor visitor(plan.get_num_ops());
+    packer.unpack_plan(plan, visitor);
+    object = visitor._tuple;
+
+    if (packer.had_pack_error()) {
+      // Decoding stopped partway; don't leave holes in the tuple.
+      for (size_t n = 0; n < plan.get_num_ops(); ++n) {
+        if (PyTuple_GET_ITEM(object, n) == nullptr) {
+          Py_INCREF(Py_None);
+          PyTuple_SET_ITEM(object, n, Py_None);
+        }
+      }
+    }
+  } else {
+    object = invoke_extension(&packer).unpack_object();
+  }
 
   if (!packer.had_error()) {
     // Successfully unpacked.
@@ -172,6 +172,11 @@ read(std::istream &in, const string &filename) {
   dcyyparse();
   dc_cleanup_parser();
 
+  FieldsByIndex::iterator fi;
+  for (fi = _fields_by_index.begin(); fi != _fields_by_index.end(); ++fi) {
+    (*fi)->compile_pack_plan();
+  }
+
   return (dc_error_count() == 0);
 }
 
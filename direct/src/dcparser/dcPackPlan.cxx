@@ -0,0 +1,147 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file dcPackPlan.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "dcPackPlan.h"
+#include "dcField.h"
+#include "dcAtomicField.h"
+#include "dcSimpleParameter.h"
+
+/**
+ *
+ */
+DCPackPlan::
+DCPackPlan() {
+  _field = nullptr;
+  _has_fixed_byte_size = false;
+  _fixed_byte_size = 0;
+  _has_range_limits = false;
+}
+
+/**
+ * Empties the plan and marks it invalid.
+ */
+void DCPackPlan::
+clear() {
+  _ops.clear();
+  _field = nullptr;
+  _has_fixed_byte_size = false;
+  _fixed_byte_size = 0;
+  _has_range_limits = false;
+}
+
+/**
+ * Compiles the plan for the indicated field.  Returns true if the field could
+ * be compiled, or false if it has some argument the plan cannot represent
+ * (an array, a nested class, a switch, and so on), in which case the plan is
+ * left invalid.
+ */
+bool DCPackPlan::
+compile(const DCField *field) {
+  clear();
+
+  const DCAtomicField *atomic = field->as_atomic_field();
+  if (atomic == nullptr) {
+    return false;
+  }
+
+  bool has_fixed_byte_size = true;
+  size_t offset = 0;
+
+  int num_elements = atomic->get_num_elements();
+  _ops.reserve(num_elements);
+  for (int i = 0; i < num_elements; ++i) {
+    const DCSimpleParameter *simple =
+      atomic->get_element(i)->as_simple_parameter();
+    if (simple == nullptr) {
+      _ops.clear();
+      return false;
+    }
+
+    Op op;
+    op._pack_type = simple->get_pack_type();
+    op._divisor = simple->get_divisor();
+    op._offset = offset;
+    op._param = simple;
+    op._has_range_limits = simple->has_range_limits();
+
+    switch (simple->get_type()) {
+    case ST_int8:
+      op._opcode = OP_int8;
+      break;
+    case ST_int16:
+      op._opcode = OP_int16;
+      break;
+    case ST_int32:
+      op._opcode = OP_int32;
+      break;
+    case ST_int64:
+      op._opcode = OP_int64;
+      break;
+    case ST_uint8:
+      op._opcode = OP_uint8;
+      break;
+    case ST_uint16:
+      op._opcode = OP_uint16;
+      break;
+    case ST_uint32:
+      op._opcode = OP_uint32;
+      break;
+    case ST_uint64:
+      op._opcode = OP_uint64;
+      break;
+    case ST_float64:
+      op._opcode = OP_float64;
+      break;
+    case ST_char:
+      op._opcode = OP_char;
+      break;
+    case ST_string:
+      op._opcode = OP_string;
+      break;
+    case ST_blob:
+      op._opcode = OP_blob;
+      break;
+    case ST_blob32:
+      op._opcode = OP_blob32;
+      break;
+
+    default:
+      // The array types unpack to lists; leave those to the packer.
+      _ops.clear();
+      return false;
+    }
+
+    if (simple->has_fixed_byte_size()) {
+      offset += simple->get_fixed_byte_size();
+    } else {
+      has_fixed_byte_size = false;
+    }
+
+    if ((op._opcode == OP_string || op._opcode == OP_blob ||
+         op._opcode == OP_blob32) && simple->get_num_length_bytes() == 0) {
+      // A fixed-length string has no length prefix; its parameter knows how
+      // long it is.
+      op._has_range_limits = true;
+    }
+
+    if (op._has_range_limits) {
+      _has_range_limits = true;
+    }
+    _ops.push_back(op);
+  }
+
+  _field = field;
+  _has_fixed_byte_size = has_fixed_byte_size;
+  _fixed_byte_size = has_fixed_byte_size ? offset : 0;
+  return true;
+}
@@ -0,0 +1,107 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file dcPackPlan.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef DCPACKPLAN_H
+#define DCPACKPLAN_H
+
+#include "dcbase.h"
+#include "dcPackerInterface.h"
+#include "dcSubatomicType.h"
+
+class DCField;
+
+/**
+ * A flattened description of the arguments of a DCField, compiled once when
+ * the .dc file is read.  Each argument becomes one opcode with its divisor,
+ * its byte offset within the field, and a pointer to the parameter that
+ * validates it if it has range limits.
+ *
+ * DCPacker can execute a plan in place of walking the DCPackerInterface
+ * hierarchy one argument at a time; see DCPacker::unpack_plan() and
+ * DCPacker::pack_plan().  Only atomic fields made up entirely of simple
+ * (non-array) parameters can be compiled; is_valid() returns false for
+ * anything else, and such fields go through the packer as before.
+ */
+class EXPCL_DIRECT_DCPARSER DCPackPlan {
+public:
+  DCPackPlan();
+
+  enum Opcode {
+    OP_int8,
+    OP_int16,
+    OP_int32,
+    OP_int64,
+    OP_uint8,
+    OP_uint16,
+    OP_uint32,
+    OP_uint64,
+    OP_float64,
+    OP_char,
+    OP_string,
+    OP_blob,
+    OP_blob32,
+  };
+
+  // One argument of the field.
+  class Op {
+  public:
+    Opcode _opcode;
+    DCPackType _pack_type;
+    unsigned int _divisor;
+
+    // The byte offset of the argument from the start of the field.  This is
+    // only meaningful up to the first variable-length argument.
+    size_t _offset;
+
+    // The parameter this argument was compiled from.  Values are packed
+    // through it, and also unpacked through it if _has_range_limits is set,
+    // so that the parameter can validate them.
+    const DCPackerInterface *_param;
+    bool _has_range_limits;
+  };
+
+  void clear();
+  bool compile(const DCField *field);
+
+  INLINE bool is_valid() const;
+  INLINE const DCField *get_field() const;
+  INLINE bool has_fixed_byte_size() const;
+  INLINE size_t get_fixed_byte_size() const;
+  INLINE bool has_range_limits() const;
+
+  INLINE size_t get_num_ops() const;
+  INLINE const Op &get_op(size_t n) const;
+
+  template<class Visitor>
+  INLINE void unpack(const char *data, size_t length, size_t &p,
+                     Visitor &visitor,
+                     bool &pack_error, bool &range_error) const;
+
+private:
+  template<class Visitor>
+  INLINE static void unpack_op(const Op &op, size_t n, const char *data,
+                               size_t length, size_t &p, Visitor &visitor,
+                               bool &pack_error, bool &range_error);
+
+  typedef pvector<Op> Ops;
+  Ops _ops;
+
+  const DCField *_field;
+  bool _has_fixed_byte_size;
+  size_t _fixed_byte_size;
+  bool _has_range_limits;
+};
+
+#include "dcPackPlan.I"
+
+#endif
@@ -19,6 +19,7 @@
 #include "dcSubatomicType.h"
 #include "dcPackData.h"
 #include "dcPackerCatalog.h"
+#include "dcPackPlan.h"
 
 #ifdef WITHIN_PANDA
 #include "extension.h"
@@ -105,6 +106,13 @@ public:
   INLINE void unpack_blob(vector_uchar &value);
   INLINE void unpack_literal_value(vector_uchar &value);
 
+  // These execute a precompiled DCPackPlan in place of packing or unpacking
+  // each argument of the current field individually.
+  template<class Visitor>
+  INLINE void unpack_plan(const DCPackPlan &plan, Visitor &visitor);
+  template<class Source>
+  INLINE void pack_plan(const DCPackPlan &plan, Source &source);
+
 PUBLISHED:
 
   EXTENSION(void pack_object(PyObject *object));
@@ -7,6 +7,7 @@
 #include "dcKeyword.cxx"
 #include "dcKeywordList.cxx"
 #include "dcPackData.cxx"
+#include "dcPackPlan.cxx"
 #include "dcPacker.cxx"
 #include "dcPackerCatalog.cxx"
 #include "dcPackerInterface.cxx"
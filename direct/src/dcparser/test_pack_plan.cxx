@@ -0,0 +1,300 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_pack_plan.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "dcbase.h"
+#include "dcFile.h"
+#include "dcClass.h"
+#include "dcField.h"
+#include "dcPacker.h"
+#include "dcPackPlan.h"
+#include "trueClock.h"
+
+/**
+ * One argument of a field, as unpacked.
+ */
+class Value {
+public:
+  DCPackType _type;
+  int64_t _int;
+  uint64_t _uint;
+  double _double;
+  std::string _string;
+};
+typedef pvector<Value> Values;
+
+/**
+ * Collects the arguments unpacked by a plan.
+ */
+class ValueVisitor {
+public:
+  ValueVisitor(Values &values) : _values(values) {}
+
+  void unpack_int(const DCPackPlan::Op &op, size_t n, int64_t value) {
+    _values[n]._type = PT_int64;
+    _values[n]._int = value;
+  }
+  void unpack_uint(const DCPackPlan::Op &op, size_t n, uint64_t value) {
+    _values[n]._type = PT_uint64;
+    _values[n]._uint = value;
+  }
+  void unpack_double(const DCPackPlan::Op &op, size_t n, double value) {
+    _values[n]._type = PT_double;
+    _values[n]._double = value;
+  }
+  void unpack_string(const DCPackPlan::Op &op, size_t n,
+                     const char *data, size_t length) {
+    _values[n]._type = PT_string;
+    _values[n]._string.assign(data, length);
+  }
+
+  Values &_values;
+};
+
+/**
+ * Supplies the arguments to be packed by a plan.
+ */
+class ValueSource {
+public:
+  ValueSource(const Values &values) : _values(values) {}
+
+  void pack_op(const DCPackPlan::Op &op, size_t n, DCPackData &pack_data,
+               bool &pack_error, bool &range_error) const {
+    const Value &value = _values[n];
+    switch (value._type) {
+    case PT_int64:
+      op._param->pack_int64(pack_data, value._int, pack_error, range_error);
+      break;
+    case PT_uint64:
+      op._param->pack_uint64(pack_data, value._uint, pack_error, range_error);
+      break;
+    case PT_double:
+      op._param->pack_double(pack_data, value._double, pack_error, range_error);
+      break;
+    default:
+      op._param->pack_string(pack_data, value._string, pack_error, range_error);
+      break;
+    }
+  }
+
+  const Values &_values;
+};
+
+/**
+ * Unpacks the current field one value at a time, the way
+ * DCPacker::unpack_object() does.
+ */
+static void
+unpack_general(DCPacker &packer, Values &values) {
+  switch (packer.get_pack_type()) {
+  case PT_double:
+    values.push_back(Value());
+    values.back()._type = PT_double;
+    values.back()._double = packer.unpack_double();
+    break;
+
+  case PT_int:
+  case PT_int64:
+    values.push_back(Value());
+    values.back()._type = PT_int64;
+    values.back()._int = packer.unpack_int64();
+    break;
+
+  case PT_uint:
+  case PT_uint64:
+    values.push_back(Value());
+    values.back()._type = PT_uint64;
+    values.back()._uint = packer.unpack_uint64();
+    break;
+
+  case PT_string:
+  case PT_blob:
+    values.push_back(Value());
+    values.back()._type = PT_string;
+    packer.unpack_string(values.back()._string);
+    break;
+
+  default:
+    packer.push();
+    while (packer.more_nested_fields()) {
+      unpack_general(packer, values);
+    }
+    packer.pop();
+    break;
+  }
+}
+
+/**
+ * Packs the values into the current field one at a time, the way
+ * DCPacker::pack_object() does.
+ */
+static void
+pack_general(DCPacker &packer, const Values &values) {
+  packer.push();
+  for (const Value &value : values) {
+    switch (value._type) {
+    case PT_int64:
+      packer.pack_int64(value._int);
+      break;
+    case PT_uint64:
+      packer.pack_uint64(value._uint);
+      break;
+    case PT_double:
+      packer.pack_double(value._double);
+      break;
+    default:
+      packer.pack_string(value._string);
+      break;
+    }
+  }
+  packer.pop();
+}
+
+int
+main(int argc, char *argv[]) {
+  std::string filename = "direct/src/distributed/direct.dc";
+  if (argc > 1) {
+    filename = argv[1];
+  }
+  int iterations = 100000;
+  if (argc > 2) {
+    iterations = atoi(argv[2]);
+  }
+
+  DCFile file;
+  if (!file.read(Filename::from_os_specific(filename))) {
+    nout << "Unable to read " << filename << "\n";
+    return 1;
+  }
+
+  // Collect every field with a plan, along with its default value to use as
+  // the test message.
+  pvector<const DCField *> fields;
+  int num_fields = 0;
+  for (int i = 0; i < file.get_num_classes(); ++i) {
+    DCClass *dclass = file.get_class(i);
+    for (int j = 0; j < dclass->get_num_fields(); ++j) {
+      const DCField *field = dclass->get_field(j);
+      ++num_fields;
+      if (field->get_pack_plan().is_valid()) {
+        fields.push_back(field);
+      }
+    }
+  }
+  nout << fields.size() << " of " << num_fields
+       << " fields have a pack plan.\n";
+
+  // Check that the plan and the general path agree on every field.
+  Values values;
+  for (const DCField *field : fields) {
+    const DCPackPlan &plan = field->get_pack_plan();
+    const vector_uchar &data = field->get_default_value();
+    values.assign(plan.get_num_ops(), Value());
+
+    DCPacker unpacker;
+    unpacker.set_unpack_data((const char *)data.data(), data.size(), false);
+    unpacker.begin_unpack(field);
+    ValueVisitor visitor(values);
+    unpacker.unpack_plan(plan, visitor);
+    if (!unpacker.end_unpack()) {
+      nout << "Unable to unpack " << field->get_name() << "\n";
+      return 1;
+    }
+
+    DCPacker packer;
+    packer.begin_pack(field);
+    ValueSource source(values);
+    packer.pack_plan(plan, source);
+    if (!packer.end_pack() || packer.get_bytes() != data) {
+      nout << "Repacking " << field->get_name() << " did not round-trip\n";
+      return 1;
+    }
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start, elapsed;
+  double num_messages = (double)iterations * fields.size();
+
+  // Unpack throughput.
+  start = clock->get_short_time();
+  for (int k = 0; k < iterations; ++k) {
+    for (const DCField *field : fields) {
+      const vector_uchar &data = field->get_default_value();
+      values.clear();
+      DCPacker unpacker;
+      unpacker.set_unpack_data((const char *)data.data(), data.size(), false);
+      unpacker.begin_unpack(field);
+      unpack_general(unpacker, values);
+      unpacker.end_unpack();
+    }
+  }
+  elapsed = clock->get_short_time() - start;
+  nout << "general unpack: " << num_messages / elapsed << " fields per second\n";
+
+  start = clock->get_short_time();
+  for (int k = 0; k < iterations; ++k) {
+    for (const DCField *field : fields) {
+      const DCPackPlan &plan = field->get_pack_plan();
+      const vector_uchar &data = field->get_default_value();
+      values.resize(plan.get_num_ops());
+      DCPacker unpacker;
+      unpacker.set_unpack_data((const char *)data.data(), data.size(), false);
+      unpacker.begin_unpack(field);
+      ValueVisitor visitor(values);
+      unpacker.unpack_plan(plan, visitor);
+      unpacker.end_unpack();
+    }
+  }
+  elapsed = clock->get_short_time() - start;
+  nout << "planned unpack: " << num_messages / elapsed << " fields per second\n";
+
+  // Pack throughput.  Each field packs the values of its own default.
+  pvector<Values> field_values(fields.size());
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const DCPackPlan &plan = fields[i]->get_pack_plan();
+    const vector_uchar &data = fields[i]->get_default_value();
+    field_values[i].resize(plan.get_num_ops());
+    DCPacker unpacker;
+    unpacker.set_unpack_data((const char *)data.data(), data.size(), false);
+    unpacker.begin_unpack(fields[i]);
+    ValueVisitor visitor(field_values[i]);
+    unpacker.unpack_plan(plan, visitor);
+    unpacker.end_unpack();
+  }
+
+  start = clock->get_short_time();
+  for (int k = 0; k < iterations; ++k) {
+    for (size_t i = 0; i < fields.size(); ++i) {
+      DCPacker packer;
+      packer.begin_pack(fields[i]);
+      pack_general(packer, field_values[i]);
+      packer.end_pack();
+    }
+  }
+  elapsed = clock->get_short_time() - start;
+  nout << "general pack: " << num_messages / elapsed << " fields per second\n";
+
+  start = clock->get_short_time();
+  for (int k = 0; k < iterations; ++k) {
+    for (size_t i = 0; i < fields.size(); ++i) {
+      DCPacker packer;
+      packer.begin_pack(fields[i]);
+      ValueSource source(field_values[i]);
+      packer.pack_plan(fields[i]->get_pack_plan(), source);
+      packer.end_pack();
+    }
+  }
+  elapsed = clock->get_short_time() - start;
+  nout << "planned pack: " << num_messages / elapsed << " fields per second\n";
+
+  return 0;
+}
@@ -31,6 +31,19 @@ ConfigVariableBool accept_clock_skew
  PRC_DESC("This controls the default value of "
           "SmoothMover::get_accept_clock_skew()."));
 
+ConfigVariableInt smooth_mover_threads
+("smooth-mover-threads", 0,
+ PRC_DESC("The number of worker threads the global SmoothMoverManager uses "
+          "to compute smoothed positions, in addition to the calling "
+          "thread.  Set this to 0 to compute them all on the calling "
+          "thread."));
+
+ConfigVariableInt smooth_mover_min_per_thread
+("smooth-mover-min-per-thread", 64,
+ PRC_DESC("The SmoothMoverManager will not hand a worker thread fewer than "
+          "this many SmoothMovers; below this, the work is not worth the "
+          "cost of waking the thread."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
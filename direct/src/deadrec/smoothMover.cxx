@@ -12,6 +12,7 @@
  */
 
 #include "smoothMover.h"
+#include "smoothMoverManager.h"
 #include "pnotify.h"
 #include "config_deadrec.h"
 
@@ -64,6 +65,9 @@ SmoothMover() {
  */
 SmoothMover::
 ~SmoothMover() {
+  if (_link._manager != nullptr) {
+    _link._manager->remove_mover(this);
+  }
 }
 
 /**
@@ -21,6 +21,8 @@
 #include "nodePath.h"
 #include "pdeque.h"
 
+class SmoothMoverManager;
+
 static const int max_position_reports = 10;
 static const int max_timestamp_delays = 10;
 
@@ -202,6 +204,22 @@ private:
   double _reset_velocity_age;
   bool _directional_velocity;
   bool _default_to_standing_still;
+
+  // The SmoothMoverManager this mover has been added to, if any, and its
+  // index within the manager.  A copy of a mover does not belong to the
+  // manager.
+  class ManagerLink {
+  public:
+    INLINE ManagerLink() : _manager(nullptr), _index(0) {}
+    INLINE ManagerLink(const ManagerLink &) : _manager(nullptr), _index(0) {}
+    INLINE ManagerLink &operator = (const ManagerLink &) { return *this; }
+
+    SmoothMoverManager *_manager;
+    size_t _index;
+  };
+  ManagerLink _link;
+
+  friend class SmoothMoverManager;
 };
 
 #include "smoothMover.I"
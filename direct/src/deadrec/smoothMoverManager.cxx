@@ -0,0 +1,399 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file smoothMoverManager.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "smoothMoverManager.h"
+#include "config_deadrec.h"
+#include "mutexHolder.h"
+#include "pStatTimer.h"
+#include "pStatClient.h"
+
+SmoothMoverManager *SmoothMoverManager::_global_ptr = nullptr;
+
+PStatCollector SmoothMoverManager::_update_pcollector("App:Smooth movers");
+PStatCollector SmoothMoverManager::_compute_pcollector("App:Smooth movers:Compute");
+PStatCollector SmoothMoverManager::_apply_pcollector("App:Smooth movers:Apply");
+
+/**
+ *
+ */
+SmoothMoverManager::
+SmoothMoverManager() :
+  _start_cvar(_lock),
+  _done_cvar(_lock)
+{
+  _pass = 0;
+  _chunk_size = 0;
+  _timestamp = 0.0;
+  _num_active = 0;
+  _num_working = 0;
+  _shutdown = false;
+}
+
+/**
+ *
+ */
+SmoothMoverManager::
+~SmoothMoverManager() {
+  stop_threads();
+  clear_movers();
+}
+
+/**
+ * Adds the indicated mover to the manager.  Each call to update() will
+ * compute its smoothed position, and if it has changed, apply the position to
+ * pos_node and the orientation to hpr_node.  These may be the same node.
+ *
+ * If the mover already belongs to this manager, its nodes are replaced; if it
+ * belongs to a different manager, it is first removed from that one.
+ */
+void SmoothMoverManager::
+add_mover(SmoothMover *mover, const NodePath &pos_node,
+          const NodePath &hpr_node) {
+  nassertv(mover != nullptr);
+
+  if (mover->_link._manager == this) {
+    size_t n = mover->_link._index;
+    _pos_nodes[n] = pos_node;
+    _hpr_nodes[n] = hpr_node;
+    return;
+  }
+
+  if (mover->_link._manager != nullptr) {
+    mover->_link._manager->remove_mover(mover);
+  }
+
+  mover->_link._manager = this;
+  mover->_link._index = _movers.size();
+
+  _movers.push_back(mover);
+  _pos_nodes.push_back(pos_node);
+  _hpr_nodes.push_back(hpr_node);
+  _smooth_pos.push_back(mover->get_smooth_pos());
+  _smooth_hpr.push_back(mover->get_smooth_hpr());
+  _changed.push_back(0);
+  _stop_state.push_back(SS_moving);
+}
+
+/**
+ * Removes the indicated mover from the manager.  Returns true if it was
+ * removed, or false if it did not belong to this manager.
+ */
+bool SmoothMoverManager::
+remove_mover(SmoothMover *mover) {
+  nassertr(mover != nullptr, false);
+  if (mover->_link._manager != this) {
+    return false;
+  }
+
+  // Move the last mover into the vacated slot.
+  size_t n = mover->_link._index;
+  size_t last = _movers.size() - 1;
+  nassertr(n <= last && _movers[n] == mover, false);
+  if (n != last) {
+    _movers[n] = _movers[last];
+    _pos_nodes[n] = std::move(_pos_nodes[last]);
+    _hpr_nodes[n] = std::move(_hpr_nodes[last]);
+    _smooth_pos[n] = _smooth_pos[last];
+    _smooth_hpr[n] = _smooth_hpr[last];
+    _changed[n] = _changed[last];
+    _stop_state[n] = _stop_state[last];
+    _movers[n]->_link._index = n;
+  }
+
+  _movers.pop_back();
+  _pos_nodes.pop_back();
+  _hpr_nodes.pop_back();
+  _smooth_pos.pop_back();
+  _smooth_hpr.pop_back();
+  _changed.pop_back();
+  _stop_state.pop_back();
+
+  mover->_link._manager = nullptr;
+  mover->_link._index = 0;
+  return true;
+}
+
+/**
+ * Removes all movers from the manager.
+ */
+void SmoothMoverManager::
+clear_movers() {
+  for (SmoothMover *mover : _movers) {
+    mover->_link._manager = nullptr;
+    mover->_link._index = 0;
+  }
+  _movers.clear();
+  _pos_nodes.clear();
+  _hpr_nodes.clear();
+  _smooth_pos.clear();
+  _smooth_hpr.clear();
+  _changed.clear();
+  _stop_state.clear();
+}
+
+/**
+ * Indicates whether the sender of the indicated mover's position has stopped
+ * moving.  Once a stopped mover's smoothed position no longer changes, it is
+ * fully stopped, and update() skips it altogether until this is called again
+ * with stopped false.  This has no effect if the mover does not belong to
+ * this manager.
+ */
+void SmoothMoverManager::
+set_mover_stopped(SmoothMover *mover, bool stopped) {
+  nassertv(mover != nullptr);
+  if (mover->_link._manager != this) {
+    return;
+  }
+
+  unsigned char &state = _stop_state[mover->_link._index];
+  if (!stopped) {
+    state = SS_moving;
+  } else if (state == SS_moving) {
+    state = SS_stopped;
+  }
+}
+
+/**
+ * Returns true if the indicated mover has been marked stopped, and its
+ * smoothed position has since stopped changing, so that update() no longer
+ * computes it.
+ */
+bool SmoothMoverManager::
+is_mover_fully_stopped(const SmoothMover *mover) const {
+  nassertr(mover != nullptr, false);
+  if (mover->_link._manager != this) {
+    return false;
+  }
+  return _stop_state[mover->_link._index] == SS_fully_stopped;
+}
+
+/**
+ * Specifies the number of worker threads that share the computation with the
+ * thread that calls update().  Set this to 0 to compute everything on the
+ * calling thread.  This has no effect if Panda was not compiled with true
+ * threading support.
+ */
+void SmoothMoverManager::
+set_num_threads(int num_threads) {
+  stop_threads();
+  if (num_threads > 0 && Thread::is_true_threads()) {
+    start_threads(num_threads);
+  }
+}
+
+/**
+ * Computes the smoothed position of every mover at the indicated time, and
+ * applies each one that changed to its node(s).  Returns the number of movers
+ * whose position changed.
+ *
+ * The computation may be split across the worker threads; the nodes are
+ * always updated on the calling thread.
+ */
+int SmoothMoverManager::
+update(double timestamp) {
+  PStatTimer timer(_update_pcollector);
+
+  size_t num_movers = _movers.size();
+  if (num_movers == 0) {
+    return 0;
+  }
+
+  {
+    PStatTimer timer2(_compute_pcollector);
+
+    // Don't bother handing work to threads that would have little to do.
+    size_t min_per_thread = (size_t)std::max((int)smooth_mover_min_per_thread, 1);
+    size_t num_threads = std::min(_threads.size(), num_movers / min_per_thread);
+
+    if (num_threads == 0) {
+      compute_range(0, num_movers, timestamp);
+
+    } else {
+      // Only the first num_threads workers take a share.  The condition
+      // variable wakes all of them, but the rest go straight back to sleep.
+      size_t chunk_size = (num_movers + num_threads) / (num_threads + 1);
+      {
+        MutexHolder holder(_lock);
+        _timestamp = timestamp;
+        _chunk_size = chunk_size;
+        _num_active = (int)num_threads;
+        _num_working = (int)num_threads;
+        ++_pass;
+        _start_cvar.notify_all();
+      }
+
+      // The calling thread takes the first share.
+      compute_range(0, chunk_size, timestamp);
+
+      MutexHolder holder(_lock);
+      while (_num_working > 0) {
+        _done_cvar.wait();
+      }
+    }
+  }
+
+  PStatTimer timer3(_apply_pcollector);
+  int num_changed = 0;
+  for (size_t n = 0; n < num_movers; ++n) {
+    if (!_changed[n]) {
+      continue;
+    }
+    ++num_changed;
+
+    NodePath &pos_node = _pos_nodes[n];
+    NodePath &hpr_node = _hpr_nodes[n];
+    if (pos_node == hpr_node) {
+      // Setting both at once makes one new transform rather than two.
+      if (!pos_node.is_empty()) {
+        pos_node.set_pos_hpr(_smooth_pos[n], _smooth_hpr[n]);
+      }
+    } else {
+      if (!pos_node.is_empty()) {
+        pos_node.set_pos(_smooth_pos[n]);
+      }
+      if (!hpr_node.is_empty()) {
+        hpr_node.set_hpr(_smooth_hpr[n]);
+      }
+    }
+  }
+
+  return num_changed;
+}
+
+/**
+ * Returns the global SmoothMoverManager, which uses the number of threads
+ * specified by the smooth-mover-threads config variable.
+ */
+SmoothMoverManager *SmoothMoverManager::
+get_global_ptr() {
+  if (_global_ptr == nullptr) {
+    _global_ptr = new SmoothMoverManager;
+    _global_ptr->set_num_threads(smooth_mover_threads);
+  }
+  return _global_ptr;
+}
+
+/**
+ * Computes the smoothed position of the movers in the indicated range, other
+ * than those that are fully stopped, and records the result.  This may be called on any thread, as each mover is
+ * only touched by one thread at a time.
+ */
+void SmoothMoverManager::
+compute_range(size_t begin, size_t end, double timestamp) {
+  end = std::min(end, _movers.size());
+  for (size_t n = begin; n < end; ++n) {
+    unsigned char &state = _stop_state[n];
+    if (state == SS_fully_stopped) {
+      _changed[n] = 0;
+      continue;
+    }
+
+    SmoothMover *mover = _movers[n];
+    bool changed = mover->compute_smooth_position(timestamp);
+    _changed[n] = changed;
+    if (changed) {
+      _smooth_pos[n] = mover->get_smooth_pos();
+      _smooth_hpr[n] = mover->get_smooth_hpr();
+    } else if (state == SS_stopped) {
+      state = SS_fully_stopped;
+    }
+  }
+}
+
+/**
+ * Starts the indicated number of worker threads.  Assumes none are running.
+ */
+void SmoothMoverManager::
+start_threads(int num_threads) {
+  MutexHolder holder(_lock);
+  _shutdown = false;
+  for (int i = 0; i < num_threads; ++i) {
+    std::ostringstream name_strm;
+    name_strm << "SmoothMoverThread-" << i;
+    PT(WorkerThread) thread = new WorkerThread(this, i, _pass, name_strm.str());
+    if (thread->start(TP_normal, true)) {
+      _threads.push_back(thread);
+    }
+  }
+}
+
+/**
+ * Signals all the worker threads to stop and waits for them.
+ */
+void SmoothMoverManager::
+stop_threads() {
+  Threads threads;
+  {
+    MutexHolder holder(_lock);
+    _shutdown = true;
+    _start_cvar.notify_all();
+    threads.swap(_threads);
+  }
+
+  for (WorkerThread *thread : threads) {
+    thread->join();
+  }
+}
+
+/**
+ *
+ */
+SmoothMoverManager::WorkerThread::
+WorkerThread(SmoothMoverManager *manager, int index, unsigned int start_pass,
+             const std::string &name) :
+  Thread(name, name),
+  _manager(manager),
+  _index(index),
+  _last_pass(start_pass)
+{
+}
+
+/**
+ * The main processing loop for each worker thread.  Each pass, worker n
+ * computes the (n + 1)th share of the movers, if it is one of the workers
+ * taking part in that pass.
+ *
+ * The thread starts from the pass that was current when it was created, so
+ * that it does not miss a pass begun before it first gets the lock.
+ */
+void SmoothMoverManager::WorkerThread::
+thread_main() {
+  MutexHolder holder(_manager->_lock);
+
+  while (true) {
+    PStatClient::thread_tick(get_sync_name());
+
+    while (_manager->_pass == _last_pass && !_manager->_shutdown) {
+      _manager->_start_cvar.wait();
+    }
+    if (_manager->_shutdown) {
+      return;
+    }
+    _last_pass = _manager->_pass;
+    if (_index >= _manager->_num_active) {
+      continue;
+    }
+
+    size_t begin = (_index + 1) * _manager->_chunk_size;
+    size_t end = begin + _manager->_chunk_size;
+    double timestamp = _manager->_timestamp;
+
+    _manager->_lock.release();
+    _manager->compute_range(begin, end, timestamp);
+    _manager->_lock.acquire();
+
+    if (--_manager->_num_working == 0) {
+      _manager->_done_cvar.notify();
+    }
+  }
+}
@@ -0,0 +1,131 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file smoothMoverManager.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef SMOOTHMOVERMANAGER_H
+#define SMOOTHMOVERMANAGER_H
+
+#include "directbase.h"
+#include "smoothMover.h"
+#include "nodePath.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "thread.h"
+#include "pStatCollector.h"
+
+/**
+ * This object updates many SmoothMovers at once.  Rather than calling
+ * compute_and_apply_smooth_pos_hpr() on each mover from its own task, the
+ * application registers each mover along with the node(s) it drives, and
+ * calls update() once per frame.
+ *
+ * The manager keeps its movers, their nodes and their results in parallel
+ * arrays.  update() computes every smoothed position in one pass, optionally
+ * split across worker threads (see set_num_threads()), and then applies all
+ * of the positions that changed to their nodes on the calling thread.
+ *
+ * A mover that has been marked stopped with set_mover_stopped() is skipped
+ * once its smoothed position stops changing, until it is marked moving again.
+ *
+ * A SmoothMover may belong to only one manager at a time.  It removes itself
+ * from its manager when it is destructed.
+ */
+class EXPCL_DIRECT_DEADREC SmoothMoverManager {
+PUBLISHED:
+  SmoothMoverManager();
+  ~SmoothMoverManager();
+
+  void add_mover(SmoothMover *mover, const NodePath &pos_node,
+                 const NodePath &hpr_node);
+  INLINE void add_mover(SmoothMover *mover, const NodePath &node);
+  bool remove_mover(SmoothMover *mover);
+  void clear_movers();
+
+  INLINE size_t get_num_movers() const;
+  INLINE SmoothMover *get_mover(size_t n) const;
+  MAKE_SEQ(get_movers, get_num_movers, get_mover);
+  INLINE bool has_mover(const SmoothMover *mover) const;
+
+  void set_mover_stopped(SmoothMover *mover, bool stopped);
+  bool is_mover_fully_stopped(const SmoothMover *mover) const;
+
+  void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+
+  INLINE int update();
+  int update(double timestamp);
+
+  static SmoothMoverManager *get_global_ptr();
+
+private:
+  void compute_range(size_t begin, size_t end, double timestamp);
+
+  enum StopState {
+    SS_moving,
+    SS_stopped,
+    SS_fully_stopped,
+  };
+  void start_threads(int num_threads);
+  void stop_threads();
+
+  class WorkerThread : public Thread {
+  public:
+    WorkerThread(SmoothMoverManager *manager, int index,
+                 unsigned int start_pass, const std::string &name);
+
+  protected:
+    virtual void thread_main();
+
+  private:
+    SmoothMoverManager *_manager;
+    int _index;
+    unsigned int _last_pass;
+  };
+  typedef pvector<PT(WorkerThread) > Threads;
+
+  // One entry per registered mover.  These are kept parallel; a removed
+  // mover is replaced by the last one.
+  pvector<SmoothMover *> _movers;
+  pvector<NodePath> _pos_nodes;
+  pvector<NodePath> _hpr_nodes;
+  pvector<LPoint3> _smooth_pos;
+  pvector<LVecBase3> _smooth_hpr;
+  pvector<unsigned char> _changed;
+  pvector<unsigned char> _stop_state;
+
+  // Protects the following members, which hand each pass to the worker
+  // threads.
+  Mutex _lock;
+  ConditionVar _start_cvar;
+  ConditionVar _done_cvar;
+  Threads _threads;
+  unsigned int _pass;
+  size_t _chunk_size;
+  double _timestamp;
+  int _num_active;
+  int _num_working;
+  bool _shutdown;
+
+  static SmoothMoverManager *_global_ptr;
+
+  static PStatCollector _update_pcollector;
+  static PStatCollector _compute_pcollector;
+  static PStatCollector _apply_pcollector;
+
+  friend class WorkerThread;
+};
+
+#include "smoothMoverManager.I"
+
+#endif
@@ -598,8 +598,12 @@ class ConnectionRepository(
         self.stopReaderPollTask()
         self.accept(CConnectionRepository.getOverflowEventName(),
                     self.handleReaderOverflow)
+        if self.config.GetBool('reader-poll-batched', False):
+            pollFunc = self.readerPollBatched
+        else:
+            pollFunc = self.readerPollUntilEmpty
         self.readerPollTaskObj = taskMgr.add(
-            self.readerPollUntilEmpty, self.uniqueName("readerPollTask"),
+            pollFunc, self.uniqueName("readerPollTask"),
             priority = self.taskPriority, taskChain = self.taskChain)
 
     def stopReaderPollTask(self):
@@ -625,6 +629,21 @@ class ConnectionRepository(
             messenger.send(self.uniqueName('lostConnection'), taskChain = 'default')
         return 0
 
+    def readerPollBatched(self, task):
+        # Field updates are dispatched by C++ within processIncoming();
+        # we only see the messages it couldn't handle, in order.
+        numResidual = self.processIncoming(
+            self.config.GetInt('reader-poll-max-messages', -1),
+            self.config.GetDouble('reader-poll-time-budget', -1.0))
+        for i in range(numResidual):
+            self.getResidualDatagramIterator(i, self.private__di)
+            self.handleDatagram(self.private__di)
+
+        if numResidual == 0 and not self.isConnected():
+            self.stopReaderPollTask()
+            messenger.send(self.uniqueName('lostConnection'), taskChain = 'default')
+        return Task.cont
+
     def handleReaderOverflow(self):
         # this is called if the incoming-datagram queue overflowed and
         # we lost some data. Override and handle if desired.
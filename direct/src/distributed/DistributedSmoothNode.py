@@ -1,6 +1,9 @@
 """DistributedSmoothNode module: contains the DistributedSmoothNode class"""
 
 from panda3d.core import *
+from panda3d.direct import SmoothMoverManager, CSmoothNodeCodec
+from .PyDatagram import PyDatagram
+from .PyDatagramIterator import PyDatagramIterator
 from .ClockDelta import *
 from . import DistributedNode
 from . import DistributedSmoothNodeBase
@@ -32,6 +35,14 @@ EnablePrediction = config.GetBool("smooth-enable-prediction", 1)
 Lag = config.GetDouble("smooth-lag", 0.2)
 PredictionLag = config.GetDouble("smooth-prediction-lag", 0.0)
 
+# Set this true to have the global SmoothMoverManager smooth all of the
+# nodes in one pass each frame, instead of running a task per node.
+BatchSmoothing = config.GetBool("smooth-batched", 0)
+
+def _smoothMoverManagerTask(task):
+    SmoothMoverManager.getGlobalPtr().update()
+    return cont
+
 
 GlobalSmoothing = 0
 GlobalPrediction = 0
@@ -70,6 +81,7 @@ class DistributedSmoothNode(DistributedNode.DistributedNode,
             self.smoothStarted = 0
 
             self.smoother = None
+            self.__codec = None
 
             # Set this True to assert that the local process has
             # complete authority over the position of this object when
@@ -86,6 +98,7 @@ class DistributedSmoothNode(DistributedNode.DistributedNode,
     def generate(self):
         self.smoother = SmoothMover()
         self.smoothStarted = 0
+        self.__codec = None
         self.lastSuggestResync = 0
         self._smoothWrtReparents = False
 
@@ -149,7 +162,16 @@ class DistributedSmoothNode(DistributedNode.DistributedNode,
             taskName = self.taskName("smooth")
             taskMgr.remove(taskName)
             self.reloadPosition()
-            taskMgr.add(self.doSmoothTask, taskName)
+            if self.__wantsBatchedSmoothing():
+                # The manager skips the node once it has come to a stop,
+                # just as smoothPosition() does.
+                mgr = SmoothMoverManager.getGlobalPtr()
+                mgr.addMover(self.smoother, self)
+                mgr.setMoverStopped(self.smoother, self.stopped)
+                if not taskMgr.hasTaskNamed("smoothMoverManager"):
+                    taskMgr.add(_smoothMoverManagerTask, "smoothMoverManager")
+            else:
+                taskMgr.add(self.doSmoothTask, taskName)
             self.smoothStarted = 1
 
     def stopSmooth(self):
@@ -160,9 +182,23 @@ class DistributedSmoothNode(DistributedNode.DistributedNode,
         if self.smoothStarted:
             taskName = self.taskName("smooth")
             taskMgr.remove(taskName)
+            if self.__wantsBatchedSmoothing() and self.smoother is not None:
+                SmoothMoverManager.getGlobalPtr().removeMover(self.smoother)
             self.forceToTruePosition()
             self.smoothStarted = 0
 
+    def __wantsBatchedSmoothing(self):
+        # The manager can only stand in for the default smoothPosition().
+        return BatchSmoothing and \
+               type(self).smoothPosition is DistributedSmoothNode.smoothPosition
+
+    def __setStopped(self, stopped):
+        self.stopped = stopped
+        if not stopped:
+            self.fullyStopped = False
+        if self.smoothStarted and self.__wantsBatchedSmoothing():
+            SmoothMoverManager.getGlobalPtr().setMoverStopped(self.smoother, stopped)
+
     def setSmoothWrtReparents(self, flag):
         self._smoothWrtReparents = flag
     def getSmoothWrtReparents(self):
@@ -217,14 +253,13 @@ class DistributedSmoothNode(DistributedNode.DistributedNode,
                 self.smoother.setPhonyTimestamp(local,True)
                 self.smoother.markPosition()
 
-        self.stopped = False
-        self.fullyStopped = False
+            self.__setStopped(False)
 
     # distributed set pos and hpr functions
     # 'send' versions are inherited from DistributedSmoothNodeBase
     def setSmStop(self, timestamp=None):
         self.setComponentTLive(timestamp)
-        self.stopped = True
+        self.__setStopped(True)
     def setSmH(self, h, timestamp=None):
         self._checkResume(timestamp)
         self.setComponentH(h)
@@ -289,6 +324,31 @@ class DistributedSmoothNode(DistributedNode.DistributedNode,
         self.setComponentR(r)
         self.setComponentTLive(timestamp)
 
+    def setSmQuantized(self, data, timestamp=None):
+        if self.__codec is None:
+            self.__codec = CSmoothNodeCodec()
+        if not self.__codec.decode(data):
+            # This is a delta against an update we never saw; wait for
+            # the next keyframe.
+            return
+        if self.__codec.isStop():
+            self.setSmStop(timestamp)
+            return
+        self._checkResume(timestamp)
+        self.smoother.setPosHpr(self.__codec.getPos(), self.__codec.getHpr())
+        self.setComponentTLive(timestamp)
+
+    def setSmBundle(self, data, timestamp=None):
+        # The updates for a number of nodes, each one preceded by its
+        # doId.  See CSmoothNodeBundle.
+        dgi = PyDatagramIterator(PyDatagram(data))
+        while dgi.getRemainingSize() > 0:
+            doId = dgi.getUint32()
+            update = dgi.extractBytes(dgi.getUint8())
+            obj = self.cr.doId2do.get(doId)
+            if isinstance(obj, DistributedSmoothNode) and obj.smoother is not None:
+                obj.setSmQuantized(update, timestamp)
+
     ### component set pos and hpr functions ###
 
     ### These are the component functions that are invoked
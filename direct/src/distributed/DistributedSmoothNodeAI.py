@@ -1,5 +1,8 @@
 from . import DistributedNodeAI
 from . import DistributedSmoothNodeBase
+from .PyDatagram import PyDatagram
+from .PyDatagramIterator import PyDatagramIterator
+from panda3d.direct import CSmoothNodeCodec
 
 class DistributedSmoothNodeAI(DistributedNodeAI.DistributedNodeAI,
                               DistributedSmoothNodeBase.DistributedSmoothNodeBase):
@@ -7,6 +10,7 @@ class DistributedSmoothNodeAI(DistributedNodeAI.DistributedNodeAI,
     def __init__(self, air, name=None):
         DistributedNodeAI.DistributedNodeAI.__init__(self, air, name)
         DistributedSmoothNodeBase.DistributedSmoothNodeBase.__init__(self)
+        self.__codec = None
 
     def generate(self):
         DistributedNodeAI.DistributedNodeAI.generate(self)
@@ -63,6 +67,21 @@ class DistributedSmoothNodeAI(DistributedNodeAI.DistributedNodeAI,
     def setSmPosHprL(self, l, x, y, z, h, p, r, t=None):
         self.setPosHpr(x, y, z, h, p, r)
 
+    def setSmQuantized(self, data, t=None):
+        if self.__codec is None:
+            self.__codec = CSmoothNodeCodec()
+        if self.__codec.decode(data) and not self.__codec.isStop():
+            self.setPosHpr(self.__codec.getPos(), self.__codec.getHpr())
+
+    def setSmBundle(self, data, t=None):
+        dgi = PyDatagramIterator(PyDatagram(data))
+        while dgi.getRemainingSize() > 0:
+            doId = dgi.getUint32()
+            update = dgi.extractBytes(dgi.getUint8())
+            obj = self.air.doId2do.get(doId)
+            if isinstance(obj, DistributedSmoothNodeAI):
+                obj.setSmQuantized(update, t)
+
     def clearSmoothing(self, bogus = None):
         pass
 
@@ -15,7 +15,7 @@ DummyTask = DummyTaskClass()
 class DistributedSmoothNodeBase:
     """common base class for DistributedSmoothNode and DistributedSmoothNodeAI
     """
-    BroadcastTypes = Enum('FULL, XYH, XY')
+    BroadcastTypes = Enum('FULL, XYH, XY, QUANTIZED')
 
     def __init__(self):
         self.__broadcastPeriod = None
@@ -79,6 +79,7 @@ class DistributedSmoothNodeBase:
             BT.FULL: self.cnode.broadcastPosHprFull,
             BT.XYH:  self.cnode.broadcastPosHprXyh,
             BT.XY:  self.cnode.broadcastPosHprXy,
+            BT.QUANTIZED: self.cnode.broadcastPosHprQuantized,
             }
         # this comment is here so it will show up in a grep for 'def d_broadcastPosHpr'
         self.d_broadcastPosHpr = broadcastFuncs[self.broadcastType]
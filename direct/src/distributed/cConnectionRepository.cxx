@@ -23,6 +23,7 @@
 #include "datagramIterator.h"
 #include "throw_event.h"
 #include "pStatTimer.h"
+#include "trueClock.h"
 
 #ifdef HAVE_PYTHON
 #include "py_panda.h"
@@ -33,9 +34,12 @@ using std::endl;
 using std::string;
 
 const string CConnectionRepository::_overflow_event_name = "CRDatagramOverflow";
+const string CConnectionRepository::_capture_header = string("pcr\0\n", 5);
 
 #ifndef CPPPARSER
 PStatCollector CConnectionRepository::_update_pcollector("App:Show code:readerPollTask:Update");
+PStatCollector CConnectionRepository::_process_incoming_pcollector("App:Show code:readerPollTask:Process incoming");
+PStatCollector CConnectionRepository::_drain_pcollector("App:Show code:readerPollTask:Process incoming:Drain");
 #endif  // CPPPARSER
 
 /**
@@ -70,7 +74,9 @@ CConnectionRepository(bool has_owner_view, bool threaded_net) :
   _handle_c_updates(true),
   _want_message_bundling(true),
   _bundling_msgs(0),
-  _in_quiet_zone(0)
+  _in_quiet_zone(0),
+  _capture(nullptr),
+  _replay(nullptr)
 {
 #if defined(HAVE_NET) && defined(SIMULATE_NETWORK_DELAY)
   if (min_lag != 0.0 || max_lag != 0.0) {
@@ -86,6 +92,8 @@ CConnectionRepository(bool has_owner_view, bool threaded_net) :
 CConnectionRepository::
 ~CConnectionRepository() {
   disconnect();
+  stop_capture();
+  stop_replay();
 }
 
 /**
@@ -261,43 +269,35 @@ check_datagram() {
     _bdc.Flush();
   #endif //WANT_NATIVE_NET
 
-  while (do_check_datagram()) {
+  while (true) {
+#if defined(WANT_NATIVE_NET) && defined(HAVE_PYTHON)
+    if (_native && _capture == nullptr && _replay == nullptr) {
+      bool okflag = true;
+      if (handle_native_update(okflag)) {
+        if (!okflag) {
+          return false;
+        }
+        continue;
+      }
+    }
+#endif
+
+    if (!do_check_datagram()) {
+      break;
+    }
+
     if (get_verbose()) {
       describe_message(nout, "RECV", _dg);
     }
 
     // Start breaking apart the datagram.
     _di = DatagramIterator(_dg);
+    read_message_header(_di, _msg_channels, _msg_sender, _msg_type);
 
     if (!_client_datagram) {
-      unsigned char  wc_cnt;
-      wc_cnt = _di.get_uint8();
-      _msg_channels.clear();
-      for (unsigned char lp1 = 0; lp1 < wc_cnt; lp1++) {
-        CHANNEL_TYPE  schan  = _di.get_uint64();
-        _msg_channels.push_back(schan);
-      }
-      _msg_sender = _di.get_uint64();
-
-#ifdef HAVE_PYTHON
-      // For now, we need to stuff this field onto the Python structure, to
-      // support legacy code that expects to find it there.
-      if (_python_repository != nullptr) {
-#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
-        PyGILState_STATE gstate;
-        gstate = PyGILState_Ensure();
-#endif
-        PyObject *value = PyLong_FromUnsignedLongLong(_msg_sender);
-        PyObject_SetAttrString(_python_repository, "msgSender", value);
-        Py_DECREF(value);
-#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
-        PyGILState_Release(gstate);
-#endif
-      }
-#endif  // HAVE_PYTHON
+      set_python_msg_sender(_msg_sender);
     }
 
-    _msg_type = _di.get_uint16();
     // Is this a message that we can process directly?
     if (!_handle_datagrams_internally) {
       return true;
@@ -308,12 +308,14 @@ check_datagram() {
     case CLIENT_OBJECT_SET_FIELD:
     case STATESERVER_OBJECT_SET_FIELD:
       if (_handle_c_updates) {
+        const char *data = (const char *)_dg.get_data() + _di.get_current_index();
+        size_t length = _di.get_remaining_size();
         if (_has_owner_view) {
-          if (!handle_update_field_owner()) {
+          if (!handle_update_field_owner(data, length)) {
             return false;
           }
         } else {
-          if (!handle_update_field()) {
+          if (!handle_update_field(data, length)) {
             return false;
           }
         }
@@ -334,6 +336,239 @@ check_datagram() {
   return false;
 }
 
+/**
+ * Drains up to max_messages datagrams from the connection (or all of them, if
+ * max_messages is negative), spending no more than time_budget seconds doing
+ * so (unlimited if negative).  Field updates that would be handled by
+ * check_datagram() are dispatched directly, with the Python lock acquired only
+ * once for the whole run of updates; everything else is kept for the caller,
+ * and the number of such residual messages is returned.  They may be
+ * retrieved with get_residual_datagram_iterator().
+ *
+ * This is intended to replace a Python loop over check_datagram(), paying
+ * one call into C++ per frame instead of one per message.
+ *
+ * Messages are never reordered: once a message has been left for the caller,
+ * all messages that follow it in the same batch are left for the caller too,
+ * since they may depend on it (for instance, an update to an object that the
+ * residual message generates).
+ */
+int CConnectionRepository::
+process_incoming(int max_messages, double time_budget) {
+  ReMutexHolder holder(_lock);
+  PStatTimer timer(_process_incoming_pcollector);
+
+  _residual.clear();
+  if (_simulated_disconnect) {
+    return 0;
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  #ifdef WANT_NATIVE_NET
+  if(_native)
+    _bdc.Flush();
+  #endif //WANT_NATIVE_NET
+
+  // Anything still pending was left behind by a Python exception during the
+  // previous batch; it precedes whatever is waiting on the connection.
+  bool any_residual = false;
+  IncomingMessages::const_iterator pi;
+  for (pi = _pending.begin(); pi != _pending.end(); ++pi) {
+    if (!(*pi)._c_handled) {
+      any_residual = true;
+    }
+  }
+
+  // First, pull the messages off the connection and decode their headers.
+  // This doesn't need to touch Python at all.
+  {
+    PStatTimer drain_timer(_drain_pcollector);
+    while ((max_messages < 0 || (int)_pending.size() < max_messages) &&
+           (time_budget < 0.0 || clock->get_short_time() - start < time_budget) &&
+           do_check_datagram()) {
+      if (get_verbose()) {
+        describe_message(nout, "RECV", _dg);
+      }
+
+      _pending.push_back(IncomingMessage());
+      IncomingMessage &msg = _pending.back();
+      msg._dg = std::move(_dg);
+
+      DatagramIterator di(msg._dg);
+      read_message_header(di, msg._msg_channels, msg._msg_sender, msg._msg_type);
+      msg._payload = di.get_current_index();
+      msg._c_handled = !any_residual && is_c_update(msg._msg_type);
+      any_residual = any_residual || !msg._c_handled;
+    }
+  }
+
+  // Now dispatch the leading run of field updates.
+  size_t num_handled = 0;
+  bool interrupted = false;
+
+#ifdef HAVE_PYTHON
+  if (!_pending.empty() && _pending[0]._c_handled) {
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+    PyGILState_STATE gstate;
+    gstate = PyGILState_Ensure();
+#endif
+
+    while (num_handled < _pending.size() && _pending[num_handled]._c_handled) {
+      if (time_budget >= 0.0 && clock->get_short_time() - start >= time_budget) {
+        interrupted = true;
+        break;
+      }
+
+      // Make this the current message, so that the update methods see the
+      // same state they would have seen through check_datagram().
+      IncomingMessage &msg = _pending[num_handled];
+      ++num_handled;
+
+      _msg_channels = msg._msg_channels;
+      _msg_sender = msg._msg_sender;
+      _msg_type = msg._msg_type;
+      if (!_client_datagram) {
+        set_python_msg_sender(_msg_sender);
+      }
+
+      const char *data = (const char *)msg._dg.get_data() + msg._payload;
+      size_t length = msg._dg.get_length() - msg._payload;
+      bool okflag = _has_owner_view ? handle_update_field_owner(data, length)
+                                    : handle_update_field(data, length);
+      if (!okflag) {
+        interrupted = true;
+        break;
+      }
+    }
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+    PyGILState_Release(gstate);
+#endif
+  }
+#endif  // HAVE_PYTHON
+
+  _pending.erase(_pending.begin(), _pending.begin() + num_handled);
+  if (interrupted) {
+    // Pick up where we left off next time; the residual messages can't be
+    // returned before the updates that precede them.
+    return 0;
+  }
+
+  _residual.swap(_pending);
+  return (int)_residual.size();
+}
+
+/**
+ * Fills the DatagramIterator object with the iterator for the nth message
+ * left over by the last call to process_incoming().  As with
+ * get_datagram_iterator(), the iterator has already read past the datagram
+ * header and the message type.
+ *
+ * This also makes the indicated message the current message, so that
+ * get_datagram(), get_msg_type(), get_msg_sender() and friends report on it,
+ * exactly as if it had been returned by check_datagram().
+ */
+void CConnectionRepository::
+get_residual_datagram_iterator(size_t n, DatagramIterator &di) {
+  ReMutexHolder holder(_lock);
+  nassertv(n < _residual.size());
+
+  const IncomingMessage &msg = _residual[n];
+  _dg = msg._dg;
+  _di = DatagramIterator(_dg, msg._payload);
+  _msg_channels = msg._msg_channels;
+  _msg_sender = msg._msg_sender;
+  _msg_type = msg._msg_type;
+  if (!_client_datagram) {
+    set_python_msg_sender(_msg_sender);
+  }
+
+  di = _di;
+}
+
+/**
+ * Starts writing every datagram subsequently received on the connection to
+ * the indicated file, which may later be fed back through the repository with
+ * start_replay().  Returns true on success, false if the file could not be
+ * opened.
+ */
+bool CConnectionRepository::
+start_capture(const Filename &filename) {
+  ReMutexHolder holder(_lock);
+
+  stop_capture();
+
+  _capture = new DatagramOutputFile;
+  if (!_capture->open(filename) || !_capture->write_header(_capture_header)) {
+    distributed_cat.error()
+      << "Unable to open " << filename << " for capturing datagrams.\n";
+    delete _capture;
+    _capture = nullptr;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Stops a capture started by start_capture() and closes the file.
+ */
+void CConnectionRepository::
+stop_capture() {
+  ReMutexHolder holder(_lock);
+
+  if (_capture != nullptr) {
+    _capture->close();
+    delete _capture;
+    _capture = nullptr;
+  }
+}
+
+/**
+ * Starts reading incoming datagrams from the indicated file, which was
+ * previously written by start_capture(), instead of from the connection.
+ * This is useful for reproducing and measuring the cost of a particular
+ * stream of messages.  The replay stops automatically at the end of the file.
+ * Returns true on success, false if the file could not be read.
+ */
+bool CConnectionRepository::
+start_replay(const Filename &filename) {
+  ReMutexHolder holder(_lock);
+
+  stop_replay();
+
+  _replay = new DatagramInputFile;
+  std::string header;
+  if (!_replay->open(filename) ||
+      !_replay->read_header(header, _capture_header.size()) ||
+      header != _capture_header) {
+    distributed_cat.error()
+      << filename << " is not a datagram capture file.\n";
+    delete _replay;
+    _replay = nullptr;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Stops a replay started by start_replay(), and resumes reading datagrams
+ * from the connection.
+ */
+void CConnectionRepository::
+stop_replay() {
+  ReMutexHolder holder(_lock);
+
+  if (_replay != nullptr) {
+    _replay->close();
+    delete _replay;
+    _replay = nullptr;
+  }
+}
+
 /**
  * Returns true if the connection to the gameserver is established and still
  * good, false if we are not connected.  A false value means either (a) we
@@ -638,6 +873,91 @@ shutdown() {
  */
 bool CConnectionRepository::
 do_check_datagram() {
+  if (_replay != nullptr) {
+    if (_replay->get_datagram(_dg)) {
+      return true;
+    }
+    stop_replay();
+    return false;
+  }
+
+  if (_capture != nullptr) {
+    if (!do_receive_datagram()) {
+      return false;
+    }
+    _capture->put_datagram(_dg);
+    return true;
+  }
+
+  return do_receive_datagram();
+}
+
+/**
+ * Reads the header of a message from the indicated iterator, which should be
+ * positioned at the beginning of the datagram.  On return, the iterator is
+ * positioned at the beginning of the message data.
+ */
+void CConnectionRepository::
+read_message_header(DatagramIterator &di,
+                    std::vector<CHANNEL_TYPE> &msg_channels,
+                    CHANNEL_TYPE &msg_sender, unsigned int &msg_type) const {
+  if (!_client_datagram) {
+    unsigned char  wc_cnt;
+    wc_cnt = di.get_uint8();
+    msg_channels.clear();
+    for (unsigned char lp1 = 0; lp1 < wc_cnt; lp1++) {
+      CHANNEL_TYPE  schan  = di.get_uint64();
+      msg_channels.push_back(schan);
+    }
+    msg_sender = di.get_uint64();
+  }
+
+  msg_type = di.get_uint16();
+}
+
+/**
+ * Returns true if messages of the indicated type are currently handled
+ * directly by the C++ layer, rather than being returned to Python.
+ */
+bool CConnectionRepository::
+is_c_update(unsigned int msg_type) const {
+#ifdef HAVE_PYTHON
+  if (_handle_datagrams_internally && _handle_c_updates) {
+    return (msg_type == CLIENT_OBJECT_SET_FIELD ||
+            msg_type == STATESERVER_OBJECT_SET_FIELD);
+  }
+#endif  // HAVE_PYTHON
+  return false;
+}
+
+/**
+ * Stores the sender of the current message on the Python repository object,
+ * to support legacy code that expects to find it there.
+ */
+void CConnectionRepository::
+set_python_msg_sender(CHANNEL_TYPE msg_sender) {
+#ifdef HAVE_PYTHON
+  if (_python_repository != nullptr) {
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+    PyGILState_STATE gstate;
+    gstate = PyGILState_Ensure();
+#endif
+    PyObject *value = PyLong_FromUnsignedLongLong(msg_sender);
+    PyObject_SetAttrString(_python_repository, "msgSender", value);
+    Py_DECREF(value);
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+    PyGILState_Release(gstate);
+#endif
+  }
+#endif  // HAVE_PYTHON
+}
+
+/**
+ * Receives one datagram from whichever connection is open, if one is
+ * available.
+ */
+bool CConnectionRepository::
+do_receive_datagram() {
   #ifdef WANT_NATIVE_NET
   if(_native) {
     return _bdc.GetMessage(_dg);
@@ -665,6 +985,75 @@ do_check_datagram() {
   return false;
 }
 
+#if defined(WANT_NATIVE_NET) && defined(HAVE_PYTHON)
+/**
+ * If the next message waiting in the native connection's receive buffer is a
+ * field update that we handle directly, decodes its header in place and
+ * dispatches it without first copying it into a Datagram, and returns true.
+ * okflag is set false if there was an error processing the update.
+ *
+ * Returns false, leaving the message where it is, if there is no message or
+ * it needs to be read normally.
+ */
+bool CConnectionRepository::
+handle_native_update(bool &okflag) {
+  const char *data;
+  size_t length;
+  if (get_verbose() || !_bdc.PeekMessage(data, length)) {
+    return false;
+  }
+
+  DCPacker packer;
+  packer.set_unpack_data(data, length, false);
+
+  // If this turns out not to be an update, the header is simply read again
+  // by check_datagram().
+  if (!_client_datagram) {
+    _msg_channels.clear();
+    unsigned char mcnt = packer.raw_unpack_uint8();
+    for (; mcnt > 0; mcnt--) {
+      _msg_channels.push_back(packer.RAW_UNPACK_CHANNEL());
+    }
+    _msg_sender = packer.RAW_UNPACK_CHANNEL();
+  }
+  _msg_type = packer.raw_unpack_uint16();
+
+  if (packer.had_pack_error() || !is_c_update(_msg_type)) {
+    return false;
+  }
+
+  if (!_client_datagram) {
+    set_python_msg_sender(_msg_sender);
+  }
+
+  size_t header_size = packer.get_num_unpacked_bytes();
+  data += header_size;
+  length -= header_size;
+
+  // Copy the payload out and consume the message before dispatching it.  The
+  // update method may do anything, including disconnecting or reading further
+  // messages from this connection, either of which may overwrite the receive
+  // buffer.  Most updates are small enough to be copied onto the stack.
+  char local_buffer[512];
+  std::string heap_buffer;
+  const char *payload = local_buffer;
+  if (length <= sizeof(local_buffer)) {
+    memcpy(local_buffer, data, length);
+  } else {
+    heap_buffer.assign(data, length);
+    payload = heap_buffer.data();
+  }
+  _bdc.SkipMessage();
+
+  if (_has_owner_view) {
+    okflag = handle_update_field_owner(payload, length);
+  } else {
+    okflag = handle_update_field(payload, length);
+  }
+  return true;
+}
+#endif  // WANT_NATIVE_NET && HAVE_PYTHON
+
 /**
  * Directly handles an update message on a field.  Python never touches the
  * datagram; it just gets its distributed method called with the appropriate
@@ -672,7 +1061,7 @@ do_check_datagram() {
  * processing the field's update method.
  */
 bool CConnectionRepository::
-handle_update_field() {
+handle_update_field(const char *data, size_t length) {
 #ifdef HAVE_PYTHON
 #if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
   PyGILState_STATE gstate;
@@ -680,7 +1069,11 @@ handle_update_field() {
 #endif
 
   PStatTimer timer(_update_pcollector);
-  unsigned int do_id = _di.get_uint32();
+  DCPacker packer;
+  packer.set_unpack_data(data, length, false);
+  unsigned int do_id = packer.raw_unpack_uint32();
+  data += packer.get_num_unpacked_bytes();
+  length -= packer.get_num_unpacked_bytes();
   if (_python_repository != nullptr)
   {
     PyObject *doId2do =
@@ -730,7 +1123,7 @@ handle_update_field() {
       // get into trouble if it tried to delete the object from the doId2do
       // map.
       Py_INCREF(distobj);
-      invoke_extension(dclass).receive_update(distobj, _di);
+      invoke_extension(dclass).receive_update(distobj, data, length);
       Py_DECREF(distobj);
 
       if (PyErr_Occurred()) {
@@ -760,7 +1153,7 @@ handle_update_field() {
  * the field's update method.
  */
 bool CConnectionRepository::
-handle_update_field_owner() {
+handle_update_field_owner(const char *data, size_t length) {
 #ifdef HAVE_PYTHON
 #if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
   PyGILState_STATE gstate;
@@ -768,7 +1161,11 @@ handle_update_field_owner() {
 #endif
 
   PStatTimer timer(_update_pcollector);
-  unsigned int do_id = _di.get_uint32();
+  DCPacker packer;
+  packer.set_unpack_data(data, length, false);
+  unsigned int do_id = packer.raw_unpack_uint32();
+  data += packer.get_num_unpacked_bytes();
+  length -= packer.get_num_unpacked_bytes();
   if (_python_repository != nullptr) {
     PyObject *doId2do =
       PyObject_GetAttrString(_python_repository, "doId2do");
@@ -800,10 +1197,9 @@ handle_update_field_owner() {
       Py_DECREF(dclass_this);
 
       // check if we should forward this update to the owner view
-      vector_uchar data = _di.get_remaining_bytes();
-      DCPacker packer;
-      packer.set_unpack_data((const char *)data.data(), data.size(), false);
-      int field_id = packer.raw_unpack_uint16();
+      DCPacker field_packer;
+      field_packer.set_unpack_data(data, length, false);
+      int field_id = field_packer.raw_unpack_uint16();
       DCField *field = dclass->get_field_by_index(field_id);
       if (field->is_ownrecv()) {
         // It's a good idea to ensure the reference count to distobjOV is
@@ -811,10 +1207,7 @@ handle_update_field_owner() {
         // method might get into trouble if it tried to delete the object from
         // the doId2do map.
         Py_INCREF(distobjOV);
-        // make a copy of the datagram iterator so that we can use the main
-        // iterator for the non-owner update
-        DatagramIterator _odi(_di);
-        invoke_extension(dclass).receive_update(distobjOV, _odi);
+        invoke_extension(dclass).receive_update(distobjOV, data, length);
         Py_DECREF(distobjOV);
 
         if (PyErr_Occurred()) {
@@ -842,11 +1235,6 @@ handle_update_field_owner() {
       DCClass *dclass = (DCClass *)PyLong_AsVoidPtr(dclass_this);
       Py_DECREF(dclass_this);
 
-      // check if we should forward this update to the owner view
-      vector_uchar data = _di.get_remaining_bytes();
-      DCPacker packer;
-      packer.set_unpack_data((const char *)data.data(), data.size(), false);
-
       //int field_id = packer.raw_unpack_uint16();
       //DCField *field = dclass->get_field_by_index(field_id);
       if (true) {//field->is_broadcast()) {
@@ -855,7 +1243,7 @@ handle_update_field_owner() {
         // get into trouble if it tried to delete the object from the doId2do
         // map.
         Py_INCREF(distobj);
-        invoke_extension(dclass).receive_update(distobj, _di);
+        invoke_extension(dclass).receive_update(distobj, data, length);
         Py_DECREF(distobj);
 
         if (PyErr_Occurred()) {
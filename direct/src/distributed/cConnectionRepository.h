@@ -25,6 +25,9 @@
 #include "clockObject.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "datagramInputFile.h"
+#include "datagramOutputFile.h"
+#include "pvector.h"
 
 #ifdef HAVE_NET
 #include "queuedConnectionManager.h"
@@ -122,6 +125,21 @@ PUBLISHED:
 // INLINE unsigned char get_sec_code() const;
   BLOCKING INLINE unsigned int get_msg_type() const;
 
+  BLOCKING int process_incoming(int max_messages = -1,
+                                double time_budget = -1.0);
+  BLOCKING INLINE size_t get_num_residual_datagrams() const;
+  BLOCKING INLINE const Datagram &get_residual_datagram(size_t n) const;
+  MAKE_SEQ(get_residual_datagrams, get_num_residual_datagrams, get_residual_datagram);
+  BLOCKING void get_residual_datagram_iterator(size_t n, DatagramIterator &di);
+  BLOCKING INLINE unsigned int get_residual_msg_type(size_t n) const;
+  BLOCKING INLINE CHANNEL_TYPE get_residual_msg_sender(size_t n) const;
+
+  BLOCKING bool start_capture(const Filename &filename);
+  BLOCKING void stop_capture();
+  BLOCKING bool start_replay(const Filename &filename);
+  BLOCKING void stop_replay();
+  BLOCKING INLINE bool is_replaying() const;
+
   INLINE static const std::string &get_overflow_event_name();
 
   BLOCKING bool is_connected();
@@ -158,8 +176,18 @@ PUBLISHED:
 
 private:
   bool do_check_datagram();
-  bool handle_update_field();
-  bool handle_update_field_owner();
+  bool do_receive_datagram();
+  void read_message_header(DatagramIterator &di,
+                           std::vector<CHANNEL_TYPE> &msg_channels,
+                           CHANNEL_TYPE &msg_sender,
+                           unsigned int &msg_type) const;
+  bool is_c_update(unsigned int msg_type) const;
+  void set_python_msg_sender(CHANNEL_TYPE msg_sender);
+#if defined(WANT_NATIVE_NET) && defined(HAVE_PYTHON)
+  bool handle_native_update(bool &okflag);
+#endif
+  bool handle_update_field(const char *data, size_t length);
+  bool handle_update_field_owner(const char *data, size_t length);
 
   void describe_message(std::ostream &out, const std::string &prefix,
                         const Datagram &dg) const;
@@ -206,6 +234,30 @@ private:
   unsigned int                          _msg_type;
 
   static const std::string _overflow_event_name;
+  static const std::string _capture_header;
+
+  // One message pulled off the connection by process_incoming().  The
+  // header has already been decoded; _payload is the offset of the first
+  // byte past the message type.
+  class IncomingMessage {
+  public:
+    Datagram _dg;
+    size_t _payload;
+    std::vector<CHANNEL_TYPE> _msg_channels;
+    CHANNEL_TYPE _msg_sender;
+    unsigned int _msg_type;
+    bool _c_handled;
+  };
+  typedef pvector<IncomingMessage> IncomingMessages;
+
+  // Messages drained but not yet dispatched (normally empty between calls,
+  // unless a Python exception interrupted the previous batch), and the
+  // messages returned to the caller by the last process_incoming().
+  IncomingMessages _pending;
+  IncomingMessages _residual;
+
+  DatagramOutputFile *_capture;
+  DatagramInputFile *_replay;
 
   bool _want_message_bundling;
   unsigned int _bundling_msgs;
@@ -213,6 +265,8 @@ private:
   BundledMsgVector _bundle_msgs;
 
   static PStatCollector _update_pcollector;
+  static PStatCollector _process_incoming_pcollector;
+  static PStatCollector _drain_pcollector;
 };
 
 #include "cConnectionRepository.I"
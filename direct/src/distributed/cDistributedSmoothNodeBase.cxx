@@ -13,6 +13,7 @@
 
 #include "cDistributedSmoothNodeBase.h"
 #include "cConnectionRepository.h"
+#include "cSmoothNodeBundle.h"
 #include "dcField.h"
 #include "dcClass.h"
 #include "dcmsgtypes.h"
@@ -25,6 +26,8 @@
 static const PN_stdfloat smooth_node_epsilon = 0.01;
 static const double network_time_precision = 100.0;  // Matches ClockDelta.py
 
+CDistributedSmoothNodeBase::ClassQuantization CDistributedSmoothNodeBase::_class_quantization;
+
 /**
  *
  */
@@ -40,6 +43,11 @@ CDistributedSmoothNodeBase() {
 
   _currL[0] = 0;
   _currL[1] = 0;
+
+  _since_keyframe = 0;
+
+  _bundle = nullptr;
+  _bundle_index = 0;
 }
 
 /**
@@ -47,6 +55,9 @@ CDistributedSmoothNodeBase() {
  */
 CDistributedSmoothNodeBase::
 ~CDistributedSmoothNodeBase() {
+  if (_bundle != nullptr) {
+    _bundle->remove_node(this);
+  }
 }
 
 /**
@@ -66,6 +77,12 @@ initialize(const NodePath &node_path, DCClass *dclass, CHANNEL_TYPE do_id) {
   _store_xyz = _node_path.get_pos();
   _store_hpr = _node_path.get_hpr();
   _store_stop = false;
+
+  // This also forgets the baseline, so the next quantized update will be a
+  // keyframe.
+  _codec.set_quantization(get_class_pos_quantization(_dclass),
+                          get_class_hpr_quantization(_dclass));
+  _since_keyframe = 0;
 }
 
 /**
@@ -267,6 +284,135 @@ broadcast_pos_hpr_xy() {
   }
 }
 
+/**
+ * Broadcasts the complete pos/hpr information in a compact form: each
+ * component is quantized to the step size configured for this node's class
+ * (see set_class_quantization()), and only the components that differ from
+ * the previous update are sent, as small variable-length deltas.  See
+ * CSmoothNodeCodec for the details.
+ *
+ * This sends setSmQuantized, which each receiver decodes with its own
+ * CSmoothNodeCodec.  The update is broadcast to many receivers, so the
+ * sender cannot know which of them have seen any given update; it simply
+ * assumes that each one arrives, as it does over a reliable connection.  A
+ * keyframe is sent every smooth-node-keyframe-interval updates, so that a
+ * receiver that has missed an update, or joined late, can catch up.
+ */
+void CDistributedSmoothNodeBase::
+broadcast_pos_hpr_quantized() {
+  if (_currL[0] != _currL[1]) {
+    // The location has changed; send everything, as broadcast_pos_hpr_full()
+    // does, to keep the position and the location in sync.
+    _currL[0] = _currL[1];
+    _store_xyz = _node_path.get_pos();
+    _store_hpr = _node_path.get_hpr();
+    _store_stop = false;
+    d_setSmPosHprL(_store_xyz[0], _store_xyz[1], _store_xyz[2],
+                   _store_hpr[0], _store_hpr[1], _store_hpr[2], _currL[0]);
+    return;
+  }
+
+  Datagram update;
+  if (encode_quantized(update)) {
+    d_setSmQuantized(update);
+  }
+}
+
+/**
+ * Specifies the step sizes to which broadcast_pos_hpr_quantized() quantizes
+ * the position and the angles of nodes of the indicated class, and of the
+ * classes that inherit from it.  This takes effect the next time each node
+ * is initialized.
+ */
+void CDistributedSmoothNodeBase::
+set_class_quantization(DCClass *dclass, PN_stdfloat pos_step,
+                       PN_stdfloat hpr_step) {
+  nassertv(dclass != nullptr);
+  nassertv(pos_step > 0.0f && hpr_step > 0.0f && hpr_step <= 180.0f);
+  Quantization &quant = _class_quantization[dclass];
+  quant._pos_step = pos_step;
+  quant._hpr_step = hpr_step;
+}
+
+/**
+ * Removes the step sizes specified for the indicated class, so that it
+ * reverts to those of its parent class, or to the defaults.
+ */
+void CDistributedSmoothNodeBase::
+clear_class_quantization(DCClass *dclass) {
+  _class_quantization.erase(dclass);
+}
+
+/**
+ * Returns the step size to which positions of nodes of the indicated class
+ * are quantized.  This is the value specified for the class or its nearest
+ * ancestor, or smooth-node-pos-quantization if there is none.
+ */
+PN_stdfloat CDistributedSmoothNodeBase::
+get_class_pos_quantization(DCClass *dclass) {
+  while (dclass != nullptr) {
+    ClassQuantization::const_iterator qi = _class_quantization.find(dclass);
+    if (qi != _class_quantization.end()) {
+      return (*qi).second._pos_step;
+    }
+    dclass = dclass->get_num_parents() > 0 ? dclass->get_parent(0) : nullptr;
+  }
+  return smooth_node_pos_quantization;
+}
+
+/**
+ * Returns the step size, in degrees, to which angles of nodes of the
+ * indicated class are quantized.  This is the value specified for the class
+ * or its nearest ancestor, or smooth-node-hpr-quantization if there is none.
+ */
+PN_stdfloat CDistributedSmoothNodeBase::
+get_class_hpr_quantization(DCClass *dclass) {
+  while (dclass != nullptr) {
+    ClassQuantization::const_iterator qi = _class_quantization.find(dclass);
+    if (qi != _class_quantization.end()) {
+      return (*qi).second._hpr_step;
+    }
+    dclass = dclass->get_num_parents() > 0 ? dclass->get_parent(0) : nullptr;
+  }
+  return smooth_node_hpr_quantization;
+}
+
+/**
+ * Encodes the node's current pos/hpr as a quantized update, as described in
+ * broadcast_pos_hpr_quantized(), and appends it to the datagram.  Returns
+ * true if anything was written, or false if there is nothing to send.
+ */
+bool CDistributedSmoothNodeBase::
+encode_quantized(Datagram &dg) {
+  LPoint3 xyz = _node_path.get_pos();
+  LVecBase3 hpr = _node_path.get_hpr();
+
+  if (!_codec.quantize_changed(xyz, hpr)) {
+    // No change.  Send one and only one "stop" message.
+    if (_store_stop) {
+      return false;
+    }
+    _store_stop = true;
+    CSmoothNodeCodec::encode_stop(dg);
+    return true;
+  }
+
+  _store_stop = false;
+  _store_xyz = xyz;
+  _store_hpr = hpr;
+
+  int interval = smooth_node_keyframe_interval;
+  bool keyframe = (interval > 0 && _since_keyframe >= interval);
+  int sequence = _codec.encode(dg, xyz, hpr, keyframe);
+  if (keyframe) {
+    _since_keyframe = 0;
+  }
+  ++_since_keyframe;
+
+  _codec.set_baseline(sequence);
+  return true;
+}
+
 /**
  * Fills up the packer with the data appropriate for sending an update on the
  * indicated field name, up until the arguments.
@@ -19,9 +19,12 @@
 #include "dcbase.h"
 #include "dcPacker.h"
 #include "clockObject.h"
+#include "cSmoothNodeCodec.h"
+#include "pmap.h"
 
 class DCClass;
 class CConnectionRepository;
+class CSmoothNodeBundle;
 
 /**
  * This class defines some basic methods of DistributedSmoothNodeBase which
@@ -49,6 +52,13 @@ PUBLISHED:
   void broadcast_pos_hpr_full();
   void broadcast_pos_hpr_xyh();
   void broadcast_pos_hpr_xy();
+  void broadcast_pos_hpr_quantized();
+
+  static void set_class_quantization(DCClass *dclass, PN_stdfloat pos_step,
+                                     PN_stdfloat hpr_step);
+  static void clear_class_quantization(DCClass *dclass);
+  static PN_stdfloat get_class_pos_quantization(DCClass *dclass);
+  static PN_stdfloat get_class_hpr_quantization(DCClass *dclass);
 
   void set_curr_l(uint64_t l);
   void print_curr_l();
@@ -67,6 +77,10 @@ private:
   INLINE void d_setSmXYZH(PN_stdfloat x, PN_stdfloat y, PN_stdfloat z, PN_stdfloat h);
   INLINE void d_setSmPosHpr(PN_stdfloat x, PN_stdfloat y, PN_stdfloat z, PN_stdfloat h, PN_stdfloat p, PN_stdfloat r);
   INLINE void d_setSmPosHprL(PN_stdfloat x, PN_stdfloat y, PN_stdfloat z, PN_stdfloat h, PN_stdfloat p, PN_stdfloat r, uint64_t l);
+  INLINE void d_setSmQuantized(const Datagram &update);
+  INLINE void d_setSmBundle(const Datagram &updates);
+
+  bool encode_quantized(Datagram &dg);
 
   void begin_send_update(DCPacker &packer, const std::string &field_name);
   void finish_send_update(DCPacker &packer);
@@ -97,6 +111,23 @@ private:
   // contains most recently sent location info as index 0, index 1 contains
   // most recently set location info
   uint64_t _currL[2];
+
+  // Used by broadcast_pos_hpr_quantized().
+  CSmoothNodeCodec _codec;
+  int _since_keyframe;
+
+  // The bundle this node belongs to, if any, and its index within it.
+  CSmoothNodeBundle *_bundle;
+  size_t _bundle_index;
+
+  struct Quantization {
+    PN_stdfloat _pos_step;
+    PN_stdfloat _hpr_step;
+  };
+  typedef pmap<const DCClass *, Quantization> ClassQuantization;
+  static ClassQuantization _class_quantization;
+
+  friend class CSmoothNodeBundle;
 };
 
 #include "cDistributedSmoothNodeBase.I"
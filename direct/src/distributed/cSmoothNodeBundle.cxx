@@ -0,0 +1,142 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cSmoothNodeBundle.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "cSmoothNodeBundle.h"
+
+/**
+ *
+ */
+CSmoothNodeBundle::
+CSmoothNodeBundle() {
+  _max_bundle_size = 16384;
+}
+
+/**
+ *
+ */
+CSmoothNodeBundle::
+~CSmoothNodeBundle() {
+  clear_nodes();
+}
+
+/**
+ * Adds the indicated node to the bundle.  The node must have been
+ * initialized, and should no longer be broadcast by its own task.  If it
+ * belongs to a different bundle, it is first removed from that one.
+ */
+void CSmoothNodeBundle::
+add_node(CDistributedSmoothNodeBase *node) {
+  nassertv(node != nullptr);
+  if (node->_bundle == this) {
+    return;
+  }
+  if (node->_bundle != nullptr) {
+    node->_bundle->remove_node(node);
+  }
+
+  node->_bundle = this;
+  node->_bundle_index = _nodes.size();
+  _nodes.push_back(node);
+}
+
+/**
+ * Removes the indicated node from the bundle.  Returns true if it was
+ * removed, or false if it did not belong to this bundle.
+ */
+bool CSmoothNodeBundle::
+remove_node(CDistributedSmoothNodeBase *node) {
+  nassertr(node != nullptr, false);
+  if (node->_bundle != this) {
+    return false;
+  }
+
+  // Move the last node into the vacated slot.
+  size_t n = node->_bundle_index;
+  nassertr(n < _nodes.size() && _nodes[n] == node, false);
+  _nodes[n] = _nodes.back();
+  _nodes[n]->_bundle_index = n;
+  _nodes.pop_back();
+
+  node->_bundle = nullptr;
+  node->_bundle_index = 0;
+  return true;
+}
+
+/**
+ * Removes all nodes from the bundle.
+ */
+void CSmoothNodeBundle::
+clear_nodes() {
+  for (CDistributedSmoothNodeBase *node : _nodes) {
+    node->_bundle = nullptr;
+    node->_bundle_index = 0;
+  }
+  _nodes.clear();
+}
+
+/**
+ * Encodes a quantized update for each node whose position has changed, and
+ * sends them together.  Returns the number of nodes for which an update was
+ * sent.
+ *
+ * A node whose location has changed is sent on its own with setSmPosHprL,
+ * as broadcast_pos_hpr_quantized() would.
+ */
+int CSmoothNodeBundle::
+broadcast() {
+  if (_nodes.empty()) {
+    return 0;
+  }
+
+  CDistributedSmoothNodeBase *carrier = _nodes[0];
+  int num_sent = 0;
+
+  Datagram updates;
+  Datagram update;
+  for (CDistributedSmoothNodeBase *node : _nodes) {
+    nassertd(!node->_node_path.is_empty()) continue;
+    nassertd(node->_repository == carrier->_repository) continue;
+
+    if (node->_currL[0] != node->_currL[1]) {
+      node->broadcast_pos_hpr_quantized();
+      ++num_sent;
+      continue;
+    }
+
+    update.clear();
+    if (!node->encode_quantized(update)) {
+      continue;
+    }
+
+    // Each entry is the doId, followed by the update with an 8-bit length.
+    // An update is never longer than a keyframe with all six components.
+    nassertd(update.get_length() <= 0xff) continue;
+    ++num_sent;
+
+    size_t entry_size = 4 + 1 + update.get_length();
+    if (updates.get_length() != 0 &&
+        updates.get_length() + entry_size > _max_bundle_size) {
+      carrier->d_setSmBundle(updates);
+      updates.clear();
+    }
+    updates.add_uint32(node->_do_id);
+    updates.add_uint8((uint8_t)update.get_length());
+    updates.append_data(update.get_data(), update.get_length());
+  }
+
+  if (updates.get_length() != 0) {
+    carrier->d_setSmBundle(updates);
+  }
+
+  return num_sent;
+}
@@ -0,0 +1,63 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cSmoothNodeBundle.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef CSMOOTHNODEBUNDLE_H
+#define CSMOOTHNODEBUNDLE_H
+
+#include "directbase.h"
+#include "cDistributedSmoothNodeBase.h"
+#include "pvector.h"
+
+/**
+ * Broadcasts the positions of many DistributedSmoothNodes in one message.
+ * Rather than running a broadcast task for each node, the application adds
+ * the nodes to a bundle and calls broadcast() once per tick.  This encodes a
+ * quantized update for each node that has moved, in the same form as
+ * CDistributedSmoothNodeBase::broadcast_pos_hpr_quantized(), and sends them
+ * all together in a single setSmBundle update.
+ *
+ * The update is sent on the first node in the bundle, and the receiving end
+ * passes each contained update on to the node with the matching doId.  This
+ * means that the nodes in a bundle should be visible to the same set of
+ * clients, such as the nodes in one zone that are controlled by the AI.
+ *
+ * A node may belong to only one bundle at a time.  It removes itself from
+ * its bundle when it is destructed.
+ */
+class EXPCL_DIRECT_DISTRIBUTED CSmoothNodeBundle {
+PUBLISHED:
+  CSmoothNodeBundle();
+  ~CSmoothNodeBundle();
+
+  void add_node(CDistributedSmoothNodeBase *node);
+  bool remove_node(CDistributedSmoothNodeBase *node);
+  void clear_nodes();
+
+  INLINE size_t get_num_nodes() const;
+  INLINE CDistributedSmoothNodeBase *get_node(size_t n) const;
+  MAKE_SEQ(get_nodes, get_num_nodes, get_node);
+  INLINE bool has_node(const CDistributedSmoothNodeBase *node) const;
+
+  INLINE void set_max_bundle_size(size_t max_size);
+  INLINE size_t get_max_bundle_size() const;
+
+  int broadcast();
+
+private:
+  pvector<CDistributedSmoothNodeBase *> _nodes;
+  size_t _max_bundle_size;
+};
+
+#include "cSmoothNodeBundle.I"
+
+#endif  // CSMOOTHNODEBUNDLE_H
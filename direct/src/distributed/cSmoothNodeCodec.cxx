@@ -0,0 +1,364 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cSmoothNodeCodec.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "cSmoothNodeCodec.h"
+#include "littleEndian.h"
+
+// Quantized positions are clamped to this magnitude, so that the difference
+// between two of them, at most 2^31 - 2, always fits in an int32_t.
+static const double max_quantized = (double)((1 << 30) - 1);
+
+/**
+ *
+ */
+CSmoothNodeCodec::
+CSmoothNodeCodec() {
+  set_quantization(0.1f, 0.1f);
+}
+
+/**
+ * Specifies the step sizes to which positions and angles are quantized.  The
+ * new sizes take effect at the next keyframe; this also forgets the current
+ * baseline, so the next update will be a keyframe.
+ */
+void CSmoothNodeCodec::
+set_quantization(PN_stdfloat pos_step, PN_stdfloat hpr_step) {
+  nassertv(pos_step > 0.0f && hpr_step > 0.0f && hpr_step <= 180.0f);
+  _pos_step = (PN_float32)pos_step;
+  _hpr_step = (PN_float32)hpr_step;
+  _turn = std::max((int32_t)cfloor(360.0f / _hpr_step + 0.5f), (int32_t)2);
+  clear();
+}
+
+/**
+ * Forgets all of the previously encoded or decoded states.
+ */
+void CSmoothNodeCodec::
+clear() {
+  for (int i = 0; i < num_history; ++i) {
+    _history[i]._valid = false;
+    _history[i]._sequence = 0;
+  }
+  _next_sequence = 0;
+  _baseline = -1;
+
+  _pos.set(0.0f, 0.0f, 0.0f);
+  _hpr.set(0.0f, 0.0f, 0.0f);
+  _changed = 0;
+  _stop = false;
+  _keyframe = false;
+  _sequence = -1;
+}
+
+/**
+ * Decodes an update produced by encode() or encode_stop().  Returns true if
+ * the update was applied, in which case the new state may be queried with
+ * get_pos() and get_hpr(), or false if it could not be decoded: either the
+ * data is malformed, or it is a delta against a state that this object has
+ * not seen.  In the latter case, the caller should ignore updates until the
+ * next keyframe arrives.
+ */
+bool CSmoothNodeCodec::
+decode(const vector_uchar &data) {
+  return decode(data.data(), data.size());
+}
+
+/**
+ * Encodes an update that moves the node to the indicated pos and hpr, and
+ * appends it to the datagram.  A delta against the current baseline is
+ * written if possible; a keyframe is written if keyframe is true or if there
+ * is no usable baseline, and keyframe is updated to indicate which was
+ * written.  Returns the sequence number of the new state.
+ *
+ * The new state is not made the baseline; call set_baseline() with the new
+ * sequence number once it is known to have been received.
+ */
+int CSmoothNodeCodec::
+encode(Datagram &dg, const LVecBase3 &pos, const LVecBase3 &hpr,
+       bool &keyframe) {
+  int32_t q[6];
+  quantize(q, pos, hpr);
+
+  uint8_t sequence = _next_sequence++;
+
+  // The baseline must still be in the history at both ends, which will not
+  // be the case once we store this state over it.
+  if (_baseline < 0 ||
+      (uint8_t)(sequence - _baseline) >= (uint8_t)num_history) {
+    _baseline = -1;
+    keyframe = true;
+  }
+
+  static const int32_t zero[6] = { 0, 0, 0, 0, 0, 0 };
+  const int32_t *base = keyframe ? zero : _history[_baseline % num_history]._q;
+
+  int32_t delta[6];
+  int flags = 0;
+  for (int i = 0; i < 6; ++i) {
+    delta[i] = q[i] - base[i];
+    if (i >= 3) {
+      delta[i] = wrap_angle(delta[i]);
+    }
+    if (delta[i] != 0) {
+      flags |= (1 << i);
+    }
+  }
+
+  if (keyframe) {
+    dg.add_uint8(flags | F_keyframe);
+    dg.add_uint8(sequence);
+    dg.add_float32(_pos_step);
+    dg.add_float32(_hpr_step);
+  } else if ((uint8_t)(sequence - _baseline) == 1) {
+    // The usual case: the baseline is the previous update.
+    dg.add_uint8(flags | F_previous);
+    dg.add_uint8(sequence);
+  } else {
+    dg.add_uint8(flags);
+    dg.add_uint8(sequence);
+    dg.add_uint8((uint8_t)_baseline);
+  }
+
+  for (int i = 0; i < 6; ++i) {
+    if (flags & (1 << i)) {
+      write_varint(dg, delta[i]);
+    }
+  }
+
+  store(q, sequence);
+  return sequence;
+}
+
+/**
+ * Appends an update that indicates the node has stopped moving.  This
+ * carries no state and does not need a baseline.
+ */
+void CSmoothNodeCodec::
+encode_stop(Datagram &dg) {
+  dg.add_uint8(F_stop);
+}
+
+/**
+ * Returns true if the indicated pos and hpr, once quantized, differ from the
+ * most recently encoded state, or if nothing has been encoded yet.
+ */
+bool CSmoothNodeCodec::
+quantize_changed(const LVecBase3 &pos, const LVecBase3 &hpr) const {
+  const State &last = _history[(uint8_t)(_next_sequence - 1) % num_history];
+  if (!last._valid || last._sequence != (uint8_t)(_next_sequence - 1)) {
+    return true;
+  }
+
+  int32_t q[6];
+  quantize(q, pos, hpr);
+  for (int i = 0; i < 6; ++i) {
+    if (q[i] != last._q[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Makes the state with the indicated sequence number the baseline for
+ * subsequent deltas.  This is called by the sender once it knows that the
+ * state has reached the receiver.  Returns true if the baseline was changed,
+ * or false if the state is no longer remembered or is older than the
+ * current baseline.
+ */
+bool CSmoothNodeCodec::
+set_baseline(int sequence) {
+  if (sequence < 0 || sequence > 0xff) {
+    return false;
+  }
+
+  const State &state = _history[sequence % num_history];
+  if (!state._valid || state._sequence != (uint8_t)sequence) {
+    return false;
+  }
+
+  // A state stored after our last encode is one we haven't sent yet.
+  uint8_t age = (uint8_t)(_next_sequence - 1 - sequence);
+  if (age >= (uint8_t)num_history) {
+    return false;
+  }
+
+  if (_baseline >= 0 &&
+      age > (uint8_t)(_next_sequence - 1 - _baseline)) {
+    // This acknowledgement arrived after a newer one.
+    return false;
+  }
+
+  _baseline = sequence;
+  return true;
+}
+
+/**
+ * Decodes an update from the indicated buffer.  See decode(vector_uchar).
+ */
+bool CSmoothNodeCodec::
+decode(const unsigned char *data, size_t length) {
+  const unsigned char *p = data;
+  const unsigned char *end = data + length;
+  if (p >= end) {
+    return false;
+  }
+
+  int flags = *p++;
+  if ((flags & F_stop) == F_stop) {
+    _changed = 0;
+    _stop = true;
+    _keyframe = false;
+    return true;
+  }
+
+  if (p >= end) {
+    return false;
+  }
+  uint8_t sequence = *p++;
+
+  const int32_t *base;
+  static const int32_t zero[6] = { 0, 0, 0, 0, 0, 0 };
+
+  if ((flags & F_stop) == F_keyframe) {
+    if (end - p < 8) {
+      return false;
+    }
+    PN_float32 pos_step, hpr_step;
+    LittleEndian(p, 0, sizeof(pos_step)).store_value(&pos_step, sizeof(pos_step));
+    LittleEndian(p, 4, sizeof(hpr_step)).store_value(&hpr_step, sizeof(hpr_step));
+    p += 8;
+    if (!(pos_step > 0.0f) || !(hpr_step > 0.0f) || hpr_step > 180.0f) {
+      return false;
+    }
+    if (pos_step != _pos_step || hpr_step != _hpr_step) {
+      // The old states are meaningless at the new step sizes.
+      set_quantization(pos_step, hpr_step);
+    }
+    base = zero;
+
+  } else {
+    uint8_t baseline = sequence - 1;
+    if ((flags & F_previous) == 0) {
+      if (p >= end) {
+        return false;
+      }
+      baseline = *p++;
+    }
+    const State &state = _history[baseline % num_history];
+    if (!state._valid || state._sequence != baseline ||
+        (uint8_t)(sequence - baseline) >= (uint8_t)num_history) {
+      // We have lost track of the sender.  Forget everything, so that a
+      // stale state can't be mistaken for a later one with the same sequence
+      // number, and wait for a keyframe.
+      for (int i = 0; i < num_history; ++i) {
+        _history[i]._valid = false;
+      }
+      return false;
+    }
+    base = state._q;
+  }
+
+  int32_t q[6];
+  for (int i = 0; i < 6; ++i) {
+    int32_t delta = 0;
+    if ((flags & (1 << i)) != 0 && !read_varint(p, end, delta)) {
+      return false;
+    }
+    int64_t v = (int64_t)base[i] + delta;
+    if (i >= 3) {
+      q[i] = wrap_angle((int32_t)(v % _turn));
+    } else if (v < -(int64_t)max_quantized || v > (int64_t)max_quantized) {
+      // The sender would never have sent this.
+      return false;
+    } else {
+      q[i] = (int32_t)v;
+    }
+  }
+  if (p != end) {
+    return false;
+  }
+
+  store(q, sequence);
+  _pos.set(q[0] * _pos_step, q[1] * _pos_step, q[2] * _pos_step);
+  _hpr.set(q[3] * _hpr_step, q[4] * _hpr_step, q[5] * _hpr_step);
+  _changed = flags & F_component_mask;
+  _stop = false;
+  _keyframe = (flags & F_stop) == F_keyframe;
+  _sequence = sequence;
+  return true;
+}
+
+/**
+ * Quantizes the pos and hpr according to the current step sizes.
+ */
+void CSmoothNodeCodec::
+quantize(int32_t q[6], const LVecBase3 &pos, const LVecBase3 &hpr) const {
+  for (int i = 0; i < 3; ++i) {
+    // This is done in double precision, since a float can't hold every
+    // value up to the limit.
+    double v = cfloor((double)pos[i] / (double)_pos_step + 0.5);
+    q[i] = (int32_t)std::min(std::max(v, -max_quantized), max_quantized);
+  }
+  for (int i = 0; i < 3; ++i) {
+    PN_stdfloat v = cmod(hpr[i], (PN_stdfloat)360.0f) / _hpr_step;
+    q[i + 3] = wrap_angle((int32_t)cfloor(v + 0.5f));
+  }
+}
+
+/**
+ * Records the indicated state in the history.
+ */
+void CSmoothNodeCodec::
+store(const int32_t q[6], uint8_t sequence) {
+  State &state = _history[sequence % num_history];
+  memcpy(state._q, q, sizeof(state._q));
+  state._valid = true;
+  state._sequence = sequence;
+}
+
+/**
+ * Writes a signed value in the zigzag variable-length encoding: seven bits
+ * per byte, low bits first, with the high bit set on all but the last byte.
+ */
+void CSmoothNodeCodec::
+write_varint(Datagram &dg, int32_t value) {
+  uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  while (v >= 0x80) {
+    dg.add_uint8((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  dg.add_uint8((uint8_t)v);
+}
+
+/**
+ * Reads a value written by write_varint().  Returns false if the data runs
+ * out first.
+ */
+bool CSmoothNodeCodec::
+read_varint(const unsigned char *&p, const unsigned char *end,
+            int32_t &value) {
+  uint32_t v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (p >= end) {
+      return false;
+    }
+    uint8_t byte = *p++;
+    v |= (uint32_t)(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+      return true;
+    }
+  }
+  return false;
+}
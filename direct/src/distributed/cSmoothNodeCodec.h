@@ -0,0 +1,129 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cSmoothNodeCodec.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef CSMOOTHNODECODEC_H
+#define CSMOOTHNODECODEC_H
+
+#include "directbase.h"
+#include "luse.h"
+#include "datagram.h"
+#include "vector_uchar.h"
+#include "numeric_types.h"
+
+/**
+ * Encodes and decodes the compact position updates sent by
+ * CDistributedSmoothNodeBase::broadcast_pos_hpr_quantized().
+ *
+ * Each component of the pos/hpr is quantized to a multiple of a fixed step
+ * size, and an update contains only the components that differ from a
+ * baseline state: one that the sender expects the receiver to have seen.
+ * Each differing component is written as a variable-length signed delta, so
+ * a node that moves a little each broadcast costs a byte or two per
+ * component.
+ *
+ * Every update carries an 8-bit sequence number, and a delta update names
+ * its baseline, unless that is the previous update.  Both ends remember the
+ * last num_history states, so a sender may keep the baseline a few updates
+ * behind (see set_baseline()).  A keyframe is encoded against the zero state
+ * and also carries the step sizes, so a receiver that missed its baseline
+ * (or joined late) can resume from the next keyframe.
+ *
+ * The same object is used at either end of the connection; a sender calls
+ * encode() and a receiver calls decode().
+ */
+class EXPCL_DIRECT_DISTRIBUTED CSmoothNodeCodec {
+PUBLISHED:
+  CSmoothNodeCodec();
+
+  void set_quantization(PN_stdfloat pos_step, PN_stdfloat hpr_step);
+  INLINE PN_stdfloat get_pos_quantization() const;
+  INLINE PN_stdfloat get_hpr_quantization() const;
+
+  void clear();
+
+  bool decode(const vector_uchar &data);
+
+  INLINE const LPoint3 &get_pos() const;
+  INLINE const LVecBase3 &get_hpr() const;
+  INLINE int get_changed() const;
+  INLINE bool is_stop() const;
+  INLINE bool is_keyframe() const;
+  INLINE int get_sequence() const;
+
+public:
+  enum Flags {
+    // The low six bits name the components present, in the same order as
+    // CDistributedSmoothNodeBase::Flags: x, y, z, h, p, r.
+    F_component_mask = 0x3f,
+
+    // A keyframe is followed by the step sizes, and is encoded against the
+    // zero state.
+    F_keyframe       = 0x40,
+
+    // A delta against the immediately preceding update, whose sequence
+    // number is therefore omitted.  Otherwise, a delta names its baseline.
+    F_previous       = 0x80,
+
+    // Both of the above: the node has stopped.  Nothing else follows.
+    F_stop           = 0xc0,
+  };
+
+  enum { num_history = 16 };
+
+  int encode(Datagram &dg, const LVecBase3 &pos, const LVecBase3 &hpr,
+             bool &keyframe);
+  static void encode_stop(Datagram &dg);
+  bool quantize_changed(const LVecBase3 &pos, const LVecBase3 &hpr) const;
+
+  bool set_baseline(int sequence);
+  INLINE bool has_baseline() const;
+  INLINE int get_baseline() const;
+  INLINE int get_sequences_since_baseline() const;
+
+  bool decode(const unsigned char *data, size_t length);
+
+private:
+  struct State {
+    int32_t _q[6];
+    bool _valid;
+    uint8_t _sequence;
+  };
+
+  void quantize(int32_t q[6], const LVecBase3 &pos, const LVecBase3 &hpr) const;
+  void store(const int32_t q[6], uint8_t sequence);
+  INLINE int32_t wrap_angle(int32_t q) const;
+
+  static void write_varint(Datagram &dg, int32_t value);
+  static bool read_varint(const unsigned char *&p, const unsigned char *end,
+                          int32_t &value);
+
+  PN_float32 _pos_step;
+  PN_float32 _hpr_step;
+  int32_t _turn;
+
+  State _history[num_history];
+  uint8_t _next_sequence;
+  int _baseline;
+
+  // The result of the most recent decode().
+  LPoint3 _pos;
+  LVecBase3 _hpr;
+  int _changed;
+  bool _stop;
+  bool _keyframe;
+  int _sequence;
+};
+
+#include "cSmoothNodeCodec.I"
+
+#endif  // CSMOOTHNODECODEC_H
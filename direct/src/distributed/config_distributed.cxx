@@ -50,6 +50,28 @@ ConfigVariableBool handle_datagrams_internally
           "for performance reasons.  When it is false, all datagrams "
           "are handled by the Python implementation."));
 
+ConfigVariableDouble smooth_node_pos_quantization
+("smooth-node-pos-quantization", 0.1,
+ PRC_DESC("The default step size to which broadcastPosHprQuantized() rounds "
+          "the position of a DistributedSmoothNode.  The default matches the "
+          "precision of the setSm* fields.  This may be overridden "
+          "for a particular class with "
+          "CDistributedSmoothNodeBase.setClassQuantization()."));
+
+ConfigVariableDouble smooth_node_hpr_quantization
+("smooth-node-hpr-quantization", 0.1,
+ PRC_DESC("The default step size, in degrees, to which "
+          "broadcastPosHprQuantized() rounds the orientation of a "
+          "DistributedSmoothNode."));
+
+ConfigVariableInt smooth_node_keyframe_interval
+("smooth-node-keyframe-interval", 50,
+ PRC_DESC("The number of quantized position updates a DistributedSmoothNode "
+          "sends between keyframes.  A keyframe does not depend on any "
+          "earlier update, so a client that has just started watching the "
+          "node can begin decoding from it.  Set this to 0 to send keyframes "
+          "only when needed."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -27,6 +27,9 @@ extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableInt game_server_timeout_ms;
 extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableDouble min_lag;
 extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableDouble max_lag;
 extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableBool handle_datagrams_internally;
+extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableDouble smooth_node_pos_quantization;
+extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableDouble smooth_node_hpr_quantization;
+extern EXPCL_DIRECT_DISTRIBUTED ConfigVariableInt smooth_node_keyframe_interval;
 
 extern EXPCL_DIRECT_DISTRIBUTED void init_libdistributed();
 
@@ -0,0 +1,113 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_replay.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "directbase.h"
+#include "cConnectionRepository.h"
+#include "dcmsgtypes.h"
+#include "datagramOutputFile.h"
+#include "trueClock.h"
+
+/**
+ * Writes a synthetic capture file: mostly field updates, with the occasional
+ * message that would have to be handled by Python.
+ */
+static bool
+make_capture(const Filename &filename, int num_messages) {
+  // This must match CConnectionRepository::_capture_header.
+  static const std::string header("pcr\0\n", 5);
+
+  DatagramOutputFile out;
+  if (!out.open(filename) || !out.write_header(header)) {
+    return false;
+  }
+
+  for (int i = 0; i < num_messages; ++i) {
+    Datagram dg;
+    if (i % 10 == 9) {
+      dg.add_uint16(CLIENT_ENTER_OBJECT_REQUIRED);
+      dg.add_uint32(1000 + (i % 300));
+      dg.add_uint32(2);
+      dg.add_uint32(2000);
+    } else {
+      // Something shaped like setSmPosHpr.
+      dg.add_uint16(CLIENT_OBJECT_SET_FIELD);
+      dg.add_uint32(1000 + (i % 300));
+      dg.add_uint16(100);
+      for (int j = 0; j < 6; ++j) {
+        dg.add_int16(i + j);
+      }
+      dg.add_int16(i);
+    }
+    out.put_datagram(dg);
+  }
+
+  out.close();
+  return true;
+}
+
+int
+main(int argc, char *argv[]) {
+  Filename filename;
+  if (argc > 1) {
+    filename = Filename::from_os_specific(argv[1]);
+  } else {
+    filename = Filename::temporary("", "replay_", ".pcr");
+    nout << "No capture given; writing a synthetic one to " << filename << "\n";
+    if (!make_capture(filename, 1000000)) {
+      nout << "Unable to write " << filename << "\n";
+      return 1;
+    }
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  CConnectionRepository repository;
+
+  // First, the traditional way: one check_datagram() call per message.
+  if (!repository.start_replay(filename)) {
+    return 1;
+  }
+  int num_messages = 0;
+  double start = clock->get_short_time();
+  while (repository.check_datagram()) {
+    DatagramIterator di;
+    repository.get_datagram_iterator(di);
+    ++num_messages;
+  }
+  double elapsed = clock->get_short_time() - start;
+  nout << "check_datagram: " << num_messages << " messages in " << elapsed
+       << " s, " << num_messages / elapsed << " per second\n";
+
+  // Now the same stream through process_incoming(), in batches of the sort of
+  // size we would see in one frame.
+  if (!repository.start_replay(filename)) {
+    return 1;
+  }
+  int num_residual = 0;
+  int num_batches = 0;
+  start = clock->get_short_time();
+  while (repository.is_replaying()) {
+    int n = repository.process_incoming(1000);
+    for (int i = 0; i < n; ++i) {
+      DatagramIterator di;
+      repository.get_residual_datagram_iterator(i, di);
+    }
+    num_residual += n;
+    ++num_batches;
+  }
+  elapsed = clock->get_short_time() - start;
+  nout << "process_incoming: " << num_batches << " batches, " << num_residual
+       << " residual messages in " << elapsed << " s, "
+       << num_messages / elapsed << " per second\n";
+
+  return 0;
+}
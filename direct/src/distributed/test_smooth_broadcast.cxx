@@ -0,0 +1,321 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_smooth_broadcast.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "directbase.h"
+#include "cSmoothNodeCodec.h"
+#include "dcFile.h"
+#include "dcClass.h"
+#include "dcField.h"
+#include "dcPacker.h"
+#include "dcmsgtypes.h"
+#include "randomizer.h"
+#include "trueClock.h"
+
+// Simulates a crowd of DistributedSmoothNodes wandering around, and measures
+// the bytes and the CPU time it takes to broadcast their positions with the
+// existing setSm* fields, with setSmQuantized, and with setSmBundle.
+
+static const double tick_rate = 10.0;
+
+// The default value of smooth-node-keyframe-interval.
+static const int keyframe_interval = 50;
+
+// Every message on the wire also carries a 16-bit length.
+static const size_t datagram_overhead = 2;
+
+struct Walker {
+  LPoint3 _pos;
+  LVecBase3 _hpr;
+  double _speed;
+  double _idle_time;
+};
+
+/**
+ * Advances one member of the crowd by one tick.  Most of them walk, turning
+ * now and then; some stand still for a while.
+ */
+static void
+step(Walker &w, Randomizer &random) {
+  double dt = 1.0 / tick_rate;
+  if (w._idle_time > 0.0) {
+    w._idle_time -= dt;
+    return;
+  }
+  if (random.random_real(1.0) < 0.01) {
+    w._idle_time = random.random_real(5.0);
+    return;
+  }
+  if (random.random_real(1.0) < 0.1) {
+    w._hpr[0] += (PN_stdfloat)random.random_real_unit() * 30.0f;
+  }
+  PN_stdfloat h = deg_2_rad(w._hpr[0]);
+  w._pos[0] -= csin(h) * (PN_stdfloat)(w._speed * dt);
+  w._pos[1] += ccos(h) * (PN_stdfloat)(w._speed * dt);
+}
+
+/**
+ * Packs the message header that CDistributedSmoothNodeBase would send from a
+ * client, and begins packing the indicated field.
+ */
+static void
+begin_update(DCPacker &packer, DCField *field, uint32_t do_id) {
+  packer.raw_pack_uint16(CLIENT_OBJECT_SET_FIELD);
+  packer.raw_pack_uint32(do_id);
+  packer.raw_pack_uint16(field->get_number());
+  packer.begin_pack(field);
+  packer.push();
+}
+
+/**
+ * Packs the timestamp and finishes the message.  Returns its length on the
+ * wire.
+ */
+static size_t
+finish_update(DCPacker &packer) {
+  packer.pack_int(0);
+  packer.pop();
+  if (!packer.end_pack()) {
+    nout << "pack error\n";
+    exit(1);
+  }
+  return packer.get_length() + datagram_overhead;
+}
+
+/**
+ * Sends the update that CDistributedSmoothNodeBase::broadcast_pos_hpr_full()
+ * would send, and returns its length, or 0 if nothing is sent.
+ */
+static size_t
+send_full(DCClass *dclass, uint32_t do_id, const Walker &w,
+          LPoint3 &store_xyz, LVecBase3 &store_hpr, bool &store_stop) {
+  static const PN_stdfloat epsilon = 0.01f;
+
+  int flags = 0;
+  for (int i = 0; i < 3; ++i) {
+    if (!IS_THRESHOLD_EQUAL(store_xyz[i], w._pos[i], epsilon)) {
+      store_xyz[i] = w._pos[i];
+      flags |= (1 << i);
+    }
+    if (!IS_THRESHOLD_EQUAL(store_hpr[i], w._hpr[i], epsilon)) {
+      store_hpr[i] = w._hpr[i];
+      flags |= (8 << i);
+    }
+  }
+
+  if (flags == 0) {
+    if (store_stop) {
+      return 0;
+    }
+    store_stop = true;
+  } else {
+    store_stop = false;
+  }
+
+  // The same choices broadcast_pos_hpr_full() makes.
+  const char *name;
+  int send = flags;
+  if (flags == 0) {
+    name = "setSmStop";
+  } else if (flags == 0x08) {
+    name = "setSmH";
+  } else if (flags == 0x04) {
+    name = "setSmZ";
+  } else if ((flags & ~0x03) == 0) {
+    name = "setSmXY";
+    send = 0x03;
+  } else if ((flags & ~0x05) == 0) {
+    name = "setSmXZ";
+    send = 0x05;
+  } else if ((flags & ~0x07) == 0) {
+    name = "setSmPos";
+    send = 0x07;
+  } else if ((flags & ~0x38) == 0) {
+    name = "setSmHpr";
+    send = 0x38;
+  } else if ((flags & ~0x0b) == 0) {
+    name = "setSmXYH";
+    send = 0x0b;
+  } else if ((flags & ~0x0f) == 0) {
+    name = "setSmXYZH";
+    send = 0x0f;
+  } else {
+    name = "setSmPosHpr";
+    send = 0x3f;
+  }
+
+  DCPacker packer;
+  begin_update(packer, dclass->get_field_by_name(name), do_id);
+  for (int i = 0; i < 6; ++i) {
+    if (send & (1 << i)) {
+      packer.pack_double(i < 3 ? store_xyz[i] : store_hpr[i - 3]);
+    }
+  }
+  return finish_update(packer);
+}
+
+int
+main(int argc, char *argv[]) {
+  Filename dc_filename("direct.dc");
+  int num_nodes = 500;
+  int num_ticks = 600;
+  if (argc > 1) {
+    dc_filename = Filename::from_os_specific(argv[1]);
+  }
+  if (argc > 2) {
+    num_nodes = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    num_ticks = atoi(argv[3]);
+  }
+
+  DCFile dc_file;
+  if (!dc_file.read(dc_filename)) {
+    nout << "Unable to read " << dc_filename << "\n";
+    return 1;
+  }
+  DCClass *dclass = dc_file.get_class_by_name("DistributedSmoothNode");
+  nassertr(dclass != nullptr, 1);
+  DCField *quantized_field = dclass->get_field_by_name("setSmQuantized");
+  DCField *bundle_field = dclass->get_field_by_name("setSmBundle");
+  nassertr(quantized_field != nullptr && bundle_field != nullptr, 1);
+
+  Randomizer random(1);
+  pvector<Walker> crowd(num_nodes);
+  for (Walker &w : crowd) {
+    w._pos.set(random.random_real_unit() * 500.0f,
+               random.random_real_unit() * 500.0f, 0.0f);
+    w._hpr.set(random.random_real(360.0), 0.0f, 0.0f);
+    w._speed = 2.0 + random.random_real(4.0);
+    w._idle_time = 0.0;
+  }
+
+  // The sending state of each scheme, per node.
+  pvector<LPoint3> store_xyz(num_nodes);
+  pvector<LVecBase3> store_hpr(num_nodes);
+  pvector<char> store_stop(num_nodes, 0);
+  for (int n = 0; n < num_nodes; ++n) {
+    store_xyz[n] = crowd[n]._pos;
+    store_hpr[n] = crowd[n]._hpr;
+  }
+  pvector<CSmoothNodeCodec> encoders(num_nodes);
+  pvector<CSmoothNodeCodec> decoders(num_nodes);
+  pvector<char> quant_stop(num_nodes, 0);
+  pvector<int> since_keyframe(num_nodes, 0);
+
+  size_t full_bytes = 0, full_msgs = 0;
+  size_t quant_bytes = 0, quant_msgs = 0;
+  size_t bundle_bytes = 0, bundle_msgs = 0;
+  double full_time = 0.0, quant_time = 0.0;
+  PN_stdfloat max_error = 0.0f;
+  int decode_failures = 0;
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  Datagram update, updates;
+
+  for (int t = 0; t < num_ticks; ++t) {
+    for (Walker &w : crowd) {
+      step(w, random);
+    }
+
+    double start = clock->get_short_time();
+    for (int n = 0; n < num_nodes; ++n) {
+      bool stop = store_stop[n] != 0;
+      size_t bytes = send_full(dclass, 1000 + n, crowd[n],
+                               store_xyz[n], store_hpr[n], stop);
+      store_stop[n] = stop;
+      if (bytes != 0) {
+        full_bytes += bytes;
+        ++full_msgs;
+      }
+    }
+    double mid = clock->get_short_time();
+
+    // The quantized updates are packed into individual setSmQuantized
+    // messages, and also into one setSmBundle.
+    updates.clear();
+    for (int n = 0; n < num_nodes; ++n) {
+      const Walker &w = crowd[n];
+      update.clear();
+      if (!encoders[n].quantize_changed(w._pos, w._hpr)) {
+        if (quant_stop[n]) {
+          continue;
+        }
+        quant_stop[n] = true;
+        CSmoothNodeCodec::encode_stop(update);
+      } else {
+        quant_stop[n] = false;
+        bool keyframe = (since_keyframe[n] >= keyframe_interval);
+        int sequence = encoders[n].encode(update, w._pos, w._hpr, keyframe);
+        encoders[n].set_baseline(sequence);
+        since_keyframe[n] = keyframe ? 1 : since_keyframe[n] + 1;
+      }
+
+      DCPacker packer;
+      begin_update(packer, quantized_field, 1000 + n);
+      packer.pack_string(update.get_message());
+      quant_bytes += finish_update(packer);
+      ++quant_msgs;
+
+      updates.add_uint32(1000 + n);
+      updates.add_uint8((uint8_t)update.get_length());
+      updates.append_data(update.get_data(), update.get_length());
+
+      // Make sure the receiving end gets back what we sent.
+      if (!decoders[n].decode((const unsigned char *)update.get_data(),
+                              update.get_length())) {
+        ++decode_failures;
+      } else if (!decoders[n].is_stop()) {
+        max_error = std::max(max_error,
+                             (decoders[n].get_pos() - w._pos).length());
+      }
+    }
+    if (updates.get_length() != 0) {
+      DCPacker packer;
+      begin_update(packer, bundle_field, 1000);
+      packer.pack_string(updates.get_message());
+      bundle_bytes += finish_update(packer);
+      ++bundle_msgs;
+    }
+    double end = clock->get_short_time();
+
+    full_time += mid - start;
+    quant_time += end - mid;
+  }
+
+  double seconds = num_ticks / tick_rate;
+  nout << num_nodes << " nodes, " << num_ticks << " ticks at "
+       << tick_rate << " Hz\n\n";
+
+  nout << "setSm* fields:   " << full_msgs << " messages, "
+       << full_bytes / seconds << " bytes/s, "
+       << (double)full_bytes / std::max(full_msgs, (size_t)1)
+       << " bytes/update, "
+       << full_time * 1.0e9 / std::max(full_msgs, (size_t)1)
+       << " ns/update\n";
+
+  nout << "setSmQuantized:  " << quant_msgs << " messages, "
+       << quant_bytes / seconds << " bytes/s, "
+       << (double)quant_bytes / std::max(quant_msgs, (size_t)1)
+       << " bytes/update, "
+       << quant_time * 1.0e9 / std::max(quant_msgs, (size_t)1)
+       << " ns/update (encode, pack and decode)\n";
+
+  nout << "setSmBundle:     " << bundle_msgs << " messages, "
+       << bundle_bytes / seconds << " bytes/s, "
+       << (double)bundle_bytes / std::max(quant_msgs, (size_t)1)
+       << " bytes/update\n\n";
+
+  nout << "max position error " << max_error << ", "
+       << decode_failures << " decode failures\n";
+  return (decode_failures == 0) ? 0 : 1;
+}
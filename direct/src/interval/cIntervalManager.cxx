@@ -13,6 +13,8 @@
 
 #include "cIntervalManager.h"
 #include "cMetaInterval.h"
+#include "cLerpNodePathInterval.h"
+#include "config_interval.h"
 #include "dcast.h"
 #include "eventQueue.h"
 #include "mutexHolder.h"
@@ -96,6 +98,9 @@ add_c_interval(CInterval *interval, bool external) {
   if (interval->is_of_type(CMetaInterval::get_class_type())) {
     def._flags |= F_meta_interval;
   }
+  if (interval->is_of_type(CLerpNodePathInterval::get_class_type())) {
+    def._flags |= F_lerp_node_path;
+  }
   def._next_slot = -1;
 
   _name_index[interval->get_name()] = slot;
@@ -257,13 +262,30 @@ void CIntervalManager::
 step() {
   MutexHolder holder(_lock);
 
+  // The transform lerps of the CLerpNodePathIntervals are collected into a
+  // batch and applied together, as long as nothing in between might look at
+  // the nodes they modify.
+  bool batch_lerps = interval_batch_lerps;
+
   NameIndex::iterator ni;
   ni = _name_index.begin();
   while (ni != _name_index.end()) {
     int index = (*ni).second;
     const IntervalDef &def = _intervals[index];
     nassertv(def._interval != nullptr);
-    if (!def._interval->step_play()) {
+
+    bool keep;
+    if (batch_lerps && (def._flags & F_lerp_node_path) != 0) {
+      CLerpNodePathInterval *lerp = DCAST(CLerpNodePathInterval, def._interval);
+      lerp->set_batch(&_lerp_batch);
+      keep = lerp->step_play();
+      lerp->set_batch(nullptr);
+    } else {
+      _lerp_batch.flush();
+      keep = def._interval->step_play();
+    }
+
+    if (!keep) {
       // This interval is finished and wants to be removed from the active
       // list.
       NameIndex::iterator prev;
@@ -277,6 +299,7 @@ step() {
       ++ni;
     }
   }
+  _lerp_batch.flush();
 
   _next_event_index = 0;
 }
@@ -16,6 +16,7 @@
 
 #include "directbase.h"
 #include "cInterval.h"
+#include "cLerpNodePathBatch.h"
 #include "pointerTo.h"
 #include "pvector.h"
 #include "pmap.h"
@@ -70,6 +71,7 @@ private:
   enum Flags {
     F_external      = 0x0001,
     F_meta_interval = 0x0002,
+    F_lerp_node_path = 0x0004,
   };
   class IntervalDef {
   public:
@@ -88,6 +90,9 @@ private:
   int _first_slot;
   int _next_event_index;
 
+  // The transform lerps deferred during step().
+  CLerpNodePathBatch _lerp_batch;
+
   Mutex _lock;
 
   static CIntervalManager *_global_ptr;
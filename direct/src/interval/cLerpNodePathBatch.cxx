@@ -0,0 +1,175 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cLerpNodePathBatch.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "cLerpNodePathBatch.h"
+#include "cLerpNodePathInterval.h"
+#include "config_interval.h"
+
+/**
+ *
+ */
+CLerpNodePathBatch::
+CLerpNodePathBatch() {
+}
+
+/**
+ * Records the lerp of the indicated interval to the indicated delta, to be
+ * applied at the next call to flush().  The kind is the combination of
+ * F_end_pos, F_end_hpr, F_end_quat and F_end_scale being lerped; the interval
+ * must already know the starting value of each of these.
+ */
+void CLerpNodePathBatch::
+add(CLerpNodePathInterval *interval, unsigned int kind, double d) {
+  nassertv(kind != 0 && kind < num_groups);
+  Group &group = _groups[kind];
+
+  if ((kind & CLerpNodePathInterval::F_end_quat) != 0) {
+    // The slerp depends on how the interval set it up, so we just do it now.
+    nassertv(interval->_slerp != nullptr);
+    LQuaternion quat;
+    (interval->*(interval->_slerp))(quat, d);
+    group._quat.push_back(quat);
+  }
+  if ((kind & CLerpNodePathInterval::F_end_pos) != 0) {
+    group._start[C_pos].push_back(interval->_start_pos);
+    group._end[C_pos].push_back(interval->_end_pos);
+  }
+  if ((kind & CLerpNodePathInterval::F_end_hpr) != 0) {
+    group._start[C_hpr].push_back(interval->_start_hpr);
+    group._end[C_hpr].push_back(interval->_end_hpr);
+  }
+  if ((kind & CLerpNodePathInterval::F_end_scale) != 0) {
+    group._start[C_scale].push_back(interval->_start_scale);
+    group._end[C_scale].push_back(interval->_end_scale);
+  }
+
+  _order.push_back(Order::value_type(kind, group._intervals.size()));
+  group._intervals.push_back(interval);
+  group._d.push_back((PN_stdfloat)d);
+}
+
+/**
+ * Computes and applies all of the lerps that have been added since the last
+ * call to flush(), and empties the batch.
+ */
+void CLerpNodePathBatch::
+flush() {
+  if (_order.empty()) {
+    return;
+  }
+
+  // First, compute the new values, one group and one component at a time.
+  for (unsigned int kind = 1; kind < num_groups; ++kind) {
+    Group &group = _groups[kind];
+    size_t num_lerps = group._d.size();
+    if (num_lerps == 0) {
+      continue;
+    }
+
+    const PN_stdfloat *d = &group._d[0];
+    for (int c = 0; c < num_components; ++c) {
+      if (group._start[c].empty()) {
+        continue;
+      }
+      nassertv(group._start[c].size() == num_lerps);
+      group._value[c].resize(num_lerps);
+
+      const LVecBase3 *start = &group._start[c][0];
+      const LVecBase3 *end = &group._end[c][0];
+      LVecBase3 *value = &group._value[c][0];
+      for (size_t i = 0; i < num_lerps; ++i) {
+        value[i] = start[i] + d[i] * (end[i] - start[i]);
+      }
+    }
+  }
+
+  // Now apply them to the nodes, in the order they were stepped.
+  for (const Order::value_type &entry : _order) {
+    unsigned int kind = entry.first;
+    size_t i = entry.second;
+    Group &group = _groups[kind];
+    CLerpNodePathInterval *interval = group._intervals[i];
+    NodePath &node = interval->_node;
+
+    bool fluid = (interval->_flags & CLerpNodePathInterval::F_fluid) != 0;
+    CPT(TransformState) prev_transform;
+    if (fluid) {
+      prev_transform = node.get_prev_transform();
+    }
+
+    switch (kind) {
+    case CLerpNodePathInterval::F_end_pos:
+      node.set_pos(group._value[C_pos][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_hpr:
+      node.set_hpr(group._value[C_hpr][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_quat:
+      node.set_quat(group._quat[i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_scale:
+      node.set_scale(group._value[C_scale][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_hpr | CLerpNodePathInterval::F_end_scale:
+      node.set_hpr_scale(group._value[C_hpr][i], group._value[C_scale][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_quat | CLerpNodePathInterval::F_end_scale:
+      node.set_quat_scale(group._quat[i], group._value[C_scale][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_pos | CLerpNodePathInterval::F_end_hpr:
+      node.set_pos_hpr(group._value[C_pos][i], group._value[C_hpr][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_pos | CLerpNodePathInterval::F_end_quat:
+      node.set_pos_quat(group._value[C_pos][i], group._quat[i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_pos | CLerpNodePathInterval::F_end_hpr | CLerpNodePathInterval::F_end_scale:
+      node.set_pos_hpr_scale(group._value[C_pos][i], group._value[C_hpr][i],
+                             group._value[C_scale][i]);
+      break;
+
+    case CLerpNodePathInterval::F_end_pos | CLerpNodePathInterval::F_end_quat | CLerpNodePathInterval::F_end_scale:
+      node.set_pos_quat_scale(group._value[C_pos][i], group._quat[i],
+                              group._value[C_scale][i]);
+      break;
+
+    default:
+      interval_cat.error()
+        << "Internal error in CLerpNodePathBatch::flush().\n";
+    }
+
+    if (fluid) {
+      node.set_prev_transform(prev_transform);
+    }
+  }
+
+  // Empty the batch, but keep the memory around for the next frame.
+  for (unsigned int kind = 1; kind < num_groups; ++kind) {
+    Group &group = _groups[kind];
+    group._intervals.clear();
+    group._d.clear();
+    for (int c = 0; c < num_components; ++c) {
+      group._start[c].clear();
+      group._end[c].clear();
+    }
+    group._quat.clear();
+  }
+  _order.clear();
+}
@@ -0,0 +1,85 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cLerpNodePathBatch.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef CLERPNODEPATHBATCH_H
+#define CLERPNODEPATHBATCH_H
+
+#include "directbase.h"
+#include "pointerTo.h"
+#include "pvector.h"
+#include "vector_stdfloat.h"
+#include "luse.h"
+
+class CLerpNodePathInterval;
+
+/**
+ * Collects the transform lerps of the CLerpNodePathIntervals stepped by a
+ * CIntervalManager during one call to step(), so they can be evaluated
+ * together and applied to their nodes in one pass.
+ *
+ * Only the simple, common lerps are batched: those that lerp the local pos,
+ * hpr, quat and/or scale of a node between known starting and ending values.
+ * The lerps are grouped by the combination of components they lerp, and each
+ * group keeps its values in one array per component, so that the
+ * interpolation is a tight loop over plain arrays.  The results are applied in
+ * the order the lerps were added, so that the final effect is the same as
+ * though each had been applied as it was stepped.
+ *
+ * This is used internally by CIntervalManager.
+ */
+class EXPCL_DIRECT_INTERVAL CLerpNodePathBatch {
+public:
+  CLerpNodePathBatch();
+  CLerpNodePathBatch(const CLerpNodePathBatch &copy) = delete;
+
+  CLerpNodePathBatch &operator = (const CLerpNodePathBatch &copy) = delete;
+
+  INLINE bool empty() const;
+  INLINE size_t size() const;
+
+  void add(CLerpNodePathInterval *interval, unsigned int kind, double d);
+  void flush();
+
+private:
+  enum Component {
+    C_pos,
+    C_hpr,
+    C_scale,
+    num_components,
+  };
+
+  // One of these for each combination of F_end_pos, F_end_hpr, F_end_quat and
+  // F_end_scale.
+  class Group {
+  public:
+    pvector<PT(CLerpNodePathInterval)> _intervals;
+    vector_stdfloat _d;
+    pvector<LVecBase3> _start[num_components];
+    pvector<LVecBase3> _end[num_components];
+    pvector<LVecBase3> _value[num_components];
+    pvector<LQuaternion> _quat;
+  };
+
+  enum {
+    num_groups = 16,
+  };
+  Group _groups[num_groups];
+
+  // The order in which the lerps were added, as (group, index within group).
+  typedef pvector<std::pair<unsigned int, size_t> > Order;
+  Order _order;
+};
+
+#include "cLerpNodePathBatch.I"
+
+#endif
@@ -12,6 +12,7 @@
  */
 
 #include "cLerpNodePathInterval.h"
+#include "cLerpNodePathBatch.h"
 #include "lerp_helpers.h"
 #include "transformState.h"
 #include "renderState.h"
@@ -57,7 +58,8 @@ CLerpNodePathInterval(const std::string &name, double duration,
   _flags(0),
   _texture_stage(TextureStage::get_default()),
   _override(0),
-  _slerp(nullptr)
+  _slerp(nullptr),
+  _batch(nullptr)
 {
   if (bake_in_start) {
     _flags |= F_bake_in_start;
@@ -108,6 +110,20 @@ priv_step(double t) {
   _state = S_started;
   double d = compute_delta(t);
 
+  if (_batch != nullptr) {
+    unsigned int kind = get_batch_kind();
+    if (kind != 0) {
+      _batch->add(this, kind, d);
+      _prev_d = d;
+      _curr_t = t;
+      return;
+    }
+
+    // This lerp needs to look at the node's current state, so the lerps that
+    // were batched before it must be applied first.
+    _batch->flush();
+  }
+
   // Save this in case we want to restore it later.
   CPT(TransformState) prev_transform = _node.get_prev_transform();
 
@@ -540,6 +556,35 @@ priv_reverse_instant() {
   _state = S_initial;
 }
 
+/**
+ * If this lerp can be evaluated by a CLerpNodePathBatch in its current state,
+ * returns the combination of transform components it lerps; otherwise,
+ * returns 0.  Only lerps of the local transform between known starting and
+ * ending values qualify, since the others need to query the node first.
+ */
+unsigned int CLerpNodePathInterval::
+get_batch_kind() const {
+  if ((_flags & (F_end_shear | F_end_color | F_end_color_scale |
+                 F_end_tex_offset | F_end_tex_rotate | F_end_tex_scale)) != 0 ||
+      !_other.is_empty()) {
+    return 0;
+  }
+
+  unsigned int kind = _flags & (F_end_pos | F_end_hpr | F_end_quat | F_end_scale);
+  if (kind == 0 || kind == (F_end_pos | F_end_scale)) {
+    // The latter keeps the node's existing rotation.
+    return 0;
+  }
+
+  if (((kind & F_end_pos) != 0 && (_flags & F_start_pos) == 0) ||
+      ((kind & F_end_hpr) != 0 && (_flags & F_start_hpr) == 0) ||
+      ((kind & F_end_quat) != 0 && (_flags & F_slerp_setup) == 0) ||
+      ((kind & F_end_scale) != 0 && (_flags & F_start_scale) == 0)) {
+    return 0;
+  }
+  return kind;
+}
+
 /**
  *
  */
@@ -19,6 +19,8 @@
 #include "nodePath.h"
 #include "textureStage.h"
 
+class CLerpNodePathBatch;
+
 /**
  * An interval that lerps one or more properties (like pos, hpr, etc.) on a
  * NodePath over time.
@@ -70,8 +72,12 @@ PUBLISHED:
 
   virtual void output(std::ostream &out) const;
 
+public:
+  INLINE void set_batch(CLerpNodePathBatch *batch);
+
 private:
   void setup_slerp();
+  unsigned int get_batch_kind() const;
 
   NodePath _node;
   NodePath _other;
@@ -131,6 +137,9 @@ private:
   // Define a pointer to one of the above three methods.
   void (CLerpNodePathInterval::*_slerp)(LQuaternion &result, PN_stdfloat t) const;
 
+  // Set by the CIntervalManager while it is stepping this interval.
+  CLerpNodePathBatch *_batch;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -147,6 +156,8 @@ public:
 
 private:
   static TypeHandle _type_handle;
+
+  friend class CLerpNodePathBatch;
 };
 
 #include "cLerpNodePathInterval.I"
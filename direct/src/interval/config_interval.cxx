@@ -50,6 +50,13 @@ ConfigVariableBool verify_intervals
  PRC_DESC("Set this true to generate an assertion failure if interval "
           "functions are called out-of-order."));
 
+ConfigVariableBool interval_batch_lerps
+("interval-batch-lerps", true,
+ PRC_DESC("Set this true to have the CIntervalManager evaluate the simple "
+          "transform lerps of all its intervals together each frame, and "
+          "apply them in one pass, rather than one interval at a time.  "
+          "The result is the same either way."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
@@ -24,6 +24,7 @@ NotifyCategoryDecl(interval, EXPCL_DIRECT_INTERVAL, EXPTP_DIRECT_INTERVAL);
 
 extern ConfigVariableDouble interval_precision;
 extern EXPCL_DIRECT_INTERVAL ConfigVariableBool verify_intervals;
+extern EXPCL_DIRECT_INTERVAL ConfigVariableBool interval_batch_lerps;
 
 extern EXPCL_DIRECT_INTERVAL void init_libinterval();
 
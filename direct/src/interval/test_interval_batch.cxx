@@ -0,0 +1,113 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_interval_batch.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "directbase.h"
+#include "cIntervalManager.h"
+#include "cLerpNodePathInterval.h"
+#include "config_interval.h"
+#include "clockObject.h"
+#include "trueClock.h"
+#include "pandaNode.h"
+
+using std::cerr;
+
+static const int num_frames = 300;
+
+/**
+ * Plays the indicated number of lerps, of a few different kinds, for a number
+ * of frames, and returns the average time spent in CIntervalManager::step()
+ * per frame.  Also returns the sum of the resulting positions, to compare the
+ * batched and unbatched results.
+ */
+static double
+run(int num_intervals, bool batch, LVecBase3 &checksum) {
+  interval_batch_lerps = batch;
+
+  ClockObject *clock = ClockObject::get_global_clock();
+  clock->set_mode(ClockObject::M_slave);
+  clock->set_frame_time(0.0);
+
+  CIntervalManager mgr;
+  NodePath root("root");
+
+  for (int i = 0; i < num_intervals; ++i) {
+    std::ostringstream namestrm;
+    namestrm << "lerp-" << i;
+    NodePath np = root.attach_new_node(namestrm.str());
+
+    PT(CLerpNodePathInterval) ival = new CLerpNodePathInterval
+      (namestrm.str(), 5.0 + (i % 7), CLerpInterval::BT_ease_in_out,
+       true, false, np, NodePath());
+
+    switch (i % 3) {
+    case 0:
+      ival->set_start_pos(LVecBase3(i, 0, 0));
+      ival->set_end_pos(LVecBase3(i, 10, 5));
+      ival->set_start_hpr(LVecBase3(0, 0, 0));
+      ival->set_end_hpr(LVecBase3(360, 0, 0));
+      break;
+
+    case 1:
+      ival->set_start_pos(LVecBase3(i, 0, 0));
+      ival->set_end_pos(LVecBase3(i, 10, 5));
+      ival->set_start_quat(LQuaternion::ident_quat());
+      ival->set_end_quat(LVecBase3(90, 45, 0));
+      ival->set_start_scale(1);
+      ival->set_end_scale(2);
+      break;
+
+    default:
+      // A pos-only lerp, with the starting value baked in on the first frame.
+      ival->set_end_pos(LVecBase3(0, i, 0));
+    }
+
+    ival->setup_play(0.0, -1.0, 1.0, false);
+    mgr.add_c_interval(ival, false);
+  }
+
+  TrueClock *true_clock = TrueClock::get_global_ptr();
+  double elapsed = 0.0;
+  for (int f = 0; f < num_frames; ++f) {
+    clock->set_frame_time((f + 1) / 60.0);
+    double start = true_clock->get_short_time();
+    mgr.step();
+    elapsed += true_clock->get_short_time() - start;
+  }
+
+  checksum.set(0, 0, 0);
+  for (int i = 0; i < root.get_num_children(); ++i) {
+    checksum += root.get_child(i).get_pos();
+  }
+  return elapsed / num_frames;
+}
+
+int
+main(int argc, char *argv[]) {
+  static const int counts[] = { 1000, 10000 };
+
+  for (int num_intervals : counts) {
+    LVecBase3 unbatched_sum, batched_sum;
+    double unbatched = run(num_intervals, false, unbatched_sum);
+    double batched = run(num_intervals, true, batched_sum);
+
+    cerr << num_intervals << " intervals: "
+         << unbatched * 1000.0 << " ms per frame unbatched, "
+         << batched * 1000.0 << " ms per frame batched";
+    if (!unbatched_sum.almost_equal(batched_sum)) {
+      cerr << " (results differ: " << unbatched_sum << " vs. "
+           << batched_sum << ")";
+    }
+    cerr << "\n";
+  }
+  return 0;
+}
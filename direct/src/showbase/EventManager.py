@@ -28,6 +28,11 @@ class EventManager:
 
         self._wantPstats = ConfigVariableBool('pstats-eventmanager', False)
 
+        # If this is set, each batch of events is dispatched to all of the
+        # C++ hooks at once, before any of it is sent to the messenger.
+        self._batchDispatch = ConfigVariableBool('event-batch-dispatch', False)
+        self._batchQueue = None
+
     def doEvents(self):
         """
         Process all the events on the C++ event queue
@@ -40,6 +45,24 @@ class EventManager:
             processFunc = self.processEvent
         isEmptyFunc = self.eventQueue.isQueueEmpty
         dequeueFunc = self.eventQueue.dequeueEvent
+
+        handler = self.eventHandler
+        if handler and self._batchDispatch:
+            # Let the EventHandler call the C++ hooks for everything that is
+            # pending, then send the same events on to the messenger.
+            if self._batchQueue is None:
+                self._batchQueue = EventQueue()
+            batchQueue = self._batchQueue
+            isBatchEmptyFunc = batchQueue.isQueueEmpty
+            dequeueBatchFunc = batchQueue.dequeueEvent
+            while True:
+                while not isBatchEmptyFunc():
+                    processFunc(dequeueBatchFunc(), False)
+                if isEmptyFunc():
+                    break
+                handler.processEvents(batchQueue)
+            return
+
         while not isEmptyFunc():
             processFunc(dequeueFunc())
 
@@ -72,7 +95,7 @@ class EventManager:
             # which will be downcast to that type.
             return eventParameter.getPtr()
 
-    def processEvent(self, event):
+    def processEvent(self, event, dispatchCpp=True):
         """
         Process a C++ event
         Duplicate any changes in processEventPstats
@@ -101,14 +124,14 @@ class EventManager:
 
             # Also send the event down into C++ land
             handler = self.eventHandler
-            if handler:
+            if handler and dispatchCpp:
                 handler.dispatchEvent(event)
 
         else:
             # An unnamed event from C++ is probably a bad thing
             EventManager.notify.warning('unnamed event in processEvent')
 
-    def processEventPstats(self, event):
+    def processEventPstats(self, event, dispatchCpp=True):
         """
         Process a C++ event with pstats tracking
         Duplicate any changes in processEvent
@@ -139,7 +162,7 @@ class EventManager:
                 name = name[0:hyphen]
             pstatCollector = PStatCollector('App:Show code:eventManager:' + name)
             pstatCollector.start()
-            if self.eventHandler:
+            if self.eventHandler and dispatchCpp:
                 cppPstatCollector = PStatCollector(
                     'App:Show code:eventManager:' + name + ':C++')
 
@@ -147,7 +170,7 @@ class EventManager:
 
             # Also send the event down into C++ land
             handler = self.eventHandler
-            if handler:
+            if handler and dispatchCpp:
                 cppPstatCollector.start()
                 handler.dispatchEvent(event)
                 cppPstatCollector.stop()
@@ -1913,7 +1913,9 @@ class ShowBase(DirectObject.DirectObject):
     def createStats(self, hostname=None, port=None):
         """
         If want-pstats is set in Config.prc, or the `wantStats` member is
-        otherwise set to True, connects to the PStats server.
+        otherwise set to True, connects to the PStats server.  If
+        pstats-record-file is set, the stats are written to that file
+        instead, for later conversion with pstats-convert.
         This is normally called automatically from the ShowBase constructor.
         """
         # You can specify pstats-host in your Config.prc or use ~pstats/~aipstats
@@ -1928,7 +1930,10 @@ class ShowBase(DirectObject.DirectObject):
             hostname = ''
         if port is None:
             port = -1
-        PStatClient.connect(hostname, port)
+        if self.config.GetString('pstats-record-file', ''):
+            PStatClient.record()
+        else:
+            PStatClient.connect(hostname, port)
         return PStatClient.isConnected()
 
     def addSfxManager(self, extraSfxManager):
@@ -4957,6 +4957,8 @@ if not PkgSkip("DIRECT"):
     TargetAdd('libp3distributed.in', opts=['IMOD:panda3d.direct', 'ILIB:libp3distributed', 'SRCDIR:direct/src/distributed'])
     PyTargetAdd('p3distributed_cConnectionRepository.obj', opts=OPTS, input='cConnectionRepository.cxx')
     PyTargetAdd('p3distributed_cDistributedSmoothNodeBase.obj', opts=OPTS, input='cDistributedSmoothNodeBase.cxx')
+    PyTargetAdd('p3distributed_cSmoothNodeBundle.obj', opts=OPTS, input='cSmoothNodeBundle.cxx')
+    PyTargetAdd('p3distributed_cSmoothNodeCodec.obj', opts=OPTS, input='cSmoothNodeCodec.cxx')
 
 #
 # DIRECTORY: direct/src/interval/
@@ -5042,6 +5044,8 @@ if not PkgSkip("DIRECT"):
     PyTargetAdd('direct.pyd', input='p3dcparser_ext_composite.obj')
     PyTargetAdd('direct.pyd', input='p3distributed_cConnectionRepository.obj')
     PyTargetAdd('direct.pyd', input='p3distributed_cDistributedSmoothNodeBase.obj')
+    PyTargetAdd('direct.pyd', input='p3distributed_cSmoothNodeBundle.obj')
+    PyTargetAdd('direct.pyd', input='p3distributed_cSmoothNodeCodec.obj')
 
     PyTargetAdd('direct.pyd', input='direct_module.obj')
     PyTargetAdd('direct.pyd', input='libp3direct.dll')
@@ -5694,6 +5698,19 @@ if not PkgSkip("PANDATOOL") and not PkgSkip("EGG"):
 #    TargetAdd('bin2c.exe', input=COMMON_PANDA_LIBS)
 #    TargetAdd('bin2c.exe', opts=['ADVAPI'])
 
+#
+# DIRECTORY: pandatool/src/pstatprogs/
+#
+
+if not PkgSkip("PANDATOOL"):
+    OPTS=['DIR:pandatool/src/pstatprogs']
+    TargetAdd('pstats-convert_pStatsConvert.obj', opts=OPTS, input='pStatsConvert.cxx')
+    TargetAdd('pstats-convert.exe', input='pstats-convert_pStatsConvert.obj')
+    TargetAdd('pstats-convert.exe', input='libp3progbase.lib')
+    TargetAdd('pstats-convert.exe', input='libp3pandatoolbase.lib')
+    TargetAdd('pstats-convert.exe', input=COMMON_PANDA_LIBS)
+    TargetAdd('pstats-convert.exe', opts=['ADVAPI'])
+
 #
 # DIRECTORY: pandatool/src/pstatserver/
 #
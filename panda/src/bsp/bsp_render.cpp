@@ -367,28 +367,18 @@ void BSPCullTraverser::traverse_below( CullTraverserData &data )
                 return;
         }
 
-        // Now visit all the node's children.
-        PandaNode::Children children = node_reader->get_children();
-        node_reader->release();
-        int num_children = children.get_num_children();
-        if ( !node->has_selective_visibility() )
-        {
-                for ( int i = 0; i < num_children; ++i )
-                {
-                        CullTraverserData next_data( data, children.get_child( i ) );
-                        do_traverse( next_data );
-                }
-        }
-        else
-        {
-                int i = node->get_first_visible_child();
-                while ( i < num_children )
-                {
-                        CullTraverserData next_data( data, children.get_child( i ) );
-                        do_traverse( next_data );
-                        i = node->get_next_visible_child( i );
-                }
-        }
+        // Now visit all the node's children.  The children of BSPRender may be
+        // split among the parallel cull threads.
+        traverse_children( data );
+}
+
+/**
+ * Returns a copy of this traverser to carry on the traversal below a
+ * parallel cull node on another thread.
+ */
+PT( CullTraverser ) BSPCullTraverser::make_parallel_copy() const
+{
+        return new BSPCullTraverser( (CullTraverser *)this, _loader );
 }
 
 /**
@@ -415,6 +405,10 @@ BSPRender::BSPRender( const std::string &name, BSPLoader *loader ) :
         _loader( loader )
 {
         set_cull_callback();
+
+        // The level's entities and props can be culled on several threads,
+        // if parallel-cull-threads is set.
+        set_parallel_cull( true );
 }
 
 bool BSPRender::cull_callback( CullTraverser *trav, CullTraverserData &data )
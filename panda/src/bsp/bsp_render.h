@@ -62,6 +62,7 @@ PUBLISHED:
 
 protected:
         virtual bool is_in_view( CullTraverserData &data );
+        virtual PT( CullTraverser ) make_parallel_copy() const;
 
 private:
         INLINE void add_geomnode_for_draw( GeomNode *node, CullTraverserData &data );
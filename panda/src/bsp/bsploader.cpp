@@ -1662,6 +1662,27 @@ bool BSPLoader::read( const Filename &file, bool is_transition )
         }
         _leaf_aabb_lock.release();
 
+        if ( !_ai )
+        {
+                // Start loading every material the level refers to in the
+                // background, so that make_faces() and the static decals
+                // don't have to stop and load them one at a time.
+                vector_string materials;
+                for ( int i = 0; i < _bspdata->numtexrefs; i++ )
+                {
+                        materials.push_back( _bspdata->dtexrefs[i].name );
+                }
+                for ( int entnum = 0; entnum < _bspdata->numentities; entnum++ )
+                {
+                        const entity_t *ent = _bspdata->entities + entnum;
+                        if ( !strncmp( ValueForKey( ent, "classname" ), "infodecal", 9 ) )
+                        {
+                                materials.push_back( ValueForKey( ent, "texture" ) );
+                        }
+                }
+                BSPMaterial::prefetch( materials );
+        }
+
 	load_geometry();
 
         load_entities();
@@ -11,10 +11,18 @@
 
 #include "bspMaterial.h"
 
-#include <lightReMutex.h>
-#include <lightReMutexHolder.h>
+#include <lightMutex.h>
+#include <lightMutexHolder.h>
+#include <genericAsyncTask.h>
+#include <asyncTaskManager.h>
+#include <thread.h>
+#include <texturePool.h>
+#include <loaderOptions.h>
 
-static LightReMutex g_matmutex("MaterialMutex");
+// Protects the material cache itself.  It is held only while looking up or
+// adding an entry, never while a material is being read, so different
+// materials can be loaded by different threads at the same time.
+static LightMutex g_matmutex("MaterialMutex");
 
 //====================================================================//
 
@@ -26,16 +34,197 @@ NotifyCategoryDef(bspmaterial, "");
 TypeHandle BSPMaterial::_type_handle;
 
 BSPMaterial::materialcache_t BSPMaterial::_material_cache;
+BSPMaterial::WaitingOn BSPMaterial::_waiting_on;
 
+/**
+ * Returns the material loaded from the indicated file, loading it first if
+ * it has not been loaded already.  If another thread is already loading the
+ * same file, waits for it to finish.  Returns NULL if the material could not
+ * be loaded, or if it includes itself, directly or through other materials.
+ */
 const BSPMaterial *BSPMaterial::get_from_file(const Filename &file) {
-  LightReMutexHolder holder(g_matmutex);
+  Thread *current_thread = Thread::get_current_thread();
+  PT(AsyncFuture) future;
+  {
+    LightMutexHolder holder(g_matmutex);
+
+    int idx = _material_cache.find(file);
+    if (idx != -1) {
+      const CacheEntry &entry = _material_cache.get_data(idx);
+      if (would_deadlock(entry, current_thread)) {
+        // We are already loading this file further up the stack, or another
+        // thread that is loading it is waiting for a file we are loading.
+        bspmaterial_cat.error()
+          << "Material " << file << " includes itself\n";
+        return nullptr;
+      }
+      future = entry._future;
+      if (entry._loader != nullptr) {
+        _waiting_on[current_thread] = file;
+      }
+
+    } else {
+      // Nobody has asked for this material yet, so it is ours to load.
+      CacheEntry entry;
+      entry._future = new AsyncFuture;
+      entry._loader = current_thread;
+      _material_cache[file] = entry;
+    }
+  }
+
+  if (future != nullptr) {
+    // It has been (or is being) loaded by someone else.
+    future->wait();
+
+    LightMutexHolder holder(g_matmutex);
+    _waiting_on.erase(current_thread);
+    return DCAST(BSPMaterial, future->get_result());
+  }
+
+  PT(BSPMaterial) mat = load_from_file(file);
+
+  {
+    LightMutexHolder holder(g_matmutex);
+    int idx = _material_cache.find(file);
+    nassertr(idx != -1, mat);
+    future = _material_cache.get_data(idx)._future;
+    if (mat != nullptr) {
+      _material_cache.modify_data(idx)._loader = nullptr;
+    } else {
+      // Don't remember the failure, so that we try again next time, in case
+      // the file shows up later.
+      _material_cache.remove_element(idx);
+    }
+  }
+
+  // This wakes up anyone else who was waiting for this material.  The cache
+  // keeps the material alive through the future's reference to it.
+  future->set_result(mat.p());
+  return mat;
+}
+
+/**
+ * Returns true if waiting for the indicated cache entry to be loaded would
+ * never return, because it is being loaded by the current thread, or by a
+ * thread that is (through any number of other threads) waiting for the
+ * current thread.  Assumes the lock is held.
+ */
+bool BSPMaterial::would_deadlock(const CacheEntry &entry, Thread *current_thread) {
+  Thread *loader = entry._loader;
+  while (loader != nullptr) {
+    if (loader == current_thread) {
+      return true;
+    }
+    WaitingOn::const_iterator wi = _waiting_on.find(loader);
+    if (wi == _waiting_on.end()) {
+      return false;
+    }
+    int idx = _material_cache.find((*wi).second);
+    if (idx == -1) {
+      return false;
+    }
+    loader = _material_cache.get_data(idx)._loader;
+  }
+  return false;
+}
+
+/**
+ * Starts loading each of the indicated material files on the prefetch task
+ * chain (see bsp-material-prefetch-threads), so that they are already in the
+ * cache by the time get_from_file() is called for them.  Unless
+ * bsp-material-prefetch-textures is false, the textures they refer to are
+ * loaded as well.  Files that have already been loaded are skipped.  Returns
+ * a future that is done when all of the materials have been loaded.
+ *
+ * If bsp-material-prefetch-threads is 0, the materials are instead loaded
+ * on the calling thread before this returns.
+ */
+PT(AsyncFuture) BSPMaterial::prefetch(const vector_string &files) {
+  int num_threads = bsp_material_prefetch_threads;
+  if (num_threads <= 0) {
+    for (const std::string &file : files) {
+      if (!file.empty()) {
+        prefetch_file(file);
+      }
+    }
+    return AsyncFuture::gather(AsyncFuture::Futures());
+  }
+
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  AsyncTaskChain *chain =
+    task_mgr->make_worker_chain("bsp_material_prefetch", num_threads, TP_normal);
+
+  AsyncFuture::Futures futures;
+  for (const std::string &file : files) {
+    if (file.empty()) {
+      continue;
+    }
+    {
+      LightMutexHolder holder(g_matmutex);
+      if (_material_cache.find(file) != -1) {
+        continue;
+      }
+    }
+
+    // The task is named after the file it loads.
+    PT(GenericAsyncTask) task = new GenericAsyncTask(file, &prefetch_task, nullptr);
+    task->set_task_chain(chain->get_name());
+    task_mgr->add(task);
+    futures.push_back(task.p());
+  }
+
+  return AsyncFuture::gather(std::move(futures));
+}
+
+/**
+ * The task function used by prefetch().
+ */
+AsyncTask::DoneStatus BSPMaterial::prefetch_task(GenericAsyncTask *task, void *) {
+  prefetch_file(task->get_name());
+  return AsyncTask::DS_done;
+}
+
+/**
+ * Loads the indicated material, and the textures it refers to if
+ * bsp-material-prefetch-textures is true.
+ */
+void BSPMaterial::prefetch_file(const Filename &file) {
+  const BSPMaterial *mat = get_from_file(file);
+  if (mat == nullptr || !bsp_material_prefetch_textures) {
+    return;
+  }
+
+  // Also load the textures that the shaders will ask for, so that they are
+  // decoded and their mipmaps generated on this thread.  They are kept in
+  // RAM, so the pool hands back the loaded image when the shader asks.
+  LoaderOptions options;
+  options.set_texture_flags(options.get_texture_flags() | LoaderOptions::TF_preload);
+
+  static const char *const texture_keys[] = {
+    "$bumpmap", "$detail", "$lightwarp", "$arme",
+  };
 
-  int idx = _material_cache.find(file);
-  if (idx != -1) {
-    // We've already loaded this material file.
-    return _material_cache.get_data(idx);
+  if (mat->has_keyvalue("$basetexture")) {
+    if (mat->has_keyvalue("$basetexture_alpha")) {
+      TexturePool::load_texture(mat->get_keyvalue("$basetexture"),
+                                mat->get_keyvalue("$basetexture_alpha"),
+                                0, 0, false, options);
+    } else {
+      TexturePool::load_texture(mat->get_keyvalue("$basetexture"), 0, false, options);
+    }
+  }
+  for (const char *key : texture_keys) {
+    if (mat->has_keyvalue(key)) {
+      TexturePool::load_texture(mat->get_keyvalue(key), 0, false, options);
+    }
   }
+}
 
+/**
+ * Reads and parses the indicated material file, without consulting the cache
+ * for the file itself.  Any $include is loaded through get_from_file().
+ */
+PT(BSPMaterial) BSPMaterial::load_from_file(const Filename &file) {
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
   if (!vfs->exists(file)) {
     bspmaterial_cat.error()
@@ -104,8 +293,6 @@ const BSPMaterial *BSPMaterial::get_from_file(const Filename &file) {
   mat->_lightmapped = mat->get_shader() == "LightmappedGeneric";
   mat->_skybox = mat->get_shader() == "SkyBox";
 
-  _material_cache[file] = mat;
-
   return mat;
 }
 
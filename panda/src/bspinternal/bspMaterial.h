@@ -17,6 +17,12 @@
 #include "simpleHashMap.h"
 #include "pointerTo.h"
 #include "typedReferenceCount.h"
+#include "asyncTask.h"
+#include "vector_string.h"
+#include "pmap.h"
+
+class GenericAsyncTask;
+class Thread;
 
 #define DEFAULT_SHADER	"UnlitNoMat"
 
@@ -135,6 +141,23 @@ PUBLISHED:
   }
 
   static const BSPMaterial *get_from_file(const Filename &file);
+  static PT(AsyncFuture) prefetch(const vector_string &files);
+
+private:
+  // Each material file in the cache has a future that is set to the material
+  // once it has been loaded, so that other threads asking for the same file
+  // wait for it to be loaded only once.  _loader is the thread that is
+  // loading it, or NULL once it is done.
+  class CacheEntry {
+  public:
+    PT(AsyncFuture) _future;
+    Thread *_loader;
+  };
+
+  static PT(BSPMaterial) load_from_file(const Filename &file);
+  static AsyncTask::DoneStatus prefetch_task(GenericAsyncTask *task, void *data);
+  static void prefetch_file(const Filename &file);
+  static bool would_deadlock(const CacheEntry &entry, Thread *current_thread);
 
 private:
   Filename _file;
@@ -149,9 +172,15 @@ private:
   std::string _contents;
   SimpleHashMap<std::string, std::string, string_hash> _shader_keyvalues;
 
-  typedef SimpleHashMap<std::string, CPT(BSPMaterial), string_hash> materialcache_t;
+  typedef SimpleHashMap<std::string, CacheEntry, string_hash> materialcache_t;
   static materialcache_t _material_cache;
 
+  // The file that each thread is waiting for another thread to finish
+  // loading.  Together with the _loader of each entry, this lets us tell
+  // when two threads are loading materials that include each other.
+  typedef pmap<Thread *, std::string> WaitingOn;
+  static WaitingOn _waiting_on;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -9,6 +9,19 @@ ConfigureFn(config_bspinternal) {
   init_libbspinternal();
 }
 
+ConfigVariableInt bsp_material_prefetch_threads
+("bsp-material-prefetch-threads", 2,
+ PRC_DESC("The number of threads that BSPMaterial::prefetch() uses to load "
+          "material files in the background.  If this is 0, prefetch() "
+          "loads them on the calling thread instead."));
+
+ConfigVariableBool bsp_material_prefetch_textures
+("bsp-material-prefetch-textures", true,
+ PRC_DESC("When this is true, BSPMaterial::prefetch() also loads the "
+          "textures referenced by each material, keeping their images in "
+          "RAM, so that several textures are decoded and mipmapped at once "
+          "while a level loads."));
+
 void
 init_libbspinternal() {
   static bool initialized = false;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "pandabase.h"
+#include "configVariableBool.h"
+#include "configVariableInt.h"
 
 #ifdef BUILDING_BSPINTERNAL
 #define EXPCL_BSPINTERNAL EXPORT_CLASS
@@ -10,4 +12,7 @@
 #define EXPTP_BSPINTERNAL IMPORT_TEMPL
 #endif
 
+extern EXPCL_BSPINTERNAL ConfigVariableInt bsp_material_prefetch_threads;
+extern EXPCL_BSPINTERNAL ConfigVariableBool bsp_material_prefetch_textures;
+
 extern EXPCL_BSPINTERNAL void init_libbspinternal();
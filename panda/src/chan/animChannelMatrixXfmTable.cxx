@@ -33,6 +33,7 @@ AnimChannelMatrixXfmTable::
 AnimChannelMatrixXfmTable() {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _compressed_index[i] = -1;
   }
 }
 
@@ -43,10 +44,12 @@ AnimChannelMatrixXfmTable() {
  */
 AnimChannelMatrixXfmTable::
 AnimChannelMatrixXfmTable(AnimGroup *parent, const AnimChannelMatrixXfmTable &copy) :
-  AnimChannelMatrix(parent, copy)
+  AnimChannelMatrix(parent, copy),
+  _compressed(copy._compressed)
 {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = copy._tables[i];
+    _compressed_index[i] = copy._compressed_index[i];
   }
 }
 
@@ -59,6 +62,7 @@ AnimChannelMatrixXfmTable(AnimGroup *parent, const std::string &name)
 {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _compressed_index[i] = -1;
   }
 }
 
@@ -80,9 +84,8 @@ has_changed(int last_frame, double last_frac,
             int this_frame, double this_frac) {
   if (last_frame != this_frame) {
     for (int i = 0; i < num_matrix_components; i++) {
-      if (_tables[i].size() > 1) {
-        if (_tables[i][last_frame % _tables[i].size()] !=
-            _tables[i][this_frame % _tables[i].size()]) {
+      if (get_table_size(i) > 1) {
+        if (get_table_value(i, last_frame) != get_table_value(i, this_frame)) {
           return true;
         }
       }
@@ -93,9 +96,8 @@ has_changed(int last_frame, double last_frac,
     // If we have some fractional changes, also check the next subsequent
     // frame (since we'll be blending with that).
     for (int i = 0; i < num_matrix_components; i++) {
-      if (_tables[i].size() > 1) {
-        if (_tables[i][last_frame % _tables[i].size()] !=
-            _tables[i][(this_frame + 1) % _tables[i].size()]) {
+      if (get_table_size(i) > 1) {
+        if (get_table_value(i, last_frame) != get_table_value(i, this_frame + 1)) {
           return true;
         }
       }
@@ -113,11 +115,7 @@ get_value(int frame, LMatrix4 &mat) {
   PN_stdfloat components[num_matrix_components];
 
   for (int i = 0; i < num_matrix_components; i++) {
-    if (_tables[i].empty()) {
-      components[i] = get_default_value(i);
-    } else {
-      components[i] = _tables[i][frame % _tables[i].size()];
-    }
+    components[i] = get_table_value(i, frame);
   }
 
   compose_matrix(mat, components);
@@ -138,11 +136,7 @@ get_value_no_scale_shear(int frame, LMatrix4 &mat) {
   components[5] = 0.0f;
 
   for (int i = 6; i < num_matrix_components; i++) {
-    if (_tables[i].empty()) {
-      components[i] = get_default_value(i);
-    } else {
-      components[i] = _tables[i][frame % _tables[i].size()];
-    }
+    components[i] = get_table_value(i, frame);
   }
 
   compose_matrix(mat, components);
@@ -154,11 +148,7 @@ get_value_no_scale_shear(int frame, LMatrix4 &mat) {
 void AnimChannelMatrixXfmTable::
 get_scale(int frame, LVecBase3 &scale) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i].empty()) {
-      scale[i] = 1.0f;
-    } else {
-      scale[i] = _tables[i][frame % _tables[i].size()];
-    }
+    scale[i] = get_table_value(i, frame);
   }
 }
 
@@ -169,11 +159,7 @@ get_scale(int frame, LVecBase3 &scale) {
 void AnimChannelMatrixXfmTable::
 get_hpr(int frame, LVecBase3 &hpr) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 6].empty()) {
-      hpr[i] = 0.0f;
-    } else {
-      hpr[i] = _tables[i + 6][frame % _tables[i + 6].size()];
-    }
+    hpr[i] = get_table_value(i + 6, frame);
   }
 }
 
@@ -186,11 +172,7 @@ void AnimChannelMatrixXfmTable::
 get_quat(int frame, LQuaternion &quat) {
   LVecBase3 hpr;
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 6].empty()) {
-      hpr[i] = 0.0f;
-    } else {
-      hpr[i] = _tables[i + 6][frame % _tables[i + 6].size()];
-    }
+    hpr[i] = get_table_value(i + 6, frame);
   }
 
   quat.set_hpr(hpr);
@@ -203,11 +185,7 @@ get_quat(int frame, LQuaternion &quat) {
 void AnimChannelMatrixXfmTable::
 get_pos(int frame, LVecBase3 &pos) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 9].empty()) {
-      pos[i] = 0.0f;
-    } else {
-      pos[i] = _tables[i + 9][frame % _tables[i + 9].size()];
-    }
+    pos[i] = get_table_value(i + 9, frame);
   }
 }
 
@@ -218,11 +196,7 @@ get_pos(int frame, LVecBase3 &pos) {
 void AnimChannelMatrixXfmTable::
 get_shear(int frame, LVecBase3 &shear) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 3].empty()) {
-      shear[i] = 0.0f;
-    } else {
-      shear[i] = _tables[i + 3][frame % _tables[i + 3].size()];
-    }
+    shear[i] = get_table_value(i + 3, frame);
   }
 }
 
@@ -249,6 +223,21 @@ set_table(char table_id, const CPTA_stdfloat &table) {
   }
 
   _tables[i] = table;
+  _compressed_index[i] = -1;
+}
+
+/**
+ * Returns a pointer to the indicated subtable's data, if it exists, or NULL
+ * if it does not.  If the table has been compressed, this returns a newly
+ * decompressed copy of it.
+ */
+CPTA_stdfloat AnimChannelMatrixXfmTable::
+get_table(char table_id) const {
+  int table_index = get_table_index(table_id);
+  if (table_index < 0) {
+    return CPTA_stdfloat(get_class_type());
+  }
+  return get_component_table(table_index);
 }
 
 
@@ -260,7 +249,70 @@ void AnimChannelMatrixXfmTable::
 clear_all_tables() {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _compressed_index[i] = -1;
+  }
+  _compressed.clear();
+}
+
+/**
+ * Replaces each of the tables that has more than one frame with a compressed
+ * copy, which keeps only the keyframes that are needed to reproduce the
+ * table to within the indicated tolerance, quantized to 16 bits.  This
+ * typically saves most of the memory used by the channel, at the cost of a
+ * little more work each time it is sampled.  Tables that are too long to be
+ * compressed are left as they are.
+ *
+ * The tolerance is in the units of each component: degrees for the
+ * rotation, and model units for the translation.
+ */
+void AnimChannelMatrixXfmTable::
+compress_tables(PN_stdfloat tolerance) {
+  decompress_tables();
+
+  for (int i = 0; i < num_matrix_components; i++) {
+    size_t num_frames = _tables[i].size();
+    if (num_frames > 1 && num_frames <= CompressedAnimTable::max_frames) {
+      CompressedAnimTable compressed;
+      compressed.compress(_tables[i], tolerance);
+      _compressed_index[i] = (int8_t)_compressed.size();
+      _compressed.push_back(std::move(compressed));
+      _tables[i] = CPTA_stdfloat(get_class_type());
+    }
+  }
+  _compressed.shrink_to_fit();
+}
+
+/**
+ * Restores any tables that were compressed by compress_tables() to full
+ * tables of floats.  This does not undo the loss of precision.
+ */
+void AnimChannelMatrixXfmTable::
+decompress_tables() {
+  for (int i = 0; i < num_matrix_components; i++) {
+    int ci = _compressed_index[i];
+    if (ci >= 0) {
+      _tables[i] = _compressed[ci].decompress(get_class_type());
+      _compressed_index[i] = -1;
+    }
+  }
+  _compressed.clear();
+}
+
+/**
+ * Returns the number of bytes used by the channel's tables, whether or not
+ * they are compressed.  This is intended for measuring the effect of
+ * compress_tables().
+ */
+size_t AnimChannelMatrixXfmTable::
+get_table_memory_size() const {
+  size_t size = 0;
+  for (int i = 0; i < num_matrix_components; i++) {
+    size += _tables[i].size() * sizeof(PN_stdfloat);
   }
+  for (const CompressedAnimTable &compressed : _compressed) {
+    size += compressed.get_memory_size();
+  }
+  return size;
 }
 
 /**
@@ -274,11 +326,15 @@ write(std::ostream &out, int indent_level) const {
   // Write a list of all the sub-tables that have data.
   bool found_any = false;
   for (int i = 0; i < num_matrix_components; i++) {
-    if (!_tables[i].empty()) {
-      out << get_table_id(i) << _tables[i].size();
+    size_t size = get_table_size(i);
+    if (size != 0) {
+      out << get_table_id(i) << size;
       found_any = true;
     }
   }
+  if (is_compressed()) {
+    out << " (compressed)";
+  }
 
   if (!found_any) {
     out << "(no data)";
@@ -303,6 +359,19 @@ make_copy(AnimGroup *parent) const {
   return new AnimChannelMatrixXfmTable(parent, *this);
 }
 
+/**
+ * Returns the indicated table as an array of floats, decompressing it if
+ * necessary.
+ */
+CPTA_stdfloat AnimChannelMatrixXfmTable::
+get_component_table(int table_index) const {
+  int ci = _compressed_index[table_index];
+  if (ci >= 0) {
+    return _compressed[ci].decompress(get_class_type());
+  }
+  return _tables[table_index];
+}
+
 /**
  * Returns the table index number, a value between 0 and
  * num_matrix_components, that corresponds to the indicated table id.  Returns
@@ -327,7 +396,13 @@ void AnimChannelMatrixXfmTable::
 write_datagram(BamWriter *manager, Datagram &me) {
   AnimChannelMatrix::write_datagram(manager, me);
 
-  if (compress_channels) {
+  // Tables compressed by compress_tables() are written as they are, if the
+  // bam version allows it; otherwise, they are written in full.
+  bool write_quantized =
+    is_compressed() && manager->get_file_minor_ver() >= 46;
+
+  bool write_fft = compress_channels && !write_quantized;
+  if (write_fft) {
     chan_cat.warning()
       << "FFT compression of animations is deprecated.  For compatibility "
          "with future versions of Panda3D, set compress-channels to false.\n";
@@ -336,20 +411,47 @@ write_datagram(BamWriter *manager, Datagram &me) {
       chan_cat.error()
         << "Compression is not available; writing uncompressed channels.\n";
       compress_channels = false;
+      write_fft = false;
     }
   }
 
-  me.add_bool(compress_channels);
+  me.add_bool(write_fft);
 
   // We now always use the new HPR conventions.
   me.add_bool(true);
 
-  if (!compress_channels) {
+  if (manager->get_file_minor_ver() >= 46) {
+    me.add_bool(write_quantized);
+  }
+
+  if (write_quantized) {
+    // Write out each table either compressed or as a stream of floats.
+    for (int i = 0; i < num_matrix_components; i++) {
+      int ci = _compressed_index[i];
+      me.add_bool(ci >= 0);
+      if (ci >= 0) {
+        _compressed[ci].write_datagram(manager, me);
+      } else {
+        me.add_uint16(_tables[i].size());
+        for (int j = 0; j < (int)_tables[i].size(); j++) {
+          me.add_stdfloat(_tables[i][j]);
+        }
+      }
+    }
+    return;
+  }
+
+  CPTA_stdfloat tables[num_matrix_components];
+  for (int i = 0; i < num_matrix_components; i++) {
+    tables[i] = get_component_table(i);
+  }
+
+  if (!write_fft) {
     // Write out everything uncompressed, as a stream of floats.
     for (int i = 0; i < num_matrix_components; i++) {
-      me.add_uint16(_tables[i].size());
-      for(int j = 0; j < (int)_tables[i].size(); j++) {
-        me.add_stdfloat(_tables[i][j]);
+      me.add_uint16(tables[i].size());
+      for(int j = 0; j < (int)tables[i].size(); j++) {
+        me.add_stdfloat(tables[i][j]);
       }
     }
 
@@ -363,18 +465,18 @@ write_datagram(BamWriter *manager, Datagram &me) {
     // First, write out the scales and shears.
     int i;
     for (i = 0; i < 6; i++) {
-      compressor.write_reals(me, _tables[i], _tables[i].size());
+      compressor.write_reals(me, tables[i], tables[i].size());
     }
 
     // Now, write out the joint angles.  For these we need to build up a HPR
     // array.
     pvector<LVecBase3> hprs;
-    int hprs_length = std::max(std::max(_tables[6].size(), _tables[7].size()), _tables[8].size());
+    int hprs_length = std::max(std::max(tables[6].size(), tables[7].size()), tables[8].size());
     hprs.reserve(hprs_length);
     for (i = 0; i < hprs_length; i++) {
-      PN_stdfloat h = _tables[6].empty() ? 0.0f : _tables[6][i % _tables[6].size()];
-      PN_stdfloat p = _tables[7].empty() ? 0.0f : _tables[7][i % _tables[7].size()];
-      PN_stdfloat r = _tables[8].empty() ? 0.0f : _tables[8][i % _tables[8].size()];
+      PN_stdfloat h = tables[6].empty() ? 0.0f : tables[6][i % tables[6].size()];
+      PN_stdfloat p = tables[7].empty() ? 0.0f : tables[7][i % tables[7].size()];
+      PN_stdfloat r = tables[8].empty() ? 0.0f : tables[8][i % tables[8].size()];
       hprs.push_back(LVecBase3(h, p, r));
     }
     const LVecBase3 *hprs_array = nullptr;
@@ -385,11 +487,46 @@ write_datagram(BamWriter *manager, Datagram &me) {
 
     // And now the translations.
     for(i = 9; i < num_matrix_components; i++) {
-      compressor.write_reals(me, _tables[i], _tables[i].size());
+      compressor.write_reals(me, tables[i], tables[i].size());
     }
   }
 }
 
+/**
+ * Finishes reading an AnimChannelMatrixXfmTable from a bam file: it
+ * decompresses the tables that were written with an FFTCompressor, if any,
+ * and compresses them again if compress-anim-tables is set.
+ */
+class AnimChannelMatrixXfmTable::DecodeTables : public BamReader::DeferredDecode {
+public:
+  DecodeTables(AnimChannelMatrixXfmTable *table) :
+    _table(table), _fft(false), _index(0), _file_minor_ver(0),
+    _new_hpr(true) {}
+  DecodeTables(AnimChannelMatrixXfmTable *table, const DatagramIterator &scan,
+               int file_minor_ver, bool new_hpr) :
+    _table(table), _fft(true), _datagram(scan.get_datagram()),
+    _index(scan.get_current_index()), _file_minor_ver(file_minor_ver),
+    _new_hpr(new_hpr) {}
+
+  virtual void decode() {
+    if (_fft) {
+      DatagramIterator scan(_datagram, _index);
+      _table->fillin_fft_tables(scan, _file_minor_ver, _new_hpr);
+    }
+    if (compress_anim_tables) {
+      _table->compress_tables(anim_table_tolerance);
+    }
+  }
+
+private:
+  PT(AnimChannelMatrixXfmTable) _table;
+  bool _fft;
+  Datagram _datagram;
+  size_t _index;
+  int _file_minor_ver;
+  bool _new_hpr;
+};
+
 /**
  * Function that reads out of the datagram (or asks manager to read) all of
  * the data that is needed to re-create this object and stores it in the
@@ -405,7 +542,35 @@ fillin(DatagramIterator &scan, BamReader *manager) {
   // have to convert the HPR values to the new convention.
   bool new_hpr = scan.get_bool();
 
-  if (!wrote_compressed) {
+  bool wrote_quantized = false;
+  if (manager->get_file_minor_ver() >= 46) {
+    wrote_quantized = scan.get_bool();
+  }
+
+  if (wrote_quantized) {
+    // Tables compressed by compress_tables().
+    for (int i = 0; i < num_matrix_components; i++) {
+      if (scan.get_bool()) {
+        CompressedAnimTable compressed;
+        if (compressed.read_datagram(scan, manager)) {
+          _compressed_index[i] = (int8_t)_compressed.size();
+          _compressed.push_back(std::move(compressed));
+        } else {
+          // The table was bad; leave the channel with its plain table.
+          _compressed_index[i] = -1;
+        }
+      } else {
+        int size = scan.get_uint16();
+        PTA_stdfloat ind_table(get_class_type());
+        for (int j = 0; j < size; j++) {
+          ind_table.push_back(scan.get_stdfloat());
+        }
+        _tables[i] = ind_table;
+      }
+    }
+    return;
+
+  } else if (!wrote_compressed) {
     // Regular floats.
 
     for (int i = 0; i < num_matrix_components; i++) {
@@ -461,50 +626,68 @@ fillin(DatagramIterator &scan, BamReader *manager) {
       return;
     }
 
-    FFTCompressor compressor;
-    compressor.read_header(scan, manager->get_file_minor_ver());
+    // Decompressing them needs nothing more from the BamReader, so it may be
+    // done later, along with that of the other channels in the file.
+    manager->defer_decode(new DecodeTables(this, scan, manager->get_file_minor_ver(), new_hpr));
+    scan.skip_bytes(scan.get_remaining_size());
+    return;
+  }
 
-    int i;
-    // First, read in the scales and shears.
-    for (i = 0; i < 6; i++) {
-      PTA_stdfloat ind_table = PTA_stdfloat::empty_array(0, get_class_type());
-      compressor.read_reals(scan, ind_table.v());
-      _tables[i] = ind_table;
-    }
+  if (compress_anim_tables) {
+    manager->defer_decode(new DecodeTables(this));
+  }
+}
 
-    // Read in the HPR array and store it back in the joint angles.
-    pvector<LVecBase3> hprs;
-    compressor.read_hprs(scan, hprs, new_hpr);
-    PTA_stdfloat h_table = PTA_stdfloat::empty_array(hprs.size(), get_class_type());
-    PTA_stdfloat p_table = PTA_stdfloat::empty_array(hprs.size(), get_class_type());
-    PTA_stdfloat r_table = PTA_stdfloat::empty_array(hprs.size(), get_class_type());
-
-    for (i = 0; i < (int)hprs.size(); i++) {
-      if (!new_hpr) {
-        // Convert the old HPR form to the new HPR form.
-        LVecBase3 hpr = old_to_new_hpr(hprs[i]);
-        h_table[i] = hpr[0];
-        p_table[i] = hpr[1];
-        r_table[i] = hpr[2];
+/**
+ * Reads the tables that were written compressed with an FFTCompressor.  This
+ * is the tail end of fillin(), which may be run on another thread; see
+ * DecodeTables.
+ */
+void AnimChannelMatrixXfmTable::
+fillin_fft_tables(DatagramIterator &scan, int file_minor_ver, bool new_hpr) {
+  FFTCompressor compressor;
+  compressor.read_header(scan, file_minor_ver);
+
+  int i;
+  // First, read in the scales and shears.
+  for (i = 0; i < 6; i++) {
+    PTA_stdfloat ind_table = PTA_stdfloat::empty_array(0, get_class_type());
+    compressor.read_reals(scan, ind_table.v());
+    _tables[i] = ind_table;
+  }
 
-      } else {
-        // Store the HPR angle directly.
-        h_table[i] = hprs[i][0];
-        p_table[i] = hprs[i][1];
-        r_table[i] = hprs[i][2];
-      }
-    }
-    _tables[6] = h_table;
-    _tables[7] = p_table;
-    _tables[8] = r_table;
-
-    // Now read in the translations.
-    for (i = 9; i < num_matrix_components; i++) {
-      PTA_stdfloat ind_table = PTA_stdfloat::empty_array(0, get_class_type());
-      compressor.read_reals(scan, ind_table.v());
-      _tables[i] = ind_table;
+  // Read in the HPR array and store it back in the joint angles.
+  pvector<LVecBase3> hprs;
+  compressor.read_hprs(scan, hprs, new_hpr);
+  PTA_stdfloat h_table = PTA_stdfloat::empty_array(hprs.size(), get_class_type());
+  PTA_stdfloat p_table = PTA_stdfloat::empty_array(hprs.size(), get_class_type());
+  PTA_stdfloat r_table = PTA_stdfloat::empty_array(hprs.size(), get_class_type());
+
+  for (i = 0; i < (int)hprs.size(); i++) {
+    if (!new_hpr) {
+      // Convert the old HPR form to the new HPR form.
+      LVecBase3 hpr = old_to_new_hpr(hprs[i]);
+      h_table[i] = hpr[0];
+      p_table[i] = hpr[1];
+      r_table[i] = hpr[2];
+
+    } else {
+      // Store the HPR angle directly.
+      h_table[i] = hprs[i][0];
+      p_table[i] = hprs[i][1];
+      r_table[i] = hprs[i][2];
     }
   }
+  _tables[6] = h_table;
+  _tables[7] = p_table;
+  _tables[8] = r_table;
+
+  // Now read in the translations.
+  for (i = 9; i < num_matrix_components; i++) {
+    PTA_stdfloat ind_table = PTA_stdfloat::empty_array(0, get_class_type());
+    compressor.read_reals(scan, ind_table.v());
+    _tables[i] = ind_table;
+  }
 }
 
 /**
@@ -17,6 +17,7 @@
 #include "pandabase.h"
 
 #include "animChannel.h"
+#include "compressedAnimTable.h"
 
 #include "pointerToArray.h"
 #include "pta_stdfloat.h"
@@ -53,7 +54,7 @@ PUBLISHED:
   static INLINE bool is_valid_id(char table_id);
 
   void set_table(char table_id, const CPTA_stdfloat &table);
-  INLINE CPTA_stdfloat get_table(char table_id) const;
+  CPTA_stdfloat get_table(char table_id) const;
 
   void clear_all_tables();
   INLINE bool has_table(char table_id) const;
@@ -61,6 +62,13 @@ PUBLISHED:
 
   MAKE_MAP_PROPERTY(tables, has_table, get_table, set_table, clear_table);
 
+  void compress_tables(PN_stdfloat tolerance);
+  void decompress_tables();
+  INLINE bool is_compressed() const;
+  size_t get_table_memory_size() const;
+
+  MAKE_PROPERTY(compressed, is_compressed);
+
 public:
   virtual void write(std::ostream &out, int indent_level) const;
 
@@ -71,8 +79,19 @@ protected:
   static int get_table_index(char table_id);
   INLINE static PN_stdfloat get_default_value(int table_index);
 
+  INLINE size_t get_table_size(int table_index) const;
+  INLINE PN_stdfloat get_table_value(int table_index, int frame) const;
+  CPTA_stdfloat get_component_table(int table_index) const;
+
   CPTA_stdfloat _tables[num_matrix_components];
 
+  // The tables that have been compressed by compress_tables().  For each
+  // component, _compressed_index is the index of its table in _compressed,
+  // or -1 if the component is still stored in _tables.
+  typedef pvector<CompressedAnimTable> CompressedTables;
+  CompressedTables _compressed;
+  int8_t _compressed_index[num_matrix_components];
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
@@ -81,6 +100,11 @@ public:
 
 protected:
   void fillin(DatagramIterator& scan, BamReader* manager);
+  void fillin_fft_tables(DatagramIterator &scan, int file_minor_ver,
+                         bool new_hpr);
+
+private:
+  class DecodeTables;
 
 public:
   virtual TypeHandle get_type() const {
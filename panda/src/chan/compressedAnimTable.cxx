@@ -0,0 +1,209 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compressedAnimTable.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "compressedAnimTable.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "bamReader.h"
+#include "bamWriter.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Replaces the contents of this table with a compressed copy of the
+ * indicated table.  Frames are dropped wherever linear interpolation between
+ * the remaining keyframes reproduces them to within the indicated tolerance,
+ * which is in the units of the table.  The error can never be smaller than
+ * half of the quantization step, which is 1/65535 of the range of the table.
+ * The table may not have more than max_frames frames.
+ */
+void CompressedAnimTable::
+compress(const CPTA_stdfloat &table, PN_stdfloat tolerance) {
+  clear();
+
+  size_t num_frames = table.size();
+  nassertv(num_frames <= max_frames);
+  if (num_frames == 0) {
+    return;
+  }
+  _num_frames = (int)num_frames;
+
+  PN_stdfloat min_value = table[0];
+  PN_stdfloat max_value = table[0];
+  for (size_t i = 1; i < num_frames; ++i) {
+    min_value = std::min(min_value, table[i]);
+    max_value = std::max(max_value, table[i]);
+  }
+  _min_value = min_value;
+  _scale = (max_value - min_value) / 65535.0f;
+  tolerance = std::max(tolerance, _scale * 0.5f);
+
+  pvector<uint16_t> quantized(num_frames);
+  for (size_t i = 0; i < num_frames; ++i) {
+    if (_scale > 0.0f) {
+      double q = std::floor((table[i] - min_value) / _scale + 0.5);
+      quantized[i] = (uint16_t)std::min(std::max(q, 0.0), 65535.0);
+    } else {
+      quantized[i] = 0;
+    }
+  }
+
+  _frames.push_back(0);
+  _values.push_back(quantized[0]);
+
+  // Starting from each keyframe, find the furthest frame that the next
+  // keyframe can be placed at.  The slope of the line from the keyframe must
+  // stay within the window that passes within tolerance of each frame in
+  // between, so this only takes one pass.
+  size_t a = 0;
+  while (a + 1 < num_frames) {
+    double va = dequantize(quantized[a]);
+    double lo = -HUGE_VAL;
+    double hi = HUGE_VAL;
+    size_t b = a + 1;
+    for (size_t i = a + 1; i < num_frames; ++i) {
+      double dist = (double)(i - a);
+      double slope = (dequantize(quantized[i]) - va) / dist;
+      if (slope < lo || slope > hi) {
+        break;
+      }
+      b = i;
+
+      lo = std::max(lo, (table[i] - tolerance - va) / dist);
+      hi = std::min(hi, (table[i] + tolerance - va) / dist);
+      if (lo > hi) {
+        break;
+      }
+    }
+
+    _frames.push_back((uint16_t)b);
+    _values.push_back(quantized[b]);
+    a = b;
+  }
+
+  if (_frames.size() * 2 + (num_frames >> block_shift) >= num_frames) {
+    // The frame numbers would cost more than they save; keep every frame.
+    _values.swap(quantized);
+    _frames.clear();
+    _frames.shrink_to_fit();
+  } else {
+    _values.shrink_to_fit();
+    _frames.shrink_to_fit();
+    make_blocks();
+  }
+}
+
+/**
+ * Returns the full table of values, one for each frame.
+ */
+CPTA_stdfloat CompressedAnimTable::
+decompress(TypeHandle type_handle) const {
+  PTA_stdfloat table = PTA_stdfloat::empty_array(_num_frames, type_handle);
+  for (int i = 0; i < _num_frames; ++i) {
+    table[i] = get_value(i);
+  }
+  return table;
+}
+
+/**
+ * Returns the number of bytes used by the table, including its own size.
+ */
+size_t CompressedAnimTable::
+get_memory_size() const {
+  return sizeof(*this) +
+    (_values.capacity() + _frames.capacity() + _blocks.capacity()) * sizeof(uint16_t);
+}
+
+/**
+ * Writes the table to the datagram.
+ */
+void CompressedAnimTable::
+write_datagram(BamWriter *manager, Datagram &dg) const {
+  dg.add_uint16(_num_frames);
+  if (_num_frames == 0) {
+    return;
+  }
+
+  dg.add_stdfloat(_min_value);
+  dg.add_stdfloat(_scale);
+
+  // A key count of 0 means that every frame is stored.
+  dg.add_uint16(_frames.size());
+  for (uint16_t frame : _frames) {
+    dg.add_uint16(frame);
+  }
+  for (uint16_t value : _values) {
+    dg.add_uint16(value);
+  }
+}
+
+/**
+ * Reads the table from the datagram.  Returns false if the table that was
+ * read is not valid, in which case it is left empty.
+ */
+bool CompressedAnimTable::
+read_datagram(DatagramIterator &scan, BamReader *manager) {
+  clear();
+  _num_frames = scan.get_uint16();
+  if (_num_frames == 0) {
+    return true;
+  }
+
+  _min_value = scan.get_stdfloat();
+  _scale = scan.get_stdfloat();
+  size_t num_keys = scan.get_uint16();
+  if (num_keys == 0) {
+    _values.resize(_num_frames);
+    for (int i = 0; i < _num_frames; ++i) {
+      _values[i] = scan.get_uint16();
+    }
+    return true;
+  }
+
+  _frames.resize(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    _frames[i] = scan.get_uint16();
+  }
+  _values.resize(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    _values[i] = scan.get_uint16();
+  }
+
+  nassertd(_frames[0] == 0 && _frames[num_keys - 1] == _num_frames - 1) {
+    clear();
+    return false;
+  }
+  make_blocks();
+  return true;
+}
+
+/**
+ * Fills in the _blocks index from the keyframes.
+ */
+void CompressedAnimTable::
+make_blocks() {
+  size_t num_blocks = ((size_t)_num_frames + (1 << block_shift) - 1) >> block_shift;
+  size_t num_keys = _frames.size();
+
+  _blocks.clear();
+  _blocks.reserve(num_blocks);
+  size_t k = 0;
+  for (size_t bi = 0; bi < num_blocks; ++bi) {
+    size_t first_frame = bi << block_shift;
+    while (k + 1 < num_keys && _frames[k + 1] <= first_frame) {
+      ++k;
+    }
+    _blocks.push_back((uint16_t)k);
+  }
+}
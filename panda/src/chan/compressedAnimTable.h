@@ -0,0 +1,87 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compressedAnimTable.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef COMPRESSEDANIMTABLE_H
+#define COMPRESSEDANIMTABLE_H
+
+#include "pandabase.h"
+
+#include "pta_stdfloat.h"
+#include "pvector.h"
+
+class BamWriter;
+class BamReader;
+class Datagram;
+class DatagramIterator;
+
+/**
+ * A compact, lossy representation of one component table of an animation
+ * channel, such as the x translation of an AnimChannelMatrixXfmTable.
+ *
+ * The values are quantized to 16 bits over the range of the table, and only
+ * the keyframes are kept: any frame that can be reproduced within the
+ * requested tolerance by interpolating linearly between its neighbors is
+ * dropped.  To keep sampling cheap, the table also stores, for each block of
+ * 16 frames, the keyframe that is in effect at the start of the block, so
+ * that finding the keyframes around any frame takes a short scan within one
+ * block.  If too few frames can be dropped for this to pay off, every frame
+ * is kept instead, and the frame numbers are not stored.
+ *
+ * Since the frame numbers are stored in 16 bits, a table may not be longer
+ * than max_frames.
+ */
+class EXPCL_PANDA_CHAN CompressedAnimTable {
+public:
+  enum { max_frames = 0xffff };
+
+  INLINE CompressedAnimTable();
+
+  void compress(const CPTA_stdfloat &table, PN_stdfloat tolerance);
+  CPTA_stdfloat decompress(TypeHandle type_handle) const;
+  INLINE void clear();
+
+  INLINE bool empty() const;
+  INLINE int get_num_frames() const;
+  INLINE int get_num_keys() const;
+  INLINE PN_stdfloat get_value(int frame) const;
+
+  size_t get_memory_size() const;
+
+  void write_datagram(BamWriter *manager, Datagram &dg) const;
+  bool read_datagram(DatagramIterator &scan, BamReader *manager);
+
+private:
+  INLINE PN_stdfloat dequantize(uint16_t value) const;
+  void make_blocks();
+
+  enum { block_shift = 4 };
+
+  int _num_frames;
+  PN_stdfloat _min_value;
+  PN_stdfloat _scale;
+
+  // The quantized values of the keyframes, and their frame numbers, in
+  // order.  The first and last frames are always keyframes.  If every frame
+  // is a keyframe, _frames is left empty.
+  typedef pvector<uint16_t> Values;
+  Values _values;
+  Values _frames;
+
+  // For each block of frames, the index of the last keyframe at or before
+  // the first frame of the block.  This is empty if _frames is.
+  Values _blocks;
+};
+
+#include "compressedAnimTable.I"
+
+#endif
@@ -78,6 +78,21 @@ PRC_DESC("Set this false to disable reading of compressed animation channels, "
          "might want to do this would be to speed load time when you don't "
          "care about what the animation looks like."));
 
+ConfigVariableBool compress_anim_tables
+("compress-anim-tables", false,
+PRC_DESC("Set this true to compress the tables of each animation channel as "
+         "it is loaded, keeping only the keyframes needed to reproduce it "
+         "to within anim-table-tolerance, quantized to 16 bits.  Unlike "
+         "compress-channels, this reduces the memory used by the loaded "
+         "animations.  Compressed tables are also written to bam files "
+         "in compressed form, when the bam version allows it."));
+
+ConfigVariableDouble anim_table_tolerance
+("anim-table-tolerance", 0.001,
+PRC_DESC("The largest error allowed when compress-anim-tables drops a frame "
+         "from an animation table, in degrees for rotations and in model "
+         "units for translations."));
+
 ConfigVariableBool interpolate_frames
 ("interpolate-frames", false,
 PRC_DESC("Set this true to interpolate character animations between frames, "
@@ -56,6 +56,7 @@ public:
                          PartGroup *parent, bool parent_changed,
                          bool anim_changed, Thread *current_thread);
 
+  bool has_channel_changed(const CycleData *root_cdata);
   virtual void get_blend_value(const PartBundle *root)=0;
   virtual bool update_internals(PartBundle *root, PartGroup *parent,
                                 bool self_changed, bool parent_changed,
@@ -1,5 +1,6 @@
 #include "animPreloadTable.cxx"
 #include "bindAnimRequest.cxx"
+#include "compressedAnimTable.cxx"
 #include "config_chan.cxx"
 #include "movingPartBase.cxx"
 #include "movingPartMatrix.cxx"
@@ -12,6 +12,7 @@
  */
 
 #include "partBundle.h"
+#include "movingPartBase.h"
 #include "animBundle.h"
 #include "animBundleNode.h"
 #include "animControl.h"
@@ -55,6 +56,9 @@ PartBundle(const PartBundle &copy) :
 {
   _anim_preload = copy._anim_preload;
   _update_delay = 0.0;
+  _parts_flattened = false;
+  _flat_hierarchy_seq = 0;
+  _hierarchy_seq = 0;
 
   CDWriter cdata(_cycler, true);
   CDReader cdata_from(copy._cycler);
@@ -73,6 +77,20 @@ PartBundle(const string &name) :
   PartGroup(name)
 {
   _update_delay = 0.0;
+  _parts_flattened = false;
+  _flat_hierarchy_seq = 0;
+  _hierarchy_seq = 0;
+}
+
+/**
+ *
+ */
+PartBundle::
+~PartBundle() {
+  // Make sure that none of the groups that outlive us can still refer to us.
+  if (_parts_flattened) {
+    r_clear_flat_bundle(this);
+  }
 }
 
 /**
@@ -483,8 +501,7 @@ update() {
     bool anim_changed = cdata->_anim_changed;
     bool frame_blend_flag = cdata->_frame_blend_flag;
 
-    any_changed = do_update(this, cdata, nullptr, false, anim_changed,
-                            current_thread);
+    any_changed = do_flat_update(cdata, false, anim_changed, current_thread);
 
     // Now update all the controls for next time.
     ChannelBlend::const_iterator cbi;
@@ -508,7 +525,7 @@ bool PartBundle::
 force_update() {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, false, current_thread);
-  bool any_changed = do_update(this, cdata, nullptr, true, true, current_thread);
+  bool any_changed = do_flat_update(cdata, true, true, current_thread);
 
   // Now update all the controls for next time.
   ChannelBlend::const_iterator cbi;
@@ -523,6 +540,119 @@ force_update() {
 }
 
 
+/**
+ * Rebuilds the flattened list of moving parts used by do_flat_update().  This
+ * is called automatically whenever the set of bound animations changes, or the
+ * part hierarchy has been modified since the list was last built.
+ */
+void PartBundle::
+flatten_parts() {
+  // Fetch the sequence before walking the hierarchy, so that a change made
+  // while we're walking it will cause it to be rebuilt again next time.
+  _flat_hierarchy_seq = AtomicAdjust::get(_hierarchy_seq);
+  _flat_bundle = this;
+
+  _flat_parts.clear();
+  _flat_parent_groups.clear();
+  _flat_parent_indices.clear();
+  r_flatten_parts(this, -1);
+
+  size_t num_parts = _flat_parts.size();
+  _flat_needs_update.resize(num_parts);
+  _flat_changed.resize(num_parts);
+  _parts_flattened = true;
+}
+
+/**
+ * The recursive implementation of flatten_parts().  Appends the moving parts
+ * below the indicated group in depth-first order, which guarantees that each
+ * part comes after its parent.
+ */
+void PartBundle::
+r_flatten_parts(PartGroup *group, int parent_index) {
+  static TypeHandle moving_part_type = MovingPartBase::get_class_type();
+
+  int num_children = group->get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    PartGroup *child = group->get_child(i);
+    child->_flat_bundle = this;
+    if (child->is_of_type(moving_part_type)) {
+      int index = (int)_flat_parts.size();
+      _flat_parts.push_back((MovingPartBase *)child);
+      _flat_parent_groups.push_back(group);
+      _flat_parent_indices.push_back(parent_index);
+      r_flatten_parts(child, index);
+    } else {
+      // A plain group passes its parent's state through unchanged.
+      r_flatten_parts(child, parent_index);
+    }
+  }
+}
+
+/**
+ * Recursively clears the pointer back to this bundle left on the groups by
+ * flatten_parts().
+ */
+void PartBundle::
+r_clear_flat_bundle(PartGroup *group) {
+  if (group->_flat_bundle == this) {
+    group->_flat_bundle = nullptr;
+  }
+  int num_children = group->get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_clear_flat_bundle(group->get_child(i));
+  }
+}
+
+/**
+ * Updates all of the moving parts in the bundle.  This has the same effect as
+ * calling do_update() on the bundle, but rather than recursing through the
+ * hierarchy, it walks the flattened list of parts twice: first to fetch the
+ * new value of every part whose channels have changed, and then to propagate
+ * the changes down to the net transforms, parents first.
+ *
+ * Returns true if any part has changed as a result of this.
+ */
+bool PartBundle::
+do_flat_update(const CData *cdata, bool parent_changed, bool anim_changed,
+               Thread *current_thread) {
+  if (anim_changed || !_parts_flattened ||
+      _flat_hierarchy_seq != AtomicAdjust::get(_hierarchy_seq)) {
+    flatten_parts();
+  }
+
+  size_t num_parts = _flat_parts.size();
+  MovingPartBase **parts = _flat_parts.data();
+  unsigned char *needs_update = _flat_needs_update.data();
+  unsigned char *changed = _flat_changed.data();
+
+  for (size_t i = 0; i < num_parts; ++i) {
+    MovingPartBase *part = parts[i];
+    bool needs = anim_changed || part->has_channel_changed(cdata);
+    if (needs) {
+      part->get_blend_value(this);
+    }
+    needs_update[i] = needs;
+  }
+
+  bool any_changed = false;
+  const int *parent_indices = _flat_parent_indices.data();
+  for (size_t i = 0; i < num_parts; ++i) {
+    int pi = parent_indices[i];
+    bool part_parent_changed = (pi < 0) ? parent_changed : (changed[pi] != 0);
+    bool needs = (needs_update[i] != 0);
+    if (part_parent_changed || needs) {
+      if (parts[i]->update_internals(this, _flat_parent_groups[i], needs,
+                                     part_parent_changed, current_thread)) {
+        any_changed = true;
+      }
+    }
+    changed[i] = (part_parent_changed || needs);
+  }
+
+  return any_changed;
+}
+
 /**
  * Called by the AnimControl whenever it starts an animation.  This is just a
  * hook so the bundle can do something, if necessary, before the animation
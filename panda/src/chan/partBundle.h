@@ -31,6 +31,7 @@
 #include "transformState.h"
 #include "weakPointerTo.h"
 #include "copyOnWritePointer.h"
+#include "atomicAdjust.h"
 
 class Loader;
 class AnimBundle;
@@ -38,6 +39,7 @@ class PartBundleNode;
 class PartBundleNode;
 class TransformState;
 class AnimPreloadTable;
+class MovingPartBase;
 
 /**
  * This is the root of a MovingPart hierarchy.  It defines the hierarchy of
@@ -56,6 +58,7 @@ protected:
 
 PUBLISHED:
   explicit PartBundle(const std::string &name = "");
+  virtual ~PartBundle();
   virtual PartGroup *make_copy() const;
 
   INLINE CPT(AnimPreloadTable) get_anim_preload() const;
@@ -166,6 +169,12 @@ private:
   PN_stdfloat do_get_control_effect(AnimControl *control, const CData *cdata) const;
   void clear_and_stop_intersecting(AnimControl *control, CData *cdata);
 
+  void flatten_parts();
+  void r_flatten_parts(PartGroup *group, int parent_index);
+  void r_clear_flat_bundle(PartGroup *group);
+  bool do_flat_update(const CData *cdata, bool parent_changed,
+                      bool anim_changed, Thread *current_thread);
+
   COWPT(AnimPreloadTable) _anim_preload;
 
   typedef pvector<PartBundleNode *> Nodes;
@@ -176,6 +185,26 @@ private:
 
   double _update_delay;
 
+  // The moving parts of the bundle, flattened by flatten_parts() into the
+  // order in which a recursive do_update() would visit them, so that
+  // do_flat_update() can evaluate them all in a couple of flat loops.  Each
+  // part is stored along with the group that is its immediate parent, and
+  // the index of its nearest ancestor that is also a moving part, or -1.  The
+  // list is rebuilt whenever _hierarchy_seq has changed since; it is
+  // incremented when the children of any group in this bundle change.
+  typedef pvector<MovingPartBase *> FlatParts;
+  typedef pvector<PartGroup *> FlatGroups;
+  typedef pvector<int> FlatIndices;
+  typedef pvector<unsigned char> FlatFlags;
+  FlatParts _flat_parts;
+  FlatGroups _flat_parent_groups;
+  FlatIndices _flat_parent_indices;
+  FlatFlags _flat_needs_update;
+  FlatFlags _flat_changed;
+  bool _parts_flattened;
+  AtomicAdjust::Integer _flat_hierarchy_seq;
+  TVOLATILE AtomicAdjust::Integer _hierarchy_seq;
+
   // This is the data that must be cycled between pipeline stages.
   class CData : public CycleData {
   public:
@@ -235,6 +264,7 @@ private:
   static TypeHandle _type_handle;
 
   friend class PartBundleNode;
+  friend class PartGroup;
   friend class Character;
   friend class MovingPartBase;
   friend class MovingPartMatrix;
@@ -12,6 +12,7 @@
  */
 
 #include "partGroup.h"
+#include "partBundle.h"
 #include "animGroup.h"
 #include "config_chan.h"
 #include "partSubset.h"
@@ -41,6 +42,7 @@ PartGroup(PartGroup *parent, const std::string &name) :
   nassertv(parent != nullptr);
 
   parent->_children.push_back(this);
+  parent->mark_hierarchy_changed();
 }
 
 /**
@@ -171,6 +173,19 @@ sort_descendants() {
   for (ci = _children.begin(); ci != _children.end(); ++ci) {
     (*ci)->sort_descendants();
   }
+  mark_hierarchy_changed();
+}
+
+/**
+ * Should be called whenever the list of children of this group is changed.
+ * Tells the bundle that has flattened this group, if any, to rebuild its list
+ * of parts.
+ */
+void PartGroup::
+mark_hierarchy_changed() {
+  if (_flat_bundle != nullptr) {
+    AtomicAdjust::inc(_flat_bundle->_hierarchy_seq);
+  }
 }
 
 /**
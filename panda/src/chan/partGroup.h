@@ -101,6 +101,8 @@ public:
   virtual void determine_effective_channels(const CycleData *root_cdata);
 
 protected:
+  void mark_hierarchy_changed();
+
   void write_descendants(std::ostream &out, int indent_level) const;
   void write_descendants_with_value(std::ostream &out, int indent_level) const;
 
@@ -116,6 +118,10 @@ protected:
   typedef pvector< PT(PartGroup) > Children;
   Children _children;
 
+  // The bundle that last flattened this group into its list of parts, which
+  // must be told when the children change.  NULL if none has yet.
+  PartBundle *_flat_bundle = nullptr;
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
@@ -0,0 +1,163 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_anim_tables.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "config_chan.h"
+#include "animBundle.h"
+#include "animChannelMatrixXfmTable.h"
+#include "bamWriter.h"
+#include "datagramBuffer.h"
+#include "randomizer.h"
+#include "trueClock.h"
+#include "luse.h"
+#include "string_utils.h"
+
+// Makes an animation of many joints with smoothly varying tables, such as a
+// motion capture might produce, and compares the memory used by the tables,
+// the size of the bam data and the time taken to sample every frame, before
+// and after compress_tables().
+
+/**
+ * Fills in an animation with the indicated number of joints and frames.
+ */
+static PT(AnimBundle)
+make_anim(int num_joints, int num_frames) {
+  PT(AnimBundle) bundle = new AnimBundle("anim", 30, num_frames);
+  Randomizer random(1);
+
+  for (int ji = 0; ji < num_joints; ++ji) {
+    AnimChannelMatrixXfmTable *joint =
+      new AnimChannelMatrixXfmTable(bundle, "joint" + format_string(ji));
+
+    // The rotations and translations move along a few sine waves, with a
+    // little noise; the scales and shears are constant.
+    const char *ids = "hprxyz";
+    for (int ci = 0; ci < 6; ++ci) {
+      double amplitude = (ci < 3) ? random.random_real(90.0) : random.random_real(2.0);
+      double period = 10.0 + random.random_real(90.0);
+      double phase = random.random_real(10.0);
+
+      PTA_stdfloat table = PTA_stdfloat::empty_array(num_frames);
+      for (int fi = 0; fi < num_frames; ++fi) {
+        double t = (fi + phase) / period * 2.0 * MathNumbers::pi;
+        table[fi] = (PN_stdfloat)(amplitude * (sin(t) + 0.3 * sin(t * 3.7)) +
+                                  random.random_real(amplitude * 0.00001));
+      }
+      joint->set_table(ids[ci], table);
+    }
+  }
+  return bundle;
+}
+
+/**
+ * Returns the total memory used by the tables of the animation.
+ */
+static size_t
+get_memory_size(AnimBundle *bundle) {
+  size_t size = 0;
+  for (int i = 0; i < bundle->get_num_children(); ++i) {
+    AnimChannelMatrixXfmTable *joint =
+      DCAST(AnimChannelMatrixXfmTable, bundle->get_child(i));
+    size += joint->get_table_memory_size();
+  }
+  return size;
+}
+
+/**
+ * Returns the size of the animation when written to a bam stream.
+ */
+static size_t
+get_bam_size(AnimBundle *bundle) {
+  DatagramBuffer buffer;
+  BamWriter writer(&buffer);
+  writer.set_file_minor_ver(46);
+  writer.init();
+  writer.write_object(bundle);
+  writer.flush();
+  return buffer.get_data().size();
+}
+
+/**
+ * Samples every frame of every joint, and returns the time per sample in
+ * nanoseconds.  Also stores the sampled matrices in the indicated vector.
+ */
+static double
+sample_all(AnimBundle *bundle, pvector<LMatrix4> &values) {
+  int num_joints = bundle->get_num_children();
+  int num_frames = bundle->get_num_frames();
+  values.resize((size_t)num_joints * num_frames);
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int ji = 0; ji < num_joints; ++ji) {
+    AnimChannelMatrixXfmTable *joint =
+      DCAST(AnimChannelMatrixXfmTable, bundle->get_child(ji));
+    for (int fi = 0; fi < num_frames; ++fi) {
+      joint->get_value(fi, values[(size_t)ji * num_frames + fi]);
+    }
+  }
+  double elapsed = clock->get_short_time() - start;
+  return elapsed * 1.0e9 / values.size();
+}
+
+int
+main(int argc, char *argv[]) {
+  if (argc > 4) {
+    nout << "test_anim_tables [joints [frames [tolerance]]]\n";
+    exit(1);
+  }
+
+  int num_joints = (argc > 1) ? atoi(argv[1]) : 100;
+  int num_frames = (argc > 2) ? atoi(argv[2]) : 1000;
+  double tolerance = (argc > 3) ? atof(argv[3]) : (double)anim_table_tolerance;
+
+  PT(AnimBundle) bundle = make_anim(num_joints, num_frames);
+
+  pvector<LMatrix4> original;
+  double original_time = sample_all(bundle, original);
+  size_t original_memory = get_memory_size(bundle);
+  size_t original_bam = get_bam_size(bundle);
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < bundle->get_num_children(); ++i) {
+    DCAST(AnimChannelMatrixXfmTable, bundle->get_child(i))->compress_tables(tolerance);
+  }
+  double compress_time = clock->get_short_time() - start;
+
+  pvector<LMatrix4> compressed;
+  double compressed_time = sample_all(bundle, compressed);
+  size_t compressed_memory = get_memory_size(bundle);
+  size_t compressed_bam = get_bam_size(bundle);
+
+  PN_stdfloat max_error = 0.0f;
+  for (size_t i = 0; i < original.size(); ++i) {
+    for (int r = 0; r < 4; ++r) {
+      for (int c = 0; c < 4; ++c) {
+        max_error = std::max(max_error, (PN_stdfloat)fabs(original[i](r, c) - compressed[i](r, c)));
+      }
+    }
+  }
+
+  nout << num_joints << " joints, " << num_frames << " frames, tolerance "
+       << tolerance << "\n"
+       << "memory: " << original_memory << " -> " << compressed_memory
+       << " bytes (" << (double)compressed_memory / original_memory << ")\n"
+       << "bam: " << original_bam << " -> " << compressed_bam
+       << " bytes (" << (double)compressed_bam / original_bam << ")\n"
+       << "sample: " << original_time << " -> " << compressed_time
+       << " ns per matrix\n"
+       << "compress: " << compress_time << " s\n"
+       << "largest matrix error: " << max_error << "\n";
+  return 0;
+}
@@ -27,11 +27,47 @@
 #include "camera.h"
 #include "cullTraverser.h"
 #include "cullTraverserData.h"
+#include "nodePathCollection.h"
+#include "asyncTaskManager.h"
+
+#include <algorithm>
 
 TypeHandle Character::_type_handle;
 
 PStatCollector Character::_animation_pcollector("*:Animation");
 
+namespace {
+  // A contiguous run of the characters passed to update_characters(), to be
+  // updated by one thread.
+  struct UpdateRun {
+    Character *const *_characters;
+    size_t _num_characters;
+  };
+
+  // Returns the representative of the set that the nth character has been
+  // joined into, compressing the path on the way.
+  size_t
+  find_update_group(pvector<size_t> &groups, size_t n) {
+    while (groups[n] != n) {
+      groups[n] = groups[groups[n]];
+      n = groups[n];
+    }
+    return n;
+  }
+}
+
+/**
+ * Updates the characters of the nth run on one of the character update
+ * threads.
+ */
+static void
+update_run(size_t n, void *user_data) {
+  const UpdateRun &run = ((const UpdateRun *)user_data)[n];
+  for (size_t i = 0; i < run._num_characters; ++i) {
+    run._characters[i]->update();
+  }
+}
+
 /**
  * Use make_copy() or copy_subgraph() to copy a Character.
  */
@@ -418,6 +454,88 @@ update() {
   }
 }
 
+/**
+ * Calls update() on each of the Character nodes in the indicated collection;
+ * any other nodes are ignored.  If character-update-threads is nonzero, the
+ * characters are split among that many threads and the calling thread, and
+ * this returns when all of them have been updated.
+ *
+ * This is useful to bring a crowd of characters up to date in one go, rather
+ * than one at a time as the cull traversal comes across them.
+ */
+void Character::
+update_characters(const NodePathCollection &characters) {
+  pvector<Character *> chars;
+  chars.reserve(characters.get_num_paths());
+  for (int i = 0; i < characters.get_num_paths(); ++i) {
+    PandaNode *node = characters.get_path(i).node();
+    if (node != nullptr && node->is_of_type(get_class_type())) {
+      chars.push_back((Character *)node);
+    }
+  }
+
+  int num_threads = character_update_threads;
+  if (num_threads <= 0 || chars.size() < 2) {
+    for (Character *character : chars) {
+      character->update();
+    }
+    return;
+  }
+
+  // Characters that share any of their bundles must be updated by the same
+  // thread, so join them into groups, and sort each group together.
+  size_t num_chars = chars.size();
+  pvector<size_t> groups(num_chars);
+  pmap<PartBundle *, size_t> bundle_chars;
+  for (size_t i = 0; i < num_chars; ++i) {
+    groups[i] = i;
+    int num_bundles = chars[i]->get_num_bundles();
+    for (int bi = 0; bi < num_bundles; ++bi) {
+      auto result = bundle_chars.insert(std::make_pair(chars[i]->get_bundle(bi), i));
+      if (!result.second) {
+        groups[find_update_group(groups, i)] =
+          find_update_group(groups, result.first->second);
+      }
+    }
+  }
+
+  pvector<std::pair<size_t, Character *> > sorted;
+  sorted.reserve(num_chars);
+  for (size_t i = 0; i < num_chars; ++i) {
+    sorted.push_back(std::make_pair(find_update_group(groups, i), chars[i]));
+  }
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < num_chars; ++i) {
+    chars[i] = sorted[i].second;
+  }
+
+  // Divide the characters into contiguous runs to be shared out between the
+  // threads, taking care not to divide a group of characters that share a
+  // bundle.
+  size_t num_runs = std::min(num_chars, (size_t)num_threads + 1);
+  size_t run_size = (num_chars + num_runs - 1) / num_runs;
+
+  pvector<UpdateRun> runs;
+  runs.reserve(num_runs);
+  size_t begin = 0;
+  while (begin < num_chars) {
+    size_t end = std::min(begin + run_size, num_chars);
+    while (end < num_chars && sorted[end].first == sorted[end - 1].first) {
+      ++end;
+    }
+
+    UpdateRun run;
+    run._characters = chars.data() + begin;
+    run._num_characters = end - begin;
+    runs.push_back(run);
+    begin = end;
+  }
+
+  AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->
+    make_worker_chain("character_update", num_threads);
+  chain->parallel_for(runs.size(), &update_run, runs.data());
+}
+
 /**
  * Recalculates the character even if we think it doesn't need it.
  */
@@ -707,6 +825,7 @@ r_merge_bundles(Character::JointMap &joint_map,
   }
 
   new_group->_children.swap(new_children);
+  new_group->mark_hierarchy_changed();
 }
 
 /**
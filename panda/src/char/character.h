@@ -30,6 +30,7 @@
 #include "sliderTable.h"
 
 class CharacterJointBundle;
+class NodePathCollection;
 
 /**
  * An animated character, with skeleton-morph animation and either soft-
@@ -77,6 +78,8 @@ PUBLISHED:
   void update();
   void force_update();
 
+  static void update_characters(const NodePathCollection &characters);
+
 protected:
   virtual void r_copy_children(const PandaNode *from, InstanceMap &inst_map,
                                Thread *current_thread);
@@ -40,6 +40,11 @@ ConfigVariableBool even_animation
           "The default is to compute vertices only when they need to be "
           "computed, which can lead to an uneven frame rate."));
 
+ConfigVariableInt character_update_threads
+("character-update-threads", 0,
+ PRC_DESC("The number of extra threads that Character::update_characters() "
+          "uses to update many characters at once."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
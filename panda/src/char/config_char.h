@@ -17,6 +17,7 @@
 #include "pandabase.h"
 #include "notifyCategoryProxy.h"
 #include "configVariableBool.h"
+#include "configVariableInt.h"
 
 // CPPParser can't handle token-pasting to a keyword.
 #ifndef CPPPARSER
@@ -25,6 +26,7 @@ NotifyCategoryDecl(char, EXPCL_PANDA_CHAR, EXPTP_PANDA_CHAR);
 
 // Configure variables for char package.
 extern EXPCL_PANDA_CHAR ConfigVariableBool even_animation;
+extern EXPCL_PANDA_CHAR ConfigVariableInt character_update_threads;
 
 extern EXPCL_PANDA_CHAR void init_libchar();
 
@@ -0,0 +1,470 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBroadphase.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "collisionBroadphase.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ *
+ */
+CollisionBroadphase::
+CollisionBroadphase() :
+  _root(-1),
+  _free_list(-1),
+  _num_leaves(0)
+{
+}
+
+/**
+ * Adds a new leaf to the tree with the indicated box, enlarged on all sides
+ * by the indicated margin, and returns its index.
+ */
+int CollisionBroadphase::
+add_leaf(const LPoint3 &min_point, const LPoint3 &max_point,
+         PN_stdfloat margin, int user_index) {
+  int leaf = alloc_node();
+  Node &node = _nodes[leaf];
+  LVector3 fat(margin, margin, margin);
+  node._min = min_point - fat;
+  node._max = max_point + fat;
+  node._height = 0;
+  node._user_index = user_index;
+
+  insert_leaf(leaf);
+  ++_num_leaves;
+  return leaf;
+}
+
+/**
+ * Removes the indicated leaf from the tree.  Its index may be reused by a
+ * subsequent call to add_leaf().
+ */
+void CollisionBroadphase::
+remove_leaf(int leaf) {
+  nassertv(leaf >= 0 && leaf < (int)_nodes.size() && _nodes[leaf].is_leaf());
+
+  extract_leaf(leaf);
+  free_node(leaf);
+  --_num_leaves;
+}
+
+/**
+ * Updates the box of the indicated leaf.  If the new box still fits within
+ * the fat box that the leaf already has, nothing changes, and this returns
+ * false.  Otherwise, the leaf is given a new fat box and moved to a new place
+ * in the tree, and this returns true.
+ */
+bool CollisionBroadphase::
+move_leaf(int leaf, const LPoint3 &min_point, const LPoint3 &max_point,
+          PN_stdfloat margin) {
+  nassertr(leaf >= 0 && leaf < (int)_nodes.size() && _nodes[leaf].is_leaf(), false);
+
+  Node &node = _nodes[leaf];
+  if (node._min[0] <= min_point[0] && node._min[1] <= min_point[1] &&
+      node._min[2] <= min_point[2] && node._max[0] >= max_point[0] &&
+      node._max[1] >= max_point[1] && node._max[2] >= max_point[2]) {
+    return false;
+  }
+
+  extract_leaf(leaf);
+
+  LVector3 fat(margin, margin, margin);
+  _nodes[leaf]._min = min_point - fat;
+  _nodes[leaf]._max = max_point + fat;
+
+  insert_leaf(leaf);
+  return true;
+}
+
+/**
+ * Removes all of the leaves from the tree.
+ */
+void CollisionBroadphase::
+clear() {
+  _nodes.clear();
+  _root = -1;
+  _free_list = -1;
+  _num_leaves = 0;
+}
+
+/**
+ * Appends to the indicated vector the user index of each leaf whose fat box
+ * overlaps the indicated box.
+ */
+void CollisionBroadphase::
+query_box(const LPoint3 &min_point, const LPoint3 &max_point,
+          pvector<int> &user_indices) const {
+  if (_root < 0) {
+    return;
+  }
+
+  pvector<int> stack;
+  stack.reserve(64);
+  stack.push_back(_root);
+  while (!stack.empty()) {
+    const Node &node = _nodes[stack.back()];
+    stack.pop_back();
+
+    if (node._min[0] > max_point[0] || node._max[0] < min_point[0] ||
+        node._min[1] > max_point[1] || node._max[1] < min_point[1] ||
+        node._min[2] > max_point[2] || node._max[2] < min_point[2]) {
+      continue;
+    }
+
+    if (node.is_leaf()) {
+      user_indices.push_back(node._user_index);
+    } else {
+      stack.push_back(node._child2);
+      stack.push_back(node._child1);
+    }
+  }
+}
+
+/**
+ * Appends to the indicated vector the user index of each leaf whose fat box
+ * is crossed by the indicated line, which extends to infinity in both
+ * directions, like a BoundingLine.
+ */
+void CollisionBroadphase::
+query_line(const LPoint3 &origin, const LVector3 &direction,
+           pvector<int> &user_indices) const {
+  if (_root < 0) {
+    return;
+  }
+
+  pvector<int> stack;
+  stack.reserve(64);
+  stack.push_back(_root);
+  while (!stack.empty()) {
+    const Node &node = _nodes[stack.back()];
+    stack.pop_back();
+
+    // Clip the line against each pair of planes of the box in turn.
+    double t_min = -std::numeric_limits<double>::infinity();
+    double t_max = std::numeric_limits<double>::infinity();
+    bool crosses = true;
+    for (int i = 0; i < 3 && crosses; ++i) {
+      if (direction[i] == 0.0f) {
+        crosses = (origin[i] >= node._min[i] && origin[i] <= node._max[i]);
+      } else {
+        double t1 = (node._min[i] - origin[i]) / (double)direction[i];
+        double t2 = (node._max[i] - origin[i]) / (double)direction[i];
+        t_min = std::max(t_min, std::min(t1, t2));
+        t_max = std::min(t_max, std::max(t1, t2));
+        crosses = (t_min <= t_max);
+      }
+    }
+    if (!crosses) {
+      continue;
+    }
+
+    if (node.is_leaf()) {
+      user_indices.push_back(node._user_index);
+    } else {
+      stack.push_back(node._child2);
+      stack.push_back(node._child1);
+    }
+  }
+}
+
+/**
+ * Appends to the indicated vector the user index of every leaf.
+ */
+void CollisionBroadphase::
+query_all(pvector<int> &user_indices) const {
+  for (const Node &node : _nodes) {
+    if (node.is_leaf()) {
+      user_indices.push_back(node._user_index);
+    }
+  }
+}
+
+/**
+ * Returns the index of an unused node, either from the free list or newly
+ * added to the end of the node array.
+ */
+int CollisionBroadphase::
+alloc_node() {
+  int index;
+  if (_free_list >= 0) {
+    index = _free_list;
+    _free_list = _nodes[index]._parent;
+  } else {
+    index = (int)_nodes.size();
+    _nodes.push_back(Node());
+  }
+
+  Node &node = _nodes[index];
+  node._parent = -1;
+  node._child1 = -1;
+  node._child2 = -1;
+  node._height = 0;
+  node._user_index = -1;
+  return index;
+}
+
+/**
+ * Returns the indicated node to the free list.
+ */
+void CollisionBroadphase::
+free_node(int index) {
+  Node &node = _nodes[index];
+  node._parent = _free_list;
+  node._height = -1;
+  _free_list = index;
+}
+
+/**
+ * Links the indicated leaf, which must already have its box, into the tree,
+ * next to the sibling that least increases the total perimeter of the tree.
+ */
+void CollisionBroadphase::
+insert_leaf(int leaf) {
+  if (_root < 0) {
+    _root = leaf;
+    _nodes[leaf]._parent = -1;
+    return;
+  }
+
+  LPoint3 leaf_min = _nodes[leaf]._min;
+  LPoint3 leaf_max = _nodes[leaf]._max;
+
+  // Walk down to the best sibling.  The cost of placing the leaf next to a
+  // node is the perimeter of the new parent, plus the amount by which the
+  // boxes of all of the node's ancestors must grow to hold the leaf.
+  int index = _root;
+  while (!_nodes[index].is_leaf()) {
+    const Node &node = _nodes[index];
+
+    PN_stdfloat perimeter = get_perimeter(node._min, node._max);
+    LPoint3 combined_min = node._min.fmin(leaf_min);
+    LPoint3 combined_max = node._max.fmax(leaf_max);
+    PN_stdfloat combined_perimeter = get_perimeter(combined_min, combined_max);
+
+    PN_stdfloat cost = 2.0f * combined_perimeter;
+    PN_stdfloat inheritance_cost = 2.0f * (combined_perimeter - perimeter);
+
+    PN_stdfloat child_cost[2];
+    int children[2] = { node._child1, node._child2 };
+    for (int i = 0; i < 2; ++i) {
+      const Node &child = _nodes[children[i]];
+      PN_stdfloat grown = get_perimeter(child._min.fmin(leaf_min),
+                                        child._max.fmax(leaf_max));
+      if (child.is_leaf()) {
+        child_cost[i] = grown + inheritance_cost;
+      } else {
+        child_cost[i] = grown - get_perimeter(child._min, child._max) +
+          inheritance_cost;
+      }
+    }
+
+    if (cost < child_cost[0] && cost < child_cost[1]) {
+      break;
+    }
+    index = (child_cost[0] < child_cost[1]) ? children[0] : children[1];
+  }
+
+  // Make a new parent for the sibling and the leaf.
+  int sibling = index;
+  int old_parent = _nodes[sibling]._parent;
+  int new_parent = alloc_node();
+
+  Node &parent = _nodes[new_parent];
+  parent._parent = old_parent;
+  parent._min = leaf_min.fmin(_nodes[sibling]._min);
+  parent._max = leaf_max.fmax(_nodes[sibling]._max);
+  parent._height = _nodes[sibling]._height + 1;
+  parent._child1 = sibling;
+  parent._child2 = leaf;
+
+  if (old_parent >= 0) {
+    if (_nodes[old_parent]._child1 == sibling) {
+      _nodes[old_parent]._child1 = new_parent;
+    } else {
+      _nodes[old_parent]._child2 = new_parent;
+    }
+  } else {
+    _root = new_parent;
+  }
+  _nodes[sibling]._parent = new_parent;
+  _nodes[leaf]._parent = new_parent;
+
+  fix_upwards(new_parent);
+}
+
+/**
+ * Unlinks the indicated leaf from the tree, without freeing it.  Its parent
+ * is freed, and its sibling takes the parent's place.
+ */
+void CollisionBroadphase::
+extract_leaf(int leaf) {
+  if (leaf == _root) {
+    _root = -1;
+    return;
+  }
+
+  int parent = _nodes[leaf]._parent;
+  int grandparent = _nodes[parent]._parent;
+  int sibling = (_nodes[parent]._child1 == leaf)
+    ? _nodes[parent]._child2 : _nodes[parent]._child1;
+
+  if (grandparent >= 0) {
+    if (_nodes[grandparent]._child1 == parent) {
+      _nodes[grandparent]._child1 = sibling;
+    } else {
+      _nodes[grandparent]._child2 = sibling;
+    }
+    _nodes[sibling]._parent = grandparent;
+    free_node(parent);
+    fix_upwards(grandparent);
+
+  } else {
+    _root = sibling;
+    _nodes[sibling]._parent = -1;
+    free_node(parent);
+  }
+  _nodes[leaf]._parent = -1;
+}
+
+/**
+ * Rebalances the indicated node and each of its ancestors, and recomputes
+ * their boxes and heights.
+ */
+void CollisionBroadphase::
+fix_upwards(int index) {
+  while (index >= 0) {
+    index = balance(index);
+
+    Node &node = _nodes[index];
+    const Node &child1 = _nodes[node._child1];
+    const Node &child2 = _nodes[node._child2];
+    node._height = 1 + std::max(child1._height, child2._height);
+    node._min = child1._min.fmin(child2._min);
+    node._max = child1._max.fmax(child2._max);
+
+    index = node._parent;
+  }
+}
+
+/**
+ * If one child of the indicated node is more than one level taller than the
+ * other, rotates the taller child up to take the node's place.  Returns the
+ * index of the node that is now in that place.
+ */
+int CollisionBroadphase::
+balance(int index_a) {
+  Node &a = _nodes[index_a];
+  if (a.is_leaf() || a._height < 2) {
+    return index_a;
+  }
+
+  int index_b = a._child1;
+  int index_c = a._child2;
+  Node &b = _nodes[index_b];
+  Node &c = _nodes[index_c];
+
+  int diff = c._height - b._height;
+  if (diff > 1) {
+    // Rotate C up.
+    int index_f = c._child1;
+    int index_g = c._child2;
+    Node &f = _nodes[index_f];
+    Node &g = _nodes[index_g];
+
+    c._child1 = index_a;
+    c._parent = a._parent;
+    a._parent = index_c;
+
+    if (c._parent >= 0) {
+      if (_nodes[c._parent]._child1 == index_a) {
+        _nodes[c._parent]._child1 = index_c;
+      } else {
+        _nodes[c._parent]._child2 = index_c;
+      }
+    } else {
+      _root = index_c;
+    }
+
+    if (f._height > g._height) {
+      c._child2 = index_f;
+      a._child2 = index_g;
+      g._parent = index_a;
+      a._min = b._min.fmin(g._min);
+      a._max = b._max.fmax(g._max);
+      c._min = a._min.fmin(f._min);
+      c._max = a._max.fmax(f._max);
+      a._height = 1 + std::max(b._height, g._height);
+      c._height = 1 + std::max(a._height, f._height);
+    } else {
+      c._child2 = index_g;
+      a._child2 = index_f;
+      f._parent = index_a;
+      a._min = b._min.fmin(f._min);
+      a._max = b._max.fmax(f._max);
+      c._min = a._min.fmin(g._min);
+      c._max = a._max.fmax(g._max);
+      a._height = 1 + std::max(b._height, f._height);
+      c._height = 1 + std::max(a._height, g._height);
+    }
+    return index_c;
+  }
+
+  if (diff < -1) {
+    // Rotate B up.
+    int index_d = b._child1;
+    int index_e = b._child2;
+    Node &d = _nodes[index_d];
+    Node &e = _nodes[index_e];
+
+    b._child1 = index_a;
+    b._parent = a._parent;
+    a._parent = index_b;
+
+    if (b._parent >= 0) {
+      if (_nodes[b._parent]._child1 == index_a) {
+        _nodes[b._parent]._child1 = index_b;
+      } else {
+        _nodes[b._parent]._child2 = index_b;
+      }
+    } else {
+      _root = index_b;
+    }
+
+    if (d._height > e._height) {
+      b._child2 = index_d;
+      a._child1 = index_e;
+      e._parent = index_a;
+      a._min = c._min.fmin(e._min);
+      a._max = c._max.fmax(e._max);
+      b._min = a._min.fmin(d._min);
+      b._max = a._max.fmax(d._max);
+      a._height = 1 + std::max(c._height, e._height);
+      b._height = 1 + std::max(a._height, d._height);
+    } else {
+      b._child2 = index_e;
+      a._child1 = index_d;
+      d._parent = index_a;
+      a._min = c._min.fmin(d._min);
+      a._max = c._max.fmax(d._max);
+      b._min = a._min.fmin(e._min);
+      b._max = a._max.fmax(e._max);
+      a._height = 1 + std::max(c._height, d._height);
+      b._height = 1 + std::max(a._height, e._height);
+    }
+    return index_b;
+  }
+
+  return index_a;
+}
@@ -0,0 +1,98 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBroadphase.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef COLLISIONBROADPHASE_H
+#define COLLISIONBROADPHASE_H
+
+#include "pandabase.h"
+
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * A dynamic tree of axis-aligned bounding boxes, used by the
+ * CollisionTraverser in broadphase mode to find the into-nodes whose bounds
+ * overlap the bounds of each collider, without walking the scene graph once
+ * for each collider.
+ *
+ * Each leaf stores a "fat" box, which is somewhat larger than the box it was
+ * given, so that a node that moves only a little from one frame to the next
+ * does not need to be moved within the tree.  New leaves are placed where
+ * they least increase the surface area of the tree, and the tree is kept
+ * balanced with rotations, as in an AVL tree.
+ *
+ * Leaves are identified by the index returned from add_leaf(), which remains
+ * valid until the leaf is removed.  Each leaf also stores an arbitrary user
+ * index, which is what the queries return.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBroadphase {
+public:
+  CollisionBroadphase();
+
+  int add_leaf(const LPoint3 &min_point, const LPoint3 &max_point,
+               PN_stdfloat margin, int user_index);
+  void remove_leaf(int leaf);
+  bool move_leaf(int leaf, const LPoint3 &min_point, const LPoint3 &max_point,
+                 PN_stdfloat margin);
+  void clear();
+
+  INLINE void set_user_index(int leaf, int user_index);
+  INLINE int get_user_index(int leaf) const;
+
+  INLINE int get_num_leaves() const;
+  INLINE int get_height() const;
+
+  void query_box(const LPoint3 &min_point, const LPoint3 &max_point,
+                 pvector<int> &user_indices) const;
+  void query_line(const LPoint3 &origin, const LVector3 &direction,
+                  pvector<int> &user_indices) const;
+  void query_all(pvector<int> &user_indices) const;
+
+private:
+  int alloc_node();
+  void free_node(int index);
+  void insert_leaf(int leaf);
+  void extract_leaf(int leaf);
+  void fix_upwards(int index);
+  int balance(int index);
+
+  INLINE static PN_stdfloat get_perimeter(const LPoint3 &min_point,
+                                          const LPoint3 &max_point);
+
+  class Node {
+  public:
+    INLINE bool is_leaf() const;
+
+    LPoint3 _min = LPoint3::zero();
+    LPoint3 _max = LPoint3::zero();
+
+    // For a free node, _parent is the next node in the free list.
+    int _parent = -1;
+    int _child1 = -1;
+    int _child2 = -1;
+
+    // 0 for a leaf, -1 for a free node.
+    int _height = 0;
+    int _user_index = -1;
+  };
+
+  typedef pvector<Node> Nodes;
+  Nodes _nodes;
+  int _root;
+  int _free_list;
+  int _num_leaves;
+};
+
+#include "collisionBroadphase.I"
+
+#endif
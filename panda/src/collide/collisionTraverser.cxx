@@ -25,6 +25,7 @@
 #include "collisionPlane.h"
 #include "config_collide.h"
 #include "boundingSphere.h"
+#include "boundingLine.h"
 #include "transformState.h"
 #include "geomNode.h"
 #include "geom.h"
@@ -35,6 +36,7 @@
 #include "nodePath.h"
 #include "pStatTimer.h"
 #include "indent.h"
+#include "asyncTaskManager.h"
 
 #include <algorithm>
 
@@ -65,15 +67,61 @@ public:
   const CollisionTraverser &_trav;
 };
 
+// This handler is used in broadphase mode to hold the collisions detected for
+// one collider on a worker thread, until they can be passed on to the
+// collider's real handler on the thread that called traverse().
+class DeferredCollisionHandler : public CollisionHandler {
+public:
+  DeferredCollisionHandler(const CollisionHandler *handler) {
+    _wants_all_potential_collidees = handler->wants_all_potential_collidees();
+  }
+
+  virtual void add_entry(CollisionEntry *entry) {
+    _entries.push_back(entry);
+  }
+
+  pvector<PT(CollisionEntry)> _entries;
+};
+
+// One solid of one collider, as prepared for a broadphase traversal.
+class CollisionTraverser::BroadphaseCollider {
+public:
+  CollisionNode *_node;
+  NodePath _node_path;
+  CPT(CollisionSolid) _solid;
+  CollideMask _from_mask;
+  CollisionHandler *_handler;
+
+  // The net transform of the collider, relative to the root's parent, and
+  // the bounding volume of the solid in the collider's own space.
+  CPT(TransformState) _net;
+  PT(GeometricBoundingVolume) _bounds;
+
+  PT(DeferredCollisionHandler) _deferred;
+};
+
+// A contiguous run of the colliders of a broadphase traversal, to be tested
+// by one thread.
+class CollisionTraverser::BroadphaseRun {
+public:
+  CollisionTraverser *_traverser;
+  BroadphaseCollider *_colliders;
+  size_t _num_colliders;
+};
+
 /**
  *
  */
 CollisionTraverser::
 CollisionTraverser(const std::string &name) :
   Namable(name),
-  _this_pcollector(_collisions_pcollector, name)
+  _this_pcollector(_collisions_pcollector, name),
+  _bp_update_pcollector(_this_pcollector, "Broadphase update"),
+  _bp_collide_pcollector(_this_pcollector, "Broadphase collide")
 {
   _respect_prev_transform = respect_prev_transform;
+  _broadphase = collision_broadphase;
+  _bp_seq = 0;
   #ifdef DO_COLLISION_RECORDING
   _recorder = nullptr;
   #endif
@@ -89,6 +137,36 @@ CollisionTraverser::
   #endif
 }
 
+/**
+ * Sets the flag that indicates whether the traverser uses broadphase mode.
+ *
+ * In broadphase mode, the traverser keeps a tree of the bounding boxes of all
+ * of the into-nodes under the root, which it brings up to date at the start
+ * of each traversal, and it finds the into-nodes near each collider by
+ * looking up the collider's bounding box in this tree, rather than by walking
+ * the scene graph once for every group of colliders.  This is much faster
+ * when there are many colliders and many into-nodes.  The colliders may also
+ * be tested on several threads at once; see collision-broadphase-threads.
+ *
+ * The same collisions are detected in either mode, and the handlers receive
+ * each collider's collisions in the same order, but the collisions of
+ * different colliders are no longer interleaved.
+ *
+ * The default is taken from the collision-broadphase config variable.
+ */
+void CollisionTraverser::
+set_broadphase(bool flag) {
+  _broadphase = flag;
+  if (!flag) {
+    _bp_root.clear();
+    _bp_tree.clear();
+    _bp_intos.clear();
+    _bp_proxies.clear();
+    _bp_unbounded.clear();
+    _bp_subtree = BroadphaseSubtree();
+  }
+}
+
 /**
  * Adds a new CollisionNode, representing an object that will be tested for
  * collisions into other objects, along with the handler that will serve each
@@ -272,8 +350,14 @@ traverse(const NodePath &root) {
   }
 
   bool traversal_done = false;
-  if ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
-      !allow_collider_multiple) {
+  if (_broadphase) {
+    traverse_broadphase(root);
+    traversal_done = true;
+  }
+
+  if (!traversal_done &&
+      ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
+       !allow_collider_multiple)) {
     // Use the single-word-at-a-time traverser, which might need to make lots
     // of passes.
     LevelStatesSingle level_states;
@@ -528,9 +612,13 @@ prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
       ocd._in_graph = true;
       CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
 
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+
       CollisionLevelStateSingle::ColliderDef def;
       def._node = cnode;
       def._node_path = cnode_path;
+      def._handler = (*ci).second;
 
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
@@ -600,7 +688,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_node(
-              entry,
+              entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               node_gbv);
@@ -645,7 +733,7 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_geom_node(
-              entry,
+              entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               node_gbv);
@@ -739,9 +827,13 @@ prepare_colliders_double(CollisionTraverser::LevelStatesDouble &level_states,
       ocd._in_graph = true;
       CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
 
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+
       CollisionLevelStateDouble::ColliderDef def;
       def._node = cnode;
       def._node_path = cnode_path;
+      def._handler = (*ci).second;
 
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
@@ -811,7 +903,7 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_node(
-              entry,
+              entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               node_gbv);
@@ -856,7 +948,7 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_geom_node(
-              entry,
+              entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               node_gbv);
@@ -950,9 +1042,13 @@ prepare_colliders_quad(CollisionTraverser::LevelStatesQuad &level_states,
       ocd._in_graph = true;
       CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
 
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+
       CollisionLevelStateQuad::ColliderDef def;
       def._node = cnode;
       def._node_path = cnode_path;
+      def._handler = (*ci).second;
 
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
@@ -1022,7 +1118,7 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_node(
-              entry,
+              entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               node_gbv);
@@ -1067,7 +1163,7 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
           entry._from = level_state.get_collider(c);
 
           compare_collider_to_geom_node(
-              entry,
+              entry, level_state.get_collider_handler(c),
               level_state.get_parent_bound(c),
               level_state.get_local_bound(c),
               node_gbv);
@@ -1114,11 +1210,486 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
   }
 }
 
+/**
+ * Performs the traversal in broadphase mode.  The tree of into-nodes is
+ * brought up to date, and then each collider solid is looked up in the tree
+ * and tested against each of the into-nodes whose box it overlaps.
+ */
+void CollisionTraverser::
+traverse_broadphase(const NodePath &root) {
+  BroadphaseColliders colliders;
+  prepare_colliders_broadphase(colliders, root);
+
+  CollideMask from_mask;
+  for (const BroadphaseCollider &collider : colliders) {
+    from_mask |= collider._from_mask;
+  }
+
+  {
+    PStatTimer timer(_bp_update_pcollector);
+    update_broadphase(root, from_mask);
+  }
+
+  if (colliders.empty()) {
+    return;
+  }
+
+  PStatTimer timer(_bp_collide_pcollector);
+
+  int num_threads = collision_broadphase_threads;
+  bool parallel = (num_threads > 0 && colliders.size() > 1 &&
+                   Thread::is_threading_supported());
+#ifdef DO_COLLISION_RECORDING
+  // The recorder is not prepared to be called from several threads at once.
+  if (has_recorder()) {
+    parallel = false;
+  }
+#endif  // DO_COLLISION_RECORDING
+
+  if (!parallel) {
+    for (const BroadphaseCollider &collider : colliders) {
+      compare_collider_to_broadphase(collider, collider._handler);
+    }
+    return;
+  }
+
+  // The handlers are not prepared to be called from several threads at once
+  // either, so each collider passes its collisions to a handler of its own,
+  // which holds on to them until all of the colliders have been tested.
+  for (BroadphaseCollider &collider : colliders) {
+    collider._deferred = new DeferredCollisionHandler(collider._handler);
+  }
+
+  // Divide the colliders into contiguous runs to be shared out between the
+  // threads.
+  size_t num_colliders = colliders.size();
+  size_t num_runs = std::min(num_colliders, (size_t)num_threads + 1);
+  size_t run_size = (num_colliders + num_runs - 1) / num_runs;
+
+  pvector<BroadphaseRun> runs;
+  runs.reserve(num_runs);
+  for (size_t begin = 0; begin < num_colliders; begin += run_size) {
+    BroadphaseRun run;
+    run._traverser = this;
+    run._colliders = colliders.data() + begin;
+    run._num_colliders = std::min(run_size, num_colliders - begin);
+    runs.push_back(run);
+  }
+
+  AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->
+    make_worker_chain("collision_broadphase", num_threads);
+  chain->parallel_for(runs.size(), &broadphase_run, runs.data());
+
+  // Now pass the collisions on to the real handlers, in the same order in
+  // which a single thread would have found them.
+  for (const BroadphaseCollider &collider : colliders) {
+    for (CollisionEntry *entry : collider._deferred->_entries) {
+      collider._handler->add_entry(entry);
+    }
+  }
+}
+
+/**
+ * Tests the colliders of the nth run of a broadphase traversal on one of the
+ * broadphase threads.
+ */
+void CollisionTraverser::
+broadphase_run(size_t n, void *user_data) {
+  const BroadphaseRun &run = ((const BroadphaseRun *)user_data)[n];
+  for (size_t i = 0; i < run._num_colliders; ++i) {
+    const BroadphaseCollider &collider = run._colliders[i];
+    run._traverser->compare_collider_to_broadphase(collider, collider._deferred);
+  }
+}
+
+/**
+ * Brings the broadphase tree up to date with the into-nodes under the
+ * indicated root.  Into-nodes that share no collide bits with the indicated
+ * mask are left out.
+ */
+void CollisionTraverser::
+update_broadphase(const NodePath &root, CollideMask from_mask) {
+  if (root != _bp_root) {
+    // We have been asked to traverse a different root; start over.
+    _bp_tree.clear();
+    _bp_proxies.clear();
+    _bp_subtree = BroadphaseSubtree();
+    _bp_root = root;
+  }
+  if (from_mask != _bp_from_mask) {
+    // A different set of into-nodes may be wanted now.
+    _bp_subtree = BroadphaseSubtree();
+    _bp_from_mask = from_mask;
+  }
+
+  ++_bp_seq;
+  BroadphaseIntos prev_intos;
+  prev_intos.swap(_bp_intos);
+  _bp_intos.reserve(prev_intos.size());
+  _bp_unbounded.clear();
+
+  if (!from_mask.is_zero()) {
+    r_update_broadphase(WorkingNodePath(root), TransformState::make_identity(),
+                        CollideMask::all_on(), from_mask, _bp_subtree,
+                        prev_intos);
+  }
+
+  // Remove the leaves of the into-nodes that were not found this time.
+  BroadphaseProxies::iterator pi = _bp_proxies.begin();
+  while (pi != _bp_proxies.end()) {
+    if ((*pi).second._seq != _bp_seq) {
+      if ((*pi).second._leaf >= 0) {
+        _bp_tree.remove_leaf((*pi).second._leaf);
+      }
+      pi = _bp_proxies.erase(pi);
+    } else {
+      ++pi;
+    }
+  }
+
+  if (collide_cat.is_spam()) {
+    collide_cat.spam()
+      << "Broadphase has " << _bp_intos.size() << " into-nodes, "
+      << _bp_tree.get_num_leaves() << " in a tree of height "
+      << _bp_tree.get_height() << "\n";
+  }
+}
+
+/**
+ * Finds the into-nodes at and below the indicated node, recording each one
+ * in _bp_intos and adding or moving its leaf in the broadphase tree.  This
+ * visits the same nodes as r_traverse_single() would, except for the subtrees
+ * in which nothing has changed since the last traversal; the into-nodes found
+ * there last time are taken over from prev_intos without walking them again.
+ */
+void CollisionTraverser::
+r_update_broadphase(const WorkingNodePath &node_path,
+                    const TransformState *parent_net,
+                    CollideMask include_mask, CollideMask from_mask,
+                    BroadphaseSubtree &subtree,
+                    const BroadphaseIntos &prev_intos) {
+  PandaNode *node = node_path.node();
+  UpdateSeq bounds_seq;
+  node->get_bounds(bounds_seq);
+  const TransformState *transform = node->get_transform();
+
+  if (subtree._reusable && subtree._seq == _bp_seq - 1 &&
+      subtree._node == node && subtree._bounds_seq == bounds_seq &&
+      subtree._parent_net == parent_net && subtree._transform == transform &&
+      subtree._include_mask == include_mask) {
+    // Any change at or below this node would have changed its bounds seq, so
+    // the into-nodes found here last time are still right, and their leaves
+    // are still in the right place.
+    size_t begin = _bp_intos.size();
+    for (size_t i = subtree._begin; i < subtree._end; ++i) {
+      int index = (int)_bp_intos.size();
+      _bp_intos.push_back(prev_intos[i]);
+
+      BroadphaseProxy *proxy = prev_intos[i]._proxy;
+      proxy->_seq = _bp_seq;
+      if (proxy->_leaf >= 0) {
+        _bp_tree.set_user_index(proxy->_leaf, index);
+      } else {
+        _bp_unbounded.push_back(index);
+      }
+    }
+    subtree._seq = _bp_seq;
+    subtree._begin = begin;
+    subtree._end = _bp_intos.size();
+    return;
+  }
+
+  subtree._node = node;
+  subtree._seq = _bp_seq;
+  subtree._bounds_seq = bounds_seq;
+  subtree._parent_net = parent_net;
+  subtree._transform = transform;
+  subtree._include_mask = include_mask;
+  subtree._begin = _bp_intos.size();
+  subtree._end = subtree._begin;
+
+  // The visible child of a switch or sequence node may change without its
+  // bounds seq changing, so a subtree with one in it is always walked.
+  subtree._reusable = !node->has_single_child_visibility();
+
+  if ((node->get_net_collide_mask() & include_mask & from_mask).is_zero()) {
+    subtree._children.clear();
+    return;
+  }
+
+  if (transform->is_singular()) {
+    // Nothing below a node that scales to zero can be collided with.
+    subtree._children.clear();
+    return;
+  }
+  CPT(TransformState) net = parent_net->compose(transform);
+
+  if (node->is_collision_node() || node->is_geom_node()) {
+    CollideMask into_mask = node->get_into_collide_mask() & include_mask;
+    CPT(BoundingVolume) bounds = node->get_bounds();
+
+    if (!(into_mask & from_mask).is_zero() && !bounds->is_empty()) {
+      int index = (int)_bp_intos.size();
+      _bp_intos.push_back(BroadphaseInto());
+      BroadphaseInto &into = _bp_intos.back();
+      into._node_path = node_path.get_node_path();
+      into._parent_net = parent_net;
+      into._net = net;
+      into._bounds = bounds;
+      into._gbv = bounds->as_geometric_bounding_volume();
+      into._into_mask = into_mask;
+
+      BroadphaseProxies::iterator pi = _bp_proxies.find(into._node_path);
+      bool changed = false;
+      if (pi == _bp_proxies.end()) {
+        pi = _bp_proxies.insert(BroadphaseProxies::value_type(into._node_path, BroadphaseProxy())).first;
+        changed = true;
+      }
+      BroadphaseProxy &proxy = (*pi).second;
+      proxy._seq = _bp_seq;
+      into._proxy = &proxy;
+
+      // We only need to recompute the box if the node's bounds or the
+      // transform above it have changed since the last traversal.
+      if (changed || proxy._parent_net != parent_net || proxy._bounds != bounds) {
+        proxy._parent_net = parent_net;
+        proxy._bounds = bounds;
+
+        if (into._gbv != nullptr && !bounds->is_infinite() &&
+            bounds->as_finite_bounding_volume() != nullptr) {
+          PT(BoundingVolume) net_bounds = bounds->make_copy();
+          net_bounds->as_geometric_bounding_volume()->xform(parent_net->get_mat());
+          const FiniteBoundingVolume *fbv = net_bounds->as_finite_bounding_volume();
+
+          PN_stdfloat margin = collision_broadphase_margin;
+          if (proxy._leaf >= 0) {
+            _bp_tree.move_leaf(proxy._leaf, fbv->get_min(), fbv->get_max(), margin);
+          } else {
+            proxy._leaf = _bp_tree.add_leaf(fbv->get_min(), fbv->get_max(), margin, index);
+          }
+
+        } else if (proxy._leaf >= 0) {
+          // The node no longer has a finite box; it goes in the unbounded
+          // list instead.
+          _bp_tree.remove_leaf(proxy._leaf);
+          proxy._leaf = -1;
+        }
+      }
+
+      if (proxy._leaf >= 0) {
+        _bp_tree.set_user_index(proxy._leaf, index);
+      } else {
+        _bp_unbounded.push_back(index);
+      }
+    }
+  }
+
+  if (node->has_single_child_visibility()) {
+    int num_children = node->get_num_children();
+    subtree._children.resize(num_children);
+    int index = node->get_visible_child();
+    if (index >= 0 && index < num_children) {
+      WorkingNodePath next_path(node_path, node->get_child(index));
+      r_update_broadphase(next_path, net, include_mask, from_mask,
+                          subtree._children[index], prev_intos);
+    }
+
+  } else if (node->is_lod_node()) {
+    // As in r_traverse_single(), only the lowest level of detail may be
+    // collided with as visible geometry.
+    int index = DCAST(LODNode, node)->get_lowest_switch();
+    PandaNode::Children children = node->get_children();
+    int num_children = children.get_num_children();
+    subtree._children.resize(num_children);
+    for (int i = 0; i < num_children; ++i) {
+      WorkingNodePath next_path(node_path, children.get_child(i));
+      CollideMask next_mask = include_mask;
+      if (i != index) {
+        next_mask &= ~GeomNode::get_default_collide_mask();
+      }
+      BroadphaseSubtree &child_subtree = subtree._children[i];
+      r_update_broadphase(next_path, net, next_mask, from_mask,
+                          child_subtree, prev_intos);
+      subtree._reusable = subtree._reusable && child_subtree._reusable;
+    }
+
+  } else {
+    PandaNode::Children children = node->get_children();
+    int num_children = children.get_num_children();
+    subtree._children.resize(num_children);
+    for (int i = 0; i < num_children; ++i) {
+      WorkingNodePath next_path(node_path, children.get_child(i));
+      BroadphaseSubtree &child_subtree = subtree._children[i];
+      r_update_broadphase(next_path, net, include_mask, from_mask,
+                          child_subtree, prev_intos);
+      subtree._reusable = subtree._reusable && child_subtree._reusable;
+    }
+  }
+
+  subtree._end = _bp_intos.size();
+}
+
+/**
+ * Fills up the list of collider solids for a broadphase traversal, in the
+ * same order as the other traversers would test them.
+ */
+void CollisionTraverser::
+prepare_colliders_broadphase(CollisionTraverser::BroadphaseColliders &colliders,
+                             const NodePath &root) {
+  int num_colliders = _colliders.size();
+  colliders.reserve(num_colliders);
+
+  int *indirect = (int *)alloca(sizeof(int) * num_colliders);
+  int i;
+  for (i = 0; i < num_colliders; ++i) {
+    indirect[i] = i;
+  }
+  std::sort(indirect, indirect + num_colliders, SortByColliderSort(*this));
+
+  NodePath root_parent = root.get_parent();
+
+  for (i = 0; i < num_colliders; ++i) {
+    OrderedColliderDef &ocd = _ordered_colliders[indirect[i]];
+    NodePath cnode_path = ocd._node_path;
+
+    if (!cnode_path.is_same_graph(root)) {
+      if (ocd._in_graph) {
+        // Only report this warning once.
+        collide_cat.info()
+          << "Collider " << cnode_path
+          << " is not in scene graph.  Ignoring.\n";
+        ocd._in_graph = false;
+      }
+      continue;
+    }
+
+    ocd._in_graph = true;
+    CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
+    if (cnode->get_from_collide_mask().is_zero()) {
+      continue;
+    }
+
+    Colliders::const_iterator ci = _colliders.find(cnode_path);
+    nassertd(ci != _colliders.end()) continue;
+
+    CPT(TransformState) net = cnode_path.get_transform(root_parent);
+    LPoint3 pos_delta = cnode_path.get_pos_delta(root);
+
+    int num_solids = cnode->get_num_solids();
+    for (int s = 0; s < num_solids; ++s) {
+      BroadphaseCollider collider;
+      collider._node = cnode;
+      collider._node_path = cnode_path;
+      collider._solid = cnode->get_solid(s);
+      collider._from_mask = cnode->get_from_collide_mask();
+      collider._handler = (*ci).second;
+      collider._net = net;
+
+      // The bounding volume is extended by the collider's motion, exactly as
+      // in CollisionLevelStateBase::prepare_collider().
+      CPT(BoundingVolume) bv = collider._solid->get_bounds();
+      if (bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
+        collider._bounds = DCAST(GeometricBoundingVolume, bv->make_copy());
+
+        if (bv->as_bounding_sphere() && pos_delta != LVector3::zero()) {
+          LMatrix4 inv_trans = LMatrix4::translate_mat(-pos_delta);
+          PT(GeometricBoundingVolume) gbv_prev;
+          gbv_prev = DCAST(GeometricBoundingVolume, bv->make_copy());
+
+          gbv_prev->xform(inv_trans);
+          collider._bounds->extend_by(gbv_prev);
+        }
+      }
+
+      colliders.push_back(std::move(collider));
+    }
+  }
+}
+
+/**
+ * Looks up the indicated collider solid in the broadphase tree, and tests it
+ * against each of the into-nodes it might intersect, passing any collisions
+ * to the indicated handler.  This may be called on several threads at once.
+ */
+void CollisionTraverser::
+compare_collider_to_broadphase(const BroadphaseCollider &collider,
+                               CollisionHandler *handler) {
+  pvector<int> intos;
+  if (collider._bounds == nullptr) {
+    // Without a bounding volume, the collider might collide with anything.
+    _bp_tree.query_all(intos);
+
+  } else {
+    if (collider._bounds->is_empty()) {
+      return;
+    }
+
+    PT(GeometricBoundingVolume) net_bounds =
+      DCAST(GeometricBoundingVolume, collider._bounds->make_copy());
+    net_bounds->xform(collider._net->get_mat());
+
+    const FiniteBoundingVolume *fbv = net_bounds->as_finite_bounding_volume();
+    const BoundingLine *line = net_bounds->as_bounding_line();
+    if (fbv != nullptr && !net_bounds->is_infinite()) {
+      _bp_tree.query_box(fbv->get_min(), fbv->get_max(), intos);
+    } else if (line != nullptr) {
+      _bp_tree.query_line(line->get_point_a(),
+                          line->get_point_b() - line->get_point_a(), intos);
+    } else {
+      _bp_tree.query_all(intos);
+    }
+  }
+
+  // The into-nodes are numbered in scene graph order, so this tests them in
+  // the order that the other traversers would.
+  intos.insert(intos.end(), _bp_unbounded.begin(), _bp_unbounded.end());
+  std::sort(intos.begin(), intos.end());
+
+  for (int i : intos) {
+    const BroadphaseInto &into = _bp_intos[i];
+    PandaNode *node = into._node_path.node();
+
+    // Don't test a node with itself.
+    if (node == collider._node ||
+        (collider._from_mask & into._into_mask).is_zero()) {
+      continue;
+    }
+
+    // Bring the collider's bounding volume into the space of the into-node's
+    // parent, in which the node's own bounds are expressed, and into the
+    // space of the into-node itself, for comparing to each solid.
+    PT(GeometricBoundingVolume) parent_gbv;
+    PT(GeometricBoundingVolume) node_gbv;
+    if (collider._bounds != nullptr) {
+      parent_gbv = DCAST(GeometricBoundingVolume, collider._bounds->make_copy());
+      parent_gbv->xform(into._parent_net->invert_compose(collider._net)->get_mat());
+      node_gbv = DCAST(GeometricBoundingVolume, collider._bounds->make_copy());
+      node_gbv->xform(into._net->invert_compose(collider._net)->get_mat());
+    }
+
+    CollisionEntry entry;
+    entry._from_node = collider._node;
+    entry._from_node_path = collider._node_path;
+    entry._from = collider._solid;
+    entry._into_node = node;
+    entry._into_node_path = into._node_path;
+    if (_respect_prev_transform) {
+      entry._flags |= CollisionEntry::F_respect_prev_transform;
+    }
+
+    if (node->is_collision_node()) {
+      compare_collider_to_node(entry, handler, parent_gbv, node_gbv, into._gbv);
+    } else {
+      compare_collider_to_geom_node(entry, handler, parent_gbv, node_gbv, into._gbv);
+    }
+  }
+}
+
 /**
  *
  */
 void CollisionTraverser::
-compare_collider_to_node(CollisionEntry &entry,
+compare_collider_to_node(CollisionEntry &entry, CollisionHandler *handler,
                          const GeometricBoundingVolume *from_parent_gbv,
                          const GeometricBoundingVolume *from_node_gbv,
                          const GeometricBoundingVolume *into_node_gbv) {
@@ -1148,10 +1719,7 @@ compare_collider_to_node(CollisionEntry &entry,
     // we just tested, is the same as the solid's bounding volume.)
     if (num_solids == 1) {
       entry._into = cnode->_solids[0].get_read_pointer(current_thread);
-      Colliders::const_iterator ci;
-      ci = _colliders.find(entry.get_from_node_path());
-      nassertv(ci != _colliders.end());
-      entry.test_intersection((*ci).second, this);
+      entry.test_intersection(handler, this);
     } else {
       CollisionNode::Solids::const_iterator si;
       for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
@@ -1167,7 +1735,7 @@ compare_collider_to_node(CollisionEntry &entry,
           solid_gbv = (const GeometricBoundingVolume *)solid_bv.p();
         }
 
-        compare_collider_to_solid(entry, from_node_gbv, solid_gbv);
+        compare_collider_to_solid(entry, handler, from_node_gbv, solid_gbv);
       }
     }
   }
@@ -1178,6 +1746,7 @@ compare_collider_to_node(CollisionEntry &entry,
  */
 void CollisionTraverser::
 compare_collider_to_geom_node(CollisionEntry &entry,
+                              CollisionHandler *handler,
                               const GeometricBoundingVolume *from_parent_gbv,
                               const GeometricBoundingVolume *from_node_gbv,
                               const GeometricBoundingVolume *into_node_gbv) {
@@ -1208,7 +1777,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
           DCAST_INTO_V(geom_gbv, geom_bv);
         }
 
-        compare_collider_to_geom(entry, geom, from_node_gbv, geom_gbv);
+        compare_collider_to_geom(entry, handler, geom, from_node_gbv, geom_gbv);
       }
     }
   }
@@ -1218,7 +1787,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_solid(CollisionEntry &entry,
+compare_collider_to_solid(CollisionEntry &entry, CollisionHandler *handler,
                           const GeometricBoundingVolume *from_node_gbv,
                           const GeometricBoundingVolume *solid_gbv) {
   bool within_solid_bounds = true;
@@ -1238,10 +1807,7 @@ compare_collider_to_solid(CollisionEntry &entry,
 #endif  // NDEBUG
   }
   if (within_solid_bounds) {
-    Colliders::const_iterator ci;
-    ci = _colliders.find(entry.get_from_node_path());
-    nassertv(ci != _colliders.end());
-    entry.test_intersection((*ci).second, this);
+    entry.test_intersection(handler, this);
   }
 }
 
@@ -1249,7 +1815,8 @@ compare_collider_to_solid(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
+compare_collider_to_geom(CollisionEntry &entry, CollisionHandler *handler,
+                         const Geom *geom,
                          const GeometricBoundingVolume *from_node_gbv,
                          const GeometricBoundingVolume *geom_gbv) {
   bool within_geom_bounds = true;
@@ -1259,10 +1826,6 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
     _geom_volume_pcollector.add_level(1);
   }
   if (within_geom_bounds) {
-    Colliders::const_iterator ci;
-    ci = _colliders.find(entry.get_from_node_path());
-    nassertv(ci != _colliders.end());
-
     if (geom->get_primitive_type() == Geom::PT_polygons) {
       Thread *current_thread = Thread::get_current_thread();
       CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
@@ -1302,7 +1865,7 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
               if (within_solid_bounds) {
                 PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
                 entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
+                entry.test_intersection(handler, this);
               }
             }
           }
@@ -1332,7 +1895,7 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
               if (within_solid_bounds) {
                 PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
                 entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
+                entry.test_intersection(handler, this);
               }
             }
           }
@@ -18,11 +18,13 @@
 
 #include "collisionHandler.h"
 #include "collisionLevelState.h"
+#include "collisionBroadphase.h"
 
 #include "pointerTo.h"
 #include "pStatCollector.h"
 
 #include "pset.h"
+#include "pmap.h"
 #include "register_type.h"
 #include "extension.h"
 
@@ -53,6 +55,10 @@ PUBLISHED:
   MAKE_PROPERTY(respect_prev_transform, get_respect_prev_transform,
                                         set_respect_prev_transform);
 
+  void set_broadphase(bool flag);
+  INLINE bool get_broadphase() const;
+  MAKE_PROPERTY(broadphase, get_broadphase, set_broadphase);
+
   void add_collider(const NodePath &collider, CollisionHandler *handler);
   bool remove_collider(const NodePath &collider);
   bool has_collider(const NodePath &collider) const;
@@ -96,18 +102,40 @@ private:
   void prepare_colliders_quad(LevelStatesQuad &level_states, const NodePath &root);
   void r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass);
 
+  class BroadphaseCollider;
+  class BroadphaseRun;
+  typedef pvector<BroadphaseCollider> BroadphaseColliders;
+  void traverse_broadphase(const NodePath &root);
+  void update_broadphase(const NodePath &root, CollideMask from_mask);
+  class BroadphaseInto;
+  class BroadphaseSubtree;
+  void r_update_broadphase(const WorkingNodePath &node_path,
+                           const TransformState *parent_net,
+                           CollideMask include_mask, CollideMask from_mask,
+                           BroadphaseSubtree &subtree,
+                           const pvector<BroadphaseInto> &prev_intos);
+  void prepare_colliders_broadphase(BroadphaseColliders &colliders,
+                                    const NodePath &root);
+  void compare_collider_to_broadphase(const BroadphaseCollider &collider,
+                                      CollisionHandler *handler);
+  static void broadphase_run(size_t n, void *user_data);
+
   void compare_collider_to_node(CollisionEntry &entry,
+                                CollisionHandler *handler,
                                 const GeometricBoundingVolume *from_parent_gbv,
                                 const GeometricBoundingVolume *from_node_gbv,
                                 const GeometricBoundingVolume *into_node_gbv);
   void compare_collider_to_geom_node(CollisionEntry &entry,
+                                     CollisionHandler *handler,
                                      const GeometricBoundingVolume *from_parent_gbv,
                                      const GeometricBoundingVolume *from_node_gbv,
                                      const GeometricBoundingVolume *into_node_gbv);
   void compare_collider_to_solid(CollisionEntry &entry,
+                                 CollisionHandler *handler,
                                  const GeometricBoundingVolume *from_node_gbv,
                                  const GeometricBoundingVolume *solid_gbv);
-  void compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
+  void compare_collider_to_geom(CollisionEntry &entry,
+                                CollisionHandler *handler, const Geom *geom,
                                 const GeometricBoundingVolume *from_node_gbv,
                                 const GeometricBoundingVolume *solid_gbv);
 
@@ -133,6 +161,60 @@ private:
   Handlers::iterator remove_handler(Handlers::iterator hi);
 
   bool _respect_prev_transform;
+
+  // The state of the broadphase, kept from one traversal to the next.  There
+  // is an entry in _bp_intos for each into-node found under the root by the
+  // last traversal, in scene graph order, and an entry in _bp_proxies for
+  // each into-node that has been found by any recent traversal.
+  class BroadphaseProxy {
+  public:
+    int _leaf = -1;
+    int _seq = 0;
+    CPT(TransformState) _parent_net;
+    CPT(BoundingVolume) _bounds;
+  };
+  typedef pmap<NodePath, BroadphaseProxy> BroadphaseProxies;
+
+  class BroadphaseInto {
+  public:
+    NodePath _node_path;
+    CPT(TransformState) _parent_net;
+    CPT(TransformState) _net;
+    CPT(BoundingVolume) _bounds;
+    const GeometricBoundingVolume *_gbv;
+    CollideMask _into_mask;
+    BroadphaseProxy *_proxy;
+  };
+  typedef pvector<BroadphaseInto> BroadphaseIntos;
+
+  // What the last traversal found at and below one node that it visited: the
+  // range of _bp_intos that came from there, and what the node looked like.
+  // These form a tree of the same shape as the visited part of the graph.  If
+  // the node's bounds seq and transform have not changed since, nothing below
+  // it has either, and its into-nodes can be taken over as they are.
+  class BroadphaseSubtree {
+  public:
+    PT(PandaNode) _node;
+    int _seq = 0;
+    UpdateSeq _bounds_seq;
+    CPT(TransformState) _parent_net;
+    CPT(TransformState) _transform;
+    CollideMask _include_mask;
+    bool _reusable = false;
+    size_t _begin = 0;
+    size_t _end = 0;
+    pvector<BroadphaseSubtree> _children;
+  };
+
+  bool _broadphase;
+  NodePath _bp_root;
+  int _bp_seq;
+  CollisionBroadphase _bp_tree;
+  BroadphaseIntos _bp_intos;
+  BroadphaseProxies _bp_proxies;
+  pvector<int> _bp_unbounded;
+  BroadphaseSubtree _bp_subtree;
+  CollideMask _bp_from_mask;
 #ifdef DO_COLLISION_RECORDING
   CollisionRecorder *_recorder;
   NodePath _collision_visualizer_np;
@@ -149,6 +231,8 @@ private:
   static PStatCollector _geom_volume_pcollector;
 
   PStatCollector _this_pcollector;
+  PStatCollector _bp_update_pcollector;
+  PStatCollector _bp_collide_pcollector;
   typedef pvector<PStatCollector> PassCollectors;
   PassCollectors _pass_collectors;
   // pstats category for actual collision detection (vs.  bounding heirarchy
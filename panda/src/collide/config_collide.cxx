@@ -111,6 +111,30 @@ ConfigVariableBool pushers_horizontal
           "set_horizontal() flag by default, false to let the move "
           "in three dimensions by default."));
 
+ConfigVariableBool collision_broadphase
+("collision-broadphase", false,
+ PRC_DESC("Set this true to make all CollisionTraversers use broadphase "
+          "mode by default.  In this mode, the traverser keeps a tree of "
+          "the bounding boxes of all of the into-nodes under the root, which "
+          "it updates each traversal, and looks up each collider in the tree "
+          "instead of walking the scene graph.  This is much faster when "
+          "there are many colliders and many into-nodes.  See "
+          "CollisionTraverser::set_broadphase()."));
+
+ConfigVariableInt collision_broadphase_threads
+("collision-broadphase-threads", 0,
+ PRC_DESC("The number of extra threads that a CollisionTraverser in "
+          "broadphase mode uses to test its colliders.  The handlers still "
+          "receive the collisions on the thread that calls traverse(), in "
+          "the same order."));
+
+ConfigVariableDouble collision_broadphase_margin
+("collision-broadphase-margin", 0.5,
+ PRC_DESC("The distance, in the units of the traversal root, by which the "
+          "boxes in a CollisionTraverser's broadphase tree are enlarged, so "
+          "that a node that moves less than this from one traversal to the "
+          "next need not be moved within the tree."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
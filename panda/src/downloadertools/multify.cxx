@@ -47,6 +47,7 @@ bool got_header_prefix = false;
 Filename chdir_to;             // -C
 bool got_chdir_to = false;
 size_t scale_factor = 0;       // -F
+int block_size = -1;           // -B
 pset<string> dont_compress;    // -Z
 pset<string> text_ext;         // -X
 vector_string sign_params;     // -S
@@ -198,6 +199,15 @@ help() {
     "      size of the Multifile will be limited to 4GB * scale_factor.  The size\n"
     "      of individual subfiles may not exceed 4GB in any case.\n\n"
 
+    "  -B <block_size>\n"
+    "      With -z, compress each subfile in independent blocks of the indicated\n"
+    "      size in bytes, so that it can later be read starting from any point\n"
+    "      without decompressing what comes before, and decompressed on several\n"
+    "      threads at once.  A block size of 0 compresses each subfile as a single\n"
+    "      stream, which is a little smaller.  The default is taken from the\n"
+    "      multifile-compression-block-size Config variable.  This does not apply\n"
+    "      to encrypted subfiles.\n\n"
+
     "  -C <extract_dir>\n"
 
     "      Change to the named directory before working on files;\n"
@@ -408,6 +418,10 @@ add_files(const vector_string &params) {
     multifile->set_scale_factor(scale_factor);
   }
 
+  if (block_size >= 0) {
+    multifile->set_compression_block_size((size_t)block_size);
+  }
+
   pvector<Filename> filenames;
   filenames.reserve(params.size());
   vector_string::const_iterator si;
@@ -781,7 +795,7 @@ main(int argc, char **argv) {
 
   extern char *optarg;
   extern int optind;
-  static const char *optflags = "crutxkvz123456789Z:T:X:S:f:OC:ep:P:F:h";
+  static const char *optflags = "crutxkvz123456789Z:T:X:S:f:OC:ep:P:F:B:h";
   int flag = getopt(argc, argv, optflags);
   Filename rel_path;
   while (flag != EOF) {
@@ -907,6 +921,18 @@ main(int argc, char **argv) {
       }
       break;
 
+    case 'B':
+      {
+        char *endptr;
+        block_size = strtol(optarg, &endptr, 10);
+        if (*endptr != '\0' || block_size < 0) {
+          cerr << "Invalid block size: " << optarg << "\n";
+          usage();
+          return 1;
+        }
+      }
+      break;
+
     case 'h':
       help();
       return 1;
@@ -24,6 +24,7 @@
 #include "animBundleNode.h"
 #include "animChannelMatrixXfmTable.h"
 #include "animChannelScalarTable.h"
+#include "config_chan.h"
 
 using std::min;
 
@@ -314,5 +315,9 @@ create_xfm_channel(EggXfmSAnim *egg_anim, const std::string &name,
     }
   }
 
+  if (compress_anim_tables) {
+    table->compress_tables(anim_table_tolerance);
+  }
+
   return table;
 }
@@ -40,6 +40,10 @@ AsyncTask(const string &name) :
   _chain(nullptr),
   _start_time(0.0),
   _start_frame(0),
+  _wheel_prev(nullptr),
+  _wheel_next(nullptr),
+  _wheel_tick(0),
+  _wheel_slot(-1),
   _dt(0.0),
   _max_dt(0.0),
   _total_dt(0.0),
@@ -131,11 +135,13 @@ recalc_wake_time() {
     MutexHolder holder(_manager->_lock);
     if (_state == S_sleeping) {
       double now = _manager->_clock->get_frame_time();
+
+      // The task has to be moved to the slot for its new wake time.
+      PT(AsyncTask) hold_task = this;
+      _chain->_sleeping.remove(this);
       _wake_time = now + _delay;
       _start_time = _wake_time;
-
-      make_heap(_chain->_sleeping.begin(), _chain->_sleeping.end(),
-                AsyncTaskChain::AsyncTaskSortWakeTime());
+      _chain->_sleeping.add(this);
     }
   }
 }
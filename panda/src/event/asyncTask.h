@@ -149,6 +149,12 @@ protected:
   double _start_time;
   int _start_frame;
 
+  // Used by AsyncTaskTimerWheel while the task is sleeping.
+  AsyncTask *_wheel_prev;
+  AsyncTask *_wheel_next;
+  int64_t _wheel_tick;
+  int _wheel_slot;
+
   double _dt;
   double _max_dt;
   double _total_dt;
@@ -182,6 +188,7 @@ private:
   friend class AsyncTaskManager;
   friend class AsyncTaskChain;
   friend class AsyncTaskSequence;
+  friend class AsyncTaskTimerWheel;
 };
 
 INLINE std::ostream &operator << (std::ostream &out, const AsyncTask &task) {
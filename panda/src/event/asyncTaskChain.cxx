@@ -13,6 +13,7 @@
 
 #include "asyncTaskChain.h"
 #include "asyncTaskManager.h"
+#include "genericAsyncTask.h"
 #include "event.h"
 #include "mutexHolder.h"
 #include "indent.h"
@@ -32,6 +33,43 @@ TypeHandle AsyncTaskChain::_type_handle;
 
 PStatCollector AsyncTaskChain::_task_pcollector("Task");
 PStatCollector AsyncTaskChain::_wait_pcollector("Wait");
+PStatCollector AsyncTaskChain::_parallel_wait_pcollector("Wait:Parallel tasks");
+
+namespace {
+  // The state shared by the threads taking part in one parallel_for().
+  struct ParallelRange {
+    AsyncTaskChain::ParallelFunction *_function;
+    void *_user_data;
+    AtomicAdjust::Integer _count;
+    TVOLATILE AtomicAdjust::Integer _next;
+    int _pipeline_stage;
+  };
+
+  // Calls the function for each index that no other thread has claimed yet.
+  void
+  run_parallel_range(ParallelRange *range) {
+    AtomicAdjust::Integer n;
+    while ((n = AtomicAdjust::add(range->_next, 1) - 1) < range->_count) {
+      range->_function((size_t)n, range->_user_data);
+    }
+  }
+
+  // The task function that runs parallel_for() on one of the chain's threads.
+  AsyncTask::DoneStatus
+  parallel_range_task(GenericAsyncTask *task, void *user_data) {
+    ParallelRange *range = (ParallelRange *)user_data;
+
+    // The work is done on behalf of the thread that called parallel_for(),
+    // so it should see the scene graph as that thread sees it.
+    Thread *current_thread = Thread::get_current_thread();
+    if (current_thread->get_pipeline_stage() != range->_pipeline_stage) {
+      current_thread->set_pipeline_stage(range->_pipeline_stage);
+    }
+
+    run_parallel_range(range);
+    return AsyncTask::DS_done;
+  }
+}
 
 /**
  *
@@ -400,6 +438,64 @@ write(ostream &out, int indent_level) const {
   do_write(out, indent_level);
 }
 
+/**
+ * Calls function(n, user_data) once for each n from 0 to count - 1, sharing
+ * the calls between the threads of this chain and the calling thread, and
+ * returns when all of them have finished.  The calls are made in no
+ * particular order, and any number of them may be made at once, so the
+ * function must be safe to call from several threads.  Each thread reads
+ * the pipeline stage of the calling thread.
+ *
+ * This is intended for splitting up work that must be done before the
+ * calling thread can continue, such as part of a frame.  Typically, the work
+ * is first divided into a run for each thread plus one for the calling
+ * thread, which it takes part in so that it does not merely sit waiting.  If
+ * the chain has no threads, or the count is less than 2, everything is done
+ * on the calling thread.  See also AsyncTaskManager::make_worker_chain().
+ */
+void AsyncTaskChain::
+parallel_for(size_t count, ParallelFunction *function, void *user_data) {
+  size_t num_tasks = 0;
+  if (count > 1 && Thread::is_threading_supported()) {
+    num_tasks = std::min((size_t)std::max(get_num_threads(), 0), count - 1);
+  }
+  if (num_tasks == 0) {
+    for (size_t n = 0; n < count; ++n) {
+      function(n, user_data);
+    }
+    return;
+  }
+
+  ParallelRange range;
+  range._function = function;
+  range._user_data = user_data;
+  range._count = (AtomicAdjust::Integer)count;
+  range._next = 0;
+  range._pipeline_stage = Thread::get_current_pipeline_stage();
+
+  pvector<PT(AsyncTask)> tasks;
+  tasks.reserve(num_tasks);
+  for (size_t ti = 0; ti < num_tasks; ++ti) {
+    PT(AsyncTask) task =
+      new GenericAsyncTask(get_name(), &parallel_range_task, &range);
+    task->set_task_chain(get_name());
+    _manager->add(task);
+    tasks.push_back(task);
+  }
+
+  run_parallel_range(&range);
+
+  // Everything has been claimed by now.  A task that no thread has picked up
+  // yet has nothing left to do, so rather than waiting for a thread to come
+  // around to it, which might never happen if they are all busy, it is
+  // simply removed.
+  PStatTimer timer(_parallel_wait_pcollector);
+  for (AsyncTask *task : tasks) {
+    task->remove();
+    task->wait();
+  }
+}
+
 /**
  * Adds the indicated task to the active queue.  It is an error if the task is
  * already added to this or any other active queue.
@@ -413,7 +509,9 @@ do_add(AsyncTask *task) {
            task->_manager == nullptr &&
            task->_chain_name == get_name() &&
            task->_state == AsyncTask::S_inactive);
+#ifdef _DEBUG
   nassertv(!do_has_task(task));
+#endif
 
   do_start_threads();
 
@@ -434,8 +532,7 @@ do_add(AsyncTask *task) {
     task->_wake_time = now + task->get_delay();
     task->_start_time = task->_wake_time;
     task->_state = AsyncTask::S_sleeping;
-    _sleeping.push_back(task);
-    push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
+    _sleeping.add(task);
 
   } else {
     // This is an active task.  Add it to the active set.
@@ -484,11 +581,9 @@ do_remove(AsyncTask *task, bool upon_death) {
   case AsyncTask::S_sleeping:
     // Sleeping, easy.
     {
-      int index = find_task_on_heap(_sleeping, task);
-      nassertr(index != -1, false);
+      nassertr(_sleeping.contains(task), false);
       PT(AsyncTask) hold_task = task;
-      _sleeping.erase(_sleeping.begin() + index);
-      make_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
+      _sleeping.remove(task);
       cleanup_task(task, upon_death, false);
     }
     return true;
@@ -591,7 +686,9 @@ do_cleanup() {
     dead.push_back(task);
     cleanup_task(task, false, false);
   }
-  for (ti = _sleeping.begin(); ti != _sleeping.end(); ++ti) {
+  TaskHeap sleeping;
+  _sleeping.pop_all(sleeping);
+  for (ti = sleeping.begin(); ti != sleeping.end(); ++ti) {
     AsyncTask *task = (*ti);
     dead.push_back(task);
     cleanup_task(task, false, false);
@@ -623,7 +720,7 @@ bool AsyncTaskChain::
 do_has_task(AsyncTask *task) const {
   return (find_task_on_heap(_active, task) != -1 ||
           find_task_on_heap(_next_active, task) != -1 ||
-          find_task_on_heap(_sleeping, task) != -1 ||
+          _sleeping.contains(task) ||
           find_task_on_heap(_this_active, task) != -1);
 }
 
@@ -706,8 +803,7 @@ service_one_task(AsyncTaskChain::AsyncTaskChainThread *thread) {
             task->_wake_time = now + task->get_delay();
             task->_start_time = task->_wake_time;
             task->_state = AsyncTask::S_sleeping;
-            _sleeping.push_back(task);
-            push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
+            _sleeping.add(task);
             if (task_cat.is_spam()) {
               task_cat.spam()
                 << "Sleeping " << *task << ", wake time at "
@@ -880,15 +976,14 @@ finish_sort_group() {
 
     // Check for any sleeping tasks that need to be woken.
     double now = _manager->_clock->get_frame_time();
-    while (!_sleeping.empty() && _sleeping.front()->_wake_time <= now) {
-      PT(AsyncTask) task = _sleeping.front();
+    TaskHeap woken;
+    _sleeping.pop_due(now, woken);
+    for (AsyncTask *task : woken) {
       if (task_cat.is_spam()) {
         task_cat.spam()
           << "Waking " << *task << ", wake time at "
           << task->_wake_time - now << "\n";
       }
-      pop_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
-      _sleeping.pop_back();
       task->_state = AsyncTask::S_active;
       task->_start_frame = _manager->_clock->get_frame_count();
       _active.push_back(task);
@@ -900,8 +995,8 @@ finish_sort_group() {
           << "No more tasks on sleeping queue.\n";
       } else {
         task_cat.spam()
-          << "Next sleeper: " << *_sleeping.front() << ", wake time at "
-          << _sleeping.front()->_wake_time - now << "\n";
+          << "Next sleeper wakes at "
+          << _sleeping.get_next_wake_time() - now << "\n";
       }
     }
 
@@ -1132,8 +1227,10 @@ AsyncTaskCollection AsyncTaskChain::
 do_get_sleeping_tasks() const {
   AsyncTaskCollection result;
 
+  TaskHeap sleeping;
+  _sleeping.get_tasks(sleeping);
   TaskHeap::const_iterator ti;
-  for (ti = _sleeping.begin(); ti != _sleeping.end(); ++ti) {
+  for (ti = sleeping.begin(); ti != sleeping.end(); ++ti) {
     AsyncTask *task = (*ti);
     result.add_task(task);
   }
@@ -1312,10 +1409,12 @@ do_write(ostream &out, int indent_level) const {
     }
   }
 
-  // Instead of iterating through the _sleeping list in heap order, copy it
-  // and then use repeated pops to get it out in sorted order, for the user's
-  // satisfaction.
-  TaskHeap sleeping = _sleeping;
+  // The sleeping tasks are not kept in any particular order, so copy them
+  // into a heap and then use repeated pops to get them out in sorted order,
+  // for the user's satisfaction.
+  TaskHeap sleeping;
+  _sleeping.get_tasks(sleeping);
+  make_heap(sleeping.begin(), sleeping.end(), AsyncTaskSortWakeTime());
   while (!sleeping.empty()) {
     PT(AsyncTask) task = sleeping.front();
     pop_heap(sleeping.begin(), sleeping.end(), AsyncTaskSortWakeTime());
@@ -18,6 +18,7 @@
 
 #include "asyncTask.h"
 #include "asyncTaskCollection.h"
+#include "asyncTaskTimerWheel.h"
 #include "typedReferenceCount.h"
 #include "thread.h"
 #include "conditionVar.h"
@@ -91,6 +92,10 @@ PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent_level = 0) const;
 
+public:
+  typedef void ParallelFunction(size_t n, void *user_data);
+  void parallel_for(size_t count, ParallelFunction *function, void *user_data);
+
 protected:
   class AsyncTaskChainThread;
   typedef pvector< PT(AsyncTask) > TaskHeap;
@@ -181,7 +186,7 @@ protected:
   TaskHeap _active;
   TaskHeap _this_active;
   TaskHeap _next_active;
-  TaskHeap _sleeping;
+  AsyncTaskTimerWheel _sleeping;
   State _state;
   int _current_sort;
   bool _pickup_mode;
@@ -195,6 +200,7 @@ protected:
 
   static PStatCollector _task_pcollector;
   static PStatCollector _wait_pcollector;
+  static PStatCollector _parallel_wait_pcollector;
 
 public:
   static TypeHandle get_class_type() {
@@ -131,6 +131,25 @@ make_task_chain(const string &name) {
   return do_make_task_chain(name);
 }
 
+/**
+ * Returns the AsyncTaskChain of the indicated name, creating it if necessary,
+ * after making sure that it has the indicated number of threads, running at
+ * the indicated priority.  This is meant for the chains that several threads
+ * use to share work through AsyncTaskChain::parallel_for(), each of which is
+ * sized by a config variable of its own.
+ */
+AsyncTaskChain *AsyncTaskManager::
+make_worker_chain(const string &name, int num_threads,
+                  ThreadPriority priority) {
+  AsyncTaskChain *chain = make_task_chain(name);
+  if (chain->get_num_threads() != num_threads ||
+      chain->get_thread_priority() != priority) {
+    chain->set_num_threads(num_threads);
+    chain->set_thread_priority(priority);
+  }
+  return chain;
+}
+
 /**
  * Searches a new AsyncTaskChain of the indicated name and returns it if it
  * exists, or NULL otherwise.
@@ -198,16 +217,23 @@ add(AsyncTask *task) {
       }
     }
 
+    // Searching every chain for the task is slow with many tasks, and the
+    // state check already catches the same mistakes, so only do it in a debug
+    // build.
     nassertv(task->_manager == nullptr &&
              task->_state == AsyncTask::S_inactive);
+#ifdef _DEBUG
     nassertv(!do_has_task(task));
+#endif
 
     _lock.unlock();
     task->upon_birth(this);
     _lock.lock();
     nassertv(task->_manager == nullptr &&
              task->_state == AsyncTask::S_inactive);
+#ifdef _DEBUG
     nassertv(!do_has_task(task));
+#endif
 
     AsyncTaskChain *chain = do_find_task_chain(task->_chain_name);
     if (chain == nullptr) {
@@ -253,6 +279,7 @@ AsyncTask *AsyncTaskManager::
 find_task(const string &name) const {
   AsyncTask sample_task(name);
   sample_task.local_object();
+  sample_task._task_id = -1;
 
   TasksByName::const_iterator tbni = _tasks_by_name.lower_bound(&sample_task);
   if (tbni != _tasks_by_name.end() && (*tbni)->get_name() == name) {
@@ -269,6 +296,7 @@ AsyncTaskCollection AsyncTaskManager::
 find_tasks(const string &name) const {
   AsyncTask sample_task(name);
   sample_task.local_object();
+  sample_task._task_id = -1;
 
   TasksByName::const_iterator tbni = _tasks_by_name.lower_bound(&sample_task);
   AsyncTaskCollection result;
@@ -289,6 +317,7 @@ find_tasks_matching(const GlobPattern &pattern) const {
   string prefix = pattern.get_const_prefix();
   AsyncTask sample_task(prefix);
   sample_task.local_object();
+  sample_task._task_id = -1;
 
   TasksByName::const_iterator tbni = _tasks_by_name.lower_bound(&sample_task);
   AsyncTaskCollection result;
@@ -593,19 +622,10 @@ do_find_task_chain(const string &name) {
 void AsyncTaskManager::
 remove_task_by_name(AsyncTask *task) {
   if (!task->get_name().empty()) {
-    // We have to scan linearly through all of the tasks with the same name.
-    TasksByName::iterator tbni = _tasks_by_name.lower_bound(task);
-    while (tbni != _tasks_by_name.end()) {
-      if ((*tbni) == task) {
-        _tasks_by_name.erase(tbni);
-        return;
-      }
-      if ((*tbni)->get_name() != task->get_name()) {
-        // Too far.
-        break;
-      }
-
-      ++tbni;
+    TasksByName::iterator tbni = _tasks_by_name.find(task);
+    if (tbni != _tasks_by_name.end() && (*tbni) == task) {
+      _tasks_by_name.erase(tbni);
+      return;
     }
 
     // For some reason, the task wasn't on the index.
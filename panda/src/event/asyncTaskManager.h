@@ -95,6 +95,10 @@ PUBLISHED:
 
   INLINE static AsyncTaskManager *get_global_ptr();
 
+public:
+  AsyncTaskChain *make_worker_chain(const std::string &name, int num_threads,
+                                    ThreadPriority priority = TP_high);
+
 protected:
   AsyncTaskChain *do_make_task_chain(const std::string &name);
   AsyncTaskChain *do_find_task_chain(const std::string &name);
@@ -110,10 +114,16 @@ private:
   static void make_global_ptr();
 
 protected:
+  // Tasks with the same name are ordered by id, so that any one task can be
+  // found on the index directly.
   class AsyncTaskSortName {
   public:
     bool operator () (AsyncTask *a, AsyncTask *b) const {
-      return a->get_name() < b->get_name();
+      int compare = a->get_name().compare(b->get_name());
+      if (compare != 0) {
+        return compare < 0;
+      }
+      return a->_task_id < b->_task_id;
     }
   };
 
@@ -0,0 +1,354 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncTaskTimerWheel.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "asyncTaskTimerWheel.h"
+#include "pbitops.h"
+
+const double AsyncTaskTimerWheel::_ticks_per_second = 1024.0;
+
+/**
+ *
+ */
+AsyncTaskTimerWheel::
+AsyncTaskTimerWheel() :
+  _current_tick(0),
+  _size(0),
+  _next_wake_time(-1.0),
+  _next_wake_time_valid(false)
+{
+  for (int i = 0; i <= overflow_slot; ++i) {
+    _slots[i] = nullptr;
+  }
+  for (int l = 0; l < num_levels; ++l) {
+    _occupied[l] = 0;
+  }
+}
+
+/**
+ *
+ */
+AsyncTaskTimerWheel::
+~AsyncTaskTimerWheel() {
+  Tasks tasks;
+  pop_all(tasks);
+}
+
+/**
+ * Adds a task to the wheel, to be woken at its _wake_time.  The wheel holds a
+ * reference to the task until it is removed again.
+ */
+void AsyncTaskTimerWheel::
+add(AsyncTask *task) {
+  nassertv(task->_wheel_slot == -1);
+  task->ref();
+  task->_wheel_tick = get_tick(task->_wake_time);
+  place(task);
+
+  if (_size == 0) {
+    _next_wake_time = task->_wake_time;
+    _next_wake_time_valid = true;
+  } else if (_next_wake_time_valid) {
+    _next_wake_time = std::min(_next_wake_time, task->_wake_time);
+  }
+  ++_size;
+}
+
+/**
+ * Removes a task that was added with add().  The caller should hold its own
+ * reference to the task.
+ */
+void AsyncTaskTimerWheel::
+remove(AsyncTask *task) {
+#ifdef _DEBUG
+  nassertv(contains(task));
+#else
+  nassertv(task->_wheel_slot >= 0);
+#endif
+
+  unlink(task);
+  --_size;
+  if (_next_wake_time_valid && task->_wake_time <= _next_wake_time) {
+    _next_wake_time_valid = false;
+  }
+  unref_delete(task);
+}
+
+/**
+ * Returns true if the task is on this wheel.
+ */
+bool AsyncTaskTimerWheel::
+contains(AsyncTask *task) const {
+  int slot = task->_wheel_slot;
+  if (slot < 0 || slot > overflow_slot) {
+    return false;
+  }
+  for (AsyncTask *t = _slots[slot]; t != nullptr; t = t->_wheel_next) {
+    if (t == task) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Removes all of the tasks whose wake time is at or before the indicated
+ * time, and appends them to the result, in no particular order.
+ */
+void AsyncTaskTimerWheel::
+pop_due(double now, Tasks &result) {
+  int64_t target = get_tick(now);
+  if (_size == 0) {
+    _current_tick = target;
+    return;
+  }
+  if (target < _current_tick) {
+    // The clock has gone backwards.  Start over from the new time.
+    rebuild(target);
+  }
+
+  size_t orig_size = _size;
+  while (true) {
+    // Wake the tasks in the first-level slots up to the target tick, or to
+    // the end of the current group of ticks if the target is beyond it.  The
+    // tasks in the target tick's own slot have to be checked one by one.
+    bool same_group = ((_current_tick ^ target) >> slot_bits) == 0;
+    int first = (int)(_current_tick & (num_slots - 1));
+    int last = same_group ? (int)(target & (num_slots - 1)) : num_slots - 1;
+    uint64_t mask = (~(uint64_t)0 >> (num_slots - 1 - last)) & (~(uint64_t)0 << first);
+
+    uint64_t bits = _occupied[0] & mask;
+    while (bits != 0) {
+      int slot = get_lowest_on_bit((unsigned long long)bits);
+      bits &= bits - 1;
+
+      AsyncTask *task = _slots[slot];
+      while (task != nullptr) {
+        AsyncTask *next = task->_wheel_next;
+        if (task->_wheel_tick < target || task->_wake_time <= now) {
+          unlink(task);
+          --_size;
+          result.push_back(task);
+          task->unref();
+        }
+        task = next;
+      }
+    }
+
+    if (same_group) {
+      _current_tick = target;
+      break;
+    }
+
+    // Skip ahead to the next tick at which a higher-level slot comes due.  If
+    // that's beyond the target, there's nothing more to wake.
+    int64_t next = get_next_cascade_tick();
+    if (next > target) {
+      _current_tick = target;
+      break;
+    }
+    _current_tick = next;
+    cascade();
+  }
+
+  if (_size != orig_size) {
+    _next_wake_time_valid = false;
+  }
+}
+
+/**
+ * Removes all of the tasks, and appends them to the result.
+ */
+void AsyncTaskTimerWheel::
+pop_all(Tasks &result) {
+  result.reserve(result.size() + _size);
+  for (int i = 0; i <= overflow_slot; ++i) {
+    AsyncTask *task = _slots[i];
+    while (task != nullptr) {
+      AsyncTask *next = task->_wheel_next;
+      task->_wheel_prev = nullptr;
+      task->_wheel_next = nullptr;
+      task->_wheel_slot = -1;
+      result.push_back(task);
+      task->unref();
+      task = next;
+    }
+    _slots[i] = nullptr;
+  }
+  for (int l = 0; l < num_levels; ++l) {
+    _occupied[l] = 0;
+  }
+  _size = 0;
+  _next_wake_time_valid = false;
+}
+
+/**
+ * Appends all of the tasks to the result, in no particular order.
+ */
+void AsyncTaskTimerWheel::
+get_tasks(Tasks &result) const {
+  result.reserve(result.size() + _size);
+  for (int i = 0; i <= overflow_slot; ++i) {
+    for (AsyncTask *task = _slots[i]; task != nullptr; task = task->_wheel_next) {
+      result.push_back(task);
+    }
+  }
+}
+
+/**
+ * Returns the earliest wake time of all of the tasks, or -1 if there are no
+ * tasks.
+ */
+double AsyncTaskTimerWheel::
+get_next_wake_time() const {
+  if (_size == 0) {
+    return -1.0;
+  }
+
+  if (!_next_wake_time_valid) {
+    // The earliest task is in the first occupied slot of the lowest occupied
+    // level, since every slot covers earlier ticks than the slots after it
+    // and the levels above it.
+    AsyncTask *list = nullptr;
+    for (int l = 0; l < num_levels && list == nullptr; ++l) {
+      if (_occupied[l] != 0) {
+        list = _slots[l * num_slots + get_lowest_on_bit((unsigned long long)_occupied[l])];
+      }
+    }
+    if (list == nullptr) {
+      list = _slots[overflow_slot];
+    }
+    _next_wake_time = get_earliest(list);
+    _next_wake_time_valid = true;
+  }
+  return _next_wake_time;
+}
+
+/**
+ * Puts the task in the slot appropriate for its tick, relative to the current
+ * tick.  A task whose tick has already passed goes in the current slot.
+ */
+void AsyncTaskTimerWheel::
+place(AsyncTask *task) {
+  int64_t tick = std::max(task->_wheel_tick, _current_tick);
+
+  // The level is determined by the highest group of bits in which the tick
+  // differs from the current tick.
+  uint64_t diff = (uint64_t)(tick ^ _current_tick);
+  int level = (diff == 0) ? 0 : get_highest_on_bit((unsigned long long)diff) / slot_bits;
+  if (level >= num_levels) {
+    link(task, overflow_slot);
+  } else {
+    int index = (int)((tick >> (level * slot_bits)) & (num_slots - 1));
+    link(task, level * num_slots + index);
+  }
+}
+
+/**
+ * Called when the current tick has just advanced to the start of a group of
+ * ticks, to move the tasks in the slots that have now come due down to the
+ * lower levels.
+ */
+void AsyncTaskTimerWheel::
+cascade() {
+  // Work from the top down, since a task moved out of a higher level may land
+  // in the slot of a lower level that is about to be redistributed too.
+  const int64_t top_mask = ((int64_t)1 << (num_levels * slot_bits)) - 1;
+  if ((_current_tick & top_mask) == 0) {
+    AsyncTask *task = _slots[overflow_slot];
+    _slots[overflow_slot] = nullptr;
+    while (task != nullptr) {
+      AsyncTask *next = task->_wheel_next;
+      place(task);
+      task = next;
+    }
+  }
+
+  for (int l = num_levels - 1; l >= 1; --l) {
+    int shift = l * slot_bits;
+    if ((_current_tick & (((int64_t)1 << shift) - 1)) == 0) {
+      int index = (int)((_current_tick >> shift) & (num_slots - 1));
+      int slot = l * num_slots + index;
+      AsyncTask *task = _slots[slot];
+      _slots[slot] = nullptr;
+      _occupied[l] &= ~((uint64_t)1 << index);
+      while (task != nullptr) {
+        AsyncTask *next = task->_wheel_next;
+        place(task);
+        task = next;
+      }
+    }
+  }
+}
+
+/**
+ * Returns the first tick after the current tick at which one of the slots
+ * above the first level comes due, or the largest possible tick if there are
+ * none.
+ */
+int64_t AsyncTaskTimerWheel::
+get_next_cascade_tick() const {
+  int64_t next = INT64_MAX;
+  for (int l = 1; l < num_levels; ++l) {
+    if (_occupied[l] != 0) {
+      // All of the occupied slots on this level lie ahead of the current
+      // tick, within the same group of the level above.
+      int shift = l * slot_bits;
+      int64_t base = _current_tick & ~(((int64_t)1 << (shift + slot_bits)) - 1);
+      int index = get_lowest_on_bit((unsigned long long)_occupied[l]);
+      next = std::min(next, base + ((int64_t)index << shift));
+    }
+  }
+  if (_slots[overflow_slot] != nullptr) {
+    int shift = num_levels * slot_bits;
+    int64_t base = _current_tick & ~(((int64_t)1 << shift) - 1);
+    next = std::min(next, base + ((int64_t)1 << shift));
+  }
+  return next;
+}
+
+/**
+ * Redistributes all of the tasks relative to a new current tick.  This is
+ * only needed if the clock goes backwards.
+ */
+void AsyncTaskTimerWheel::
+rebuild(int64_t tick) {
+  pvector<AsyncTask *> tasks;
+  tasks.reserve(_size);
+  for (int i = 0; i <= overflow_slot; ++i) {
+    for (AsyncTask *task = _slots[i]; task != nullptr; task = task->_wheel_next) {
+      tasks.push_back(task);
+    }
+    _slots[i] = nullptr;
+  }
+  for (int l = 0; l < num_levels; ++l) {
+    _occupied[l] = 0;
+  }
+
+  _current_tick = tick;
+  for (AsyncTask *task : tasks) {
+    place(task);
+  }
+}
+
+/**
+ * Returns the earliest wake time of the tasks in the indicated list.
+ */
+double AsyncTaskTimerWheel::
+get_earliest(AsyncTask *list) const {
+  nassertr(list != nullptr, -1.0);
+  double earliest = list->_wake_time;
+  for (AsyncTask *task = list->_wheel_next; task != nullptr; task = task->_wheel_next) {
+    earliest = std::min(earliest, task->_wake_time);
+  }
+  return earliest;
+}
@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncTaskTimerWheel.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef ASYNCTASKTIMERWHEEL_H
+#define ASYNCTASKTIMERWHEEL_H
+
+#include "pandabase.h"
+#include "asyncTask.h"
+#include "pvector.h"
+#include "pointerTo.h"
+
+/**
+ * Holds the sleeping tasks of an AsyncTaskChain, ordered by wake time, so that
+ * adding or removing a task takes constant time no matter how many tasks are
+ * sleeping.
+ *
+ * This is a hierarchical timer wheel.  Time is divided into ticks of about a
+ * millisecond; the first level has a slot for each of the next 64 ticks, the
+ * next level a slot for each of the next 64 groups of 64 ticks, and so on.
+ * Each slot is an intrusive list threaded through the AsyncTask itself.  As
+ * time advances, the tasks in a higher-level slot are redistributed into the
+ * lower levels, so each task is only moved a few times before it wakes.
+ * Tasks too far in the future for the top level are kept on a separate list.
+ *
+ * The tasks are woken by their exact wake time; the ticks only decide where
+ * they are kept.  This class is not thread-safe; the AsyncTaskChain protects
+ * it with the manager's lock.
+ */
+class EXPCL_PANDA_EVENT AsyncTaskTimerWheel {
+public:
+  typedef pvector<PT(AsyncTask)> Tasks;
+
+  AsyncTaskTimerWheel();
+  AsyncTaskTimerWheel(const AsyncTaskTimerWheel &copy) = delete;
+  ~AsyncTaskTimerWheel();
+
+  AsyncTaskTimerWheel &operator = (const AsyncTaskTimerWheel &copy) = delete;
+
+  INLINE bool empty() const;
+  INLINE size_t size() const;
+
+  void add(AsyncTask *task);
+  void remove(AsyncTask *task);
+  bool contains(AsyncTask *task) const;
+
+  void pop_due(double now, Tasks &result);
+  void pop_all(Tasks &result);
+  void get_tasks(Tasks &result) const;
+  double get_next_wake_time() const;
+
+private:
+  INLINE static int64_t get_tick(double time);
+  INLINE void link(AsyncTask *task, int slot);
+  INLINE void unlink(AsyncTask *task);
+  void place(AsyncTask *task);
+  void cascade();
+  int64_t get_next_cascade_tick() const;
+  void rebuild(int64_t tick);
+  double get_earliest(AsyncTask *list) const;
+
+  enum {
+    slot_bits = 6,
+    num_slots = 1 << slot_bits,
+    num_levels = 4,
+
+    // The slot index of the list of tasks that are too far in the future for
+    // the top level.
+    overflow_slot = num_levels * num_slots,
+  };
+
+  static const double _ticks_per_second;
+
+  AsyncTask *_slots[overflow_slot + 1];
+  uint64_t _occupied[num_levels];
+  int64_t _current_tick;
+  size_t _size;
+
+  mutable double _next_wake_time;
+  mutable bool _next_wake_time_valid;
+};
+
+#include "asyncTaskTimerWheel.I"
+
+#endif
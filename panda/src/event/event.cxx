@@ -21,9 +21,12 @@ TypeHandle Event::_type_handle;
  */
 Event::
 Event(const std::string &event_name, EventReceiver *receiver) :
-  _name(event_name)
+  _name(event_name),
+  _queue_next(nullptr),
+  _queued(0)
 {
   _receiver = receiver;
+  _name_hash = string_hash::add_hash(0, _name);
 }
 
 /**
@@ -33,7 +36,10 @@ Event::
 Event(const Event &copy) :
   _parameters(copy._parameters),
   _receiver(copy._receiver),
-  _name(copy._name)
+  _name(copy._name),
+  _name_hash(copy._name_hash),
+  _queue_next(nullptr),
+  _queued(0)
 {
 }
 
@@ -45,6 +51,7 @@ operator = (const Event &copy) {
   _parameters = copy._parameters;
   _receiver = copy._receiver;
   _name = copy._name;
+  _name_hash = copy._name_hash;
 }
 
 /**
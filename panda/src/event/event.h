@@ -18,6 +18,8 @@
 #include "pandabase.h"
 #include "eventParameter.h"
 #include "typedReferenceCount.h"
+#include "stl_compares.h"
+#include "atomicAdjust.h"
 
 class EventReceiver;
 
@@ -59,6 +61,9 @@ PUBLISHED:
   MAKE_SEQ_PROPERTY(parameters, get_num_parameters, get_parameter);
   MAKE_PROPERTY2(receiver, has_receiver, get_receiver, set_receiver, clear_receiver);
 
+public:
+  INLINE size_t get_name_hash() const;
+
 protected:
   typedef pvector<EventParameter> ParameterList;
   ParameterList _parameters;
@@ -67,6 +72,16 @@ protected:
 private:
   std::string _name;
 
+  // Computed whenever the name changes, by the thread that throws the event,
+  // so that the EventHandler doesn't have to.
+  size_t _name_hash;
+
+  // Used by EventQueue to link the event into its list of pending events.
+  mutable Event *_queue_next;
+  mutable AtomicAdjust::Integer _queued;
+
+  friend class EventQueue;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
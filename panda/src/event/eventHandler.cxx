@@ -26,7 +26,11 @@ EventHandler *EventHandler::_global_event_handler = nullptr;
  *
  */
 EventHandler::
-EventHandler(EventQueue *ev_queue) : _queue(*ev_queue) {
+EventHandler(EventQueue *ev_queue) :
+  _queue(*ev_queue),
+  _dispatch_depth(0),
+  _has_empty_hooks(false)
+{
 }
 
 /**
@@ -35,16 +39,15 @@ EventHandler(EventQueue *ev_queue) : _queue(*ev_queue) {
  */
 AsyncFuture *EventHandler::
 get_future(const string &event_name) {
-  Futures::iterator fi;
-  fi = _futures.find(event_name);
+  Hook &hook = get_hook(event_name);
 
   // If we already have a future, but someone cancelled it, we need to create
   // a new future instead.
-  if (fi != _futures.end() && !fi->second->cancelled()) {
-    return fi->second;
+  if (hook._future != nullptr && !hook._future->cancelled()) {
+    return hook._future;
   } else {
     AsyncFuture *fut = new AsyncFuture;
-    _futures[event_name] = fut;
+    hook._future = fut;
     return fut;
   }
 }
@@ -56,11 +59,44 @@ get_future(const string &event_name) {
  */
 void EventHandler::
 process_events() {
-  while (!_queue.is_queue_empty()) {
-    dispatch_event(_queue.dequeue_event());
+  EventQueue::EventList events;
+  _queue.dequeue_events(events);
+  while (!events.empty()) {
+    for (const CPT_Event &event : events) {
+      dispatch_event(event);
+    }
+    events.clear();
+
+    // The hooks may have thrown more events.
+    _queue.dequeue_events(events);
   }
 }
 
+/**
+ * Calls the hooks assigned to all of the events that are currently pending,
+ * and then moves the events, in the same order, to the indicated queue.  This
+ * is meant to be used by the scripting language, to run all of the C++ hooks
+ * at once and then process the events itself from forward_queue, rather than
+ * calling dispatch_event() for each one as it goes.
+ *
+ * Events thrown by the hooks are left on the queue for the next call.
+ * Returns the number of events processed.
+ */
+size_t EventHandler::
+process_events(EventQueue *forward_queue) {
+  nassertr(forward_queue != nullptr && forward_queue != &_queue, 0);
+
+  EventQueue::EventList events;
+  _queue.dequeue_events(events);
+  for (const CPT_Event &event : events) {
+    dispatch_event(event);
+  }
+  for (const CPT_Event &event : events) {
+    forward_queue->queue_event(event);
+  }
+  return events.size();
+}
+
 /**
  * Calls the hooks assigned to the indicated single event.
  */
@@ -70,13 +106,19 @@ dispatch_event(const Event *event) {
 
   // Is the event name defined in the hook table?  It will be if anyone has
   // ever assigned a hook to this particular event name.
-  Hooks::const_iterator hi;
-  hi = _hooks.find(event->get_name());
+  Hook *hook = find_hook(event->get_name(), event->get_name_hash());
+  if (hook == nullptr) {
+    return;
+  }
+
+  // The hooks may remove themselves, or others, but they are not erased until
+  // we are done with them.
+  ++_dispatch_depth;
 
-  if (hi != _hooks.end()) {
+  if (!hook->_functions.empty()) {
     // Yes, it is!  Now walk through all the functions assigned to that event
     // name.
-    Functions copy_functions = (*hi).second;
+    Functions copy_functions = hook->_functions;
 
     Functions::const_iterator fi;
     for (fi = copy_functions.begin(); fi != copy_functions.end(); ++fi) {
@@ -91,12 +133,8 @@ dispatch_event(const Event *event) {
   }
 
   // now for callback hooks
-  CallbackHooks::const_iterator chi;
-  chi = _cbhooks.find(event->get_name());
-
-  if (chi != _cbhooks.end()) {
-    // found one
-    CallbackFunctions copy_functions = (*chi).second;
+  if (!hook->_cbfunctions.empty()) {
+    CallbackFunctions copy_functions = hook->_cbfunctions;
 
     CallbackFunctions::const_iterator cfi;
     for (cfi = copy_functions.begin(); cfi != copy_functions.end(); ++cfi) {
@@ -105,15 +143,19 @@ dispatch_event(const Event *event) {
   }
 
   // Finally, check for futures that need to be triggered.
-  Futures::iterator fi;
-  fi = _futures.find(event->get_name());
-
-  if (fi != _futures.end()) {
-    AsyncFuture *fut = (*fi).second;
+  if (hook->_future != nullptr) {
+    PT(AsyncFuture) fut = std::move(hook->_future);
+    hook->_future = nullptr;
     if (!fut->done()) {
       fut->set_result((TypedReferenceCount *)event);
     }
-    _futures.erase(fi);
+  }
+
+  if (hook->is_empty()) {
+    _has_empty_hooks = true;
+  }
+  if (--_dispatch_depth == 0 && _has_empty_hooks) {
+    erase_empty_hooks();
   }
 }
 
@@ -124,34 +166,8 @@ dispatch_event(const Event *event) {
 void EventHandler::
 write(std::ostream &out) const {
   Hooks::const_iterator hi;
-  hi = _hooks.begin();
-
-  CallbackHooks::const_iterator chi;
-  chi = _cbhooks.begin();
-
-  while (hi != _hooks.end() && chi != _cbhooks.end()) {
-    if ((*hi).first < (*chi).first) {
-      write_hook(out, *hi);
-      ++hi;
-    } else if ((*chi).first < (*hi).first) {
-      write_cbhook(out, *chi);
-      ++chi;
-    } else {
-      write_hook(out, *hi);
-      write_cbhook(out, *chi);
-      ++hi;
-      ++chi;
-    }
-  }
-
-  while (hi != _hooks.end()) {
+  for (hi = _hooks.begin(); hi != _hooks.end(); ++hi) {
     write_hook(out, *hi);
-    ++hi;
-  }
-
-  while (chi != _cbhooks.end()) {
-    write_cbhook(out, *chi);
-    ++chi;
   }
 }
 
@@ -171,7 +187,7 @@ add_hook(const string &event_name, EventFunction *function) {
   }
   assert(!event_name.empty());
   assert(function);
-  return _hooks[event_name].insert(function).second;
+  return get_hook(event_name)._functions.insert(function).second;
 }
 
 
@@ -186,7 +202,7 @@ add_hook(const string &event_name, EventCallbackFunction *function,
          void *data) {
   assert(!event_name.empty());
   assert(function);
-  return _cbhooks[event_name].insert(CallbackFunction(function, data)).second;
+  return get_hook(event_name)._cbfunctions.insert(CallbackFunction(function, data)).second;
 }
 
 /**
@@ -196,23 +212,9 @@ add_hook(const string &event_name, EventCallbackFunction *function,
 bool EventHandler::
 has_hook(const string &event_name) const {
   assert(!event_name.empty());
-  Hooks::const_iterator hi;
-  hi = _hooks.find(event_name);
-  if (hi != _hooks.end()) {
-    if (!(*hi).second.empty()) {
-      return true;
-    }
-  }
-
-  CallbackHooks::const_iterator chi;
-  chi = _cbhooks.find(event_name);
-  if (chi != _cbhooks.end()) {
-    if (!(*chi).second.empty()) {
-      return true;
-    }
-  }
-
-  return false;
+  const Hook *hook = find_hook(event_name);
+  return hook != nullptr &&
+    (!hook->_functions.empty() || !hook->_cbfunctions.empty());
 }
 
 
@@ -223,16 +225,9 @@ has_hook(const string &event_name) const {
 bool EventHandler::
 has_hook(const string &event_name, EventFunction *function) const {
   assert(!event_name.empty());
-  Hooks::const_iterator hi;
-  hi = _hooks.find(event_name);
-  if (hi != _hooks.end()) {
-    const Functions& functions = (*hi).second;
-    if (functions.find(function) != functions.end()) {
-      return true;
-    }
-  }
-
-  return false;
+  const Hook *hook = find_hook(event_name);
+  return hook != nullptr &&
+    hook->_functions.find(function) != hook->_functions.end();
 }
 
 
@@ -243,16 +238,9 @@ has_hook(const string &event_name, EventFunction *function) const {
 bool EventHandler::
 has_hook(const string &event_name, EventCallbackFunction *function, void *data) const {
   assert(!event_name.empty());
-  CallbackHooks::const_iterator chi;
-  chi = _cbhooks.find(event_name);
-  if (chi != _cbhooks.end()) {
-    const CallbackFunctions& cbfunctions = (*chi).second;
-    if (cbfunctions.find(CallbackFunction(function, data)) != cbfunctions.end()) {
-      return true;
-    }
-  }
-
-  return false;
+  const Hook *hook = find_hook(event_name);
+  return hook != nullptr &&
+    hook->_cbfunctions.find(CallbackFunction(function, data)) != hook->_cbfunctions.end();
 }
 
 
@@ -264,7 +252,12 @@ bool EventHandler::
 remove_hook(const string &event_name, EventFunction *function) {
   assert(!event_name.empty());
   assert(function);
-  return _hooks[event_name].erase(function) != 0;
+  Hook *hook = find_hook(event_name);
+  if (hook == nullptr || hook->_functions.erase(function) == 0) {
+    return false;
+  }
+  erase_hook_if_empty(event_name, hook);
+  return true;
 }
 
 
@@ -278,7 +271,13 @@ remove_hook(const string &event_name, EventCallbackFunction *function,
             void *data) {
   assert(!event_name.empty());
   assert(function);
-  return _cbhooks[event_name].erase(CallbackFunction(function, data)) != 0;
+  Hook *hook = find_hook(event_name);
+  if (hook == nullptr ||
+      hook->_cbfunctions.erase(CallbackFunction(function, data)) == 0) {
+    return false;
+  }
+  erase_hook_if_empty(event_name, hook);
+  return true;
 }
 
 /**
@@ -288,24 +287,15 @@ remove_hook(const string &event_name, EventCallbackFunction *function,
 bool EventHandler::
 remove_hooks(const string &event_name) {
   assert(!event_name.empty());
-  bool any_removed = false;
-
-  Hooks::iterator hi = _hooks.find(event_name);
-  if (hi != _hooks.end()) {
-    if (!(*hi).second.empty()) {
-      any_removed = true;
-    }
-    _hooks.erase(hi);
-  }
-
-  CallbackHooks::iterator chi = _cbhooks.find(event_name);
-  if (chi != _cbhooks.end()) {
-    if (!(*chi).second.empty()) {
-      any_removed = true;
-    }
-    _cbhooks.erase(chi);
+  Hook *hook = find_hook(event_name);
+  if (hook == nullptr) {
+    return false;
   }
 
+  bool any_removed = !hook->_functions.empty() || !hook->_cbfunctions.empty();
+  hook->_functions.clear();
+  hook->_cbfunctions.clear();
+  erase_hook_if_empty(event_name, hook);
   return any_removed;
 }
 
@@ -317,9 +307,9 @@ bool EventHandler::
 remove_hooks_with(void *data) {
   bool any_removed = false;
 
-  CallbackHooks::iterator chi;
-  for (chi = _cbhooks.begin(); chi != _cbhooks.end(); ++chi) {
-    CallbackFunctions &funcs = (*chi).second;
+  Hooks::iterator hi;
+  for (hi = _hooks.begin(); hi != _hooks.end(); ++hi) {
+    CallbackFunctions &funcs = (*hi).second._cbfunctions;
     CallbackFunctions::iterator cfi;
 
     CallbackFunctions new_funcs;
@@ -333,6 +323,12 @@ remove_hooks_with(void *data) {
     funcs.swap(new_funcs);
   }
 
+  if (any_removed) {
+    _has_empty_hooks = true;
+    if (_dispatch_depth == 0) {
+      erase_empty_hooks();
+    }
+  }
   return any_removed;
 }
 
@@ -342,27 +338,158 @@ remove_hooks_with(void *data) {
  */
 void EventHandler::
 remove_all_hooks() {
-  _hooks.clear();
-  _cbhooks.clear();
+  Hooks::iterator hi;
+  for (hi = _hooks.begin(); hi != _hooks.end(); ++hi) {
+    (*hi).second._functions.clear();
+    (*hi).second._cbfunctions.clear();
+  }
+
+  _has_empty_hooks = true;
+  if (_dispatch_depth == 0) {
+    erase_empty_hooks();
+  }
 }
 
 /**
- *
+ * Returns the hooks assigned to the indicated event name, whose hash is
+ * given, or nullptr if nothing has ever been assigned to it.
+ */
+EventHandler::Hook *EventHandler::
+find_hook(const string &event_name, size_t hash) const {
+  if (_table.empty()) {
+    return nullptr;
+  }
+
+  size_t mask = _table.size() - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+    Hooks::value_type *entry = _table[i];
+    if (entry == nullptr) {
+      return nullptr;
+    }
+    if (entry->second._hash == hash && entry->first == event_name) {
+      return &entry->second;
+    }
+  }
+}
+
+/**
+ * Returns the hooks assigned to the indicated event name, creating a new
+ * empty entry if there isn't one already.
+ */
+EventHandler::Hook &EventHandler::
+get_hook(const string &event_name) {
+  size_t hash = string_hash::add_hash(0, event_name);
+  Hook *hook = find_hook(event_name, hash);
+  if (hook != nullptr) {
+    return *hook;
+  }
+
+  Hooks::iterator hi = _hooks.insert(Hooks::value_type(event_name, Hook())).first;
+  (*hi).second._hash = hash;
+
+  if (_hooks.size() * 2 > _table.size()) {
+    // Keep the table no more than half full.
+    rebuild_table(std::max(_table.size() * 2, (size_t)64));
+  } else {
+    size_t mask = _table.size() - 1;
+    size_t i = hash & mask;
+    while (_table[i] != nullptr) {
+      i = (i + 1) & mask;
+    }
+    _table[i] = &(*hi);
+  }
+
+  return (*hi).second;
+}
+
+/**
+ * Erases the indicated hook, which belongs to the indicated event name, if
+ * nothing is waiting on it any more.  If dispatch_event() is running, this is
+ * put off until it returns.
  */
 void EventHandler::
-make_global_event_handler() {
-  init_memory_hook();
-  _global_event_handler = new EventHandler(EventQueue::get_global_event_queue());
+erase_hook_if_empty(const string &event_name, Hook *hook) {
+  if (!hook->is_empty()) {
+    return;
+  }
+  if (_dispatch_depth > 0) {
+    _has_empty_hooks = true;
+    return;
+  }
+
+  Hooks::iterator hi = _hooks.find(event_name);
+  nassertv(hi != _hooks.end() && &(*hi).second == hook);
+  erase_hook(hi);
 }
 
+/**
+ * Erases all of the hooks that nothing is waiting on any more.
+ */
+void EventHandler::
+erase_empty_hooks() {
+  nassertv(_dispatch_depth == 0);
+  _has_empty_hooks = false;
+
+  Hooks::iterator hi = _hooks.begin();
+  while (hi != _hooks.end()) {
+    Hooks::iterator next = hi;
+    ++next;
+    if ((*hi).second.is_empty()) {
+      erase_hook(hi);
+    }
+    hi = next;
+  }
+}
 
 /**
- *
+ * Removes the indicated hook from _hooks and from the hash table.
  */
 void EventHandler::
-write_hook(std::ostream &out, const EventHandler::Hooks::value_type &hook) const {
-  if (!hook.second.empty()) {
-    out << hook.first << " has " << hook.second.size() << " functions.\n";
+erase_hook(Hooks::iterator hi) {
+  Hooks::value_type *entry = &(*hi);
+  size_t mask = _table.size() - 1;
+  size_t i = entry->second._hash & mask;
+  while (_table[i] != entry) {
+    nassertv(_table[i] != nullptr);
+    i = (i + 1) & mask;
+  }
+
+  // Move back any of the following entries that would no longer be found
+  // past the hole, so that no tombstone is needed.
+  size_t j = i;
+  while (true) {
+    j = (j + 1) & mask;
+    if (_table[j] == nullptr) {
+      break;
+    }
+    size_t k = _table[j]->second._hash & mask;
+    if (((j - k) & mask) >= ((j - i) & mask)) {
+      _table[i] = _table[j];
+      i = j;
+    }
+  }
+  _table[i] = nullptr;
+
+  _hooks.erase(hi);
+
+  if (_table.size() > 64 && _hooks.size() * 8 < _table.size()) {
+    rebuild_table(_table.size() / 2);
+  }
+}
+
+/**
+ * Rebuilds the hash table from _hooks, with the indicated number of slots,
+ * which must be a power of 2.
+ */
+void EventHandler::
+rebuild_table(size_t size) {
+  _table.assign(size, nullptr);
+  for (Hooks::iterator hi = _hooks.begin(); hi != _hooks.end(); ++hi) {
+    size_t i = (*hi).second._hash & (size - 1);
+    while (_table[i] != nullptr) {
+      i = (i + 1) & (size - 1);
+    }
+    _table[i] = &(*hi);
   }
 }
 
@@ -370,8 +497,21 @@ write_hook(std::ostream &out, const EventHandler::Hooks::value_type &hook) const
  *
  */
 void EventHandler::
-write_cbhook(std::ostream &out, const EventHandler::CallbackHooks::value_type &hook) const {
-  if (!hook.second.empty()) {
-    out << hook.first << " has " << hook.second.size() << " callback functions.\n";
+make_global_event_handler() {
+  init_memory_hook();
+  _global_event_handler = new EventHandler(EventQueue::get_global_event_queue());
+}
+
+
+/**
+ *
+ */
+void EventHandler::
+write_hook(std::ostream &out, const EventHandler::Hooks::value_type &hook) const {
+  if (!hook.second._functions.empty()) {
+    out << hook.first << " has " << hook.second._functions.size() << " functions.\n";
+  }
+  if (!hook.second._cbfunctions.empty()) {
+    out << hook.first << " has " << hook.second._cbfunctions.size() << " callback functions.\n";
   }
 }
@@ -22,6 +22,7 @@
 
 #include "pset.h"
 #include "pmap.h"
+#include "pvector.h"
 
 class EventQueue;
 
@@ -47,6 +48,7 @@ PUBLISHED:
   AsyncFuture *get_future(const std::string &event_name);
 
   void process_events();
+  size_t process_events(EventQueue *forward_queue);
 
   virtual void dispatch_event(const Event *event);
 
@@ -74,15 +76,45 @@ public:
 protected:
 
   typedef pset<EventFunction *> Functions;
-  typedef pmap<std::string, Functions> Hooks;
   typedef std::pair<EventCallbackFunction*, void*> CallbackFunction;
   typedef pset<CallbackFunction> CallbackFunctions;
-  typedef pmap<std::string, CallbackFunctions> CallbackHooks;
-  typedef pmap<std::string, PT(AsyncFuture)> Futures;
+
+  // Everything that is waiting on a particular event name.  A Hook is erased
+  // once nothing is waiting on it any more, but never while dispatch_event()
+  // is running, so a pointer to one remains valid while its functions are
+  // being called.
+  class Hook {
+  public:
+    INLINE bool is_empty() const;
+
+    size_t _hash;
+    Functions _functions;
+    CallbackFunctions _cbfunctions;
+    PT(AsyncFuture) _future;
+  };
+  typedef pmap<std::string, Hook> Hooks;
+
+  Hook *find_hook(const std::string &event_name, size_t hash) const;
+  INLINE Hook *find_hook(const std::string &event_name) const;
+  Hook &get_hook(const std::string &event_name);
+  void erase_hook_if_empty(const std::string &event_name, Hook *hook);
+  void erase_empty_hooks();
+  void erase_hook(Hooks::iterator hi);
+  void rebuild_table(size_t size);
 
   Hooks _hooks;
-  CallbackHooks _cbhooks;
-  Futures _futures;
+
+  // An open-addressed hash table of the entries in _hooks, indexed by the
+  // hash of the event name, so dispatch_event() can find the hooks for an
+  // event without comparing its name against others.
+  typedef pvector<Hooks::value_type *> HookTable;
+  HookTable _table;
+
+  // The number of dispatch_event() calls in progress, and whether any hooks
+  // became empty during them, to be erased when the last one returns.
+  int _dispatch_depth;
+  bool _has_empty_hooks;
+
   EventQueue &_queue;
 
   static EventHandler *_global_event_handler;
@@ -90,7 +122,6 @@ protected:
 
 private:
   void write_hook(std::ostream &out, const Hooks::value_type &hook) const;
-  void write_cbhook(std::ostream &out, const CallbackHooks::value_type &hook) const;
 
 
 public:
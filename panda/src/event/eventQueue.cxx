@@ -22,7 +22,10 @@ EventQueue *EventQueue::_global_event_queue = nullptr;
  *
  */
 EventQueue::
-EventQueue() : _lock("EventQueue::_lock") {
+EventQueue() :
+  _pushed(nullptr),
+  _lock("EventQueue::_lock")
+{
 }
 
 /**
@@ -30,6 +33,7 @@ EventQueue() : _lock("EventQueue::_lock") {
  */
 EventQueue::
 ~EventQueue() {
+  clear();
 }
 
 /**
@@ -43,9 +47,26 @@ queue_event(CPT_Event event) {
     return;
   }
 
-  LightMutexHolder holder(_lock);
+  Event *ev = (Event *)event.p();
+  if (AtomicAdjust::compare_and_exchange(ev->_queued, 0, 1) != 0) {
+    // This same Event object is already waiting on a queue, so it can't be
+    // linked in again.  Queue a copy of it instead.
+    ev = new Event(*event);
+    ev->_queued = 1;
+  }
+
+  // The list holds a reference to each event.
+  ev->ref();
+  void *head = AtomicAdjust::get_ptr(_pushed);
+  while (true) {
+    ev->_queue_next = (Event *)head;
+    void *orig = AtomicAdjust::compare_and_exchange_ptr(_pushed, head, ev);
+    if (orig == head) {
+      break;
+    }
+    head = orig;
+  }
 
-  _queue.push_back(event);
   if (event_cat.is_debug()) {
     if (event->get_name() == "NewFrame") {
       // Don't bother us with this particularly spammy event.
@@ -67,6 +88,7 @@ void EventQueue::
 clear() {
   LightMutexHolder holder(_lock);
 
+  take_pushed();
   _queue.clear();
 }
 
@@ -77,7 +99,7 @@ clear() {
 bool EventQueue::
 is_queue_empty() const {
   LightMutexHolder holder(_lock);
-  return _queue.empty();
+  return _queue.empty() && AtomicAdjust::get_ptr(_pushed) == nullptr;
 }
 
 /**
@@ -96,6 +118,11 @@ CPT_Event EventQueue::
 dequeue_event() {
   LightMutexHolder holder(_lock);
 
+  if (_queue.empty()) {
+    take_pushed();
+    nassertr(!_queue.empty(), nullptr);
+  }
+
   CPT_Event result = _queue.front();
   _queue.pop_front();
 
@@ -103,6 +130,56 @@ dequeue_event() {
   return result;
 }
 
+/**
+ * Removes all of the events currently on the queue, and appends them to the
+ * indicated list, in the order they were thrown.  This is cheaper than
+ * dequeuing them one at a time.
+ */
+void EventQueue::
+dequeue_events(EventList &result) {
+  LightMutexHolder holder(_lock);
+
+  take_pushed();
+  result.reserve(result.size() + _queue.size());
+  for (CPT_Event &event : _queue) {
+    result.push_back(std::move(event));
+  }
+  _queue.clear();
+}
+
+/**
+ * Moves the events that have been thrown since the last call onto the end of
+ * _queue.  Assumes the lock is held.
+ */
+void EventQueue::
+take_pushed() {
+  Event *head = (Event *)AtomicAdjust::set_ptr(_pushed, nullptr);
+  if (head == nullptr) {
+    return;
+  }
+
+  // The list is newest first; reverse it.
+  Event *reversed = nullptr;
+  while (head != nullptr) {
+    Event *next = head->_queue_next;
+    head->_queue_next = reversed;
+    reversed = head;
+    head = next;
+  }
+
+  while (reversed != nullptr) {
+    Event *event = reversed;
+    reversed = event->_queue_next;
+    event->_queue_next = nullptr;
+    AtomicAdjust::set(event->_queued, 0);
+
+    // Hand over the reference that the list was holding.
+    CPT_Event ptr = event;
+    event->unref();
+    _queue.push_back(std::move(ptr));
+  }
+}
+
 /**
  *
  */
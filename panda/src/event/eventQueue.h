@@ -19,12 +19,18 @@
 #include "event.h"
 #include "pt_Event.h"
 #include "lightMutex.h"
+#include "atomicAdjust.h"
 #include "pdeque.h"
+#include "pvector.h"
 
 /**
  * A queue of pending events.  As events are thrown, they are added to this
  * queue; eventually, they will be extracted out again by an EventHandler and
  * processed.
+ *
+ * Any number of threads may throw events at once without taking a lock: each
+ * event is linked onto a list with a single compare-and-exchange.  The thread
+ * reading the events takes the whole list at once and puts it back in order.
  */
 class EXPCL_PANDA_EVENT EventQueue {
 PUBLISHED:
@@ -40,10 +46,22 @@ PUBLISHED:
 
   INLINE static EventQueue *get_global_event_queue();
 
+public:
+  typedef pvector<CPT_Event> EventList;
+  void dequeue_events(EventList &result);
+
 private:
+  void take_pushed();
+
   static void make_global_event_queue();
   static EventQueue *_global_event_queue;
 
+  // The events most recently thrown, newest first, linked through
+  // Event::_queue_next.
+  TVOLATILE AtomicAdjust::Pointer _pushed;
+
+  // The events taken off _pushed, in the order they were thrown.  This is
+  // only touched by the threads reading from the queue, with the lock held.
   typedef pdeque<CPT_Event> Events;
   Events _queue;
 
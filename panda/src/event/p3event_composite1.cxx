@@ -5,6 +5,7 @@
 #include "asyncTaskManager.cxx"
 #include "asyncTaskPause.cxx"
 #include "asyncTaskSequence.cxx"
+#include "asyncTaskTimerWheel.cxx"
 #include "buttonEvent.cxx"
 #include "buttonEventList.cxx"
 #include "genericAsyncTask.cxx"
@@ -0,0 +1,129 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_event_throughput.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "event.h"
+#include "eventQueue.h"
+#include "eventHandler.h"
+#include "thread.h"
+#include "trueClock.h"
+#include "atomicAdjust.h"
+
+using std::cerr;
+
+/**
+ * Measures how many events per second can be thrown and dispatched to C++
+ * hooks, both from a single thread and with several threads throwing into the
+ * same queue while the main thread drains it.
+ */
+static const int num_names = 64;
+static const int events_per_thread = 200000;
+
+static std::string event_names[num_names];
+static int num_handled = 0;
+
+static void
+handle_event(const Event *event) {
+  ++num_handled;
+}
+
+class ProducerThread : public Thread {
+public:
+  ProducerThread(const std::string &name, EventQueue *queue, int seed) :
+    Thread(name, name), _queue(queue), _seed(seed), _done(0) {}
+
+  virtual void thread_main() {
+    for (int i = 0; i < events_per_thread; ++i) {
+      _queue->queue_event(new Event(event_names[(i + _seed) % num_names]));
+    }
+    AtomicAdjust::set(_done, 1);
+  }
+
+  EventQueue *_queue;
+  int _seed;
+  TVOLATILE AtomicAdjust::Integer _done;
+};
+
+int
+main(int argc, char *argv[]) {
+  for (int i = 0; i < num_names; ++i) {
+    std::ostringstream namestrm;
+    namestrm << "event-" << i;
+    event_names[i] = namestrm.str();
+  }
+
+  EventQueue queue;
+  EventHandler handler(&queue);
+
+  // Only every other name has a hook, so that half the events miss.
+  for (int i = 0; i < num_names; i += 2) {
+    handler.add_hook(event_names[i], &handle_event);
+  }
+
+  TrueClock *true_clock = TrueClock::get_global_ptr();
+
+  // First, throw and dispatch in small batches from this thread, as a game
+  // would from a single frame.
+  int total = events_per_thread * 4;
+  double start = true_clock->get_short_time();
+  for (int i = 0; i < total; i += 100) {
+    for (int j = 0; j < 100; ++j) {
+      queue.queue_event(new Event(event_names[(i + j) % num_names]));
+    }
+    handler.process_events();
+  }
+  double elapsed = true_clock->get_short_time() - start;
+  cerr << "Single thread: " << total << " events in " << elapsed * 1000.0
+       << " ms (" << total / elapsed << " events/s), " << num_handled
+       << " handled\n";
+
+  // Now have several threads throwing at once, while this thread dispatches.
+  if (Thread::is_threading_supported()) {
+    static const int num_threads = 4;
+    num_handled = 0;
+
+    PT(ProducerThread) threads[num_threads];
+    for (int t = 0; t < num_threads; ++t) {
+      std::ostringstream namestrm;
+      namestrm << "producer-" << t;
+      threads[t] = new ProducerThread(namestrm.str(), &queue, t * 7);
+    }
+
+    start = true_clock->get_short_time();
+    for (int t = 0; t < num_threads; ++t) {
+      threads[t]->start(TP_normal, true);
+    }
+
+    bool all_done;
+    do {
+      all_done = true;
+      for (int t = 0; t < num_threads; ++t) {
+        all_done = all_done && AtomicAdjust::get(threads[t]->_done) != 0;
+      }
+      handler.process_events();
+    } while (!all_done);
+    handler.process_events();
+    elapsed = true_clock->get_short_time() - start;
+
+    for (int t = 0; t < num_threads; ++t) {
+      threads[t]->join();
+    }
+
+    total = events_per_thread * num_threads;
+    cerr << num_threads << " producer threads: " << total << " events in "
+         << elapsed * 1000.0 << " ms (" << total / elapsed << " events/s), "
+         << num_handled << " handled\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_timer_wheel.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "asyncTask.h"
+#include "asyncTaskManager.h"
+#include "clockObject.h"
+#include "trueClock.h"
+#include "randomizer.h"
+
+using std::cerr;
+
+/**
+ * Measures the cost of scheduling, cancelling and waking large numbers of
+ * delayed tasks, as with doMethodLater.
+ */
+class SleepyTask : public AsyncTask {
+public:
+  SleepyTask(const std::string &name) : AsyncTask(name) {}
+  ALLOC_DELETED_CHAIN(SleepyTask);
+
+  virtual DoneStatus do_task() {
+    ++_num_run;
+    return DS_done;
+  }
+
+  static int _num_run;
+};
+
+int SleepyTask::_num_run = 0;
+
+static const int num_tasks = 100000;
+static const int num_frames = 600;
+static const double frame_dt = 1.0 / 60.0;
+
+int
+main(int argc, char *argv[]) {
+  PT(ClockObject) clock = new ClockObject(ClockObject::M_slave);
+  PT(AsyncTaskManager) task_mgr = new AsyncTaskManager("task_mgr");
+  task_mgr->set_clock(clock);
+
+  TrueClock *true_clock = TrueClock::get_global_ptr();
+  Randomizer random(1);
+
+  // Schedule the tasks with delays spread out over the next 20 seconds, so
+  // about half of them come due during the frames below.
+  double start = true_clock->get_short_time();
+  for (int i = 0; i < num_tasks; ++i) {
+    std::ostringstream namestrm;
+    namestrm << "sleepy-" << i;
+    PT(SleepyTask) task = new SleepyTask(namestrm.str());
+    task->set_delay(random.random_real(20.0));
+    task_mgr->add(task);
+  }
+  double elapsed = true_clock->get_short_time() - start;
+  cerr << "Scheduled " << num_tasks << " tasks in " << elapsed * 1000.0
+       << " ms\n";
+
+  // Cancel every fourth one, by name, as a game would when the object that
+  // scheduled it goes away.
+  start = true_clock->get_short_time();
+  int num_cancelled = 0;
+  for (int i = 0; i < num_tasks; i += 4) {
+    std::ostringstream namestrm;
+    namestrm << "sleepy-" << i;
+    num_cancelled += task_mgr->remove(task_mgr->find_tasks(namestrm.str()));
+  }
+  elapsed = true_clock->get_short_time() - start;
+  cerr << "Cancelled " << num_cancelled << " tasks in " << elapsed * 1000.0
+       << " ms\n";
+
+  // Now step the clock and let the due tasks run.
+  double max_poll = 0.0;
+  start = true_clock->get_short_time();
+  for (int f = 0; f < num_frames; ++f) {
+    clock->set_frame_time((f + 1) * frame_dt);
+    double poll_start = true_clock->get_short_time();
+    task_mgr->poll();
+    max_poll = std::max(max_poll, true_clock->get_short_time() - poll_start);
+  }
+  elapsed = true_clock->get_short_time() - start;
+  cerr << "Ran " << SleepyTask::_num_run << " tasks over " << num_frames
+       << " frames in " << elapsed * 1000.0 << " ms ("
+       << elapsed * 1000.0 / num_frames << " ms per frame, worst "
+       << max_poll * 1000.0 << " ms), " << task_mgr->get_num_tasks()
+       << " still sleeping\n";
+
+  task_mgr->cleanup();
+  return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file blockCompression.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "blockCompression.h"
+
+#ifdef HAVE_ZLIB
+
+#include "config_express.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "virtualFile.h"
+
+#include <zlib.h>
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+// The blocks are handed to plain OS threads, since the Panda thread classes
+// are not available at this level.  The threads only run zlib on memory that
+// belongs to the calling thread, and are joined before returning.
+#include <thread>
+#define BLOCK_COMPRESSION_THREADS 1
+#endif
+
+using std::streampos;
+using std::streamsize;
+
+// The codec, block size and number of blocks.
+const size_t BlockCompression::_header_size = 1 + 4 + 4;
+
+/**
+ * Calls func(begin, end) on contiguous runs of the blocks, running them on
+ * several threads if multifile-block-threads allows it.  The first run is
+ * processed by the calling thread.
+ */
+template<class Func>
+static void
+run_blocks(size_t num_blocks, const Func &func) {
+  size_t num_runs = 1;
+#ifdef BLOCK_COMPRESSION_THREADS
+  int num_threads = multifile_block_threads;
+  if (num_threads > 0 && num_blocks >= 4) {
+    num_runs = std::min((size_t)num_threads + 1, num_blocks);
+  }
+#endif
+
+  if (num_runs <= 1) {
+    func((size_t)0, num_blocks);
+    return;
+  }
+
+#ifdef BLOCK_COMPRESSION_THREADS
+  pvector<std::thread> threads;
+  threads.reserve(num_runs - 1);
+  for (size_t r = 1; r < num_runs; ++r) {
+    threads.push_back(std::thread(func, num_blocks * r / num_runs,
+                                  num_blocks * (r + 1) / num_runs));
+  }
+  func((size_t)0, num_blocks / num_runs);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+#endif
+}
+
+/**
+ * Reads the index from the beginning of the data, which starts at the
+ * indicated position in the source and is data_length bytes long.  Returns
+ * true on success, or false if the data is not in the expected format.
+ */
+bool BlockCompression::Index::
+read(IStreamWrapper *source, streampos start, size_t data_length,
+     size_t uncompressed_length) {
+  _offsets.clear();
+  if (data_length < _header_size) {
+    return false;
+  }
+
+  unsigned char header[_header_size];
+  streamsize count;
+  bool eof;
+  source->seek_read(start, (char *)header, _header_size, count, eof);
+  if (count != (streamsize)_header_size) {
+    return false;
+  }
+
+  Datagram dg(header, _header_size);
+  DatagramIterator scan(dg);
+  _codec = scan.get_uint8();
+  _block_size = scan.get_uint32();
+  size_t num_blocks = scan.get_uint32();
+  _uncompressed_length = uncompressed_length;
+
+  if (_codec != C_zlib) {
+    express_cat.error()
+      << "Unknown block compression codec " << _codec << ".\n";
+    return false;
+  }
+
+  // The number of blocks must be exactly what is needed to hold the data, and
+  // the table must fit in the data.
+  if (_block_size == 0 ||
+      num_blocks != (uncompressed_length + _block_size - 1) / _block_size ||
+      (num_blocks + 1) * 4 > data_length - _header_size) {
+    return false;
+  }
+
+  size_t table_size = (num_blocks + 1) * 4;
+  vector_uchar table(table_size);
+  source->seek_read(start + (streampos)_header_size, (char *)table.data(),
+                    table_size, count, eof);
+  if (count != (streamsize)table_size) {
+    return false;
+  }
+
+  Datagram tdg(std::move(table));
+  DatagramIterator tscan(tdg);
+  _offsets.reserve(num_blocks + 1);
+  uint32_t prev = (uint32_t)(_header_size + table_size);
+  for (size_t i = 0; i <= num_blocks; ++i) {
+    uint32_t offset = tscan.get_uint32();
+    if (offset < prev || offset > data_length) {
+      _offsets.clear();
+      return false;
+    }
+    _offsets.push_back(offset);
+    prev = offset;
+  }
+  return true;
+}
+
+/**
+ * Reads all of the data from the indicated stream, and writes it to the
+ * output in the block format, compressing it in blocks of the indicated size.
+ * Sets uncompressed_length to the number of bytes read from the input.
+ * Returns true on success, false on failure.
+ */
+bool BlockCompression::
+write_blocks(std::ostream &out, std::istream &in, size_t block_size,
+             int compression_level, size_t &uncompressed_length) {
+  nassertr(block_size > 0 && block_size <= 0xffffffffu, false);
+
+  vector_uchar data;
+  if (!VirtualFile::simple_read_file(&in, data)) {
+    return false;
+  }
+  uncompressed_length = data.size();
+
+  size_t num_blocks = (data.size() + block_size - 1) / block_size;
+  pvector<vector_uchar> blocks(num_blocks);
+  pvector<char> failed(num_blocks, 0);
+
+  run_blocks(num_blocks, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const unsigned char *source = data.data() + i * block_size;
+      size_t source_length = std::min(block_size, data.size() - i * block_size);
+
+      vector_uchar &block = blocks[i];
+      uLongf dest_length = compressBound((uLong)source_length);
+      block.resize(dest_length);
+      int result = compress2(block.data(), &dest_length, source,
+                             (uLong)source_length, compression_level);
+      if (result != Z_OK) {
+        failed[i] = 1;
+      } else if (dest_length >= source_length) {
+        // It didn't get any smaller, so store it as it is.
+        block.assign(source, source + source_length);
+      } else {
+        block.resize(dest_length);
+      }
+    }
+  });
+
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (failed[i]) {
+      express_cat.error()
+        << "Failed to compress block " << i << ".\n";
+      return false;
+    }
+  }
+
+  Datagram dg;
+  dg.add_uint8(C_zlib);
+  dg.add_uint32((uint32_t)block_size);
+  dg.add_uint32((uint32_t)num_blocks);
+
+  uint64_t offset = _header_size + (num_blocks + 1) * 4;
+  for (size_t i = 0; i <= num_blocks; ++i) {
+    if (offset > 0xffffffffu) {
+      express_cat.error()
+        << "Block-compressed data may not be larger than 4 GB.\n";
+      return false;
+    }
+    dg.add_uint32((uint32_t)offset);
+    if (i < num_blocks) {
+      offset += blocks[i].size();
+    }
+  }
+
+  out.write((const char *)dg.get_data(), dg.get_length());
+  for (const vector_uchar &block : blocks) {
+    out.write((const char *)block.data(), block.size());
+  }
+  return !out.fail();
+}
+
+/**
+ * Reads and decompresses all of the block-compressed data that starts at the
+ * indicated position in the source, decompressing the blocks on several
+ * threads if multifile-block-threads allows it.  Returns true on success,
+ * false on failure.
+ */
+bool BlockCompression::
+read_blocks(IStreamWrapper *source, streampos start, size_t data_length,
+            size_t uncompressed_length, vector_uchar &result) {
+  Index index;
+  if (!index.read(source, start, data_length, uncompressed_length)) {
+    express_cat.error()
+      << "Invalid block compression index.\n";
+    return false;
+  }
+
+  size_t num_blocks = index.get_num_blocks();
+  result.resize(uncompressed_length);
+  if (num_blocks == 0) {
+    return true;
+  }
+
+  // Read all of the compressed blocks at once.
+  size_t first = index.get_block_start(0);
+  size_t compressed_length = index._offsets[num_blocks] - first;
+  vector_uchar compressed(compressed_length);
+  streamsize count;
+  bool eof;
+  source->seek_read(start + (streampos)first, (char *)compressed.data(),
+                    compressed_length, count, eof);
+  if (count != (streamsize)compressed_length) {
+    return false;
+  }
+
+  pvector<char> failed(num_blocks, 0);
+  run_blocks(num_blocks, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if (!decompress_block(index, i,
+                            compressed.data() + index.get_block_start(i) - first,
+                            result.data() + i * index.get_block_size())) {
+        failed[i] = 1;
+      }
+    }
+  });
+
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (failed[i]) {
+      express_cat.error()
+        << "Failed to decompress block " << i << ".\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Decompresses the nth block, whose compressed bytes are at source, into the
+ * buffer at dest, which must have room for index.get_block_length(n) bytes.
+ * Returns true on success, false if the block is corrupt.
+ */
+bool BlockCompression::
+decompress_block(const Index &index, size_t n, const unsigned char *source,
+                 unsigned char *dest) {
+  size_t length = index.get_block_length(n);
+  size_t compressed_length = index.get_compressed_length(n);
+
+  if (compressed_length == length) {
+    // This block was stored as it is.
+    memcpy(dest, source, length);
+    return true;
+  }
+
+  uLongf dest_length = (uLongf)length;
+  int result = uncompress(dest, &dest_length, source, (uLong)compressed_length);
+  return result == Z_OK && dest_length == (uLongf)length;
+}
+
+#endif  // HAVE_ZLIB
@@ -0,0 +1,91 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file blockCompression.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "pnotify.h"
+#include "streamWrapper.h"
+#include "vector_uchar.h"
+#include "pvector.h"
+
+/**
+ * Reads and writes data that has been compressed as a series of independent,
+ * fixed-size blocks.  Unlike a single zlib stream, any part of the data can be
+ * reached by decompressing only the block that contains it, and the blocks
+ * can be compressed or decompressed on several threads at once.
+ *
+ * The data begins with a uint8 codec, the uint32 uncompressed size of each
+ * block (only the last block may be smaller) and the uint32 number of blocks.
+ * This is followed by num_blocks + 1 uint32 offsets, measured from the start
+ * of the data, of the beginning of each block and of the end of the last
+ * block.  A block that did not get any smaller is stored uncompressed, which
+ * can be recognized by its length.
+ */
+class EXPCL_PANDA_EXPRESS BlockCompression {
+public:
+  enum Codec {
+    C_zlib = 0,
+  };
+
+  /**
+   * The table at the start of the data, describing where each block is.
+   */
+  class EXPCL_PANDA_EXPRESS Index {
+  public:
+    INLINE Index();
+
+    bool read(IStreamWrapper *source, std::streampos start, size_t data_length,
+              size_t uncompressed_length);
+
+    INLINE size_t get_num_blocks() const;
+    INLINE size_t get_block_size() const;
+    INLINE size_t get_uncompressed_length() const;
+    INLINE size_t get_block_length(size_t n) const;
+    INLINE size_t get_block_start(size_t n) const;
+    INLINE size_t get_compressed_length(size_t n) const;
+
+  private:
+    int _codec;
+    size_t _block_size;
+    size_t _uncompressed_length;
+    pvector<uint32_t> _offsets;
+
+    friend class BlockCompression;
+  };
+
+  static bool write_blocks(std::ostream &out, std::istream &in,
+                           size_t block_size, int compression_level,
+                           size_t &uncompressed_length);
+  static bool read_blocks(IStreamWrapper *source, std::streampos start,
+                          size_t data_length, size_t uncompressed_length,
+                          vector_uchar &result);
+
+  static bool decompress_block(const Index &index, size_t n,
+                               const unsigned char *source,
+                               unsigned char *dest);
+
+private:
+  static const size_t _header_size;
+};
+
+#include "blockCompression.I"
+
+#endif  // HAVE_ZLIB
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file blockDecompressStream.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef BLOCKDECOMPRESSSTREAM_H
+#define BLOCKDECOMPRESSSTREAM_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "blockDecompressStreamBuf.h"
+
+/**
+ * An input stream object that reads data written by
+ * BlockCompression::write_blocks() from a range of another stream, as
+ * Multifile does for block-compressed subfiles.
+ *
+ * Seeking is supported; only the block containing the new position needs to
+ * be decompressed.
+ */
+class EXPCL_PANDA_EXPRESS IBlockDecompressStream : public std::istream {
+public:
+  INLINE IBlockDecompressStream();
+  INLINE explicit IBlockDecompressStream(IStreamWrapper *source,
+                                         std::streampos start,
+                                         size_t data_length,
+                                         size_t uncompressed_length);
+
+  INLINE IBlockDecompressStream &open(IStreamWrapper *source,
+                                      std::streampos start,
+                                      size_t data_length,
+                                      size_t uncompressed_length);
+  INLINE IBlockDecompressStream &close();
+
+private:
+  BlockDecompressStreamBuf _buf;
+};
+
+#include "blockDecompressStream.I"
+
+#endif  // HAVE_ZLIB
+
+#endif
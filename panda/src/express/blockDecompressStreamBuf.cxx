@@ -0,0 +1,215 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file blockDecompressStreamBuf.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "blockDecompressStreamBuf.h"
+
+#ifdef HAVE_ZLIB
+
+#include "config_express.h"
+
+using std::ios;
+using std::streamoff;
+using std::streampos;
+using std::streamsize;
+
+/**
+ *
+ */
+BlockDecompressStreamBuf::
+BlockDecompressStreamBuf() {
+  _source = nullptr;
+  _start = 0;
+  _block = 0;
+  _next_block = 0;
+  setg(nullptr, nullptr, nullptr);
+}
+
+/**
+ *
+ */
+BlockDecompressStreamBuf::
+~BlockDecompressStreamBuf() {
+  close();
+}
+
+/**
+ * Reads the block index from the indicated range of the source.  Returns true
+ * on success, or false if it is not valid.
+ */
+bool BlockDecompressStreamBuf::
+open(IStreamWrapper *source, streampos start, size_t data_length,
+     size_t uncompressed_length) {
+  close();
+
+  _source = source;
+  _start = start;
+  _source->ref();
+
+  if (!_index.read(_source, _start, data_length, uncompressed_length)) {
+    express_cat.error()
+      << "Invalid block compression index.\n";
+    return false;
+  }
+  _block = _index.get_num_blocks();
+  _next_block = 0;
+  return true;
+}
+
+/**
+ *
+ */
+void BlockDecompressStreamBuf::
+close() {
+  if (_source != nullptr && !_source->unref()) {
+    delete _source;
+  }
+  _source = nullptr;
+  _start = 0;
+  _index = BlockCompression::Index();
+  _block = 0;
+  _next_block = 0;
+  _compressed.clear();
+  _buffer.clear();
+  setg(nullptr, nullptr, nullptr);
+}
+
+/**
+ * Implements seeking within the stream.  Only reading is supported.
+ */
+streampos BlockDecompressStreamBuf::
+seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
+  if ((which & ios::in) == 0 || _source == nullptr) {
+    return EOF;
+  }
+
+  size_t length = _index.get_uncompressed_length();
+  size_t num_blocks = _index.get_num_blocks();
+  size_t block_size = _index.get_block_size();
+
+  streamoff cur_pos;
+  if (_block < num_blocks) {
+    cur_pos = (streamoff)(_block * block_size) + (gptr() - eback());
+  } else {
+    cur_pos = (streamoff)std::min(_next_block * block_size, length);
+  }
+
+  streamoff new_pos = cur_pos;
+  switch (dir) {
+  case ios::beg:
+    new_pos = off;
+    break;
+
+  case ios::cur:
+    new_pos = cur_pos + off;
+    break;
+
+  case ios::end:
+    new_pos = (streamoff)length + off;
+    break;
+
+  default:
+    // Shouldn't get here.
+    break;
+  }
+
+  if (new_pos < 0 || new_pos > (streamoff)length) {
+    return EOF;
+  }
+
+  if (new_pos == (streamoff)length) {
+    // Leave the get area empty, so that the next read reports end of file.
+    _block = num_blocks;
+    _next_block = num_blocks;
+    setg(nullptr, nullptr, nullptr);
+    return new_pos;
+  }
+
+  size_t n = (size_t)new_pos / block_size;
+  if (n != _block && !load_block(n)) {
+    return EOF;
+  }
+  char *begin = (char *)_buffer.data();
+  setg(begin, begin + (new_pos - (streamoff)(n * block_size)),
+       begin + _buffer.size());
+  _next_block = n + 1;
+  return new_pos;
+}
+
+/**
+ * A variant on seekoff() to implement seeking within a stream.
+ */
+streampos BlockDecompressStreamBuf::
+seekpos(streampos pos, ios_openmode which) {
+  return seekoff(pos, ios::beg, which);
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.
+ */
+int BlockDecompressStreamBuf::
+underflow() {
+  if (gptr() < egptr()) {
+    return (unsigned char)*gptr();
+  }
+  if (_source == nullptr) {
+    return EOF;
+  }
+
+  if (_next_block >= _index.get_num_blocks() || !load_block(_next_block)) {
+    return EOF;
+  }
+  ++_next_block;
+
+  char *begin = (char *)_buffer.data();
+  setg(begin, begin, begin + _buffer.size());
+  return (unsigned char)*gptr();
+}
+
+/**
+ * Reads and decompresses the nth block into _buffer.  Returns true on
+ * success, false on failure.
+ */
+bool BlockDecompressStreamBuf::
+load_block(size_t n) {
+  size_t compressed_length = _index.get_compressed_length(n);
+  _compressed.resize(compressed_length);
+
+  streamsize count;
+  bool eof;
+  _source->seek_read(_start + (streampos)_index.get_block_start(n),
+                     (char *)_compressed.data(), compressed_length, count, eof);
+  if (count != (streamsize)compressed_length) {
+    express_cat.error()
+      << "Unexpected end of file reading compressed block.\n";
+    _block = _index.get_num_blocks();
+    setg(nullptr, nullptr, nullptr);
+    return false;
+  }
+
+  _buffer.resize(_index.get_block_length(n));
+  if (!BlockCompression::decompress_block(_index, n, _compressed.data(),
+                                          _buffer.data())) {
+    express_cat.error()
+      << "Failed to decompress block " << n << ".\n";
+    _block = _index.get_num_blocks();
+    setg(nullptr, nullptr, nullptr);
+    return false;
+  }
+
+  _block = n;
+  thread_consider_yield();
+  return true;
+}
+
+#endif  // HAVE_ZLIB
@@ -0,0 +1,63 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file blockDecompressStreamBuf.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef BLOCKDECOMPRESSSTREAMBUF_H
+#define BLOCKDECOMPRESSSTREAMBUF_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "blockCompression.h"
+#include "streamWrapper.h"
+#include "vector_uchar.h"
+
+/**
+ * The streambuf object that implements IBlockDecompressStream.
+ */
+class EXPCL_PANDA_EXPRESS BlockDecompressStreamBuf : public std::streambuf {
+public:
+  BlockDecompressStreamBuf();
+  BlockDecompressStreamBuf(const BlockDecompressStreamBuf &copy) = delete;
+  virtual ~BlockDecompressStreamBuf();
+
+  bool open(IStreamWrapper *source, std::streampos start, size_t data_length,
+            size_t uncompressed_length);
+  void close();
+
+  virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+  virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+protected:
+  virtual int underflow();
+
+private:
+  bool load_block(size_t n);
+
+  IStreamWrapper *_source;
+  std::streampos _start;
+  BlockCompression::Index _index;
+
+  // The number of the block currently in _buffer, or _index.get_num_blocks()
+  // if there is none, and the number of the block that underflow() will read
+  // next.
+  size_t _block;
+  size_t _next_block;
+  vector_uchar _compressed;
+  vector_uchar _buffer;
+};
+
+#endif  // HAVE_ZLIB
+
+#endif
@@ -77,6 +77,22 @@ ConfigVariableBool multifile_always_binary
           "or extracted in either binary or text mode, according to the "
           "set_binary() or set_text() flag on the Filename."));
 
+ConfigVariableInt multifile_compression_block_size
+("multifile-compression-block-size", 0,
+ PRC_DESC("If this is nonzero, compressed subfiles that are added to a "
+          "Multifile are compressed in independent blocks of this many "
+          "bytes, rather than as one stream.  Such subfiles may be seeked "
+          "into without decompressing everything before the seek position, "
+          "and are decompressed on several threads when read all at once.  "
+          "This is the default for Multifile::set_compression_block_size()."));
+
+ConfigVariableInt multifile_block_threads
+("multifile-block-threads", 2,
+ PRC_DESC("The number of additional threads used to compress or decompress "
+          "the blocks of a block-compressed subfile when the whole subfile "
+          "is written or read at once.  Set this to 0 to do all of the work "
+          "on the calling thread."));
+
 ConfigVariableBool collect_tcp
 ("collect-tcp", false,
  PRC_DESC("Set this true to enable accumulation of several small consecutive "
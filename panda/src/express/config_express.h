@@ -50,6 +50,8 @@ extern ConfigVariableInt patchfile_zone_size;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool keep_temporary_files;
 extern ConfigVariableBool multifile_always_binary;
+extern EXPCL_PANDA_EXPRESS ConfigVariableInt multifile_compression_block_size;
+extern EXPCL_PANDA_EXPRESS ConfigVariableInt multifile_block_threads;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool collect_tcp;
 extern EXPCL_PANDA_EXPRESS ConfigVariableDouble collect_tcp_interval;
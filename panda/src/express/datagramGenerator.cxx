@@ -90,3 +90,42 @@ std::streampos DatagramGenerator::
 get_file_pos() {
   return 0;
 }
+
+/**
+ * Reads at most the first head_size bytes of the next datagram into data, and
+ * stores in tail_size the number of bytes of the datagram that were left
+ * unread.  Those bytes must be consumed with read_datagram_tail() or
+ * skip_datagram_tail() before the next datagram is read.  This allows a large
+ * payload at the end of a datagram to be read directly into its final
+ * destination.
+ *
+ * The default implementation reads the whole datagram, and always sets
+ * tail_size to 0.
+ */
+bool DatagramGenerator::
+get_datagram_head(Datagram &data, size_t head_size, size_t &tail_size) {
+  tail_size = 0;
+  return get_datagram(data);
+}
+
+/**
+ * Reads the next size bytes of the remainder of the datagram most recently
+ * returned by get_datagram_head() into the indicated buffer.  Returns true on
+ * success, false on failure.
+ */
+bool DatagramGenerator::
+read_datagram_tail(unsigned char *into, size_t size) {
+  nassertr(size == 0, false);
+  return true;
+}
+
+/**
+ * Discards the next size bytes of the remainder of the datagram most recently
+ * returned by get_datagram_head().  Returns true on success, false on
+ * failure.
+ */
+bool DatagramGenerator::
+skip_datagram_tail(size_t size) {
+  nassertr(size == 0, false);
+  return true;
+}
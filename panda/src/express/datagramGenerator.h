@@ -42,6 +42,12 @@ PUBLISHED:
   virtual const FileReference *get_file();
   virtual VirtualFile *get_vfile();
   virtual std::streampos get_file_pos();
+
+public:
+  virtual bool get_datagram_head(Datagram &data, size_t head_size,
+                                 size_t &tail_size);
+  virtual bool read_datagram_tail(unsigned char *into, size_t size);
+  virtual bool skip_datagram_tail(size_t size);
 };
 
 #include "datagramGenerator.I"
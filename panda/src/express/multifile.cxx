@@ -18,6 +18,8 @@
 #include "streamReader.h"
 #include "datagram.h"
 #include "zStream.h"
+#include "blockCompression.h"
+#include "blockDecompressStream.h"
 #include "encryptStream.h"
 #include "virtualFileSystem.h"
 #include "virtualFile.h"
@@ -50,8 +52,11 @@ const size_t Multifile::_header_size = 6;
 // version may still be read.
 const int Multifile::_current_major_ver = 1;
 
-const int Multifile::_current_minor_ver = 1;
+const int Multifile::_current_minor_ver = 2;
 // Bumped to version 1.1 on 6806 to add timestamps.
+// Bumped to version 1.2 to add block-compressed subfiles.  A Multifile is
+// still written as version 1.1 unless it contains any of them, so that older
+// versions of Panda can read it.
 
 // To confirm that the supplied password matches, we write the Mutifile magic
 // header at the beginning of the encrypted stream.  I suppose this does
@@ -128,6 +133,7 @@ Multifile() :
   _record_timestamp = true;
   _scale_factor = 1;
   _new_scale_factor = 1;
+  _compression_block_size = (size_t)max((int)multifile_compression_block_size, 0);
   _encryption_flag = false;
   _encryption_iteration_count = multifile_encryption_iteration_count;
   _file_major_ver = 0;
@@ -1138,9 +1144,10 @@ flush() {
     }
 
   } else {
-    if (_file_minor_ver != _current_minor_ver) {
+    if (_file_minor_ver < get_required_minor_ver()) {
       // If we *do* have an index already, but this is an old version
-      // multifile, we have to completely rewrite it anyway.
+      // multifile, or one that is too old for the subfiles we are adding, we
+      // have to completely rewrite it anyway.
       return repack();
     }
   }
@@ -1917,6 +1924,16 @@ read_subfile(int index, vector_uchar &result) {
   result.reserve(subfile->_uncompressed_length);
 
   bool success = true;
+#ifdef HAVE_ZLIB
+  if ((subfile->_flags & SF_blocked) != 0) {
+    // A block-compressed subfile can be decompressed all at once, several
+    // blocks at a time.
+    success = BlockCompression::read_blocks(_read, _offset + subfile->_data_start,
+                                            subfile->_data_length,
+                                            subfile->_uncompressed_length,
+                                            result);
+  } else
+#endif  // HAVE_ZLIB
   if (subfile->_flags & (SF_encrypted | SF_compressed)) {
     // If the subfile is encrypted or compressed, we can't read it directly.
     // Fall back to the generic implementation.
@@ -2006,6 +2023,15 @@ add_new_subfile(Subfile *subfile, int compression_level) {
   }
 #endif  // HAVE_OPENSSL
 
+  if ((subfile->_flags & SF_compressed) != 0 &&
+      (subfile->_flags & (SF_encrypted | SF_signature)) == 0 &&
+      _compression_block_size != 0) {
+    // Blocks can't be located within an encrypted stream, so only plain
+    // compressed subfiles are divided into blocks.
+    subfile->_flags |= SF_blocked;
+    subfile->_compression_block_size = _compression_block_size;
+  }
+
   if (_next_index != (streampos)0) {
     // If we're adding a Subfile to an already-existing Multifile, we will
     // eventually need to repack the file.
@@ -2050,6 +2076,29 @@ open_read_subfile(Subfile *subfile) {
   // Return an ISubStream object that references into the open Multifile
   // istream.
   nassertr(subfile->_data_start != (streampos)0, nullptr);
+
+  if ((subfile->_flags & SF_blocked) != 0) {
+#ifndef HAVE_ZLIB
+    express_cat.error()
+      << "zlib not compiled in; cannot read compressed multifiles.\n";
+    return nullptr;
+#else  // HAVE_ZLIB
+    // The subfile was compressed in independent blocks, so it can be read
+    // directly from the Multifile, one block at a time.
+    istream *stream =
+      new IBlockDecompressStream(_read, _offset + subfile->_data_start,
+                                 subfile->_data_length,
+                                 subfile->_uncompressed_length);
+    if (stream->fail()) {
+      express_cat.error()
+        << "Invalid block index in subfile " << subfile->_name << ".\n";
+      delete stream;
+      return nullptr;
+    }
+    return stream;
+#endif  // HAVE_ZLIB
+  }
+
   istream *stream =
     new ISubStream(_read, _offset + subfile->_data_start,
                    _offset + subfile->_data_start + (streampos)subfile->_data_length);
@@ -2335,21 +2384,37 @@ read_index() {
   return true;
 }
 
+/**
+ * Returns the oldest minor version that can represent all of the subfiles in
+ * the Multifile.  This is 1, unless there are block-compressed subfiles,
+ * which need version 1.2.
+ */
+int Multifile::
+get_required_minor_ver() const {
+  Subfiles::const_iterator si;
+  for (si = _subfiles.begin(); si != _subfiles.end(); ++si) {
+    if (((*si)->_flags & SF_blocked) != 0) {
+      return 2;
+    }
+  }
+  return 1;
+}
+
 /**
  * Writes just the header part of the Multifile, not the index.
  */
 bool Multifile::
 write_header() {
   _file_major_ver = _current_major_ver;
-  _file_minor_ver = _current_minor_ver;
+  _file_minor_ver = get_required_minor_ver();
 
   nassertr(_write != nullptr, false);
   nassertr(_write->tellp() == (streampos)0, false);
   _write->write(_header_prefix.data(), _header_prefix.size());
   _write->write(_header, _header_size);
   StreamWriter writer(_write, false);
-  writer.add_int16(_current_major_ver);
-  writer.add_int16(_current_minor_ver);
+  writer.add_int16(_file_major_ver);
+  writer.add_int16(_file_minor_ver);
   writer.add_uint32(_scale_factor);
 
   if (_record_timestamp) {
@@ -2657,6 +2722,23 @@ write_data(ostream &write, istream *read, streampos fpos,
         write.put(byte);
       }
     }
+#ifdef HAVE_ZLIB
+  } else if ((_flags & SF_blocked) != 0) {
+    // Write it compressed in independent blocks.  This reads the entire
+    // source first, so that the blocks can be compressed in parallel.
+    streampos write_start = fpos;
+    if (!BlockCompression::write_blocks(write, *source, _compression_block_size,
+                                        _compression_level,
+                                        _uncompressed_length)) {
+      express_cat.info()
+        << "Unable to compress subfile " << _name << ".\n";
+      _flags |= SF_data_invalid;
+    }
+
+    streampos write_end = write.tellp() - multifile->_offset;
+    _data_length = (size_t)(write_end - write_start);
+#endif  // HAVE_ZLIB
+
   } else {
     // We do have source data.  Copy it in, and also measure its length.
     ostream *putter = &write;
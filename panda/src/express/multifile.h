@@ -66,6 +66,9 @@ PUBLISHED:
   void set_scale_factor(size_t scale_factor);
   INLINE size_t get_scale_factor() const;
 
+  INLINE void set_compression_block_size(size_t block_size);
+  INLINE size_t get_compression_block_size() const;
+
   INLINE void set_encryption_flag(bool flag);
   INLINE bool get_encryption_flag() const;
   INLINE void set_encryption_password(const std::string &encryption_password);
@@ -170,6 +173,7 @@ private:
     SF_encrypted      = 0x0010,
     SF_signature      = 0x0020,
     SF_text           = 0x0040,
+    SF_blocked        = 0x0080,
   };
 
   class Subfile {
@@ -201,6 +205,7 @@ private:
     Filename _source_filename;
     int _flags;
     int _compression_level;  // Not preserved on disk.
+    size_t _compression_block_size;  // Not preserved on disk.
 #ifdef HAVE_OPENSSL
     EVP_PKEY *_pkey;         // Not preserved on disk.
 #endif
@@ -217,6 +222,7 @@ private:
 
   void clear_subfiles();
   bool read_index();
+  int get_required_minor_ver() const;
   bool write_header();
 
   void check_signatures();
@@ -249,6 +255,7 @@ private:
   bool _record_timestamp;
   size_t _scale_factor;
   size_t _new_scale_factor;
+  size_t _compression_block_size;
 
   bool _encryption_flag;
   std::string _encryption_password;
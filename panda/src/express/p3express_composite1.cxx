@@ -1,3 +1,6 @@
+#include "blockCompression.cxx"
+#include "blockDecompressStream.cxx"
+#include "blockDecompressStreamBuf.cxx"
 #include "buffer.cxx"
 #include "checksumHashGenerator.cxx"
 #include "config_express.cxx"
@@ -139,6 +139,19 @@ ConfigVariableBool driver_generate_mipmaps
           "automatically in all cases, if supported.  Set it false "
           "to generate mipmaps in software when possible."));
 
+ConfigVariableInt texture_mipmap_threads
+("texture-mipmap-threads", 0,
+ PRC_DESC("The number of extra threads that help filter each level of a "
+          "2-D texture's mipmap chain, when mipmaps are generated in "
+          "software."));
+
+ConfigVariableInt texture_mipmap_threads_min_size
+("texture-mipmap-threads-min-size", 65536,
+ PRC_DESC("The smallest mipmap level, in bytes, that will be divided "
+          "between the texture-mipmap-threads.  Smaller levels are filtered "
+          "on the loading thread, since they are finished before the other "
+          "threads would wake up."));
+
 ConfigVariableBool vertex_buffers
 ("vertex-buffers", true,
  PRC_DESC("Set this true to allow the use of vertex buffers (or buffer "
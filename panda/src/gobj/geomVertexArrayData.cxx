@@ -358,7 +358,7 @@ clear_prepared(PreparedGraphicsObjects *prepared_objects) {
 /**
  * Fills a new data array with all numeric values expressed in the indicated
  * array reversed, byte-for-byte, to convert littleendian to bigendian and
- * vice-versa.
+ * vice-versa.  The source and dest may be the same array.
  */
 void GeomVertexArrayData::
 reverse_data_endianness(unsigned char *dest, const unsigned char *source,
@@ -394,6 +394,7 @@ reverse_data_endianness(unsigned char *dest, const unsigned char *source,
 void GeomVertexArrayData::
 register_with_read_factory() {
   BamReader::get_factory()->register_factory(get_class_type(), make_from_bam);
+  BamReader::register_direct_read(get_class_type());
 }
 
 /**
@@ -463,9 +464,8 @@ finalize(BamReader *manager) {
   if (aux_data != nullptr) {
     if (aux_data->_endian_reversed) {
       // Now is the time to endian-reverse the data.
-      VertexDataBuffer new_buffer(cdata->_buffer.get_size());
-      reverse_data_endianness(new_buffer.get_write_pointer(), cdata->_buffer.get_read_pointer(true), cdata->_buffer.get_size());
-      cdata->_buffer.swap(new_buffer);
+      unsigned char *data = cdata->_buffer.get_write_pointer();
+      reverse_data_endianness(data, data, cdata->_buffer.get_size());
     }
   }
 
@@ -549,41 +549,45 @@ fillin(DatagramIterator &scan, BamReader *manager, void *extra_data) {
   GeomVertexArrayData *array_data = (GeomVertexArrayData *)extra_data;
   _usage_hint = (UsageHint)scan.get_uint8();
 
+  size_t size;
+
   if (manager->get_file_minor_ver() < 8) {
     // Before bam version 6.8, the array data was a PTA_uchar.
     PTA_uchar new_data;
     READ_PTA(manager, scan, array_data->read_raw_data, new_data);
-    _buffer.unclean_realloc(new_data.size());
-    _buffer.set_size(new_data.size());
-    memcpy(_buffer.get_write_pointer(), &new_data[0], new_data.size());
+    size = new_data.size();
+    _buffer.unclean_realloc(size);
+    _buffer.set_size(size);
+    memcpy(_buffer.get_write_pointer(), new_data.p(), size);
 
   } else {
-    // Now, the array data is just stored directly.
-    size_t size = scan.get_uint32();
+    // Now, the array data is just stored directly, at the end of the record.
+    // We read it straight into the buffer; most of it will not have been read
+    // into the datagram.
+    size = scan.get_uint32();
+    nassertv(manager->get_remaining_size(scan) >= size);
     _buffer.unclean_realloc(size);
     _buffer.set_size(size);
-
-    const unsigned char *source_data =
-      (const unsigned char *)scan.get_datagram().get_data();
-    memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
-    scan.skip_bytes(size);
+    if (!manager->read_bytes(scan, _buffer.get_write_pointer(), size)) {
+      _buffer.set_size(0);
+      size = 0;
+    }
   }
 
   bool endian_reversed = false;
 
   if (manager->get_file_endian() != BamReader::BE_native) {
-    // For non-native endian files, we have to convert the data.
+    if (array_data->_array_format != nullptr) {
+      // For non-native endian files, we have to convert the data.  Since we
+      // have the _array_format pointer now, we can reverse it immediately
+      // (and we should, to support threaded CData updates), in place.
+      unsigned char *data = _buffer.get_write_pointer();
+      array_data->reverse_data_endianness(data, data, size);
 
-    if (array_data->_array_format == nullptr) {
-      // But we can't do that until we've completed the _array_format pointer,
-      // which tells us how to convert it.
-      endian_reversed = true;
     } else {
-      // Since we have the _array_format pointer now, we can reverse it
-      // immediately (and we should, to support threaded CData updates).
-      VertexDataBuffer new_buffer(_buffer.get_size());
-      array_data->reverse_data_endianness(new_buffer.get_write_pointer(), _buffer.get_read_pointer(true), _buffer.get_size());
-      _buffer.swap(new_buffer);
+      // We can't convert the data until we've completed the _array_format
+      // pointer, which tells us how to convert it.
+      endian_reversed = true;
     }
   }
 
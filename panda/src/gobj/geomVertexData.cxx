@@ -22,6 +22,11 @@
 #include "pset.h"
 #include "indent.h"
 
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#define GVD_USE_SSE2
+#endif
+
 using std::ostream;
 
 TypeHandle GeomVertexData::_type_handle;
@@ -1897,6 +1902,110 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   }
 }
 
+#ifdef GVD_USE_SSE2
+/**
+ * Loads the first three floats of a row into the low three lanes of a
+ * register, without reading past the third float.
+ */
+static INLINE __m128
+sse2_load_3f(const float *v) {
+  return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)v),
+                       _mm_load_ss(v + 2));
+}
+
+/**
+ * Stores the low three lanes of a register into the first three floats of a
+ * row, without writing past the third float.
+ */
+static INLINE void
+sse2_store_3f(float *v, __m128 value) {
+  _mm_storel_pi((__m64 *)v, value);
+  _mm_store_ss(v + 2, _mm_movehl_ps(value, value));
+}
+
+/**
+ * Transforms each of the three-component float vectors in the indicated table
+ * by the indicated matrix, as a row vector.  If translate is true, the
+ * vectors are treated as points, and the translation component of the matrix
+ * is added in.  The rows need not be aligned, and nothing past the third
+ * component of each row is read or written.
+ *
+ * The rows are done four at a time: they are transposed so that each
+ * register holds one component of all four, and each is then multiplied by
+ * a matrix element broadcast across the register.  The products are summed
+ * in the same order as LVecBase3f * LMatrix4f.
+ */
+template<bool translate>
+static void
+sse2_xform_3f(unsigned char *datat, size_t num_rows, size_t stride,
+              const LMatrix4f &matf) {
+  const float *m = matf.get_data();
+
+  size_t i = 0;
+  if (num_rows >= 4) {
+    __m128 m00 = _mm_set1_ps(m[0]), m01 = _mm_set1_ps(m[1]), m02 = _mm_set1_ps(m[2]);
+    __m128 m10 = _mm_set1_ps(m[4]), m11 = _mm_set1_ps(m[5]), m12 = _mm_set1_ps(m[6]);
+    __m128 m20 = _mm_set1_ps(m[8]), m21 = _mm_set1_ps(m[9]), m22 = _mm_set1_ps(m[10]);
+    __m128 m30 = _mm_set1_ps(m[12]), m31 = _mm_set1_ps(m[13]), m32 = _mm_set1_ps(m[14]);
+
+    for (; i + 4 <= num_rows; i += 4) {
+      float *v0 = (float *)(datat + i * stride);
+      float *v1 = (float *)((unsigned char *)v0 + stride);
+      float *v2 = (float *)((unsigned char *)v1 + stride);
+      float *v3 = (float *)((unsigned char *)v2 + stride);
+
+      // After the transpose, x holds the x components of the four rows, and
+      // so on; w is unused.
+      __m128 x = sse2_load_3f(v0);
+      __m128 y = sse2_load_3f(v1);
+      __m128 z = sse2_load_3f(v2);
+      __m128 w = sse2_load_3f(v3);
+      _MM_TRANSPOSE4_PS(x, y, z, w);
+
+      __m128 ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)),
+                             _mm_mul_ps(z, m20));
+      __m128 oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)),
+                             _mm_mul_ps(z, m21));
+      __m128 oz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)),
+                             _mm_mul_ps(z, m22));
+      if (translate) {
+        ox = _mm_add_ps(ox, m30);
+        oy = _mm_add_ps(oy, m31);
+        oz = _mm_add_ps(oz, m32);
+      }
+
+      // Transpose back to one row per register.
+      __m128 ow = _mm_setzero_ps();
+      _MM_TRANSPOSE4_PS(ox, oy, oz, ow);
+      sse2_store_3f(v0, ox);
+      sse2_store_3f(v1, oy);
+      sse2_store_3f(v2, oz);
+      sse2_store_3f(v3, ow);
+    }
+  }
+
+  // The remaining rows are done one at a time, with the matrix rows.
+  if (i < num_rows) {
+    __m128 r0 = _mm_loadu_ps(m + 0);
+    __m128 r1 = _mm_loadu_ps(m + 4);
+    __m128 r2 = _mm_loadu_ps(m + 8);
+    __m128 r3 = _mm_loadu_ps(m + 12);
+
+    for (; i < num_rows; ++i) {
+      float *v = (float *)(datat + i * stride);
+      __m128 result = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), r0),
+                   _mm_mul_ps(_mm_set1_ps(v[1]), r1)),
+        _mm_mul_ps(_mm_set1_ps(v[2]), r2));
+      if (translate) {
+        result = _mm_add_ps(result, r3);
+      }
+      sse2_store_3f(v, result);
+    }
+  }
+}
+#endif  // GVD_USE_SSE2
+
 /**
  * Transforms each of the LPoint3f objects in the indicated table by the
  * indicated matrix.
@@ -1904,12 +2013,16 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
 void GeomVertexData::
 table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
                     const LMatrix4f &matf) {
+#ifdef GVD_USE_SSE2
+  sse2_xform_3f<true>(datat, num_rows, stride, matf);
+#else
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component point.
   for (size_t i = 0; i < num_rows; ++i) {
     LPoint3f &vertex = *(LPoint3f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif
 }
 
 /**
@@ -1921,11 +2034,19 @@ table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
+#ifdef GVD_USE_SSE2
+  sse2_xform_3f<false>(datat, num_rows, stride, matf);
+  for (size_t i = 0; i < num_rows; ++i) {
+    LNormalf &vertex = *(LNormalf *)(&datat[i * stride]);
+    vertex.normalize();
+  }
+#else
   for (size_t i = 0; i < num_rows; ++i) {
     LNormalf &vertex = *(LNormalf *)(&datat[i * stride]);
     vertex *= matf;
     vertex.normalize();
   }
+#endif
 }
 
 /**
@@ -1937,10 +2058,14 @@ table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
+#ifdef GVD_USE_SSE2
+  sse2_xform_3f<false>(datat, num_rows, stride, matf);
+#else
   for (size_t i = 0; i < num_rows; ++i) {
     LVector3f &vertex = *(LVector3f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif
 }
 
 /**
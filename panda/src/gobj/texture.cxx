@@ -42,6 +42,7 @@
 #include "streamReader.h"
 #include "texturePeeker.h"
 #include "convert_srgb.h"
+#include "asyncTaskManager.h"
 
 #ifdef HAVE_SQUISH
 #include <squish.h>
@@ -49,6 +50,11 @@
 
 #include <stddef.h>
 
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TEXTURE_USE_SSE2
+#endif
+
 using std::endl;
 using std::istream;
 using std::max;
@@ -9144,80 +9150,89 @@ do_filter_2d_mipmap_pages(const CData *cdata,
   }
 
   int num_pages = cdata->_z_size * cdata->_num_views;
+
+  if (y_size != 1) {
+    // Each destination row depends only on two source rows, so the rows of
+    // all of the pages can be filtered in any order, and by several threads
+    // if the level is big enough to be worth it.
+    Filter2DRows rows;
+    rows._to = to._image.p();
+    rows._from = from._image.p();
+    rows._to_page_size = to._page_size;
+    rows._from_page_size = from._page_size;
+    rows._pixel_size = pixel_size;
+    rows._row_size = row_size;
+    rows._to_row_size = to_row_size;
+    rows._x_size = x_size;
+    rows._rows_per_page = y_size / 2;
+    rows._begin = 0;
+    rows._end = rows._rows_per_page * num_pages;
+    rows._num_color_components = num_color_components;
+    rows._alpha = alpha;
+    rows._filter_component = filter_component;
+    rows._filter_alpha = filter_alpha;
+
+    // The plain 8-bit RGBA case can be done four source pixels at a time.
+    rows._rgba8 = (filter_component == &filter_2d_unsigned_byte &&
+                   filter_alpha == &filter_2d_unsigned_byte &&
+                   pixel_size == 4 && x_size != 1);
+
+    int num_threads = texture_mipmap_threads;
+    size_t level_size = to._page_size * num_pages;
+    if (num_threads <= 0 || level_size < (size_t)texture_mipmap_threads_min_size ||
+        rows._end < num_threads + 1) {
+      filter_2d_rows(rows);
+      return;
+    }
+
+    // Split the rows into contiguous runs to be shared out between the
+    // threads.
+    int num_runs = num_threads + 1;
+    pvector<Filter2DRows> runs(num_runs, rows);
+    for (int ri = 0; ri < num_runs; ++ri) {
+      runs[ri]._begin = (int)((int64_t)rows._end * ri / num_runs);
+      runs[ri]._end = (int)((int64_t)rows._end * (ri + 1) / num_runs);
+    }
+
+    AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->
+      make_worker_chain("texture_mipmap", num_threads);
+    chain->parallel_for(runs.size(), &filter_2d_rows_run, runs.data());
+    return;
+  }
+
   for (int z = 0; z < num_pages; ++z) {
     // For each level.
     unsigned char *p = to._image.p() + z * to._page_size;
     nassertv(p <= to._image.p() + to._image.size() + to._page_size);
     const unsigned char *q = from._image.p() + z * from._page_size;
     nassertv(q <= from._image.p() + from._image.size() + from._page_size);
-    if (y_size != 1) {
-      int y;
-      for (y = 0; y < y_size - 1; y += 2) {
-        // For each row.
-        nassertv(p == to._image.p() + z * to._page_size + (y / 2) * to_row_size);
-        nassertv(q == from._image.p() + z * from._page_size + y * row_size);
-        if (x_size != 1) {
-          int x;
-          for (x = 0; x < x_size - 1; x += 2) {
-            // For each pixel.
-            for (int c = 0; c < num_color_components; ++c) {
-              // For each component.
-              filter_component(p, q, pixel_size, row_size);
-            }
-            if (alpha) {
-              filter_alpha(p, q, pixel_size, row_size);
-            }
-            q += pixel_size;
-          }
-          if (x < x_size) {
-            // Skip the last odd pixel.
-            q += pixel_size;
-          }
-        } else {
-          // Just one pixel.
-          for (int c = 0; c < num_color_components; ++c) {
-            // For each component.
-            filter_component(p, q, 0, row_size);
-          }
-          if (alpha) {
-            filter_alpha(p, q, 0, row_size);
-          }
-        }
-        q += row_size;
-        Thread::consider_yield();
-      }
-      if (y < y_size) {
-        // Skip the last odd row.
-        q += row_size;
-      }
-    } else {
-      // Just one row.
-      if (x_size != 1) {
-        int x;
-        for (x = 0; x < x_size - 1; x += 2) {
-          // For each pixel.
-          for (int c = 0; c < num_color_components; ++c) {
-            // For each component.
-            filter_component(p, q, pixel_size, 0);
-          }
-          if (alpha) {
-            filter_alpha(p, q, pixel_size, 0);
-          }
-          q += pixel_size;
-        }
-        if (x < x_size) {
-          // Skip the last odd pixel.
-          q += pixel_size;
-        }
-      } else {
-        // Just one pixel.
+
+    // Just one row.
+    if (x_size != 1) {
+      int x;
+      for (x = 0; x < x_size - 1; x += 2) {
+        // For each pixel.
         for (int c = 0; c < num_color_components; ++c) {
           // For each component.
-          filter_component(p, q, 0, 0);
+          filter_component(p, q, pixel_size, 0);
         }
         if (alpha) {
           filter_alpha(p, q, pixel_size, 0);
         }
+        q += pixel_size;
+      }
+      if (x < x_size) {
+        // Skip the last odd pixel.
+        q += pixel_size;
+      }
+    } else {
+      // Just one pixel.
+      for (int c = 0; c < num_color_components; ++c) {
+        // For each component.
+        filter_component(p, q, 0, 0);
+      }
+      if (alpha) {
+        filter_alpha(p, q, pixel_size, 0);
       }
     }
 
@@ -9226,6 +9241,83 @@ do_filter_2d_mipmap_pages(const CData *cdata,
   }
 }
 
+/**
+ * Filters the indicated band of rows of a 2-D mipmap level, for
+ * do_filter_2d_mipmap_pages().  This may be called on several threads at
+ * once, for different bands of the same level.
+ */
+void Texture::
+filter_2d_rows(const Filter2DRows &rows) {
+  size_t pixel_size = rows._pixel_size;
+  size_t row_size = rows._row_size;
+  int x_size = rows._x_size;
+  int to_x_size = max(x_size >> 1, 1);
+
+  for (int i = rows._begin; i < rows._end; ++i) {
+    // For each row.
+    int z = i / rows._rows_per_page;
+    int y = i - z * rows._rows_per_page;
+    unsigned char *p = rows._to + z * rows._to_page_size + y * rows._to_row_size;
+    const unsigned char *q = rows._from + z * rows._from_page_size + (y * 2) * row_size;
+
+    if (x_size == 1) {
+      // Just one pixel.
+      for (int c = 0; c < rows._num_color_components; ++c) {
+        // For each component.
+        rows._filter_component(p, q, 0, row_size);
+      }
+      if (rows._alpha) {
+        rows._filter_alpha(p, q, 0, row_size);
+      }
+      continue;
+    }
+
+    int x = 0;
+#ifdef TEXTURE_USE_SSE2
+    if (rows._rgba8) {
+      // Average four source pixels of two rows into two destination pixels
+      // at a time, in 16 bits per component to avoid overflow.  This gives
+      // the same result as filter_2d_unsigned_byte().
+      const __m128i zero = _mm_setzero_si128();
+      for (; x + 2 <= to_x_size; x += 2) {
+        __m128i r0 = _mm_loadu_si128((const __m128i *)q);
+        __m128i r1 = _mm_loadu_si128((const __m128i *)(q + row_size));
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+        __m128i sum = _mm_srli_epi16(_mm_unpacklo_epi64(lo, hi), 2);
+        _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(sum, zero));
+        p += 8;
+        q += 16;
+      }
+    }
+#endif  // TEXTURE_USE_SSE2
+
+    for (; x < to_x_size; ++x) {
+      // For each pixel.
+      for (int c = 0; c < rows._num_color_components; ++c) {
+        // For each component.
+        rows._filter_component(p, q, pixel_size, row_size);
+      }
+      if (rows._alpha) {
+        rows._filter_alpha(p, q, pixel_size, row_size);
+      }
+      q += pixel_size;
+    }
+    Thread::consider_yield();
+  }
+}
+
+/**
+ * Used by do_filter_2d_mipmap_pages() to filter the nth band of rows on one
+ * of the texture-mipmap-threads.
+ */
+void Texture::
+filter_2d_rows_run(size_t n, void *data) {
+  filter_2d_rows(((const Filter2DRows *)data)[n]);
+}
+
 /**
  * Generates the next mipmap level from the previous one, treating all the
  * pages of the level as a single 3-d block of pixels.
@@ -878,6 +878,30 @@ private:
                                  const unsigned char *&q,
                                  size_t pixel_size, size_t row_size);
 
+  // A band of destination rows of one 2-D mipmap level, numbered
+  // consecutively across all of the pages, for filter_2d_rows().
+  class Filter2DRows {
+  public:
+    unsigned char *_to;
+    const unsigned char *_from;
+    size_t _to_page_size;
+    size_t _from_page_size;
+    size_t _pixel_size;
+    size_t _row_size;
+    size_t _to_row_size;
+    int _x_size;
+    int _rows_per_page;
+    int _begin;
+    int _end;
+    int _num_color_components;
+    bool _alpha;
+    bool _rgba8;
+    Filter2DComponent *_filter_component;
+    Filter2DComponent *_filter_alpha;
+  };
+  static void filter_2d_rows(const Filter2DRows &rows);
+  static void filter_2d_rows_run(size_t n, void *data);
+
   typedef void Filter3DComponent(unsigned char *&p,
                                  const unsigned char *&q,
                                  size_t pixel_size, size_t row_size,
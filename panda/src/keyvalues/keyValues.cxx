@@ -19,6 +19,7 @@
 #include "keyValues.h"
 
 #include "virtualFileSystem.h"
+#include "datagram.h"
 
 NotifyCategoryDeclNoExport(keyvalues)
 NotifyCategoryDef(keyvalues, "")
@@ -31,25 +32,41 @@ enum {
 	KVTOKEN_MACROS,
 };
 
+// The first bytes of a compiled KeyValues file.  A text file never starts
+// with a null byte, so load() can tell the two apart.
+static const char compiled_magic[4] = { '\0', 'K', 'V', 'C' };
+static const uint8_t compiled_version = 1;
+
+/**
+ * A token returned by the tokenizer.  The string data points either directly
+ * into the file buffer, or into the tokenizer's scratch buffer if the string
+ * had escape sequences or line breaks removed from it; either way, it is only
+ * valid until the next call to next_token().
+ */
 struct KeyValueToken_t {
 	int type;
-	std::string data;
+	const char *data;
+	size_t length;
 
 	bool invalid() const {
 		return type == KVTOKEN_NONE;
 	}
 };
 
+/**
+ * Splits a KeyValues text buffer into tokens.  The buffer is not copied, and
+ * must remain valid for as long as the tokenizer is used.
+ */
 class CKeyValuesTokenizer {
 public:
-	CKeyValuesTokenizer(const std::string &buffer);
+	CKeyValuesTokenizer(const char *buffer, size_t length);
 
 	KeyValueToken_t next_token();
 
 private:
 	void ignore_whitespace();
 	bool ignore_comment();
-	std::string get_string();
+	void get_string(KeyValueToken_t &token);
 
 	char current();
 	bool forward();
@@ -57,16 +74,20 @@ private:
 	std::string location();
 
 private:
-	std::string _buffer;
+	const char *_buffer;
 	size_t _buflen;
 	size_t _position;
 	int _last_line_break;
 	int _line;
+
+	// Holds the string of the last token, if it could not be returned as a
+	// range of the buffer.
+	std::string _scratch;
 };
 
-CKeyValuesTokenizer::CKeyValuesTokenizer(const std::string &buffer) {
+CKeyValuesTokenizer::CKeyValuesTokenizer(const char *buffer, size_t length) {
 	_buffer = buffer;
-	_buflen = buffer.size();
+	_buflen = length;
 	_position = 0;
 	_last_line_break = 0;
 	_line = 1;
@@ -74,6 +95,8 @@ CKeyValuesTokenizer::CKeyValuesTokenizer(const std::string &buffer) {
 
 KeyValueToken_t CKeyValuesTokenizer::next_token() {
 	KeyValueToken_t token;
+	token.data = nullptr;
+	token.length = 0;
 
 	while (1) {
 		ignore_whitespace();
@@ -99,22 +122,62 @@ KeyValueToken_t CKeyValuesTokenizer::next_token() {
 		token.type = KVTOKEN_BLOCK_END;
 		return token;
 	} else {
-		token.data = get_string();
+		get_string(token);
 		token.type = KVTOKEN_STRING;
 		return token;
 	}
 }
 
-std::string CKeyValuesTokenizer::get_string() {
-	bool escape = false;
-	std::string result = "";
-
+void CKeyValuesTokenizer::get_string(KeyValueToken_t &token) {
 	bool quoted = false;
 	if (current() == '"') {
 		quoted = true;
 		forward();
 	}
 
+	// Most strings have nothing to remove from them, so we first scan for the
+	// end of the string, and return it as a range of the buffer if we can.
+	size_t start = _position;
+	bool simple = true;
+	while (1) {
+		char c = current();
+
+		// Check if we have a character yet
+		if (!c) {
+			break;
+		}
+
+		// These characters are not part of unquoted strings.
+		if (!quoted && (c == '{' || c == '}')) {
+			break;
+		}
+
+		// Check if it's the end of a quoted string.
+		if (quoted && c == '"') {
+			break;
+		}
+
+		if (c == '\\' || c == '\n' || c == '\r') {
+			simple = false;
+			break;
+		}
+
+		forward();
+	}
+
+	if (simple) {
+		token.data = _buffer + start;
+		token.length = _position - start;
+		if (quoted) {
+			forward();
+		}
+		return;
+	}
+
+	// Otherwise, copy what we have so far to the scratch buffer and build the
+	// rest of the string there.
+	_scratch.assign(_buffer + start, _position - start);
+	bool escape = false;
 	while (1) {
 		char c = current();
 
@@ -138,14 +201,14 @@ std::string CKeyValuesTokenizer::get_string() {
 			escape = false;
 
 			if (c == '"') {
-				result += '"';
+				_scratch += '"';
 			} else if (c == '\\') {
-				result += '\\';
+				_scratch += '\\';
 			}
 		} else if (c == '\\') {
 			escape = true;
 		} else if (c != '\n' && c != '\r') {
-			result += c;
+			_scratch += c;
 		}
 
 		forward();
@@ -155,7 +218,8 @@ std::string CKeyValuesTokenizer::get_string() {
 		forward();
 	}
 
-	return result;
+	token.data = _scratch.data();
+	token.length = _scratch.size();
 }
 
 void CKeyValuesTokenizer::ignore_whitespace() {
@@ -182,7 +246,8 @@ void CKeyValuesTokenizer::ignore_whitespace() {
 
 bool CKeyValuesTokenizer::ignore_comment() {
 	if (current() == '/' && next() == '/') {
-		while (current() != '\n') {
+		// A comment on the last line may not end with a line break.
+		while (current() && current() != '\n') {
 			forward();
 		}
 
@@ -248,6 +313,10 @@ pvector<CKeyValues *> CKeyValues::get_children_with_name(const std::string &name
 
 void CKeyValues::parse(CKeyValuesTokenizer *tokenizer) {
 	bool has_key = false;
+
+	// The key has to be copied out of the token, since the next token may
+	// reuse the tokenizer's scratch buffer.  We reuse the same string for
+	// every key in the block.
 	std::string key;
 
 	while (1) {
@@ -263,9 +332,9 @@ void CKeyValues::parse(CKeyValuesTokenizer *tokenizer) {
 				PT(CKeyValues) child = new CKeyValues(key, this);
 				child->_filename = _filename;
 				child->parse(tokenizer);
-				_children.push_back(child);
+				_children.push_back(std::move(child));
 			} else if (token.type == KVTOKEN_STRING) {
-				_keyvalues[key] = token.data;
+				_keyvalues[key].assign(token.data, token.length);
 			} else {
 				keyvalues_cat.error()
 					<< "Invalid token " << token.type << "\n";
@@ -282,22 +351,34 @@ void CKeyValues::parse(CKeyValuesTokenizer *tokenizer) {
 				break;
 			}
 			has_key = true;
-			key = token.data;
+			key.assign(token.data, token.length);
 		}
 	}
 }
 
+/**
+ * Loads the indicated KeyValues file, which may be either a text file or a
+ * file written by write_compiled().  Returns NULL if the file could not be
+ * read.
+ */
 PT(CKeyValues) CKeyValues::load(const Filename &filename) {
 	VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-	if (!vfs->exists(filename)) {
+
+	// We parse the file in place, so read it straight into a buffer of our
+	// own rather than into a string that we would have to copy from.
+	vector_uchar buffer;
+	if (!vfs->read_file(filename, buffer, true)) {
 		keyvalues_cat.error()
 			<< "Unable to find `" << filename.get_fullpath() << "`\n";
 		return nullptr;
 	}
 
-	std::string buffer = vfs->read_file(filename, true);
+	if (buffer.size() >= sizeof(compiled_magic) &&
+	    memcmp(buffer.data(), compiled_magic, sizeof(compiled_magic)) == 0) {
+		return load_compiled(filename, buffer);
+	}
 
-	CKeyValuesTokenizer tokenizer(buffer);
+	CKeyValuesTokenizer tokenizer((const char *)buffer.data(), buffer.size());
 
 	PT(CKeyValues) kv = new CKeyValues("__root");
 	kv->_filename = filename;
@@ -313,6 +394,198 @@ PT(CKeyValues) CKeyValues::load(const Filename &filename) {
 	return kv;
 }
 
+//------------------------------------------------------------------------------------------------
+// The compiled KeyValues format.  After the magic number and version, it has a
+// table of every distinct string in the tree, each written once, followed by
+// the blocks in depth-first order.  Each block is the index of its name in the
+// string table, its key-value pairs as pairs of string indices, and then its
+// children.  All numbers are little-endian.
+//------------------------------------------------------------------------------------------------
+
+/**
+ * Writes this block and its children to the indicated file in the compiled
+ * KeyValues format, which load() reads without having to tokenize it.
+ * Returns true on success.
+ */
+bool CKeyValues::write_compiled(const Filename &filename) const {
+	StringTable table;
+	pvector<const std::string *> strings;
+	r_collect_strings(table, strings);
+
+	Datagram dg;
+	dg.append_data(compiled_magic, sizeof(compiled_magic));
+	dg.add_uint8(compiled_version);
+
+	dg.add_uint32((uint32_t)strings.size());
+	for (const std::string *str : strings) {
+		dg.add_string32(*str);
+	}
+
+	r_write_compiled(dg, table);
+
+	VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+	if (!vfs->write_file(filename, (const unsigned char *)dg.get_data(), dg.get_length(), false)) {
+		keyvalues_cat.error()
+			<< "Unable to write `" << filename.get_fullpath() << "`\n";
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Adds each string used by this block and its children to the table, if it
+ * is not there already.
+ */
+void CKeyValues::r_collect_strings(StringTable &table, pvector<const std::string *> &strings) const {
+	if (table.find(_name) == -1) {
+		table[_name] = (uint32_t)strings.size();
+		strings.push_back(&_name);
+	}
+	for (size_t i = 0; i < _keyvalues.size(); i++) {
+		const std::string &key = _keyvalues.get_key(i);
+		const std::string &value = _keyvalues.get_data(i);
+		if (table.find(key) == -1) {
+			table[key] = (uint32_t)strings.size();
+			strings.push_back(&key);
+		}
+		if (table.find(value) == -1) {
+			table[value] = (uint32_t)strings.size();
+			strings.push_back(&value);
+		}
+	}
+	for (const CKeyValues *child : _children) {
+		child->r_collect_strings(table, strings);
+	}
+}
+
+/**
+ * Writes this block and its children to the datagram.
+ */
+void CKeyValues::r_write_compiled(Datagram &dg, const StringTable &table) const {
+	dg.add_uint32(table.get_data(table.find(_name)));
+	dg.add_uint32((uint32_t)_keyvalues.size());
+	for (size_t i = 0; i < _keyvalues.size(); i++) {
+		dg.add_uint32(table.get_data(table.find(_keyvalues.get_key(i))));
+		dg.add_uint32(table.get_data(table.find(_keyvalues.get_data(i))));
+	}
+	dg.add_uint32((uint32_t)_children.size());
+	for (const CKeyValues *child : _children) {
+		child->r_write_compiled(dg, table);
+	}
+}
+
+/**
+ * Builds the tree from a buffer that has been read from a compiled KeyValues
+ * file.  The string table refers directly into the buffer.
+ */
+PT(CKeyValues) CKeyValues::load_compiled(const Filename &filename, const vector_uchar &buffer) {
+	const char *data = (const char *)buffer.data();
+	size_t size = buffer.size();
+	size_t pos = sizeof(compiled_magic);
+
+	if (pos >= size || (uint8_t)data[pos] != compiled_version) {
+		keyvalues_cat.error()
+			<< "`" << filename << "` was compiled with an unsupported version\n";
+		return nullptr;
+	}
+	++pos;
+
+	CompiledReader reader;
+	reader._data = data;
+	reader._size = size;
+	reader._pos = pos;
+	reader._error = false;
+
+	uint32_t num_strings = reader.get_uint32();
+	if (num_strings > (size - reader._pos) / 4) {
+		reader._error = true;
+	}
+	if (!reader._error) {
+		reader._strings.reserve(num_strings);
+		for (uint32_t i = 0; i < num_strings && !reader._error; i++) {
+			uint32_t length = reader.get_uint32();
+			if (length > reader._size - reader._pos) {
+				reader._error = true;
+				break;
+			}
+			reader._strings.push_back(CompiledString(data + reader._pos, length));
+			reader._pos += length;
+		}
+	}
+
+	PT(CKeyValues) kv = new CKeyValues("__root");
+	kv->_filename = filename;
+	if (!reader._error) {
+		kv->r_read_compiled(reader);
+	}
+
+	if (reader._error || reader._pos != reader._size) {
+		keyvalues_cat.error()
+			<< "`" << filename << "` is not a valid compiled KeyValues file\n";
+		return nullptr;
+	}
+
+	return kv;
+}
+
+/**
+ * Reads this block and its children from a compiled KeyValues buffer.
+ */
+void CKeyValues::r_read_compiled(CompiledReader &reader) {
+	const CompiledString &name = reader.get_string();
+	_name.assign(name.first, name.second);
+
+	uint32_t num_keys = reader.get_uint32();
+	for (uint32_t i = 0; i < num_keys && !reader._error; i++) {
+		const CompiledString &key = reader.get_string();
+		const CompiledString &value = reader.get_string();
+		_keyvalues[std::string(key.first, key.second)].assign(value.first, value.second);
+	}
+
+	uint32_t num_children = reader.get_uint32();
+	if (num_children > reader._size - reader._pos) {
+		reader._error = true;
+		return;
+	}
+	_children.reserve(num_children);
+	for (uint32_t i = 0; i < num_children && !reader._error; i++) {
+		PT(CKeyValues) child = new CKeyValues(std::string(), this);
+		child->_filename = _filename;
+		child->r_read_compiled(reader);
+		_children.push_back(std::move(child));
+	}
+}
+
+/**
+ * Returns the next little-endian 32-bit number from the buffer, or 0 and sets
+ * the error flag if the buffer has run out.
+ */
+uint32_t CKeyValues::CompiledReader::get_uint32() {
+	if (_error || _size - _pos < 4) {
+		_error = true;
+		return 0;
+	}
+	const unsigned char *p = (const unsigned char *)_data + _pos;
+	_pos += 4;
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Reads a string index from the buffer and returns the corresponding string
+ * from the string table, or an empty string and sets the error flag if it is
+ * out of range.
+ */
+const CKeyValues::CompiledString &CKeyValues::CompiledReader::get_string() {
+	static const CompiledString empty("", 0);
+	uint32_t index = get_uint32();
+	if (_error || index >= _strings.size()) {
+		_error = true;
+		return empty;
+	}
+	return _strings[index];
+}
+
 //------------------------------------------------------------------------------------------------
 // Helper functions for parsing string values that represent numbers.
 //------------------------------------------------------------------------------------------------
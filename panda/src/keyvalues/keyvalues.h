@@ -23,8 +23,10 @@
 #include "luse.h"
 #include "vector_int.h"
 #include "vector_float.h"
+#include "vector_uchar.h"
 
 class CKeyValuesTokenizer;
+class Datagram;
 
 /**
  * Represents a single block from a key-values file.
@@ -57,10 +59,32 @@ PUBLISHED:
 	const Filename &get_filename() const;
 
 private:
+	typedef SimpleHashMap<std::string, uint32_t, string_hash> StringTable;
+	typedef std::pair<const char *, size_t> CompiledString;
+
+	// Reads numbers and string indices from a compiled KeyValues buffer.
+	class CompiledReader {
+	public:
+		uint32_t get_uint32();
+		const CompiledString &get_string();
+
+		const char *_data;
+		size_t _size;
+		size_t _pos;
+		bool _error;
+		pvector<CompiledString> _strings;
+	};
+
 	void parse(CKeyValuesTokenizer *tokenizer);
 
+	static PT(CKeyValues) load_compiled(const Filename &filename, const vector_uchar &buffer);
+	void r_collect_strings(StringTable &table, pvector<const std::string *> &strings) const;
+	void r_write_compiled(Datagram &dg, const StringTable &table) const;
+	void r_read_compiled(CompiledReader &reader);
+
 PUBLISHED:
 	static PT(CKeyValues) load(const Filename &filename);
+	bool write_compiled(const Filename &filename) const;
 
   static vector_int parse_num_list_str(const std::string &str);
 	static vector_float parse_float_list_str(const std::string &str);
@@ -0,0 +1,151 @@
+/**
+ * PANDA3D BSP LIBRARY
+ *
+ * Copyright (c) Brian Lach <brianlach72@gmail.com>
+ * All rights reserved.
+ *
+ * @file test_keyvalues.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ *
+ * @desc Measures how quickly the KeyValues files in a directory (such as the
+ *	 materials directory) can be parsed, from text and from the compiled
+ *	 form, and checks that both give the same tree.
+ */
+
+#include "keyvalues.h"
+#include "virtualFileSystem.h"
+#include "virtualFileMountRamdisk.h"
+#include "virtualFileList.h"
+#include "trueClock.h"
+#include "string_utils.h"
+
+/**
+ * Adds every regular file under the indicated directory with one of the
+ * KeyValues extensions to the list.
+ */
+static void
+r_find_files(VirtualFile *dir, pvector<Filename> &files, size_t &total_size) {
+	PT(VirtualFileList) contents = dir->scan_directory();
+	if (contents == nullptr) {
+		return;
+	}
+	for (size_t i = 0; i < contents->get_num_files(); i++) {
+		VirtualFile *file = contents->get_file(i);
+		if (file->is_directory()) {
+			r_find_files(file, files, total_size);
+		} else {
+			std::string ext = file->get_filename().get_extension();
+			if (ext == "mat" || ext == "txt" || ext == "vmt" || ext == "kv") {
+				files.push_back(file->get_filename());
+				total_size += file->get_file_size();
+			}
+		}
+	}
+}
+
+/**
+ * Returns true if the two trees have the same names, keys, values and
+ * children, in the same order.
+ */
+static bool
+compare_trees(const CKeyValues *a, const CKeyValues *b) {
+	if (a->get_name() != b->get_name() ||
+	    a->get_num_keys() != b->get_num_keys() ||
+	    a->get_num_children() != b->get_num_children()) {
+		return false;
+	}
+	for (size_t i = 0; i < a->get_num_keys(); i++) {
+		if (a->get_key(i) != b->get_key(i) || a->get_value(i) != b->get_value(i)) {
+			return false;
+		}
+	}
+	for (size_t i = 0; i < a->get_num_children(); i++) {
+		if (!compare_trees(a->get_child(i), b->get_child(i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Loads each of the files the indicated number of times, and returns the
+ * elapsed time in seconds.
+ */
+static double
+load_all(const pvector<Filename> &files, int passes) {
+	TrueClock *clock = TrueClock::get_global_ptr();
+	double start = clock->get_short_time();
+	for (int pass = 0; pass < passes; pass++) {
+		for (const Filename &filename : files) {
+			PT(CKeyValues) kv = CKeyValues::load(filename);
+			nassertr(kv != nullptr, 0.0);
+		}
+	}
+	return clock->get_short_time() - start;
+}
+
+int
+main(int argc, char *argv[]) {
+	if (argc < 2 || argc > 3) {
+		nout << "test_keyvalues directory [passes]\n";
+		exit(1);
+	}
+
+	Filename dirname = Filename::from_os_specific(argv[1]);
+	int passes = (argc > 2) ? atoi(argv[2]) : 10;
+
+	VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+	PT(VirtualFile) dir = vfs->get_file(dirname);
+	if (dir == nullptr || !dir->is_directory()) {
+		nout << dirname << " is not a directory\n";
+		exit(1);
+	}
+
+	pvector<Filename> text_files;
+	size_t text_size = 0;
+	r_find_files(dir, text_files, text_size);
+	if (text_files.empty()) {
+		nout << "No KeyValues files found in " << dirname << "\n";
+		exit(1);
+	}
+
+	// Compile each file onto a ramdisk.  The text files are read once more
+	// below before timing, so that both sets of loads come from memory.
+	vfs->mount(new VirtualFileMountRamdisk, "/kvc", 0);
+	pvector<Filename> compiled_files;
+	size_t compiled_size = 0;
+	for (size_t i = 0; i < text_files.size(); i++) {
+		PT(CKeyValues) kv = CKeyValues::load(text_files[i]);
+		if (kv == nullptr) {
+			nout << "Could not load " << text_files[i] << "\n";
+			exit(1);
+		}
+		Filename compiled("/kvc/" + format_string(i) + ".kvc");
+		kv->write_compiled(compiled);
+		compiled_size += vfs->get_file(compiled)->get_file_size();
+
+		PT(CKeyValues) reloaded = CKeyValues::load(compiled);
+		if (reloaded == nullptr || !compare_trees(kv, reloaded)) {
+			nout << "Compiled form of " << text_files[i] << " does not match\n";
+			exit(1);
+		}
+		compiled_files.push_back(compiled);
+	}
+
+	// Warm up the file caches before timing anything.
+	load_all(text_files, 1);
+
+	double text_time = load_all(text_files, passes);
+	double compiled_time = load_all(compiled_files, passes);
+
+	double num_loads = (double)text_files.size() * passes;
+	nout << text_files.size() << " files, " << passes << " passes\n"
+	     << "text: " << text_size << " bytes, "
+	     << text_time * 1.0e6 / num_loads << " us per file, "
+	     << text_size * passes / text_time / 1.0e6 << " MB/s\n"
+	     << "compiled: " << compiled_size << " bytes, "
+	     << compiled_time * 1.0e6 / num_loads << " us per file ("
+	     << text_time / compiled_time << "x)\n";
+	return 0;
+}
@@ -19,6 +19,8 @@
 #include "datagramIterator.h"
 #include "compose_matrix.h"
 #include "pmap.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
 #include <math.h>
 
 #ifdef HAVE_FFTW
@@ -40,6 +42,11 @@ typedef pmap<int, fftw_plan> RealPlans;
 static RealPlans _real_compress_plans;
 static RealPlans _real_decompress_plans;
 
+// Protects the above maps, since several threads may be decompressing at once
+// while a bam file is read.  The FFTW planner itself is not thread-safe either,
+// so the plans are also created while holding this.
+static LightMutex _real_plans_lock("FFTCompressor::_real_plans_lock");
+
 #endif
 
 /**
@@ -819,6 +826,7 @@ read_hprs(DatagramIterator &di, pvector<LVecBase3> &array) {
 void FFTCompressor::
 free_storage() {
 #ifdef HAVE_FFTW
+  LightMutexHolder holder(_real_plans_lock);
   RealPlans::iterator pi;
   for (pi = _real_compress_plans.begin();
        pi != _real_compress_plans.end();
@@ -1053,6 +1061,7 @@ get_compressability(const PN_stdfloat *data, int length) const {
  */
 static fftw_plan
 get_real_compress_plan(int length) {
+  LightMutexHolder holder(_real_plans_lock);
   RealPlans::iterator pi;
   pi = _real_compress_plans.find(length);
   if (pi != _real_compress_plans.end()) {
@@ -1072,6 +1081,7 @@ get_real_compress_plan(int length) {
  */
 static fftw_plan
 get_real_decompress_plan(int length) {
+  LightMutexHolder holder(_real_plans_lock);
   RealPlans::iterator pi;
   pi = _real_decompress_plans.find(length);
   if (pi != _real_decompress_plans.end()) {
@@ -80,6 +80,8 @@ protected:
   inline bool SendMessageBufferOnly(Datagram &msg); // do not use this .. this is a way for the the COnnecting UPcall to drop messages in queue first..
 PUBLISHED:
   inline bool GetMessage(Datagram &val);
+  inline bool PeekMessage(const char *&data, size_t &length);
+  inline void SkipMessage(void);
   inline bool DoConnect(void);           // all the real state magic is in here
   inline bool IsConnected(void);
   inline explicit Buffered_DatagramConnection(int rbufsize, int wbufsize, int write_flush_point) ;
@@ -270,6 +272,37 @@ inline bool Buffered_DatagramConnection::GetMessage(Datagram  &val)
 
 
 
+/**
+ * Returns the next message in place in the receive buffer, without copying
+ * it into a Datagram.  The message is not consumed; call SkipMessage() once
+ * it has been dealt with, or GetMessage() to retrieve it normally.  The
+ * pointer is only valid until the next call to PeekMessage() or GetMessage().
+ */
+inline bool Buffered_DatagramConnection::PeekMessage(const char *&data, size_t &length)
+{
+  if(IsConnected())
+  {
+    int ans1 = _Reader.PumpMessagePeek(data,length,*this);
+    if(ans1 == 0)
+      return false;
+    if(ans1 <0) {
+      nativenet_cat.error() << "Buffered_DatagramConnection::PeekMessage->Error On PumpMessagePeek--Out Buffer = " << _Writer.AmountBuffered() << "\n";
+      ClearAll();
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Consumes the message most recently returned by PeekMessage().
+ */
+inline void Buffered_DatagramConnection::SkipMessage(void)
+{
+  _Reader.SkipMessage();
+}
+
 /**
  * Flush all writes.
  */
@@ -11,6 +11,7 @@
 class Buffered_DatagramReader : protected RingBuffer {
 private:
   inline bool GetMessageFromBuffer(Datagram &inmsg);
+  inline bool PeekMessageFromBuffer(const char *&data, size_t &length);
 
 public:
   inline Buffered_DatagramReader(int in_size = 8192) ;
@@ -37,6 +38,31 @@ public:
     return 0;
   }
 
+  // Like PumpMessageReader, but returns a pointer to the next message in
+  // place rather than copying it into a Datagram.  The message stays in the
+  // buffer until SkipMessage() is called, and the pointer is only valid
+  // until the next pump.
+  template<class SOCK_TYPE>
+  inline int PumpMessagePeek(const char *&data, size_t &length, SOCK_TYPE &sck) {
+    if (PeekMessageFromBuffer(data, length)) {
+      return 1;
+    }
+    int rp = ReadPump(sck);
+    if (rp == 0) {
+      return 0;
+    }
+
+    if (rp < 1) {
+      return -1;
+    }
+    if (PeekMessageFromBuffer(data, length)) {
+      return 1;
+    }
+    return 0;
+  }
+
+  inline void SkipMessage(void);
+
   template<class SOCK_TYPE>
   inline int ReadPump(SOCK_TYPE &sck) {
     int answer = 0;
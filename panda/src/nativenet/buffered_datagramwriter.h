@@ -23,6 +23,7 @@ public:
   Buffered_DatagramWriter(size_t in_size, int in_flush_point = -1);
   inline int AddData(const void *data, size_t len, Socket_TCP &sck);
   inline int AddData(const void *data, size_t len);
+  inline int SendGather(const void *data, size_t len, Socket_TCP &sck);
 
   // THE FUNCTIONS THAT TAKE A SOCKET NEED TO BE TEMPLATED TO WORK..
   template<class SOCK_TYPE>
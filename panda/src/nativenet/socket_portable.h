@@ -12,6 +12,7 @@ const int BASIC_ERROR = -1;
 // Interrogate doesn't need to parse any of this.
 
 typedef unsigned long SOCKET;
+struct SOCKET_IOVEC;
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -41,6 +42,34 @@ inline int DO_SOCKET_WRITE(const SOCKET a, const char *buff, const int len) {
 inline int DO_SOCKET_WRITE_TO(const SOCKET a, const char *buffer, const int buf_len, const sockaddr *addr) {
   return sendto(a, buffer, buf_len, 0, addr, SA_SIZEOF(addr));
 }
+
+// A list of buffers to send with a single call, as by writev().
+typedef WSABUF SOCKET_IOVEC;
+
+inline void SET_SOCKET_IOVEC(SOCKET_IOVEC &iov, const void *data, size_t len) {
+  iov.buf = (char *)data;
+  iov.len = (ULONG)len;
+}
+inline const char *SOCKET_IOVEC_DATA(const SOCKET_IOVEC &iov) {
+  return iov.buf;
+}
+inline size_t SOCKET_IOVEC_LEN(const SOCKET_IOVEC &iov) {
+  return iov.len;
+}
+inline int DO_SOCKET_WRITEV(const SOCKET a, const SOCKET_IOVEC *iov, const int count) {
+  DWORD sent = 0;
+  if (WSASend(a, (LPWSABUF)iov, (DWORD)count, &sent, 0, nullptr, nullptr) != 0) {
+    return -1;
+  }
+  return (int)sent;
+}
+inline int DO_SOCKET_WRITEV_TO(const SOCKET a, const SOCKET_IOVEC *iov, const int count, const sockaddr *addr) {
+  DWORD sent = 0;
+  if (WSASendTo(a, (LPWSABUF)iov, (DWORD)count, &sent, 0, addr, SA_SIZEOF(addr), nullptr, nullptr) != 0) {
+    return -1;
+  }
+  return (int)sent;
+}
 inline SOCKET DO_NEWUDP(sa_family_t family) {
   return socket(family, SOCK_DGRAM, 0);
 }
@@ -106,6 +135,7 @@ const SOCKET BAD_SOCKET = (SOCKET)-1;
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <sys/filio.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #include <errno.h>
@@ -134,6 +164,32 @@ inline int DO_SOCKET_WRITE(const SOCKET a, const char *buff, const int len) {
 inline int DO_SOCKET_WRITE_TO(const SOCKET a, const char *buffer, const int buf_len, const sockaddr *addr) {
   return sendto(a, buffer, buf_len, 0, addr, SA_SIZEOF(addr));
 }
+
+// A list of buffers to send with a single call, as by writev().
+typedef struct iovec SOCKET_IOVEC;
+
+inline void SET_SOCKET_IOVEC(SOCKET_IOVEC &iov, const void *data, size_t len) {
+  iov.iov_base = (void *)data;
+  iov.iov_len = len;
+}
+inline const char *SOCKET_IOVEC_DATA(const SOCKET_IOVEC &iov) {
+  return (const char *)iov.iov_base;
+}
+inline size_t SOCKET_IOVEC_LEN(const SOCKET_IOVEC &iov) {
+  return iov.iov_len;
+}
+inline int DO_SOCKET_WRITEV(const SOCKET a, const SOCKET_IOVEC *iov, const int count) {
+  return (int)writev(a, iov, count);
+}
+inline int DO_SOCKET_WRITEV_TO(const SOCKET a, const SOCKET_IOVEC *iov, const int count, const sockaddr *addr) {
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = (void *)addr;
+  msg.msg_namelen = SA_SIZEOF(addr);
+  msg.msg_iov = (SOCKET_IOVEC *)iov;
+  msg.msg_iovlen = count;
+  return (int)sendmsg(a, &msg, 0);
+}
 inline SOCKET DO_NEWUDP(sa_family_t family) {
   return socket(family, SOCK_DGRAM, 0);
 }
@@ -189,6 +245,7 @@ const int LOCAL_CONNECT_BLOCKING = EINPROGRESS;
 #include <sys/time.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #include <errno.h>
@@ -196,6 +253,7 @@ const int LOCAL_CONNECT_BLOCKING = EINPROGRESS;
 #include <signal.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
 // #include <netinetin_systm.h>
 #include <netinet/tcp.h>
 // #include <netinetip.h>
@@ -221,6 +279,32 @@ inline int DO_SOCKET_WRITE(const SOCKET a, const char *buff, const int len) {
 inline int DO_SOCKET_WRITE_TO(const SOCKET a, const char *buffer, const int buf_len, const sockaddr *addr) {
   return (int)sendto(a, buffer, (size_t)buf_len, 0, addr, SA_SIZEOF(addr));
 }
+
+// A list of buffers to send with a single call, as by writev().
+typedef struct iovec SOCKET_IOVEC;
+
+inline void SET_SOCKET_IOVEC(SOCKET_IOVEC &iov, const void *data, size_t len) {
+  iov.iov_base = (void *)data;
+  iov.iov_len = len;
+}
+inline const char *SOCKET_IOVEC_DATA(const SOCKET_IOVEC &iov) {
+  return (const char *)iov.iov_base;
+}
+inline size_t SOCKET_IOVEC_LEN(const SOCKET_IOVEC &iov) {
+  return iov.iov_len;
+}
+inline int DO_SOCKET_WRITEV(const SOCKET a, const SOCKET_IOVEC *iov, const int count) {
+  return (int)writev(a, iov, count);
+}
+inline int DO_SOCKET_WRITEV_TO(const SOCKET a, const SOCKET_IOVEC *iov, const int count, const sockaddr *addr) {
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = (void *)addr;
+  msg.msg_namelen = SA_SIZEOF(addr);
+  msg.msg_iov = (SOCKET_IOVEC *)iov;
+  msg.msg_iovlen = count;
+  return (int)sendmsg(a, &msg, 0);
+}
 inline SOCKET DO_NEWUDP(sa_family_t family) {
   return socket(family, SOCK_DGRAM, 0);
 }
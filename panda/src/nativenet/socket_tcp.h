@@ -29,6 +29,7 @@ PUBLISHED:
   std::string RecvData(int max_len);
 public:
   inline int SendData(const char *data, int size);
+  inline int SendDataV(const SOCKET_IOVEC *iov, int count);
   inline int RecvData(char *data, int size);
 
 public:
@@ -168,6 +169,16 @@ SendData(const char *data, int size) {
   return DO_SOCKET_WRITE(_socket, data, size);
 }
 
+/**
+ * Sends the contents of several buffers at once, in order, as by writev().
+ * Returns the number of bytes written, which may be less than the total, or
+ * a negative number on error.
+ */
+inline int Socket_TCP::
+SendDataV(const SOCKET_IOVEC *iov, int count) {
+  return DO_SOCKET_WRITEV(_socket, iov, count);
+}
+
 /**
  * Read the data from the connection - if error 0 if socket closed for read or
  * length is 0 + bytes read ( May be smaller than requested)
@@ -35,6 +35,8 @@ PUBLISHED:
   inline bool Send(const vector_uchar &data);
 public:
   inline bool SendTo(const char *data, int len, const Socket_Address &address);
+  inline bool SendToV(const SOCKET_IOVEC *iov, int count, int len,
+                      const Socket_Address &address);
 PUBLISHED:
   inline bool SendTo(const vector_uchar &data, const Socket_Address &address);
   inline bool SetToBroadCast();
@@ -109,6 +111,15 @@ SendTo(const char *data, int len, const Socket_Address &address) {
   return (DO_SOCKET_WRITE_TO(_socket, data, len, &address.GetAddressInfo()) == len);
 }
 
+/**
+ * Sends the contents of several buffers as a single packet to the specified
+ * address.  len is the total length of the buffers.
+ */
+inline bool Socket_UDP::
+SendToV(const SOCKET_IOVEC *iov, int count, int len, const Socket_Address &address) {
+  return (DO_SOCKET_WRITEV_TO(_socket, iov, count, &address.GetAddressInfo()) == len);
+}
+
 /**
  * Send data to specified address
  */
@@ -0,0 +1,73 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file atomicRingQueue.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef ATOMICRINGQUEUE_H
+#define ATOMICRINGQUEUE_H
+
+#include "pandabase.h"
+#include "atomicAdjust.h"
+
+/**
+ * A bounded FIFO queue that any number of threads may push onto and pop from
+ * at once, without a lock.  Each slot of the ring carries a sequence number
+ * that tells a producer when the slot is free and a consumer when it is
+ * full; threads claim a slot by advancing the head or tail with a single
+ * compare-and-exchange.
+ *
+ * The things are moved in and out of preallocated slots, so a queue of
+ * NetDatagrams hands each datagram's buffer from producer to consumer
+ * without copying or allocating.  This is used by QueuedReturn and
+ * DatagramQueue when net-ring-queue is enabled.
+ */
+template<class Thing>
+class AtomicRingQueue {
+public:
+  explicit AtomicRingQueue(size_t capacity);
+  AtomicRingQueue(const AtomicRingQueue &copy) = delete;
+  ~AtomicRingQueue();
+
+  AtomicRingQueue &operator = (const AtomicRingQueue &copy) = delete;
+
+  INLINE bool push(const Thing &thing);
+  INLINE bool push(Thing &&thing);
+  INLINE bool pop(Thing &result);
+
+  INLINE size_t get_capacity() const;
+  INLINE size_t size() const;
+  INLINE bool empty() const;
+
+private:
+  INLINE size_t claim_push_slot();
+  INLINE void release_push_slot(size_t pos);
+
+  class Slot {
+  public:
+    TVOLATILE AtomicAdjust::Integer _sequence;
+    Thing _thing;
+  };
+
+  Slot *_slots;
+  size_t _mask;
+
+  // The producers and the consumers each hammer on their own end of the
+  // ring, so keep the two counters on separate cache lines.
+  char _pad0[64];
+  TVOLATILE AtomicAdjust::Integer _tail;
+  char _pad1[64 - sizeof(AtomicAdjust::Integer)];
+  TVOLATILE AtomicAdjust::Integer _head;
+  char _pad2[64 - sizeof(AtomicAdjust::Integer)];
+};
+
+#include "atomicRingQueue.I"
+
+#endif
@@ -117,6 +117,107 @@ get_net_max_block() {
   return *net_max_block;
 }
 
+bool
+get_net_epoll() {
+  static ConfigVariableBool *net_epoll = nullptr;
+
+  if (net_epoll == nullptr) {
+    net_epoll = new ConfigVariableBool
+      ("net-epoll", false,
+       PRC_DESC("On Linux, set this true to have a ConnectionReader wait "
+                "for activity with epoll rather than select().  Each "
+                "reader thread then watches its own share of the "
+                "sockets, and adding or removing a socket is a "
+                "constant-time operation.  This has no effect on other "
+                "platforms."));
+  }
+
+  return *net_epoll;
+}
+
+bool
+get_net_ring_queue() {
+  static ConfigVariableBool *net_ring_queue = nullptr;
+
+  if (net_ring_queue == nullptr) {
+    net_ring_queue = new ConfigVariableBool
+      ("net-ring-queue", false,
+       PRC_DESC("Set this true to have a QueuedConnectionReader and a "
+                "threaded ConnectionWriter pass datagrams through a "
+                "lock-free ring of fixed size, rather than a deque "
+                "guarded by a mutex.  See net-ring-queue-size."));
+  }
+
+  return *net_ring_queue;
+}
+
+int
+get_net_ring_queue_size() {
+  static ConfigVariableInt *net_ring_queue_size = nullptr;
+
+  if (net_ring_queue_size == nullptr) {
+    net_ring_queue_size = new ConfigVariableInt
+      ("net-ring-queue-size", 4096,
+       PRC_DESC("The number of datagrams that fit in each ring when "
+                "net-ring-queue is true, rounded up to a power of two.  "
+                "The ring is allocated up front; a datagram that arrives "
+                "when it is full is dropped, just as when the queue "
+                "exceeds net-max-response-queue."));
+  }
+
+  return *net_ring_queue_size;
+}
+
+int
+get_net_datagram_pool_size() {
+  static ConfigVariableInt *net_datagram_pool_size = nullptr;
+
+  if (net_datagram_pool_size == nullptr) {
+    net_datagram_pool_size = new ConfigVariableInt
+      ("net-datagram-pool-size", 4,
+       PRC_DESC("The number of receive buffers a ConnectionReader keeps "
+                "for each socket.  A buffer is reused for a new datagram "
+                "once the application has let go of the last datagram "
+                "read into it, which saves allocating a new buffer for "
+                "each datagram.  Set this to 0 to allocate each time."));
+  }
+
+  return *net_datagram_pool_size;
+}
+
+int
+get_net_writer_batch_size() {
+  static ConfigVariableInt *net_writer_batch_size = nullptr;
+
+  if (net_writer_batch_size == nullptr) {
+    net_writer_batch_size = new ConfigVariableInt
+      ("net-writer-batch-size", 256,
+       PRC_DESC("The maximum number of datagrams a ConnectionWriter thread "
+                "takes from its queue before it flushes the connections "
+                "they were written to.  The datagrams for each connection "
+                "are sent together, with as few system calls as possible."));
+  }
+
+  return *net_writer_batch_size;
+}
+
+double
+get_net_writer_flush_deadline() {
+  static ConfigVariableDouble *net_writer_flush_deadline = nullptr;
+
+  if (net_writer_flush_deadline == nullptr) {
+    net_writer_flush_deadline = new ConfigVariableDouble
+      ("net-writer-flush-deadline", 0.0,
+       PRC_DESC("The maximum time, in seconds, that a ConnectionWriter "
+                "thread may hold a datagram while it waits for more to "
+                "send along with it.  If this is 0, the thread flushes as "
+                "soon as its queue is empty, or after "
+                "net-writer-batch-size datagrams."));
+  }
+
+  return *net_writer_flush_deadline;
+}
+
 // This function is used in the ReaderThread and WriterThread constructors to
 // make a simple name for each thread.
 std::string
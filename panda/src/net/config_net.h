@@ -31,6 +31,12 @@ extern int get_net_max_response_queue();
 extern bool get_net_error_abort();
 extern double get_net_max_poll_cycle();
 extern double get_net_max_block();
+extern bool get_net_epoll();
+extern bool get_net_ring_queue();
+extern int get_net_ring_queue_size();
+extern int get_net_datagram_pool_size();
+extern int get_net_writer_batch_size();
+extern double get_net_writer_flush_deadline();
 extern std::string make_thread_name(const std::string &thread_name, int thread_index);
 
 extern ConfigVariableInt net_max_read_per_epoch;
@@ -26,6 +26,9 @@
 #include "socket_udp.h"
 #include "dcast.h"
 
+TVOLATILE AtomicAdjust::Integer Connection::_num_flushes = 0;
+TVOLATILE AtomicAdjust::Integer Connection::_num_flush_syscalls = 0;
+TVOLATILE AtomicAdjust::Integer Connection::_num_flush_bytes = 0;
 
 /**
  * Creates a connection.  Normally this constructor should not be used
@@ -41,6 +44,7 @@ Connection(ConnectionManager *manager, Socket_IP *socket) :
   _collect_tcp_interval = collect_tcp_interval;
   _queued_data_start = 0.0;
   _queued_count = 0;
+  _queued_bytes = 0;
 
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
   // In the presence of SIMPLE_THREADS, we use non-blocking IO.  We simulate
@@ -149,7 +153,7 @@ bool Connection::
 consider_flush() {
   LightReMutexHolder holder(_write_mutex);
 
-  if (!_collect_tcp) {
+  if (!_collect_tcp || is_udp()) {
     return do_flush();
 
   } else {
@@ -286,53 +290,47 @@ set_max_segment(int size) {
   // TODO.
 }
 
+/**
+ * Returns the number of flushes that have written data to a socket, the
+ * number of system calls they made, and the number of bytes they sent, over
+ * all connections, since the last call to this function.  This is used to
+ * report these numbers to PStats.
+ */
+void Connection::
+get_flush_counts(int &num_flushes, int &num_syscalls, int &num_bytes) {
+  num_flushes = (int)AtomicAdjust::set(_num_flushes, 0);
+  num_syscalls = (int)AtomicAdjust::set(_num_flush_syscalls, 0);
+  num_bytes = (int)AtomicAdjust::set(_num_flush_bytes, 0);
+}
+
 /**
  * This method is intended only to be called by ConnectionWriter.  It
  * atomically writes the given datagram to the socket, returning true on
  * success, false on failure.  If the socket seems to be closed, it notifies
  * the ConnectionManager.
+ *
+ * If flush is false, the datagram is only queued, and will be sent along with
+ * any other queued datagrams by the next call to flush() or consider_flush().
  */
 bool Connection::
-send_datagram(const NetDatagram &datagram, int tcp_header_size) {
+send_datagram(const NetDatagram &datagram, int tcp_header_size, bool flush) {
   nassertr(_socket != nullptr, false);
 
-  if (_socket->is_exact_type(Socket_UDP::get_class_type())) {
-    // We have to send UDP right away.
-    Socket_UDP *udp;
-    DCAST_INTO_R(udp, _socket, false);
-
-    LightReMutexHolder holder(_write_mutex);
+  if (is_udp()) {
     DatagramUDPHeader header(datagram);
-
-    vector_uchar data;
-    CPTA_uchar header_data = header.get_array();
-    CPTA_uchar message = datagram.get_array();
-    data.insert(data.end(), header_data.begin(), header_data.end());
-    data.insert(data.end(), message.begin(), message.end());
-
     if (net_cat.is_debug()) {
       header.verify_datagram(datagram);
     }
 
-    int bytes_to_send = data.size();
-    Socket_Address addr = datagram.get_address().get_addr();
-
-    bool okflag = udp->SendTo(data, addr);
-#if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
-    while (!okflag && udp->GetLastError() == LOCAL_BLOCKING_ERROR && udp->Active()) {
-      Thread::force_yield();
-      okflag = udp->SendTo(data, addr);
-    }
-#endif  // SIMPLE_THREADS
-
-    if (net_cat.is_spam()) {
-      net_cat.spam()
-        << "Sent UDP datagram with "
-        << bytes_to_send << " bytes to " << (void *)this
-        << ", ok = " << okflag << "\n";
-    }
-
-    return check_send_error(okflag);
+    LightReMutexHolder holder(_write_mutex);
+    QueuedPacket packet;
+    packet._header = header.get_array();
+    packet._message = datagram.get_array();
+    packet._addr = datagram.get_address().get_addr();
+    _queued_packets.push_back(std::move(packet));
+
+    // UDP datagrams are never held for collect-tcp.
+    return flush ? flush_udp() : true;
   }
 
   // We might queue up TCP packets for later sending.
@@ -348,17 +346,17 @@ send_datagram(const NetDatagram &datagram, int tcp_header_size) {
 
   LightReMutexHolder holder(_write_mutex);
   CPTA_uchar header_data = header.get_array();
-  CPTA_uchar message = datagram.get_array();
-  _queued_data.insert(_queued_data.end(), header_data.begin(), header_data.end());
-  _queued_data.insert(_queued_data.end(), message.begin(), message.end());
+  queue_tcp_data(header_data.p(), header_data.size());
+  queue_tcp_data(datagram.get_array());
   _queued_count++;
 
   if (net_cat.is_debug()) {
     header.verify_datagram(datagram, tcp_header_size);
   }
 
-  if (!_collect_tcp ||
-      TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval) {
+  if (flush &&
+      (!_collect_tcp ||
+       TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval)) {
     return do_flush();
   }
 
@@ -368,62 +366,108 @@ send_datagram(const NetDatagram &datagram, int tcp_header_size) {
 /**
  * This method is intended only to be called by ConnectionWriter.  It
  * atomically writes the given datagram to the socket, without the Datagram
- * header.
+ * header.  See send_datagram() for the meaning of flush.
  */
 bool Connection::
-send_raw_datagram(const NetDatagram &datagram) {
+send_raw_datagram(const NetDatagram &datagram, bool flush) {
   nassertr(_socket != nullptr, false);
 
-  if (_socket->is_exact_type(Socket_UDP::get_class_type())) {
-    // We have to send UDP right away.
-    Socket_UDP *udp;
-    DCAST_INTO_R(udp, _socket, false);
-
-    CPTA_uchar msg = datagram.get_array();
-    vector_uchar data;
-    data.insert(data.end(), msg.begin(), msg.end());
-
+  if (is_udp()) {
     LightReMutexHolder holder(_write_mutex);
-    Socket_Address addr = datagram.get_address().get_addr();
-    bool okflag = udp->SendTo(data, addr);
-#if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
-    while (!okflag && udp->GetLastError() == LOCAL_BLOCKING_ERROR && udp->Active()) {
-      Thread::force_yield();
-      okflag = udp->SendTo(data, addr);
-    }
-#endif  // SIMPLE_THREADS
-
-    if (net_cat.is_spam()) {
-      net_cat.spam()
-        << "Sent UDP datagram with "
-        << data.size() << " bytes to " << (void *)this
-        << ", ok = " << okflag << "\n";
-    }
+    QueuedPacket packet;
+    packet._message = datagram.get_array();
+    packet._addr = datagram.get_address().get_addr();
+    _queued_packets.push_back(std::move(packet));
 
-    return check_send_error(okflag);
+    return flush ? flush_udp() : true;
   }
 
   // We might queue up TCP packets for later sending.
   LightReMutexHolder holder(_write_mutex);
-  CPTA_uchar msg = datagram.get_array();
-  _queued_data.insert(_queued_data.end(), msg.begin(), msg.end());
+  queue_tcp_data(datagram.get_array());
   _queued_count++;
 
-  if (!_collect_tcp ||
-      TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval) {
+  if (flush &&
+      (!_collect_tcp ||
+       TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval)) {
     return do_flush();
   }
 
   return true;
 }
 
+/**
+ * Returns true if this is a UDP connection, false if it is a TCP connection.
+ */
+bool Connection::
+is_udp() const {
+  return _socket->is_exact_type(Socket_UDP::get_class_type());
+}
+
+/**
+ * Appends a copy of the indicated bytes to the TCP queue.  Assumes the
+ * _write_mutex is already held.
+ */
+void Connection::
+queue_tcp_data(const unsigned char *data, size_t length) {
+  if (length == 0) {
+    return;
+  }
+
+  if (_queued_segments.empty() || !_queued_segments.back()._message.is_null()) {
+    QueuedSegment segment;
+    segment._start = _queued_data.size();
+    segment._length = 0;
+    _queued_segments.push_back(std::move(segment));
+  }
+  _queued_data.insert(_queued_data.end(), data, data + length);
+  _queued_segments.back()._length += length;
+  _queued_bytes += length;
+}
+
+/**
+ * Appends the indicated message to the TCP queue.  A large message is held
+ * by reference, rather than copied; this is safe because the datagram's
+ * buffer is copy-on-write.  Assumes the _write_mutex is already held.
+ */
+void Connection::
+queue_tcp_data(const CPTA_uchar &data) {
+  // Below this size, it is cheaper to copy the message than to give the
+  // socket another buffer to gather from.
+  static const size_t min_reference_size = 512;
+
+  if (data.size() < min_reference_size) {
+    queue_tcp_data(data.p(), data.size());
+    return;
+  }
+
+  QueuedSegment segment;
+  segment._message = data;
+  segment._start = 0;
+  segment._length = data.size();
+  _queued_segments.push_back(std::move(segment));
+  _queued_bytes += data.size();
+}
+
 /**
  * The private implementation of flush(), this assumes the _write_mutex is
  * already held.
  */
 bool Connection::
 do_flush() {
-  if (_queued_data.empty()) {
+  if (is_udp()) {
+    return flush_udp();
+  }
+  return flush_tcp();
+}
+
+/**
+ * Writes all of the queued TCP data to the socket.  Assumes the _write_mutex
+ * is already held.
+ */
+bool Connection::
+flush_tcp() {
+  if (_queued_segments.empty()) {
     _queued_count = 0;
     _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
     return true;
@@ -432,22 +476,43 @@ do_flush() {
   if (net_cat.is_spam()) {
     net_cat.spam()
       << "Sending " << _queued_count << " TCP datagram(s) with "
-      << _queued_data.size() << " total bytes to " << (void *)this << "\n";
+      << _queued_bytes << " total bytes to " << (void *)this << "\n";
   }
 
   Socket_TCP *tcp;
   DCAST_INTO_R(tcp, _socket, false);
 
-  vector_uchar sending_data;
-  _queued_data.swap(sending_data);
+  QueuedSegments segments;
+  vector_uchar data;
+  _queued_segments.swap(segments);
+  _queued_data.swap(data);
+  size_t total_bytes = _queued_bytes;
 
+  _queued_bytes = 0;
   _queued_count = 0;
   _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
 
+  int num_syscalls = 0;
+
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
+  // With non-blocking I/O, we send the data in pieces of no more than
+  // net_max_write_per_epoch, yielding in between; it is simplest to flatten
+  // the queue first.
+  if (segments.size() != 1 || !segments[0]._message.is_null()) {
+    vector_uchar flat;
+    flat.reserve(total_bytes);
+    for (const QueuedSegment &segment : segments) {
+      const unsigned char *p = segment._message.is_null()
+        ? data.data() + segment._start : segment._message.p() + segment._start;
+      flat.insert(flat.end(), p, p + segment._length);
+    }
+    data.swap(flat);
+  }
+
   int max_send = net_max_write_per_epoch;
-  int data_sent = tcp->SendData((char *)sending_data.data(), std::min((size_t)max_send, sending_data.size()));
-  bool okflag = (data_sent == (int)sending_data.size());
+  int data_sent = tcp->SendData((char *)data.data(), std::min((size_t)max_send, data.size()));
+  ++num_syscalls;
+  bool okflag = (data_sent == (int)data.size());
   if (!okflag) {
     int total_sent = 0;
     if (data_sent > 0) {
@@ -461,20 +526,165 @@ do_flush() {
       } else {
         Thread::consider_yield();
       }
-      data_sent = tcp->SendData((char *)sending_data.data() + total_sent, std::min((size_t)max_send, sending_data.size() - total_sent));
+      data_sent = tcp->SendData((char *)data.data() + total_sent, std::min((size_t)max_send, data.size() - total_sent));
+      ++num_syscalls;
       if (data_sent > 0) {
         total_sent += data_sent;
       }
-      okflag = (total_sent == (int)sending_data.size());
+      okflag = (total_sent == (int)data.size());
     }
   }
 
 #else  // SIMPLE_THREADS
-  int data_sent = tcp->SendData(sending_data);
-  bool okflag = (data_sent == (int)sending_data.size());
+  // Gather all of the segments into as few writes as the system allows.
+  static const size_t max_iovecs = 1024;
+
+  pvector<SOCKET_IOVEC> iovecs(segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const QueuedSegment &segment = segments[i];
+    const unsigned char *p = segment._message.is_null()
+      ? data.data() + segment._start : segment._message.p() + segment._start;
+    SET_SOCKET_IOVEC(iovecs[i], p, segment._length);
+  }
+
+  size_t total_sent = 0;
+  size_t i = 0;
+  while (i < iovecs.size()) {
+    int count = (int)std::min(iovecs.size() - i, max_iovecs);
+    int data_sent = tcp->SendDataV(&iovecs[i], count);
+    ++num_syscalls;
+    if (data_sent <= 0) {
+      break;
+    }
+    total_sent += data_sent;
+
+    // Skip past the buffers that were written completely, and trim the one
+    // that was written partially, if any.
+    size_t remaining = (size_t)data_sent;
+    while (i < iovecs.size() && remaining >= SOCKET_IOVEC_LEN(iovecs[i])) {
+      remaining -= SOCKET_IOVEC_LEN(iovecs[i]);
+      ++i;
+    }
+    if (remaining > 0) {
+      SET_SOCKET_IOVEC(iovecs[i], (char *)SOCKET_IOVEC_DATA(iovecs[i]) + remaining,
+                       SOCKET_IOVEC_LEN(iovecs[i]) - remaining);
+    }
+  }
+  bool okflag = (total_sent == total_bytes);
 
 #endif  // SIMPLE_THREADS
 
+  AtomicAdjust::inc(_num_flushes);
+  AtomicAdjust::add(_num_flush_syscalls, num_syscalls);
+  AtomicAdjust::add(_num_flush_bytes, (AtomicAdjust::Integer)total_bytes);
+
+  return check_send_error(okflag);
+}
+
+/**
+ * Sends all of the queued UDP datagrams.  Assumes the _write_mutex is already
+ * held.
+ */
+bool Connection::
+flush_udp() {
+  if (_queued_packets.empty()) {
+    return true;
+  }
+
+  Socket_UDP *udp;
+  DCAST_INTO_R(udp, _socket, false);
+
+  QueuedPackets packets;
+  _queued_packets.swap(packets);
+
+  bool okflag = true;
+  int num_syscalls = 0;
+  size_t total_bytes = 0;
+
+#if defined(IS_LINUX) && !(defined(HAVE_THREADS) && defined(SIMPLE_THREADS))
+  // On Linux, we can send a whole batch of datagrams with one sendmmsg().
+  static const size_t max_batch = 64;
+  struct mmsghdr msgs[max_batch];
+  struct iovec iovecs[max_batch * 2];
+
+  size_t p = 0;
+  while (okflag && p < packets.size()) {
+    size_t count = std::min(packets.size() - p, max_batch);
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (size_t i = 0; i < count; ++i) {
+      QueuedPacket &packet = packets[p + i];
+      struct iovec *iov = &iovecs[i * 2];
+      int num_iov = 0;
+      if (!packet._header.is_null()) {
+        SET_SOCKET_IOVEC(iov[num_iov], packet._header.p(), packet._header.size());
+        ++num_iov;
+      }
+      SET_SOCKET_IOVEC(iov[num_iov], packet._message.p(), packet._message.size());
+      ++num_iov;
+
+      msgs[i].msg_hdr.msg_iov = iov;
+      msgs[i].msg_hdr.msg_iovlen = num_iov;
+      const sockaddr *addr = &packet._addr.GetAddressInfo();
+      msgs[i].msg_hdr.msg_name = (void *)addr;
+      msgs[i].msg_hdr.msg_namelen = SA_SIZEOF(addr);
+    }
+
+    int sent = sendmmsg(udp->GetSocket(), msgs, count, 0);
+    ++num_syscalls;
+    if (sent <= 0) {
+      okflag = false;
+      break;
+    }
+    for (int i = 0; i < sent; ++i) {
+      okflag = okflag && (msgs[i].msg_len == packets[p + i]._header.size() + packets[p + i]._message.size());
+      total_bytes += msgs[i].msg_len;
+    }
+    p += sent;
+  }
+
+#else
+  for (const QueuedPacket &packet : packets) {
+    SOCKET_IOVEC iov[2];
+    int num_iov = 0;
+    int length = 0;
+    if (!packet._header.is_null()) {
+      SET_SOCKET_IOVEC(iov[num_iov], packet._header.p(), packet._header.size());
+      ++num_iov;
+      length += packet._header.size();
+    }
+    SET_SOCKET_IOVEC(iov[num_iov], packet._message.p(), packet._message.size());
+    ++num_iov;
+    length += packet._message.size();
+
+    bool sent_ok = udp->SendToV(iov, num_iov, length, packet._addr);
+    ++num_syscalls;
+#if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
+    while (!sent_ok && udp->GetLastError() == LOCAL_BLOCKING_ERROR && udp->Active()) {
+      Thread::force_yield();
+      sent_ok = udp->SendToV(iov, num_iov, length, packet._addr);
+      ++num_syscalls;
+    }
+#endif  // SIMPLE_THREADS
+
+    if (!sent_ok) {
+      okflag = false;
+      break;
+    }
+    total_bytes += length;
+  }
+#endif  // IS_LINUX
+
+  if (net_cat.is_spam()) {
+    net_cat.spam()
+      << "Sent " << packets.size() << " UDP datagram(s) with "
+      << total_bytes << " total bytes to " << (void *)this
+      << " in " << num_syscalls << " call(s), ok = " << okflag << "\n";
+  }
+
+  AtomicAdjust::inc(_num_flushes);
+  AtomicAdjust::add(_num_flush_syscalls, num_syscalls);
+  AtomicAdjust::add(_num_flush_bytes, (AtomicAdjust::Integer)total_bytes);
+
   return check_send_error(okflag);
 }
 
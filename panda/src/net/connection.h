@@ -19,6 +19,10 @@
 #include "netAddress.h"
 #include "lightReMutex.h"
 #include "vector_uchar.h"
+#include "pta_uchar.h"
+#include "pvector.h"
+#include "socket_address.h"
+#include "atomicAdjust.h"
 
 class Socket_IP;
 class ConnectionManager;
@@ -56,10 +60,20 @@ PUBLISHED:
   void set_no_delay(bool flag);
   void set_max_segment(int size);
 
+public:
+  static void get_flush_counts(int &num_flushes, int &num_syscalls,
+                               int &num_bytes);
+
 private:
-  bool send_datagram(const NetDatagram &datagram, int tcp_header_size);
-  bool send_raw_datagram(const NetDatagram &datagram);
+  bool send_datagram(const NetDatagram &datagram, int tcp_header_size,
+                     bool flush = true);
+  bool send_raw_datagram(const NetDatagram &datagram, bool flush = true);
+  bool is_udp() const;
+  void queue_tcp_data(const unsigned char *data, size_t length);
+  void queue_tcp_data(const CPTA_uchar &data);
   bool do_flush();
+  bool flush_tcp();
+  bool flush_udp();
   bool check_send_error(bool okflag);
 
   ConnectionManager *_manager;
@@ -69,9 +83,39 @@ private:
   bool _collect_tcp;
   double _collect_tcp_interval;
   double _queued_data_start;
-  vector_uchar _queued_data;
   int _queued_count;
 
+  // The TCP data waiting to be sent.  The headers and the smaller messages
+  // are copied into _queued_data; larger messages are held by reference
+  // instead.  Each segment is a run of bytes from one or the other, in order,
+  // and a flush hands all of them to the socket at once.
+  class QueuedSegment {
+  public:
+    CPTA_uchar _message;  // or NULL to indicate a run of _queued_data.
+    size_t _start;
+    size_t _length;
+  };
+  typedef pvector<QueuedSegment> QueuedSegments;
+  QueuedSegments _queued_segments;
+  vector_uchar _queued_data;
+  size_t _queued_bytes;
+
+  // The UDP datagrams waiting to be sent, when the caller has asked us not to
+  // flush them right away.
+  class QueuedPacket {
+  public:
+    CPTA_uchar _header;
+    CPTA_uchar _message;
+    Socket_Address _addr;
+  };
+  typedef pvector<QueuedPacket> QueuedPackets;
+  QueuedPackets _queued_packets;
+
+  // Totals over all connections, reported to PStats by PStatClient.
+  static TVOLATILE AtomicAdjust::Integer _num_flushes;
+  static TVOLATILE AtomicAdjust::Integer _num_flush_syscalls;
+  static TVOLATILE AtomicAdjust::Integer _num_flush_bytes;
+
   friend class ConnectionWriter;
 };
 
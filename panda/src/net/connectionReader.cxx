@@ -27,10 +27,27 @@
 #include "atomicAdjust.h"
 #include "config_downloader.h"
 
+#include <string.h>
+
+#ifdef IS_LINUX
+#include <sys/epoll.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
 using std::min;
 
 static const int read_buffer_size = maximum_udp_datagram + datagram_udp_header_size;
 
+// The largest buffer allocated for a TCP datagram before its data arrives.
+static const int max_tcp_preallocate = 65536;
+
+#ifdef IS_LINUX
+// The most sockets a thread will take from its epoll instance at once.
+static const int epoll_batch_size = 64;
+#endif
+
 /**
  *
  */
@@ -40,6 +57,12 @@ SocketInfo(const PT(Connection) &connection) :
 {
   _busy = false;
   _error = false;
+  _removed = false;
+  _index = 0;
+  _shard = -1;
+  _fd = BAD_SOCKET;
+  _ready = false;
+  _next_buffer = 0;
 }
 
 /**
@@ -58,6 +81,42 @@ get_socket() const {
   return _connection->get_socket();
 }
 
+/**
+ * Returns a buffer of the indicated size to read a datagram into.  This is
+ * one of the socket's pooled buffers if one is free, which saves allocating
+ * a new one.
+ */
+PTA_uchar ConnectionReader::SocketInfo::
+get_buffer(size_t size) {
+  for (size_t i = 0; i < _buffers.size(); ++i) {
+    PTA_uchar &buffer = _buffers[_next_buffer];
+    _next_buffer = (_next_buffer + 1) % _buffers.size();
+    if (buffer.get_ref_count() == 1) {
+      // Every datagram that was read into this buffer is gone.
+      buffer.v().resize(size);
+      return buffer;
+    }
+  }
+
+  PTA_uchar buffer = PTA_uchar::empty_array(size);
+  if ((int)_buffers.size() < get_net_datagram_pool_size()) {
+    _buffers.push_back(buffer);
+  }
+  return buffer;
+}
+
+/**
+ * Returns a buffer filled with a copy of the indicated data.  See above.
+ */
+PTA_uchar ConnectionReader::SocketInfo::
+get_buffer(const void *data, size_t size) {
+  PTA_uchar buffer = get_buffer(size);
+  if (size != 0) {
+    memcpy(buffer.p(), data, size);
+  }
+  return buffer;
+}
+
 /**
  *
  */
@@ -113,6 +172,33 @@ ConnectionReader(ConnectionManager *manager, int num_threads,
 
   _currently_polling_thread = -1;
 
+#ifdef IS_LINUX
+  _epoll = get_net_epoll();
+  if (_epoll) {
+    // One shard for each thread, or a single shard read by poll().
+    int num_shards = std::max(num_threads, 1);
+    _shards.resize(num_shards);
+    for (int si = 0; si < num_shards; ++si) {
+      _shards[si]._num_sockets = 0;
+      _shards[si]._epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+      if (_shards[si]._epoll_fd < 0) {
+        net_cat.warning()
+          << "Unable to create epoll instance (" << strerror(errno)
+          << "), falling back to select().\n";
+        _epoll = false;
+      }
+    }
+    if (!_epoll) {
+      for (Shard &shard : _shards) {
+        if (shard._epoll_fd >= 0) {
+          close(shard._epoll_fd);
+        }
+      }
+      _shards.clear();
+    }
+  }
+#endif  // IS_LINUX
+
   std::string reader_thread_name = thread_name;
   if (thread_name.empty()) {
     reader_thread_name = "ReaderThread";
@@ -158,6 +244,22 @@ ConnectionReader::
       sinfo->_connection.clear();
     }
   }
+
+#ifdef IS_LINUX
+  for (Shard &shard : _shards) {
+    for (SocketInfo *sinfo : shard._removed_sockets) {
+      if (!sinfo->_busy) {
+        delete sinfo;
+      } else {
+        net_cat.error()
+          << "Reentrant deletion of ConnectionReader--don't delete these\n"
+          << "in response to connection_reset().\n";
+        sinfo->_connection.clear();
+      }
+    }
+    close(shard._epoll_fd);
+  }
+#endif  // IS_LINUX
 }
 
 /**
@@ -168,7 +270,7 @@ ConnectionReader::
  * accepted.
  *
  * The return value is true if the connection was added, false if it was
- * already there.
+ * already there, or if it could not be watched for activity.
  *
  * add_connection() is thread-safe, and may be called at will by any thread.
  */
@@ -179,15 +281,24 @@ add_connection(Connection *connection) {
   LightMutexHolder holder(_sockets_mutex);
 
   // Make sure it's not already on the _sockets list.
-  Sockets::const_iterator si;
-  for (si = _sockets.begin(); si != _sockets.end(); ++si) {
-    if ((*si)->_connection == connection) {
-      // Whoops, already there.
-      return false;
-    }
+  if (_sockets_by_connection.find(connection) != _sockets_by_connection.end()) {
+    // Whoops, already there.
+    return false;
+  }
+
+  SocketInfo *sinfo = new SocketInfo(connection);
+
+#ifdef IS_LINUX
+  if (_epoll && !epoll_add(sinfo)) {
+    // No thread would ever read from the socket.
+    delete sinfo;
+    return false;
   }
+#endif
 
-  _sockets.push_back(new SocketInfo(connection));
+  sinfo->_index = _sockets.size();
+  _sockets.push_back(sinfo);
+  _sockets_by_connection[connection] = sinfo;
 
   return true;
 }
@@ -204,18 +315,29 @@ bool ConnectionReader::
 remove_connection(Connection *connection) {
   LightMutexHolder holder(_sockets_mutex);
 
-  // Walk through the list of sockets to find the one we're removing.
-  Sockets::iterator si;
-  si = _sockets.begin();
-  while (si != _sockets.end() && (*si)->_connection != connection) {
-    ++si;
-  }
-  if (si == _sockets.end()) {
+  SocketsByConnection::iterator mi = _sockets_by_connection.find(connection);
+  if (mi == _sockets_by_connection.end()) {
     return false;
   }
+  SocketInfo *sinfo = (*mi).second;
+  _sockets_by_connection.erase(mi);
+
+  // Move the last socket into the vacated slot.
+  nassertr(sinfo->_index < _sockets.size() && _sockets[sinfo->_index] == sinfo, false);
+  SocketInfo *last = _sockets.back();
+  _sockets[sinfo->_index] = last;
+  last->_index = sinfo->_index;
+  _sockets.pop_back();
+  sinfo->_removed = true;
+
+#ifdef IS_LINUX
+  if (sinfo->_shard >= 0) {
+    epoll_remove(sinfo);
+    return true;
+  }
+#endif
 
-  _removed_sockets.push_back(*si);
-  _sockets.erase(si);
+  _removed_sockets.push_back(sinfo);
 
   return true;
 }
@@ -231,18 +353,13 @@ bool ConnectionReader::
 is_connection_ok(Connection *connection) {
   LightMutexHolder holder(_sockets_mutex);
 
-  // Walk through the list of sockets to find the one we're asking about.
-  Sockets::iterator si;
-  si = _sockets.begin();
-  while (si != _sockets.end() && (*si)->_connection != connection) {
-    ++si;
-  }
-  if (si == _sockets.end()) {
+  SocketsByConnection::const_iterator mi = _sockets_by_connection.find(connection);
+  if (mi == _sockets_by_connection.end()) {
     // Don't know that connection.
     return false;
   }
 
-  SocketInfo *sinfo = (*si);
+  SocketInfo *sinfo = (*mi).second;
   bool is_ok = !sinfo->_error;
 
   return is_ok;
@@ -262,6 +379,13 @@ poll() {
     return;
   }
 
+#ifdef IS_LINUX
+  if (_epoll) {
+    epoll_poll();
+    return;
+  }
+#endif
+
   SocketInfo *sinfo = get_next_available_socket(false, -2);
   if (sinfo != nullptr) {
     double max_poll_cycle = get_net_max_poll_cycle();
@@ -489,7 +613,8 @@ process_incoming_udp_data(SocketInfo *sinfo) {
   char *dp = buffer + datagram_udp_header_size;
   bytes_read -= datagram_udp_header_size;
 
-  NetDatagram datagram(dp, bytes_read);
+  NetDatagram datagram;
+  datagram.set_array(sinfo->get_buffer(dp, bytes_read));
 
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
@@ -573,34 +698,37 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
   DatagramTCPHeader header(buffer, _tcp_header_size);
   int size = header.get_datagram_size(_tcp_header_size);
 
-  // We have to loop until the entire datagram is read.
-  NetDatagram datagram;
+  // We have to loop until the entire datagram is read.  We read it straight
+  // into the buffer that will hold the datagram.  A 4-byte header may claim
+  // an enormous datagram, so beyond the first max_tcp_preallocate bytes, the
+  // buffer grows only as the data actually arrives.
+  PTA_uchar data = sinfo->get_buffer(std::max(min(size, max_tcp_preallocate), 0));
+  int length = 0;
 
-  while (!_shutdown && (int)datagram.get_length() < size) {
+  while (!_shutdown && length < size) {
     int bytes_read;
 
-    int read_bytes = read_buffer_size;
+    int read_bytes = size - length;
+    if (length + read_bytes > (int)data.size()) {
+      read_bytes = min(read_bytes, max_tcp_preallocate);
+      data.v().resize(length + read_bytes);
+    }
+    char *dp = (char *)data.p();
 #ifdef SIMPLE_THREADS
     // In the SIMPLE_THREADS case, we want to limit the number of bytes we
     // read in a single epoch, to minimize the impact on the other threads.
-    read_bytes = min(read_buffer_size, (int)net_max_read_per_epoch);
+    read_bytes = min(read_bytes, (int)net_max_read_per_epoch);
 #endif
 
-    bytes_read =
-      socket->RecvData(buffer, min(read_bytes,
-                                   (int)(size - datagram.get_length())));
+    bytes_read = socket->RecvData(dp + length, read_bytes);
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
     while (bytes_read < 0 && socket->GetLastError() == LOCAL_BLOCKING_ERROR &&
            socket->Active()) {
       Thread::force_yield();
-      bytes_read =
-        socket->RecvData(buffer, min(read_bytes,
-                                     (int)(size - datagram.get_length())));
+      bytes_read = socket->RecvData(dp + length, read_bytes);
     }
 #endif  // SIMPLE_THREADS
 
-    char *dp = buffer;
-
     if (bytes_read <= 0) {
       // The socket was closed.  Report that and return.
       if (_manager != nullptr) {
@@ -610,20 +738,13 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
       return false;
     }
 
-    int datagram_bytes =
-      min(bytes_read, (int)(size - datagram.get_length()));
-    datagram.append_data(dp, datagram_bytes);
-
-    if (bytes_read > datagram_bytes) {
-      // There were some extra bytes at the end of the datagram.  Maybe the
-      // beginning of the next datagram?  Huh.
-      net_cat.error()
-        << "Discarding " << bytes_read - datagram_bytes
-        << " bytes following TCP datagram.\n";
-    }
+    length += bytes_read;
     Thread::consider_yield();
   }
 
+  NetDatagram datagram;
+  datagram.set_array(std::move(data));
+
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
   finish_socket(sinfo);
@@ -684,7 +805,8 @@ process_raw_incoming_udp_data(SocketInfo *sinfo) {
   }
 
   // In raw mode, we simply extract all the bytes and make that a datagram.
-  NetDatagram datagram(buffer, bytes_read);
+  NetDatagram datagram;
+  datagram.set_array(sinfo->get_buffer(buffer, bytes_read));
 
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
@@ -738,7 +860,8 @@ process_raw_incoming_tcp_data(SocketInfo *sinfo) {
   }
 
   // In raw mode, we simply extract all the bytes and make that a datagram.
-  NetDatagram datagram(buffer, bytes_read);
+  NetDatagram datagram;
+  datagram.set_array(sinfo->get_buffer(buffer, bytes_read));
 
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
@@ -771,6 +894,13 @@ thread_run(int thread_index) {
   nassertv(!_polling);
   nassertv(_threads[thread_index] == Thread::get_current_thread());
 
+#ifdef IS_LINUX
+  if (_epoll) {
+    epoll_thread_run(thread_index);
+    return;
+  }
+#endif
+
   while (!_shutdown) {
     SocketInfo *sinfo =
       get_next_available_socket(true, thread_index);
@@ -925,3 +1055,213 @@ accumulate_fdset(Socket_fdset &fdset) {
     }
   }
 }
+
+#ifdef IS_LINUX
+/**
+ * Registers the indicated socket with the least-loaded epoll shard.  Returns
+ * true on success.  Assumes the lock is already held.
+ */
+bool ConnectionReader::
+epoll_add(SocketInfo *sinfo) {
+  int shard_index = 0;
+  for (int si = 1; si < (int)_shards.size(); ++si) {
+    if (_shards[si]._num_sockets < _shards[shard_index]._num_sockets) {
+      shard_index = si;
+    }
+  }
+  Shard &shard = _shards[shard_index];
+
+  // Edge-triggered, so that a socket is reported once when data arrives,
+  // rather than on every wait until it has all been read.
+  SOCKET fd = sinfo->get_socket()->GetSocket();
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLET;
+  event.data.ptr = sinfo;
+  if (epoll_ctl(shard._epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+    net_cat.error()
+      << "Unable to add socket to epoll instance: " << strerror(errno)
+      << "\n";
+    return false;
+  }
+
+  sinfo->_shard = shard_index;
+  sinfo->_fd = fd;
+  ++shard._num_sockets;
+  return true;
+}
+
+/**
+ * Unregisters the indicated socket from its epoll shard, and queues it for
+ * deletion by that shard's thread.  Assumes the lock is already held.
+ */
+void ConnectionReader::
+epoll_remove(SocketInfo *sinfo) {
+  nassertv(sinfo->_shard >= 0 && sinfo->_shard < (int)_shards.size());
+  Shard &shard = _shards[sinfo->_shard];
+
+  // ConnectionManager removes a connection before closing its socket.  If
+  // the socket has been closed some other way, the kernel has already
+  // dropped it from the epoll instance, and its descriptor may since have
+  // been reused by another socket, which must not be unregistered instead.
+  if (sinfo->get_socket()->GetSocket() == sinfo->_fd) {
+    struct epoll_event event;
+    epoll_ctl(shard._epoll_fd, EPOLL_CTL_DEL, sinfo->_fd, &event);
+  }
+
+  --shard._num_sockets;
+  shard._removed_sockets.push_back(sinfo);
+}
+
+/**
+ * Returns true if the indicated socket can be read from without blocking,
+ * either because it has more data, or because it has been closed or has
+ * failed, which the next read will detect.  Assumes the lock is already held.
+ */
+bool ConnectionReader::
+epoll_has_data(SocketInfo *sinfo) {
+  struct pollfd pfd;
+  pfd.fd = sinfo->_fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return ::poll(&pfd, 1, 0) > 0 && pfd.revents != 0;
+}
+
+/**
+ * Collects the sockets of the indicated shard that have received data, and
+ * adds them to the shard's ready list.  Waits for activity only if allow_block
+ * is true.  Also deletes the sockets that have been removed from the shard
+ * since the last call.
+ */
+void ConnectionReader::
+epoll_wait_shard(Shard &shard, bool allow_block) {
+  int timeout = allow_block ? (int)(get_net_max_block() * 1000.0) : 0;
+#if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
+  // As in get_next_available_socket(), never wait with SIMPLE_THREADS.
+  timeout = 0;
+#endif
+
+  struct epoll_event events[epoll_batch_size];
+  int num_events = epoll_wait(shard._epoll_fd, events, epoll_batch_size, timeout);
+
+  LightMutexHolder holder(_sockets_mutex);
+  for (int i = 0; i < num_events; ++i) {
+    SocketInfo *sinfo = (SocketInfo *)events[i].data.ptr;
+    // Only this thread deletes the sockets in this shard, so the pointer is
+    // still good, even if the socket has just been removed.
+    if (!sinfo->_removed && !sinfo->_ready) {
+      sinfo->_ready = true;
+      shard._ready.push_back(sinfo);
+    }
+  }
+
+  if (!shard._removed_sockets.empty()) {
+    // A removed socket may still be on the ready list.
+    Sockets::iterator ri = shard._ready.begin();
+    while (ri != shard._ready.end()) {
+      if ((*ri)->_removed) {
+        (*ri)->_ready = false;
+        *ri = shard._ready.back();
+        shard._ready.pop_back();
+      } else {
+        ++ri;
+      }
+    }
+
+    Sockets still_busy_sockets;
+    for (SocketInfo *sinfo : shard._removed_sockets) {
+      if (sinfo->_busy) {
+        still_busy_sockets.push_back(sinfo);
+      } else {
+        delete sinfo;
+      }
+    }
+    shard._removed_sockets.swap(still_busy_sockets);
+  }
+}
+
+/**
+ * Reads one datagram from each of the sockets on the indicated shard's ready
+ * list.  A socket stays on the list until it has been drained, since the
+ * edge-triggered epoll instance will not report it again until more data
+ * arrives.  If stop is not negative, returns false as soon as that time has
+ * been reached, leaving the rest for the next call; otherwise returns true.
+ */
+bool ConnectionReader::
+epoll_read_ready(Shard &shard, double stop) {
+  TrueClock *global_clock = TrueClock::get_global_ptr();
+
+  size_t ri = 0;
+  while (ri < shard._ready.size()) {
+    SocketInfo *sinfo = shard._ready[ri];
+    sinfo->_busy = true;
+    process_incoming_data(sinfo);
+    Thread::consider_yield();
+
+    bool more;
+    {
+      // The socket is not closed until after it has been removed, so it is
+      // safe to look at it while the lock is held.
+      LightMutexHolder holder(_sockets_mutex);
+      more = !sinfo->_removed && !sinfo->_error && epoll_has_data(sinfo);
+    }
+    if (more) {
+      ++ri;
+    } else {
+      sinfo->_ready = false;
+      shard._ready[ri] = shard._ready.back();
+      shard._ready.pop_back();
+    }
+
+    if (stop >= 0.0 && global_clock->get_short_time() >= stop) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * The thread function when net-epoll is in effect.  Each thread owns the
+ * sockets in its own shard, and is the only one that reads them.
+ */
+void ConnectionReader::
+epoll_thread_run(int thread_index) {
+  nassertv(thread_index < (int)_shards.size());
+  Shard &shard = _shards[thread_index];
+
+  while (!_shutdown) {
+    // Only wait for new activity when there is nothing left to read.
+    epoll_wait_shard(shard, shard._ready.empty());
+    if (shard._ready.empty()) {
+      Thread::force_yield();
+      continue;
+    }
+
+    epoll_read_ready(shard, -1.0);
+  }
+}
+
+/**
+ * The implementation of poll() when net-epoll is in effect.
+ */
+void ConnectionReader::
+epoll_poll() {
+  nassertv(_shards.size() == 1);
+  Shard &shard = _shards[0];
+
+  double max_poll_cycle = get_net_max_poll_cycle();
+  double stop = -1.0;
+  if (max_poll_cycle >= 0.0) {
+    stop = TrueClock::get_global_ptr()->get_short_time() + max_poll_cycle;
+  }
+
+  // Any sockets that the last call ran out of time for are still on the
+  // ready list.
+  epoll_wait_shard(shard, false);
+  while (!shard._ready.empty() && !_shutdown) {
+    if (!epoll_read_ready(shard, stop)) {
+      return;
+    }
+    epoll_wait_shard(shard, false);
+  }
+}
+#endif  // IS_LINUX
@@ -22,9 +22,11 @@
 #include "pmutex.h"
 #include "lightMutex.h"
 #include "pvector.h"
+#include "pmap.h"
 #include "pset.h"
 #include "socket_fdset.h"
 #include "atomicAdjust.h"
+#include "pta_uchar.h"
 
 class NetDatagram;
 class ConnectionManager;
@@ -91,12 +93,31 @@ protected:
     SocketInfo(const PT(Connection) &connection);
     bool is_udp() const;
     Socket_IP *get_socket() const;
+    PTA_uchar get_buffer(size_t size);
+    PTA_uchar get_buffer(const void *data, size_t size);
 
     PT(Connection) _connection;
     bool _busy;
     bool _error;
+    bool _removed;
+
+    // The position of this socket within _sockets, and the index of the
+    // epoll shard that watches it, or -1 if it is not watched by epoll.
+    size_t _index;
+    int _shard;
+    // The descriptor that was registered with epoll, and whether the socket
+    // is on its shard's ready list.
+    SOCKET _fd;
+    bool _ready;
+
+    // The buffers that datagrams from this socket have been read into.  Each
+    // is reused once nothing else holds a reference to it.  Only the thread
+    // that has marked the socket busy may touch these.
+    pvector<PTA_uchar> _buffers;
+    size_t _next_buffer;
   };
   typedef pvector<SocketInfo *> Sockets;
+  typedef phash_map<Connection *, SocketInfo *, pointer_hash> SocketsByConnection;
 
   void clear_manager();
   void finish_socket(SocketInfo *sinfo);
@@ -113,6 +134,8 @@ protected:
   // These structures track the total set of sockets (connections) we know
   // about.
   Sockets _sockets;
+  // This indexes the same sockets by their connection.
+  SocketsByConnection _sockets_by_connection;
   // This is the list of recently-removed sockets.  We can't actually delete
   // them until they're no longer _busy.
   Sockets _removed_sockets;
@@ -128,6 +151,18 @@ private:
   void rebuild_select_list();
   void accumulate_fdset(Socket_fdset &fdset);
 
+#ifdef IS_LINUX
+  class Shard;
+
+  bool epoll_add(SocketInfo *sinfo);
+  void epoll_remove(SocketInfo *sinfo);
+  bool epoll_has_data(SocketInfo *sinfo);
+  void epoll_wait_shard(Shard &shard, bool allow_block);
+  bool epoll_read_ready(Shard &shard, double stop);
+  void epoll_thread_run(int thread_index);
+  void epoll_poll();
+#endif
+
 private:
   bool _raw_mode;
   int _tcp_header_size;
@@ -162,6 +197,29 @@ private:
   // thread is so waiting.
   AtomicAdjust::Integer _currently_polling_thread;
 
+#ifdef IS_LINUX
+  // When net-epoll is enabled, the sockets are instead divided among the
+  // threads, each of which waits on an epoll instance of its own, and is the
+  // only thread that reads the sockets in it.  A socket is registered
+  // edge-triggered, so it is reported once when data arrives, and is then
+  // kept on the shard's ready list until it has been drained.  A polling
+  // reader has a single shard.
+  class Shard {
+  public:
+    int _epoll_fd;
+    int _num_sockets;
+    // Sockets that have data to read.  Only this shard's thread touches
+    // this.
+    Sockets _ready;
+    // Sockets that have been removed, but may not yet be deleted because
+    // this shard's thread may still be reading them.
+    Sockets _removed_sockets;
+  };
+  typedef pvector<Shard> Shards;
+  Shards _shards;
+  bool _epoll;
+#endif
+
   friend class ConnectionManager;
   friend class ReaderThread;
 };
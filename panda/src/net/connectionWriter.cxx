@@ -19,6 +19,9 @@
 #include "socket_udp.h"
 #include "pnotify.h"
 #include "config_downloader.h"
+#include "trueClock.h"
+
+#include <algorithm>
 
 /**
  *
@@ -70,6 +73,10 @@ ConnectionWriter(ConnectionManager *manager, int num_threads,
   _immediate = (num_threads <= 0);
   _shutdown = false;
 
+  if (!_immediate && get_net_ring_queue()) {
+    _queue.enable_ring_queue(get_net_ring_queue_size());
+  }
+
   std::string writer_thread_name = thread_name;
   if (thread_name.empty()) {
     writer_thread_name = "WriterThread";
@@ -155,7 +162,7 @@ send(const Datagram &datagram, const PT(Connection) &connection, bool block) {
       return connection->send_datagram(copy, _tcp_header_size);
     }
   } else {
-    return _queue.insert(copy, block);
+    return _queue.insert(std::move(copy), block);
   }
 }
 
@@ -199,7 +206,7 @@ send(const Datagram &datagram, const PT(Connection) &connection,
       return connection->send_datagram(copy, _tcp_header_size);
     }
   } else {
-    return _queue.insert(copy, block);
+    return _queue.insert(std::move(copy), block);
   }
 }
 
@@ -315,18 +322,75 @@ clear_manager() {
 
 /**
  * This is the actual executing function for each thread.
+ *
+ * The thread takes datagrams from the queue in batches, queueing each one on
+ * its connection without sending it, and then flushes each connection it has
+ * touched once: when the queue runs dry, when net-writer-batch-size datagrams
+ * have been taken, or when net-writer-flush-deadline has passed since the
+ * first datagram of the batch, whichever comes first.  This way, a burst of
+ * datagrams for the same connection is written with one system call.
  */
 void ConnectionWriter::
 thread_run(int thread_index) {
   nassertv(!_immediate);
 
+  int batch_size = std::max(get_net_writer_batch_size(), 1);
+  double flush_deadline = get_net_writer_flush_deadline();
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  typedef pvector<PT(Connection)> Connections;
+  Connections pending;
+  int num_pending = 0;
+  double deadline = 0.0;
+
   NetDatagram datagram;
-  while (_queue.extract(datagram)) {
+  while (true) {
+    if (pending.empty()) {
+      // Nothing is waiting to be flushed, so we can sleep until the next
+      // datagram arrives.
+      if (!_queue.extract(datagram)) {
+        break;
+      }
+      deadline = clock->get_short_time() + flush_deadline;
+
+    } else {
+      double remaining = deadline - clock->get_short_time();
+      if (num_pending >= batch_size ||
+          !_queue.extract(datagram, std::max(remaining, 0.0))) {
+        if (remaining > 0.0 && num_pending < batch_size && !_shutdown) {
+          // We woke up early; go back to waiting for the deadline.
+          continue;
+        }
+
+        for (Connection *connection : pending) {
+          connection->consider_flush();
+        }
+        pending.clear();
+        num_pending = 0;
+        Thread::consider_yield();
+        continue;
+      }
+    }
+
+    Connection *connection = datagram.get_connection();
     if (_raw_mode) {
-      datagram.get_connection()->send_raw_datagram(datagram);
+      connection->send_raw_datagram(datagram, false);
     } else {
-      datagram.get_connection()->send_datagram(datagram, _tcp_header_size);
+      connection->send_datagram(datagram, _tcp_header_size, false);
+    }
+    ++num_pending;
+
+    // A batch usually touches only a handful of connections, and often the
+    // same one several times in a row.
+    if (pending.empty() || pending.back() != connection) {
+      if (std::find(pending.begin(), pending.end(), connection) == pending.end()) {
+        pending.push_back(connection);
+      }
     }
-    Thread::consider_yield();
+  }
+
+  // The queue has been shut down; send whatever we are still holding.
+  for (Connection *connection : pending) {
+    connection->consider_flush();
   }
 }
@@ -21,10 +21,14 @@
 DatagramQueue::
 DatagramQueue() :
   _cvlock("DatagramQueue::_cvlock"),
-  _cv(_cvlock)
+  _cv(_cvlock),
+  _space_cv(_cvlock)
 {
   _shutdown = false;
   _max_queue_size = get_net_max_write_queue();
+  _ring = nullptr;
+  _num_waiting = 0;
+  _num_blocked = 0;
 }
 
 /**
@@ -35,6 +39,7 @@ DatagramQueue::
   // It's an error to delete a DatagramQueue without first shutting it down
   // (and waiting for any associated threads to terminate).
   nassertv(_shutdown);
+  delete _ring;
 }
 
 /**
@@ -51,6 +56,19 @@ shutdown() {
 
   _shutdown = true;
   _cv.notify_all();
+  _space_cv.notify_all();
+}
+
+/**
+ * Switches the queue to a lock-free ring that holds at least the indicated
+ * number of datagrams.  This must be called before any datagrams are
+ * inserted, and before any threads are waiting on the queue.
+ */
+void DatagramQueue::
+enable_ring_queue(size_t capacity) {
+  MutexHolder holder(_cvlock);
+  nassertv(_ring == nullptr && _queue.empty());
+  _ring = new AtomicRingQueue<NetDatagram>(capacity);
 }
 
 
@@ -64,6 +82,40 @@ shutdown() {
  */
 bool DatagramQueue::
 insert(const NetDatagram &data, bool block) {
+  NetDatagram copy(data);
+  return insert(std::move(copy), block);
+}
+
+/**
+ * Moves the indicated datagram onto the end of the queue.  See the above
+ * flavor of insert().  The datagram is left untouched if it could not be
+ * queued.
+ */
+bool DatagramQueue::
+insert(NetDatagram &&data, bool block) {
+  if (_ring != nullptr) {
+    bool enqueue_ok = ring_push(data);
+    if (!enqueue_ok && block && !_shutdown) {
+      // The ring is full; go to sleep until extract() makes room.  As in
+      // extract(), we announce ourselves before trying again, so that a
+      // thread that frees a slot in the meantime is sure to wake us up.
+      MutexHolder holder(_cvlock);
+      AtomicAdjust::inc(_num_blocked);
+      enqueue_ok = ring_push(data);
+      while (!enqueue_ok && !_shutdown) {
+        _space_cv.wait();
+        enqueue_ok = ring_push(data);
+      }
+      AtomicAdjust::dec(_num_blocked);
+    }
+
+    if (enqueue_ok && AtomicAdjust::get(_num_waiting) != 0) {
+      MutexHolder holder(_cvlock);
+      _cv.notify();
+    }
+    return enqueue_ok;
+  }
+
   MutexHolder holder(_cvlock);
 
   bool enqueue_ok = ((int)_queue.size() < _max_queue_size);
@@ -75,7 +127,7 @@ insert(const NetDatagram &data, bool block) {
   }
 
   if (enqueue_ok) {
-    _queue.push_back(data);
+    _queue.push_back(std::move(data));
   }
   _cv.notify();  // Only need to wake up one thread.
 
@@ -101,6 +153,26 @@ extract(NetDatagram &result) {
   // connection pointer--we're about to go to sleep for a while.
   result.clear();
 
+  if (_ring != nullptr) {
+    while (!_shutdown) {
+      if (_ring->pop(result)) {
+        notify_space();
+        return true;
+      }
+
+      // The ring is empty; go to sleep.  We announce ourselves before
+      // checking the ring again, so that a thread that inserts a datagram
+      // in the meantime is sure to see us and wake us up.
+      MutexHolder holder(_cvlock);
+      AtomicAdjust::inc(_num_waiting);
+      while (_ring->empty() && !_shutdown) {
+        _cv.wait();
+      }
+      AtomicAdjust::dec(_num_waiting);
+    }
+    return false;
+  }
+
   MutexHolder holder(_cvlock);
 
   while (_queue.empty() && !_shutdown) {
@@ -112,7 +184,63 @@ extract(NetDatagram &result) {
   }
 
   nassertr(!_queue.empty(), false);
-  result = _queue.front();
+  result = std::move(_queue.front());
+  _queue.pop_front();
+
+  // Wake up any threads waiting to stuff things into the queue.
+  _cv.notify_all();
+
+  return true;
+}
+
+/**
+ * Extracts a datagram from the head of the queue, waiting no longer than the
+ * indicated number of seconds for one to become available.  If timeout is 0,
+ * this does not wait at all.
+ *
+ * The return value is true if a datagram is extracted, or false if the time
+ * ran out or the queue was shut down.  This may also return false a little
+ * early, on a spurious wakeup; the caller should be prepared to try again.
+ */
+bool DatagramQueue::
+extract(NetDatagram &result, double timeout) {
+  result.clear();
+
+  if (_ring != nullptr) {
+    if (_ring->pop(result)) {
+      notify_space();
+      return true;
+    }
+    if (timeout <= 0.0 || _shutdown) {
+      return false;
+    }
+
+    {
+      MutexHolder holder(_cvlock);
+      AtomicAdjust::inc(_num_waiting);
+      if (_ring->empty() && !_shutdown) {
+        _cv.wait(timeout);
+      }
+      AtomicAdjust::dec(_num_waiting);
+    }
+    if (!_shutdown && _ring->pop(result)) {
+      notify_space();
+      return true;
+    }
+    return false;
+  }
+
+  MutexHolder holder(_cvlock);
+
+  if (_queue.empty() && !_shutdown && timeout > 0.0) {
+    _cv.wait(timeout);
+  }
+
+  if (_shutdown || _queue.empty()) {
+    return false;
+  }
+
+  result = std::move(_queue.front());
   _queue.pop_front();
 
   // Wake up any threads waiting to stuff things into the queue.
@@ -121,6 +249,28 @@ extract(NetDatagram &result) {
   return true;
 }
 
+/**
+ * Tries to move the datagram onto the ring, if it is not already holding
+ * max_queue_size datagrams.  Returns true on success; otherwise, the datagram
+ * is left untouched.
+ */
+bool DatagramQueue::
+ring_push(NetDatagram &data) {
+  return (int)_ring->size() < _max_queue_size && _ring->push(std::move(data));
+}
+
+/**
+ * Called after a datagram has been taken off the ring, to wake up a thread
+ * that is blocked in insert() waiting for room, if there is one.
+ */
+void DatagramQueue::
+notify_space() {
+  if (AtomicAdjust::get(_num_blocked) != 0) {
+    MutexHolder holder(_cvlock);
+    _space_cv.notify();
+  }
+}
+
 /**
  * Sets the maximum size the queue is allowed to grow to.  This is primarily
  * for a sanity check; this is a limit beyond which we can assume something
@@ -149,6 +299,9 @@ get_max_queue_size() const {
  */
 int DatagramQueue::
 get_current_queue_size() const {
+  if (_ring != nullptr) {
+    return (int)_ring->size();
+  }
   MutexHolder holder(_cvlock);
   int size = _queue.size();
   return size;
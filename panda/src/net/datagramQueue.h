@@ -20,11 +20,17 @@
 #include "pmutex.h"
 #include "conditionVar.h"
 #include "pdeque.h"
+#include "atomicRingQueue.h"
+#include "atomicAdjust.h"
 
 /**
  * A thread-safe, FIFO queue of NetDatagrams.  This is used by
  * ConnectionWriter for queuing up datagrams for its various threads to write
  * to sockets.
+ *
+ * If net-ring-queue is true, the datagrams are passed through an
+ * AtomicRingQueue instead, and the lock is only taken by a thread that finds
+ * the queue empty and goes to sleep, and by a thread that must wake it.
  */
 class EXPCL_PANDA_NET DatagramQueue {
 public:
@@ -32,14 +38,21 @@ public:
   ~DatagramQueue();
   void shutdown();
 
+  void enable_ring_queue(size_t capacity);
+
   bool insert(const NetDatagram &data, bool block = false);
+  bool insert(NetDatagram &&data, bool block = false);
   bool extract(NetDatagram &result);
+  bool extract(NetDatagram &result, double timeout);
 
   void set_max_queue_size(int max_size);
   int get_max_queue_size() const;
   int get_current_queue_size() const;
 
 private:
+  bool ring_push(NetDatagram &data);
+  void notify_space();
+
   Mutex _cvlock;
   ConditionVar _cv;  // signaled when queue contents change.
 
@@ -47,6 +60,14 @@ private:
   QueueType _queue;
   bool _shutdown;
   int _max_queue_size;
+
+  AtomicRingQueue<NetDatagram> *_ring;
+  // The number of threads asleep in extract(), waiting for the ring to fill.
+  TVOLATILE AtomicAdjust::Integer _num_waiting;
+  // The number of threads asleep in insert(), waiting for the ring to make
+  // room, and the condition variable they wait on.
+  TVOLATILE AtomicAdjust::Integer _num_blocked;
+  ConditionVar _space_cv;
 };
 
 #endif
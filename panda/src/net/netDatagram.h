@@ -43,8 +43,10 @@ PUBLISHED:
   NetDatagram(const void *data, size_t size);
   NetDatagram(const Datagram &copy);
   NetDatagram(const NetDatagram &copy);
+  NetDatagram(NetDatagram &&from) noexcept;
   void operator = (const Datagram &copy);
   void operator = (const NetDatagram &copy);
+  void operator = (NetDatagram &&from) noexcept;
 
   virtual void clear();
 
@@ -25,6 +25,10 @@ QueuedConnectionReader::
 QueuedConnectionReader(ConnectionManager *manager, int num_threads) :
   ConnectionReader(manager, num_threads)
 {
+  if (get_net_ring_queue()) {
+    enable_ring_queue(get_net_ring_queue_size());
+  }
+
 #ifdef SIMULATE_NETWORK_DELAY
   _delay_active = false;
   _min_delay = 0.0;
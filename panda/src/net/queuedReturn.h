@@ -23,6 +23,7 @@
 #include "pdeque.h"
 #include "config_net.h"
 #include "lightMutexHolder.h"
+#include "atomicRingQueue.h"
 
 #include <algorithm>
 
@@ -51,9 +52,14 @@ protected:
   bool enqueue_thing(const Thing &thing);
   bool enqueue_unique_thing(const Thing &thing);
 
+  void enable_ring_queue(size_t capacity);
+
 private:
   LightMutex _mutex;
   pdeque<Thing> _things;
+  // If this is set, the things are queued here instead, and _mutex and
+  // _things are not used.
+  AtomicRingQueue<Thing> *_ring;
   bool _available;
   int _max_queue_size;
   bool _overflow_flag;
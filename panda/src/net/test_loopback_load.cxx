@@ -0,0 +1,193 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_loopback_load.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+
+#include "queuedConnectionManager.h"
+#include "queuedConnectionListener.h"
+#include "queuedConnectionReader.h"
+#include "connectionWriter.h"
+#include "netAddress.h"
+#include "connection.h"
+#include "netDatagram.h"
+#include "load_prc_file.h"
+#include "trueClock.h"
+#include "thread.h"
+#include "atomicAdjust.h"
+
+// Opens a lot of connections to a server on the loopback interface, and then
+// sends datagrams over all of them as fast as possible, to measure how many
+// connections per second the server can accept and how many datagrams per
+// second its ConnectionReader can read.  The server and the clients run in
+// the same process.
+
+static AtomicAdjust::Integer stop_sending = 0;
+
+/**
+ * Sends datagrams over its share of the client connections until it is told
+ * to stop.
+ */
+class SenderThread : public Thread {
+public:
+  SenderThread(ConnectionWriter *writer) :
+    Thread("sender", "sender"),
+    _writer(writer),
+    _num_sent(0)
+  {
+  }
+
+  virtual void thread_main() {
+    NetDatagram datagram;
+    datagram.add_uint16(1);
+    datagram.add_string("This is a test datagram of a typical size.");
+
+    while (!AtomicAdjust::get(stop_sending)) {
+      for (Connection *connection : _connections) {
+        if (!_writer->send(datagram, connection)) {
+          return;
+        }
+        ++_num_sent;
+      }
+    }
+  }
+
+  ConnectionWriter *_writer;
+  pvector<PT(Connection)> _connections;
+  size_t _num_sent;
+};
+
+int
+main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 7) {
+    nout << "test_loopback_load port [clients [reader-threads [sender-threads "
+         << "[seconds [epoll]]]]]\n";
+    exit(1);
+  }
+
+  int port = atoi(argv[1]);
+  int num_clients = (argc > 2) ? atoi(argv[2]) : 1000;
+  int num_reader_threads = (argc > 3) ? atoi(argv[3]) : 4;
+  int num_sender_threads = (argc > 4) ? atoi(argv[4]) : 4;
+  double seconds = (argc > 5) ? atof(argv[5]) : 5.0;
+  if (argc > 6) {
+    load_prc_file_data("", std::string("net-epoll ") + argv[6]);
+  }
+
+  QueuedConnectionManager cm;
+  PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, num_clients);
+  if (rendezvous.is_null()) {
+    nout << "Cannot grab port " << port << ".\n";
+    exit(1);
+  }
+
+  QueuedConnectionListener listener(&cm, 1);
+  listener.add_connection(rendezvous);
+  QueuedConnectionReader reader(&cm, num_reader_threads);
+
+  nout << "Server on port " << port << " with " << reader.get_num_threads()
+       << " reader threads\n";
+
+  // First, open all of the client connections, and wait for the server to
+  // accept each one.
+  QueuedConnectionManager client_cm;
+  ConnectionWriter writer(&client_cm, 0);
+
+  pvector<PT(SenderThread)> senders;
+  for (int i = 0; i < num_sender_threads; ++i) {
+    senders.push_back(new SenderThread(&writer));
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  int num_accepted = 0;
+  for (int i = 0; i < num_clients; ++i) {
+    PT(Connection) client =
+      client_cm.open_TCP_client_connection("127.0.0.1", port, 5000);
+    if (client.is_null()) {
+      nout << "Could only open " << i << " connections.\n";
+      break;
+    }
+    senders[i % num_sender_threads]->_connections.push_back(client);
+
+    while (listener.new_connection_available()) {
+      PT(Connection) rv;
+      NetAddress address;
+      PT(Connection) new_connection;
+      if (listener.get_new_connection(rv, address, new_connection)) {
+        reader.add_connection(new_connection);
+        ++num_accepted;
+      }
+    }
+  }
+
+  int num_opened = 0;
+  for (SenderThread *sender : senders) {
+    num_opened += (int)sender->_connections.size();
+  }
+  while (num_accepted < num_opened &&
+         clock->get_short_time() - start < 10.0) {
+    if (listener.new_connection_available()) {
+      PT(Connection) rv;
+      NetAddress address;
+      PT(Connection) new_connection;
+      if (listener.get_new_connection(rv, address, new_connection)) {
+        reader.add_connection(new_connection);
+        ++num_accepted;
+      }
+    } else {
+      Thread::force_yield();
+    }
+  }
+
+  double elapsed = clock->get_short_time() - start;
+  nout << num_accepted << " connections accepted in " << elapsed << " s, "
+       << num_accepted / elapsed << " connections/s\n";
+
+  // Now send datagrams over all of the connections at once, and count the
+  // datagrams the server reads.
+  for (SenderThread *sender : senders) {
+    sender->start(TP_normal, true);
+  }
+
+  size_t num_received = 0;
+  start = clock->get_short_time();
+  double stop = start + seconds;
+  while (clock->get_short_time() < stop) {
+    bool any = false;
+    while (reader.data_available()) {
+      NetDatagram datagram;
+      if (reader.get_data(datagram)) {
+        ++num_received;
+        any = true;
+      }
+    }
+    if (!any) {
+      Thread::force_yield();
+    }
+  }
+  elapsed = clock->get_short_time() - start;
+
+  AtomicAdjust::set(stop_sending, 1);
+  size_t num_sent = 0;
+  for (SenderThread *sender : senders) {
+    sender->join();
+    num_sent += sender->_num_sent;
+  }
+
+  nout << num_sent << " datagrams sent, " << num_received
+       << " received in " << elapsed << " s, "
+       << num_received / elapsed << " datagrams/s\n";
+
+  return (0);
+}
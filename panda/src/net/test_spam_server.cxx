@@ -25,6 +25,8 @@
 #include "clockObject.h"
 #include "thread.h"
 
+#include "load_prc_file.h"
+
 #include "pset.h"
 #include <sys/time.h>
 #include <sys/types.h>
@@ -32,12 +34,16 @@
 
 int
 main(int argc, char *argv[]) {
-  if (argc != 2) {
-    nout << "test_spam_server port\n";
+  if (argc < 2 || argc > 3) {
+    nout << "test_spam_server port [ring-queue]\n";
     exit(1);
   }
 
   int port = atoi(argv[1]);
+  if (argc > 2) {
+    // Compare the lock-free queues with the mutex-guarded ones.
+    load_prc_file_data("", std::string("net-ring-queue ") + argv[2]);
+  }
 
   QueuedConnectionManager cm;
   PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, 5);
@@ -60,6 +66,8 @@ main(int argc, char *argv[]) {
 
   int num_sent = 0;
   int num_received = 0;
+  int last_sent = 0;
+  int last_received = 0;
 
   ClockObject *global_clock = ClockObject::get_global_clock();
   double last_reported_time = global_clock->get_real_time();
@@ -106,9 +114,14 @@ main(int argc, char *argv[]) {
 
     double now = global_clock->get_real_time();
     if ((now - last_reported_time) > report_interval) {
+      double elapsed = now - last_reported_time;
       nout << "Sent " << num_sent << ", received "
-           << num_received << " datagrams.\n";
+           << num_received << " datagrams; "
+           << (num_sent - last_sent) / elapsed << " sent/s, "
+           << (num_received - last_received) / elapsed << " received/s.\n";
       last_reported_time = now;
+      last_sent = num_sent;
+      last_received = num_received;
     }
 
     // Yield the timeslice before we poll again.
@@ -80,6 +80,7 @@ protected:
   void disable_alpha();
 
   INLINE PN_stdfloat get_cur_alpha(BaseParticle* bp);
+  INLINE static uint32_t pack_color(const LColor &color);
 
   virtual void resize_pool(int new_size) = 0;
 
@@ -16,6 +16,7 @@
 #include "geomNode.h"
 #include "geom.h"
 #include "geomVertexWriter.h"
+#include "geomVertexArrayData.h"
 #include "indent.h"
 #include "pStatTimer.h"
 
@@ -189,8 +190,22 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   int remaining_particles = ttl_particles;
   int i;
 
-  GeomVertexWriter vertex(_vdata, InternalName::get_vertex());
-  GeomVertexWriter color(_vdata, InternalName::get_color());
+  // The format is known to be get_v3cp(), so rather than going through a
+  // GeomVertexWriter for each value, we size the array once and write the
+  // rows directly.
+  PT(GeomVertexArrayDataHandle) handle = _vdata->modify_array_handle(0);
+  handle->unclean_set_num_rows(ttl_particles);
+
+  const GeomVertexArrayFormat *array_format = handle->get_array_format();
+  const GeomVertexColumn *vertex_column = array_format->get_column(InternalName::get_vertex());
+  const GeomVertexColumn *color_column = array_format->get_column(InternalName::get_color());
+  nassertv(vertex_column != nullptr && color_column != nullptr);
+  nassertv(vertex_column->get_numeric_type() == GeomEnums::NT_stdfloat &&
+           color_column->get_numeric_type() == GeomEnums::NT_packed_dabc);
+
+  size_t stride = array_format->get_stride();
+  unsigned char *vertex_pointer = handle->get_write_pointer() + vertex_column->get_start();
+  unsigned char *color_pointer = handle->get_write_pointer() + color_column->get_start();
 
   // init the aabb
 
@@ -199,13 +214,13 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
 
   // run through every filled slot
 
-  for (i = 0; i < (int)po_vector.size(); i++) {
+  for (i = 0; i < (int)po_vector.size() && remaining_particles > 0; i++) {
     cur_particle = (BaseParticle *) po_vector[i].p();
 
     if (!cur_particle->get_alive())
       continue;
 
-    LPoint3 position = cur_particle->get_position();
+    const LPoint3 &position = cur_particle->get_position();
 
     // x aabb adjust
 
@@ -230,16 +245,22 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
 
     // stuff it into the arrays
 
-    vertex.add_data3(position);
-    color.add_data4(create_color(cur_particle));
-
-    // maybe jump out early?
+    memcpy(vertex_pointer, position.get_data(), sizeof(PN_stdfloat) * 3);
+    *(uint32_t *)color_pointer = pack_color(create_color(cur_particle));
+    vertex_pointer += stride;
+    color_pointer += stride;
 
     remaining_particles--;
-    if (remaining_particles == 0)
-      break;
   }
 
+  // If there were fewer living particles than we were told, don't leave
+  // uninitialized rows at the end.
+  if (remaining_particles != 0) {
+    ttl_particles -= remaining_particles;
+    handle->unclean_set_num_rows(ttl_particles);
+  }
+  handle.clear();
+
   _points->clear_vertices();
   _points->add_next_vertices(ttl_particles);
 
@@ -563,34 +563,29 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   }
   _birth_list.clear();
 
-  // Create vertex writers for each of the possible geoms.  Could possibly be
-  // changed to only create writers for geoms that would be used according to
-  // the animation configuration.
   for (i = 0; i < anim_count; ++i) {
-    for (j = 0; j < _anim_size[i]; ++j) {
-      // Set the particle per frame counts to 0.
-      memset(_ttl_count[i], 0, _anim_size[i]*sizeof(int));
-      _sprite_writer[i][j].vertex = GeomVertexWriter(_vdata[i][j], InternalName::get_vertex());
-      _sprite_writer[i][j].color = GeomVertexWriter(_vdata[i][j], InternalName::get_color());
-      _sprite_writer[i][j].rotate = GeomVertexWriter(_vdata[i][j], InternalName::get_rotate());
-      _sprite_writer[i][j].size = GeomVertexWriter(_vdata[i][j], InternalName::get_size());
-      _sprite_writer[i][j].aspect_ratio = GeomVertexWriter(_vdata[i][j], InternalName::get_aspect_ratio());
-    }
+    // Set the particle per frame counts to 0.
+    memset(_ttl_count[i], 0, _anim_size[i]*sizeof(int));
   }
 
   // init the aabb
   _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
   _aabb_max.set(-99999.0f, -99999.0f, -99999.0f);
 
-  // run through every filled slot
-  for (i = 0; i < (int)po_vector.size(); i++) {
+  // The first pass finds the living particles and the geom that each one
+  // goes into, so that we know how many rows to allocate in each geom before
+  // we write any of them.
+  _render_particles.clear();
+  _render_writers.clear();
+
+  for (i = 0; i < (int)po_vector.size() && remaining_particles > 0; i++) {
     cur_particle = (BaseParticle *) po_vector[i].p();
 
     if (!cur_particle->get_alive()) {
       continue;
     }
 
-    LPoint3 position = cur_particle->get_position();
+    const LPoint3 &position = cur_particle->get_position();
 
     // x aabb adjust
     if (position[0] > _aabb_max[0])
@@ -610,7 +605,6 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
     else if (position[2] < _aabb_min[2])
       _aabb_min[2] = position[2];
 
-
     PN_stdfloat t = cur_particle->get_parameterized_age();
     int anim_index = cur_particle->get_index();
 
@@ -637,11 +631,57 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
     frame = (frame < _anim_size[anim_index]) ? frame : (_anim_size[anim_index]-1);
     ++_ttl_count[anim_index][frame];
 
+    _render_particles.push_back(i);
+    _render_writers.push_back(&_sprite_writer[anim_index][frame]);
+
+    // maybe jump out early?
+    remaining_particles--;
+  }
+
+  // Now size each of the vertex arrays, and find where each column starts.
+  // A geom that was empty last frame and is still empty is left alone.
+  for (i = 0; i < anim_count; ++i) {
+    for (j = 0; j < _anim_size[i]; ++j) {
+      SpriteWriter &writer = _sprite_writer[i][j];
+      if (_ttl_count[i][j] == 0 && _vdata[i][j]->get_num_rows() == 0) {
+        continue;
+      }
+
+      writer.handle = _vdata[i][j]->modify_array_handle(0);
+      writer.handle->unclean_set_num_rows(_ttl_count[i][j]);
+
+      const GeomVertexArrayFormat *array_format = writer.handle->get_array_format();
+      unsigned char *pointer = writer.handle->get_write_pointer();
+      writer.stride = array_format->get_stride();
+
+      const GeomVertexColumn *column;
+      column = array_format->get_column(InternalName::get_vertex());
+      writer.vertex = pointer + column->get_start();
+      column = array_format->get_column(InternalName::get_color());
+      writer.color = pointer + column->get_start();
+      column = array_format->get_column(InternalName::get_rotate());
+      writer.rotate = (column != nullptr) ? pointer + column->get_start() : nullptr;
+      column = array_format->get_column(InternalName::get_size());
+      writer.size = (column != nullptr) ? pointer + column->get_start() : nullptr;
+      column = array_format->get_column(InternalName::get_aspect_ratio());
+      writer.aspect_ratio = (column != nullptr) ? pointer + column->get_start() : nullptr;
+    }
+  }
+
+  // The second pass computes the vertex of each particle and writes it into
+  // the next row of its geom.
+  int alphamode = get_alpha_mode();
+  size_t num_render = _render_particles.size();
+  for (size_t pi = 0; pi < num_render; ++pi) {
+    cur_particle = (BaseParticle *) po_vector[_render_particles[pi]].p();
+    SpriteWriter &writer = *_render_writers[pi];
+
+    PN_stdfloat t = cur_particle->get_parameterized_age();
+
     // Calculate the color This is where we'll want to give the renderer the
     // new color
     LColor c = _color_interpolation_manager->generateColor(t);
 
-    int alphamode=get_alpha_mode();
     if (alphamode != PR_ALPHA_NONE) {
       if (alphamode == PR_ALPHA_OUT)
         c[3] *= (1.0f - t) * get_user_alpha();
@@ -657,8 +697,10 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
     }
 
     // Send the data on its way...
-    _sprite_writer[anim_index][frame].vertex.add_data3(position);
-    _sprite_writer[anim_index][frame].color.add_data4(c);
+    memcpy(writer.vertex, cur_particle->get_position().get_data(), sizeof(PN_stdfloat) * 3);
+    *(uint32_t *)writer.color = pack_color(c);
+    writer.vertex += writer.stride;
+    writer.color += writer.stride;
 
     PN_stdfloat current_x_scale = _initial_x_scale;
     PN_stdfloat current_y_scale = _initial_y_scale;
@@ -678,24 +720,20 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
       }
     }
 
-    if (_sprite_writer[anim_index][frame].size.has_column()) {
-      _sprite_writer[anim_index][frame].size.add_data1f(current_y_scale * _height);
-    }
-    if (_sprite_writer[anim_index][frame].aspect_ratio.has_column()) {
-      _sprite_writer[anim_index][frame].aspect_ratio.add_data1f(_aspect_ratio * current_x_scale / current_y_scale);
+    if (writer.size != nullptr) {
+      *(PN_stdfloat *)writer.size = current_y_scale * _height;
+      writer.size += writer.stride;
     }
-    if (_animate_theta) {
-      _sprite_writer[anim_index][frame].rotate.add_data1f(cur_particle->get_theta());
-    } else if (_sprite_writer[anim_index][frame].rotate.has_column()) {
-      _sprite_writer[anim_index][frame].rotate.add_data1f(_theta);
+    if (writer.aspect_ratio != nullptr) {
+      *(PN_stdfloat *)writer.aspect_ratio = _aspect_ratio * current_x_scale / current_y_scale;
+      writer.aspect_ratio += writer.stride;
     }
-
-    // maybe jump out early?
-    remaining_particles--;
-    if (remaining_particles == 0) {
-      break;
+    if (writer.rotate != nullptr) {
+      *(PN_stdfloat *)writer.rotate = _animate_theta ? cur_particle->get_theta() : _theta;
+      writer.rotate += writer.stride;
     }
   }
+
   int n = 0;
   GeomNode *render_node = get_render_node();
 
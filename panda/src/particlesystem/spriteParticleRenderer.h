@@ -24,7 +24,7 @@
 #include "geomVertexData.h"
 #include "geomPoints.h"
 #include "colorInterpolationManager.h"
-#include "geomVertexWriter.h"
+#include "geomVertexArrayData.h"
 #include "textureCollection.h"
 #include "nodePathCollection.h"
 #include "vector_int.h"
@@ -33,35 +33,35 @@
 class NodePath;
 
 /**
- * Helper class used by SpriteParticleRenderer to keep track of the various
- * GeomVertexWriters associated with each geom created in
- * SpriteParticleRenderer::init_geoms().
+ * Helper class used by SpriteParticleRenderer to keep track of where the next
+ * row is to be written in each column of each geom created in
+ * SpriteParticleRenderer::init_geoms().  The rows are written directly into
+ * the vertex array, which has already been sized by render().  A column
+ * pointer is NULL if the format does not have that column.
  */
 class SpriteWriter {
 public:
   SpriteWriter() {
+    clear();
   }
-  SpriteWriter(const SpriteWriter &copy):
-    vertex(copy.vertex),
-    color(copy.color),
-    rotate(copy.rotate),
-    size(copy.size),
-    aspect_ratio(copy.aspect_ratio) {
-  };
 
   void clear() {
-    vertex.clear();
-    color.clear();
-    rotate.clear();
-    size.clear();
-    aspect_ratio.clear();
+    handle.clear();
+    stride = 0;
+    vertex = nullptr;
+    color = nullptr;
+    rotate = nullptr;
+    size = nullptr;
+    aspect_ratio = nullptr;
   }
 
-  GeomVertexWriter vertex;
-  GeomVertexWriter color;
-  GeomVertexWriter rotate;
-  GeomVertexWriter size;
-  GeomVertexWriter aspect_ratio;
+  PT(GeomVertexArrayDataHandle) handle;
+  size_t stride;
+  unsigned char *vertex;
+  unsigned char *color;
+  unsigned char *rotate;
+  unsigned char *size;
+  unsigned char *aspect_ratio;
 };
 
 /**
@@ -268,6 +268,8 @@ private:
   vector_int _anim_size;   // Holds the number of frames in each animation.
   pvector<int*> _ttl_count;  // _ttl_count[i][j] holds the number of particles attached to animation 'i' at frame 'j'.
   vector_int _birth_list;  // Holds the list of particles that need a new random animation to start on.
+  vector_int _render_particles;  // The living particles found by render(), in order.
+  pvector<SpriteWriter *> _render_writers;  // The geom that each of the above is written to.
 
   static PStatCollector _render_collector;
 };
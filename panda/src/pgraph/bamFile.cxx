@@ -18,6 +18,8 @@
 #include "bamCacheRecord.h"
 #include "config_putil.h"
 #include "bamReader.h"
+#include "bamReadAhead.h"
+#include "asyncTaskManager.h"
 #include "bamWriter.h"
 #include "filename.h"
 #include "config_express.h"
@@ -26,11 +28,22 @@
 
 using std::string;
 
+/**
+ * Hands the work that a BamReader has put off to the threads of the
+ * bam_decode worker chain.  See BamReader::set_decode_runner().
+ */
+static void
+run_decode(size_t count, BamReader::DecodeFunction *function,
+           void *user_data, void *runner_data) {
+  ((AsyncTaskChain *)runner_data)->parallel_for(count, function, user_data);
+}
+
 /**
  *
  */
 BamFile::
 BamFile() {
+  _read_ahead = nullptr;
   _reader = nullptr;
   _writer = nullptr;
 }
@@ -246,6 +259,11 @@ close() {
     delete _reader;
     _reader = nullptr;
   }
+  if (_read_ahead != nullptr) {
+    // This waits for the reader thread to stop before the file is closed.
+    delete _read_ahead;
+    _read_ahead = nullptr;
+  }
   if (_writer != nullptr) {
     delete _writer;
     _writer = nullptr;
@@ -377,12 +395,26 @@ continue_open_read(const string &bam_filename, bool report_errors) {
     return false;
   }
 
-  _reader = new BamReader(&_din);
+  // Unless it is disabled, the datagrams are read ahead on another thread
+  // while the objects are being built.
+  if (bam_read_ahead_size > 0) {
+    _read_ahead = new BamReadAhead(&_din, (size_t)bam_read_ahead_size);
+    _reader = new BamReader(_read_ahead);
+  } else {
+    _reader = new BamReader(&_din);
+  }
   if (!_reader->init()) {
     close();
     return false;
   }
 
+  // The objects may leave some of their decoding to worker threads.
+  if (bam_decode_threads > 0) {
+    AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->
+      make_worker_chain("bam_decode", bam_decode_threads);
+    _reader->set_decode_runner(&run_decode, chain);
+  }
+
   return true;
 }
 
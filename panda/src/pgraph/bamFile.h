@@ -22,6 +22,7 @@
 #include "bamEnums.h"
 
 class BamReader;
+class BamReadAhead;
 class BamWriter;
 class TypedWritable;
 class Filename;
@@ -88,6 +89,7 @@ private:
   std::string _bam_filename;
   DatagramInputFile _din;
   DatagramOutputFile _dout;
+  BamReadAhead *_read_ahead;
   BamReader *_reader;
   BamWriter *_writer;
 };
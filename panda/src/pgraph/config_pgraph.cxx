@@ -131,6 +131,20 @@ ConfigVariableBool debug_portal_cull
           "(You first need to enable portal culling, using the allow-portal-cull"
           "variable.)"));
 
+ConfigVariableInt parallel_cull_threads
+("parallel-cull-threads", 0,
+ PRC_DESC("The number of extra threads that help the cull thread traverse "
+          "the children of a node marked with "
+          "PandaNode::set_parallel_cull().  The default, 0, disables this."));
+
+ConfigVariableInt cpu_animation_threads
+("cpu-animation-threads", 0,
+ PRC_DESC("Set this nonzero to set aside the vertex datas that need CPU "
+          "animation, such as skinning that cannot be done in hardware, "
+          "until the end of the cull traversal, and then animate them with "
+          "the help of this many extra threads.  The default, 0, animates "
+          "each one as soon as it is found."));
+
 ConfigVariableBool show_occluder_volumes
 ("show-occluder-volumes", false,
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
@@ -218,6 +232,30 @@ ConfigVariableBool state_cache
           "similar to the TransformState cache controlled via "
           "transform-cache."));
 
+/**
+ * Returns the number of shards the global TransformState and RenderState
+ * tables are split into.  This is a function, rather than a global variable,
+ * because it is consulted when the first state is created, which may happen
+ * at static init time.
+ */
+int
+get_state_cache_shards() {
+  static ConfigVariableInt *state_cache_shards = nullptr;
+
+  if (state_cache_shards == nullptr) {
+    state_cache_shards = new ConfigVariableInt
+      ("state-cache-shards", 16,
+       PRC_DESC("The number of pieces the global tables of unique "
+                "TransformStates and RenderStates are split into, each "
+                "guarded by its own lock, so that threads making "
+                "different states do not contend for one lock.  This is "
+                "rounded up to a power of two, and is read only once, "
+                "when the first state is made."));
+  }
+
+  return *state_cache_shards;
+}
+
 ConfigVariableBool uniquify_transforms
 ("uniquify-transforms", true,
  PRC_DESC("Set this true to ensure that equivalent TransformStates "
@@ -34,6 +34,8 @@ extern ConfigVariableBool fake_view_frustum_cull;
 extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
+extern ConfigVariableInt parallel_cull_threads;
+extern ConfigVariableInt cpu_animation_threads;
 extern ConfigVariableBool show_occluder_volumes;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
@@ -48,6 +50,7 @@ extern ConfigVariableDouble garbage_collect_states_rate;
 extern ConfigVariableBool transform_cache;
 extern ConfigVariableBool state_cache;
 extern ConfigVariableBool uniquify_transforms;
+extern int get_state_cache_shards();
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool uniquify_states;
 extern ConfigVariableBool uniquify_attribs;
 extern ConfigVariableBool retransform_sprites;
@@ -28,9 +28,13 @@
 #include "config_pgraph.h"
 #include "depthOffsetAttrib.h"
 #include "colorBlendAttrib.h"
+#include "asyncTaskManager.h"
+#include "pStatTimer.h"
 
 TypeHandle CullResult::_type_handle;
 
+PStatCollector CullResult::_animate_pcollector("Cull:Animate vertices");
+
 /*
  * This value is used instead of 1.0 to represent the alpha level of a pixel
  * that is to be considered "opaque" for the purposes of M_dual.  Ideally, 1.0
@@ -246,7 +250,16 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
 
   // Munge vertices as needed for the GSG's requirements, and the object's
   // current state.
-  if (object->munge_geom(_gsg, _gsg->get_geom_munger(object->_state, current_thread), traverser, force)) {
+  // If we have threads for it, any CPU animation is put off until
+  // finish_cull(), so that it can be computed for all of the objects at once.
+  bool defer_animation = (cpu_animation_threads > 0 &&
+                          Thread::is_threading_supported());
+  if (object->munge_geom(_gsg, _gsg->get_geom_munger(object->_state, current_thread), traverser, force, defer_animation)) {
+    if (defer_animation && object->_munged_data->get_format()->get_animation().get_animation_type() == Geom::AT_panda) {
+      _deferred_animation.push_back(object);
+      _deferred_force |= force;
+    }
+
     // The object may or may not now be fully resident, but this may not
     // matter, since the GSG may have the necessary buffers already loaded.
     // We'll let the GSG ultimately decide whether to render it.
@@ -265,6 +278,12 @@ void CullResult::
 finish_cull(SceneSetup *scene_setup, Thread *current_thread) {
   CullBinManager *bin_manager = CullBinManager::get_global_ptr();
 
+  // The bins may sort by vertex data, so the deferred animation must be done
+  // first.
+  if (!_deferred_animation.empty()) {
+    animate_deferred(current_thread);
+  }
+
   for (size_t i = 0; i < _bins.size(); ++i) {
     if (!bin_manager->get_bin_active(i)) {
       // If the bin isn't active, don't sort it, and don't draw it.  In fact,
@@ -280,6 +299,47 @@ finish_cull(SceneSetup *scene_setup, Thread *current_thread) {
   }
 }
 
+/**
+ * Computes the CPU vertex animation of all of the objects that were set aside
+ * by add_object().  Each distinct vertex data is animated once, by the
+ * cpu-animation-threads and the cull thread together.  Since the animated
+ * result is cached on the vertex data, the objects then find it ready.
+ */
+void CullResult::
+animate_deferred(Thread *current_thread) {
+  PStatTimer timer(_animate_pcollector, current_thread);
+
+  pvector<const GeomVertexData *> vdatas;
+  vdatas.reserve(_deferred_animation.size());
+  for (CullableObject *object : _deferred_animation) {
+    vdatas.push_back(object->_munged_data);
+  }
+  std::sort(vdatas.begin(), vdatas.end());
+  vdatas.erase(std::unique(vdatas.begin(), vdatas.end()), vdatas.end());
+
+  if (vdatas.size() > 1) {
+    AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->
+      make_worker_chain("cpu_animation", cpu_animation_threads);
+    chain->parallel_for(vdatas.size(), &animate_vertex_data, vdatas.data());
+  }
+
+  for (CullableObject *object : _deferred_animation) {
+    object->animate_vertices(_deferred_force, current_thread);
+  }
+  _deferred_animation.clear();
+  _deferred_force = false;
+}
+
+/**
+ * Animates the nth of the vertex datas collected by animate_deferred(), on
+ * one of the cpu-animation-threads.  The result is cached on the vertex data.
+ */
+void CullResult::
+animate_vertex_data(size_t n, void *user_data) {
+  const GeomVertexData *vdata = ((const GeomVertexData **)user_data)[n];
+  vdata->animate_vertices(true, Thread::get_current_thread());
+}
+
 /**
  * Asks all the bins to draw themselves in the correct order.
  */
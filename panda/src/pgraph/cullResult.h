@@ -63,6 +63,8 @@ public:
 
 private:
   CullBin *make_new_bin(int bin_index);
+  void animate_deferred(Thread *current_thread);
+  static void animate_vertex_data(size_t n, void *user_data);
 
   INLINE void check_flash_bin(CPT(RenderState) &state, CullBinManager *bin_manager, int bin_index);
   INLINE void check_flash_transparency(CPT(RenderState) &state, const LColor &color);
@@ -87,6 +89,16 @@ private:
 
   bool _show_transparency = false;
 
+  // The objects whose CPU vertex animation has been put off until
+  // finish_cull(), when it is computed for all of them at once on the
+  // cpu-animation-threads.  _deferred_force is true if any of them asked for
+  // the animation to be forced.
+  typedef pvector<CullableObject *> DeferredAnimation;
+  DeferredAnimation _deferred_animation;
+  bool _deferred_force = false;
+
+  static PStatCollector _animate_pcollector;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
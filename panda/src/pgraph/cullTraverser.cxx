@@ -34,6 +34,29 @@
 #include "geomLinestrips.h"
 #include "geomLines.h"
 #include "geomVertexWriter.h"
+#include "asyncTaskManager.h"
+#include "pStatTimer.h"
+
+/**
+ * One run of the children of a node marked with set_parallel_cull(), which
+ * is traversed by its own copy of the CullTraverser on one of the parallel
+ * cull threads.  The objects found are held here until they can be passed on
+ * to the real CullHandler, in the same order a single thread would have
+ * found them.
+ */
+class CullTraverser::ParallelChunk : public CullHandler {
+public:
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser);
+
+  static void traverse_chunk(size_t n, void *user_data);
+
+  PT(CullTraverser) _trav;
+  const CullTraverserData *_parent;
+  PandaNode *const *_children;
+  size_t _num_children;
+  pvector<CullableObject *> _objects;
+};
 
 PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
@@ -56,6 +79,7 @@ CullTraverser() :
   _cull_handler = nullptr;
   _portal_clipper = nullptr;
   _effective_incomplete_render = true;
+  _parallel_worker = false;
 }
 
 /**
@@ -73,7 +97,8 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _parallel_worker(copy._parallel_worker)
 {
 }
 
@@ -196,9 +221,45 @@ traverse_below(CullTraverserData &data) {
   }
 
   // Now visit all the node's children.
+  traverse_children(data);
+}
+
+/**
+ * Traverses the children of the indicated node, with the given data, which
+ * has been converted into the node's space.  If the node has been marked with
+ * set_parallel_cull(), the children may be split among the parallel cull
+ * threads.
+ */
+void CullTraverser::
+traverse_children(CullTraverserData &data) {
+  PandaNodePipelineReader *node_reader = data.node_reader();
+  PandaNode *node = data.node();
+
   PandaNode::Children children = node_reader->get_children();
+  bool parallel = node_reader->is_parallel_cull();
   node_reader->release();
   int num_children = children.get_num_children();
+
+  if (parallel && num_children > 1 && parallel_cull_threads > 0 &&
+      !_parallel_worker && _portal_clipper == nullptr &&
+      Thread::is_threading_supported()) {
+    pvector<PandaNode *> visible;
+    visible.reserve(num_children);
+    if (!node->has_selective_visibility()) {
+      for (int i = 0; i < num_children; ++i) {
+        visible.push_back(children.get_child(i));
+      }
+    } else {
+      int i = node->get_first_visible_child();
+      while (i < num_children) {
+        visible.push_back(children.get_child(i));
+        i = node->get_next_visible_child(i);
+      }
+    }
+    traverse_parallel(data, visible);
+    return;
+  }
+
   if (!node->has_selective_visibility()) {
     for (int i = 0; i < num_children; ++i) {
       CullTraverserData next_data(data, children.get_child(i));
@@ -255,6 +316,68 @@ is_in_view(CullTraverserData &data) {
   return data.is_in_view(_camera_mask);
 }
 
+/**
+ * Returns a new CullTraverser that can carry on this traversal from another
+ * thread, or NULL if this traverser can't be copied, in which case the
+ * children of a parallel cull node are traversed on this thread as usual.  A
+ * derived class that can be used from several threads at once should
+ * override this to return a copy of itself.
+ */
+PT(CullTraverser) CullTraverser::
+make_parallel_copy() const {
+  if (get_type() != CullTraverser::get_class_type()) {
+    return nullptr;
+  }
+  return new CullTraverser(*this);
+}
+
+/**
+ * Traverses the indicated children of the current node, which have been
+ * split into runs, one per parallel cull thread plus one for this thread.
+ * Each run is traversed by a copy of this traverser, and the objects found
+ * are recorded with the CullHandler afterwards, in order, so the result is
+ * the same as a serial traversal.
+ */
+void CullTraverser::
+traverse_parallel(CullTraverserData &data,
+                  const pvector<PandaNode *> &children) {
+  int num_threads = parallel_cull_threads;
+  size_t num_chunks = std::min(children.size(), (size_t)num_threads + 1);
+
+  pvector<ParallelChunk> chunks(num_chunks);
+  size_t begin = 0;
+  for (size_t ci = 0; ci < num_chunks; ++ci) {
+    size_t end = children.size() * (ci + 1) / num_chunks;
+    ParallelChunk &chunk = chunks[ci];
+    chunk._parent = &data;
+    chunk._children = children.data() + begin;
+    chunk._num_children = end - begin;
+    begin = end;
+
+    chunk._trav = make_parallel_copy();
+    if (chunk._trav == nullptr) {
+      // This traverser can't be copied; do it all here.
+      for (PandaNode *child : children) {
+        CullTraverserData next_data(data, child);
+        do_traverse(next_data);
+      }
+      return;
+    }
+    chunk._trav->_parallel_worker = true;
+    chunk._trav->_cull_handler = &chunk;
+  }
+
+  AsyncTaskChain *chain = AsyncTaskManager::get_global_ptr()->
+    make_worker_chain("parallel_cull", num_threads);
+  chain->parallel_for(num_chunks, &ParallelChunk::traverse_chunk, chunks.data());
+
+  for (const ParallelChunk &chunk : chunks) {
+    for (CullableObject *object : chunk._objects) {
+      _cull_handler->record_object(object, this);
+    }
+  }
+}
+
 /**
  * Draws an appropriate visualization of the node's external bounding volume.
  */
@@ -549,3 +672,31 @@ get_depth_offset_state() {
   }
   return state;
 }
+
+/**
+ * Holds the object until traverse_parallel() passes it on to the real
+ * CullHandler.
+ */
+void CullTraverser::ParallelChunk::
+record_object(CullableObject *object, const CullTraverser *traverser) {
+  _objects.push_back(object);
+}
+
+/**
+ * Traverses the nth chunk's run of children on one of the parallel cull
+ * threads.
+ */
+void CullTraverser::ParallelChunk::
+traverse_chunk(size_t n, void *user_data) {
+  ParallelChunk *chunk = (ParallelChunk *)user_data + n;
+  CullTraverser *trav = chunk->_trav;
+
+  Thread *current_thread = Thread::get_current_thread();
+  trav->_current_thread = current_thread;
+
+  for (size_t i = 0; i < chunk->_num_children; ++i) {
+    CullTraverserData next_data(*chunk->_parent, chunk->_children[i],
+                                current_thread);
+    trav->do_traverse(next_data);
+  }
+}
@@ -27,6 +27,7 @@
 #include "typedReferenceCount.h"
 #include "pStatCollector.h"
 #include "fogAttrib.h"
+#include "pvector.h"
 
 class GraphicsStateGuardian;
 class PandaNode;
@@ -90,8 +91,10 @@ PUBLISHED:
 
 protected:
   INLINE void do_traverse(CullTraverserData &data);
+  void traverse_children(CullTraverserData &data);
 
   virtual bool is_in_view(CullTraverserData &data);
+  virtual PT(CullTraverser) make_parallel_copy() const;
 
 public:
   // Statistics
@@ -101,6 +104,10 @@ public:
   static PStatCollector _geoms_occluded_pcollector;
 
 private:
+  class ParallelChunk;
+  void traverse_parallel(CullTraverserData &data,
+                         const pvector<PandaNode *> &children);
+
   void show_bounds(CullTraverserData &data, bool tight);
   static PT(Geom) make_bounds_viz(const BoundingVolume *vol);
   PT(Geom) make_tight_bounds_viz(PandaNode *node) const;
@@ -122,6 +129,10 @@ private:
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
 
+  // True if this is a copy made by traverse_parallel(), which may not itself
+  // start another parallel traversal.
+  bool _parallel_worker;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
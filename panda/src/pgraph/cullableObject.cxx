@@ -60,10 +60,13 @@ make_copy() {
  * If force is false, this may do nothing and return false if the vertex data
  * is nonresident.  If force is true, this will always return true, but it may
  * have to block while the vertex data is paged in.
+ *
+ * If defer_animation is true, any vertex animation that must be computed on
+ * the CPU is left undone, and the caller must later call animate_vertices().
  */
 bool CullableObject::
 munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
-           const CullTraverser *traverser, bool force) {
+           const CullTraverser *traverser, bool force, bool defer_animation) {
   nassertr(munger != nullptr, false);
 
   Thread *current_thread = traverser->get_current_thread();
@@ -175,13 +178,12 @@ munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
     // If there is any animation left in the vertex data after it has been
     // munged--that is, we couldn't arrange to handle the animation in
     // hardware--then we have to calculate that animation now.
-    bool cpu_animated = false;
-
-    CPT(GeomVertexData) animated_vertices =
-      _munged_data->animate_vertices(force, current_thread);
-    if (animated_vertices != _munged_data) {
-      cpu_animated = true;
-      std::swap(_munged_data, animated_vertices);
+    bool cpu_animated;
+    if (defer_animation) {
+      GeomVertexDataPipelineReader data_reader(_munged_data, current_thread);
+      cpu_animated = (data_reader.get_format()->get_animation().get_animation_type() == Geom::AT_panda);
+    } else {
+      cpu_animated = animate_vertices(force, current_thread);
     }
 
     if (sattr != nullptr) {
@@ -220,6 +222,27 @@ munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
   return true;
 }
 
+/**
+ * Replaces the munged vertex data with its animated vertices, if any of its
+ * animation must be computed on the CPU.  Returns true if the vertices were
+ * animated, false if they did not need to be.
+ *
+ * This is normally called by munge_geom(), unless it was asked to defer the
+ * animation.
+ */
+bool CullableObject::
+animate_vertices(bool force, Thread *current_thread) {
+  nassertr(_munged_data != nullptr, false);
+
+  CPT(GeomVertexData) animated_vertices =
+    _munged_data->animate_vertices(force, current_thread);
+  if (animated_vertices != _munged_data) {
+    std::swap(_munged_data, animated_vertices);
+    return true;
+  }
+  return false;
+}
+
 /**
  *
  */
@@ -51,7 +51,9 @@ public:
   virtual CullableObject *make_copy();
 
   bool munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
-                  const CullTraverser *traverser, bool force);
+                  const CullTraverser *traverser, bool force,
+                  bool defer_animation = false);
+  bool animate_vertices(bool force, Thread *current_thread);
   INLINE void draw(GraphicsStateGuardianBase *gsg,
                    bool force, Thread *current_thread);
 
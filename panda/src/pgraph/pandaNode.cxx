@@ -170,6 +170,7 @@ PandaNode(const PandaNode &copy) :
     cdata->_internal_bounds_mark = UpdateSeq::initial();
     ++cdata->_internal_bounds_mark;
     cdata->_final_bounds = copy_cdata->_final_bounds;
+    cdata->_parallel_cull = copy_cdata->_parallel_cull;
     cdata->_fancy_bits = copy_cdata->_fancy_bits;
   }
 }
@@ -3698,6 +3699,7 @@ CData() :
   _bounds_type(BoundingVolume::BT_default),
   _user_bounds(nullptr),
   _final_bounds(false),
+  _parallel_cull(false),
   _fancy_bits(0),
 
   _net_collide_mask(CollideMask::all_off()),
@@ -3730,6 +3732,7 @@ CData(const PandaNode::CData &copy) :
   _bounds_type(copy._bounds_type),
   _user_bounds(copy._user_bounds),
   _final_bounds(copy._final_bounds),
+  _parallel_cull(copy._parallel_cull),
   _fancy_bits(copy._fancy_bits),
 
   _net_collide_mask(copy._net_collide_mask),
@@ -316,6 +316,10 @@ PUBLISHED:
   INLINE bool is_final(Thread *current_thread = Thread::get_current_thread()) const;
   MAKE_PROPERTY(final, is_final, set_final);
 
+  INLINE void set_parallel_cull(bool flag);
+  INLINE bool is_parallel_cull(Thread *current_thread = Thread::get_current_thread()) const;
+  MAKE_PROPERTY(parallel_cull, is_parallel_cull, set_parallel_cull);
+
   virtual bool is_geom_node() const;
   virtual bool is_lod_node() const;
   virtual bool is_collision_node() const;
@@ -603,6 +607,10 @@ private:
     // "final".  See set_final().
     bool _final_bounds;
 
+    // This is true if the children of this node may be culled on several
+    // threads at once.  See set_parallel_cull().
+    bool _parallel_cull;
+
     // This bitmask is maintained automatically by the internal PandaNode
     // code; it contains a 1 for each "fancy" attribute that is set on the
     // node.  See enum FancyBits, above.
@@ -891,6 +899,7 @@ public:
   INLINE const BoundingVolume *get_bounds() const;
   INLINE int get_nested_vertices() const;
   INLINE bool is_final() const;
+  INLINE bool is_parallel_cull() const;
   INLINE int get_fancy_bits() const;
 
   INLINE PandaNode::Children get_children() const;
@@ -211,6 +211,10 @@ private:
   void release_new();
   void remove_cache_pointers();
 
+  class StateShard;
+  static int garbage_collect_shard(StateShard &shard);
+  static bool validate_shard(StateShard &shard);
+
   void determine_bin_index();
   void determine_cull_callback();
   void fill_default();
@@ -232,17 +236,34 @@ public:
   mutable UpdateSeq _generated_shader_seq;
 
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // This mutex protects any modification to the cache, which is encoded in
+  // _composition_cache and _invert_composition_cache.
   static LightReMutex *_states_lock;
+
+  // The global set of unique RenderStates is split into shards by hash, each
+  // with its own lock, in the same way as TransformState's.  When both
+  // _states_lock and a shard's lock are needed, _states_lock must be taken
+  // first.
   typedef SimpleHashMap<const RenderState *, std::nullptr_t, indirect_compare_to_hash<const RenderState *> > States;
-  static States _states;
+  class StateShard {
+  public:
+    LightReMutex _lock;
+    States _states;
+
+    // Our current position through the garbage collection cycle.
+    size_t _garbage_index;
+  };
+  INLINE static StateShard &get_shard(const RenderState *state);
+
+  static StateShard *_shards;
+  static size_t _num_shards;
+  static int _shard_shift;
   static const RenderState *_empty_state;
 
   // This iterator records the entry corresponding to this RenderState object
-  // in the above global set.  We keep the index around so we can remove it
-  // when the RenderState destructs.
+  // in its shard of the above global set.  We keep the index around so we
+  // can remove it when the RenderState destructs.  This is protected by the
+  // shard's lock.
   int _saved_entry;
 
   // This data structure manages the job of caching the composition of two
@@ -286,10 +307,6 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static PStatCollector _cache_update_pcollector;
   static PStatCollector _garbage_collect_pcollector;
   static PStatCollector _state_compose_pcollector;
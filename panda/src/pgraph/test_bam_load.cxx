@@ -0,0 +1,96 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_bam_load.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "config_pgraph.h"
+#include "config_putil.h"
+#include "bamFile.h"
+#include "pandaNode.h"
+#include "trueClock.h"
+
+// Reads each of the bam files named on the command line several times: as
+// is, with bam-read-ahead-size, and with bam-decode-threads, and reports the
+// time taken to read and resolve each one.  Point it at the largest actors,
+// animations and levels; a pz file is decompressed by the reading thread, so
+// read-ahead makes the most difference there.
+
+/**
+ * Reads the indicated file the indicated number of times, and returns the
+ * elapsed time in seconds per read, or -1 if the file could not be read.
+ */
+static double
+time_read(const Filename &filename, int passes) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int pass = 0; pass < passes; pass++) {
+    BamFile bam_file;
+    if (!bam_file.open_read(filename)) {
+      return -1.0;
+    }
+    PT(PandaNode) node = bam_file.read_node(true);
+    if (node == nullptr) {
+      return -1.0;
+    }
+  }
+  return (clock->get_short_time() - start) / passes;
+}
+
+int
+main(int argc, char *argv[]) {
+  if (argc < 2) {
+    nout << "test_bam_load file.bam [file.bam ...]\n";
+    exit(1);
+  }
+
+  static const int passes = 10;
+  int read_ahead_size = bam_read_ahead_size;
+  if (read_ahead_size <= 0) {
+    read_ahead_size = 1048576;
+  }
+  int decode_threads = bam_decode_threads;
+  if (decode_threads <= 0) {
+    decode_threads = 4;
+  }
+
+  // The loader reports every file it opens; that would only get in the way.
+  loader_cat->set_severity(NS_warning);
+
+  for (int i = 1; i < argc; i++) {
+    Filename filename = Filename::from_os_specific(argv[i]);
+
+    // Read it once first, so that all timings come from the file cache.
+    bam_read_ahead_size.set_value(0);
+    bam_decode_threads.set_value(0);
+    if (time_read(filename, 1) < 0.0) {
+      nout << "Could not read " << filename << "\n";
+      continue;
+    }
+
+    double sync_time = time_read(filename, passes);
+
+    bam_read_ahead_size.set_value(read_ahead_size);
+    double read_ahead_time = time_read(filename, passes);
+
+    bam_read_ahead_size.set_value(0);
+    bam_decode_threads.set_value(decode_threads);
+    double decode_time = time_read(filename, passes);
+
+    nout << filename << ": " << sync_time * 1000.0 << " ms, "
+         << read_ahead_time * 1000.0 << " ms with read-ahead ("
+         << sync_time / read_ahead_time << "x), "
+         << decode_time * 1000.0 << " ms with " << decode_threads
+         << " decode threads (" << sync_time / decode_time << "x)\n";
+  }
+
+  return 0;
+}
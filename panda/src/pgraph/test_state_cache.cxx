@@ -0,0 +1,137 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_state_cache.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "config_pgraph.h"
+#include "transformState.h"
+#include "renderState.h"
+#include "colorAttrib.h"
+#include "colorScaleAttrib.h"
+#include "transparencyAttrib.h"
+#include "randomizer.h"
+#include "trueClock.h"
+#include "thread.h"
+#include "atomicAdjust.h"
+
+// Makes and composes TransformStates and RenderStates from several threads at
+// once, as the cull and app threads of a busy scene do, and measures how many
+// operations per second the state caches sustain as threads are added.  The
+// number of cache shards is set with the state-cache-shards config variable.
+
+static AtomicAdjust::Integer stop_composing = 0;
+
+/**
+ * Makes and composes states until it is told to stop.  Each thread draws from
+ * the same small pool of values, so that most of the states it makes are
+ * already in the cache, and many compositions are cache hits.
+ */
+class ComposerThread : public Thread {
+public:
+  ComposerThread(int seed) :
+    Thread("composer", "composer"),
+    _random(seed),
+    _num_ops(0)
+  {
+  }
+
+  virtual void thread_main() {
+    while (!AtomicAdjust::get(stop_composing)) {
+      for (int i = 0; i < 100; ++i) {
+        int a = _random.random_int(64);
+        int b = _random.random_int(64);
+
+        CPT(TransformState) ta = TransformState::make_pos_hpr
+          (LVecBase3(a, 0, 0), LVecBase3(0, 0, 0));
+        CPT(TransformState) tb = TransformState::make_pos_hpr
+          (LVecBase3(0, b, 0), LVecBase3(b * 5, 0, 0));
+        CPT(TransformState) tc = ta->compose(tb);
+        tc = tc->invert_compose(ta);
+
+        CPT(RenderState) ra = RenderState::make
+          (ColorAttrib::make_flat(LColor(a / 64.0f, 0, 0, 1)));
+        CPT(RenderState) rb = RenderState::make
+          (ColorScaleAttrib::make(LVecBase4(1, b / 64.0f, 1, 1)),
+           TransparencyAttrib::make((b & 1) ? TransparencyAttrib::M_alpha
+                                            : TransparencyAttrib::M_none));
+        CPT(RenderState) rc = ra->compose(rb);
+        rc = rc->invert_compose(ra);
+      }
+      _num_ops += 100 * 6;
+    }
+  }
+
+  Randomizer _random;
+  size_t _num_ops;
+};
+
+/**
+ * Runs the indicated number of threads for the indicated time, and returns
+ * the total number of operations per second.
+ */
+static double
+run(int num_threads, double seconds) {
+  AtomicAdjust::set(stop_composing, 0);
+
+  pvector<PT(ComposerThread)> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new ComposerThread(i + 1));
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (ComposerThread *thread : threads) {
+    thread->start(TP_normal, true);
+  }
+  Thread::sleep(seconds);
+  AtomicAdjust::set(stop_composing, 1);
+
+  size_t num_ops = 0;
+  for (ComposerThread *thread : threads) {
+    thread->join();
+    num_ops += thread->_num_ops;
+  }
+  double elapsed = clock->get_short_time() - start;
+
+  return num_ops / elapsed;
+}
+
+int
+main(int argc, char *argv[]) {
+  if (argc > 3) {
+    nout << "test_state_cache [max-threads [seconds]]\n";
+    exit(1);
+  }
+
+  int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+  double seconds = (argc > 2) ? atof(argv[2]) : 2.0;
+
+  nout << get_state_cache_shards() << " state cache shards\n";
+
+  double base_rate = 0.0;
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    double rate = run(num_threads, seconds);
+    if (num_threads == 1) {
+      base_rate = rate;
+    }
+    nout << num_threads << " threads: " << rate << " ops/s ("
+         << rate / base_rate << "x), "
+         << TransformState::get_num_states() << " transforms, "
+         << RenderState::get_num_states() << " states\n";
+  }
+
+  if (!TransformState::validate_states() || !RenderState::validate_states()) {
+    nout << "state cache is invalid!\n";
+    return 1;
+  }
+  return 0;
+}
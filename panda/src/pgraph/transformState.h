@@ -252,19 +252,40 @@ private:
   void release_new();
   void remove_cache_pointers();
 
+  class StateShard;
+  static int garbage_collect_shard(StateShard &shard);
+  static bool validate_shard(StateShard &shard);
+
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // This mutex protects any modification to the cache, which is encoded in
+  // _composition_cache and _invert_composition_cache.
   static LightReMutex *_states_lock;
+
+  // The global set of unique TransformStates is split into shards by hash,
+  // each with its own lock, so that threads making unrelated transforms don't
+  // wait for each other.  When both _states_lock and a shard's lock are
+  // needed, _states_lock must be taken first.
   typedef SimpleHashMap<const TransformState *, std::nullptr_t, indirect_equals_hash<const TransformState *> > States;
-  static States _states;
+  class StateShard {
+  public:
+    LightReMutex _lock;
+    States _states;
+
+    // Our current position through the garbage collection cycle.
+    size_t _garbage_index;
+  };
+  INLINE static StateShard &get_shard(const TransformState *state);
+
+  static StateShard *_shards;
+  static size_t _num_shards;
+  static int _shard_shift;
   static CPT(TransformState) _identity_state;
   static CPT(TransformState) _invalid_state;
 
   // This iterator records the entry corresponding to this TransformState
-  // object in the above global set.  We keep the index around so we can
-  // remove it when the TransformState destructs.
+  // object in its shard of the above global set.  We keep the index around
+  // so we can remove it when the TransformState destructs.  This is protected
+  // by the shard's lock.
   int _saved_entry;
 
   // This data structure manages the job of caching the composition of two
@@ -295,10 +316,6 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static bool _uniquify_matrix;
 
   static PStatCollector _cache_update_pcollector;
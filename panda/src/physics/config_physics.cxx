@@ -37,6 +37,15 @@ ConfigureFn(config_physics) {
   init_libphysics();
 }
 
+ConfigVariableBool physics_batch_uniform_forces
+("physics-batch-uniform-forces", false,
+ PRC_DESC("When this is true, the LinearEulerIntegrator sums the forces only "
+          "once for a Physical whose forces are all the same for each of its "
+          "objects (such as gravity and wind), and integrates the objects "
+          "together in blocks, which is much faster for large particle "
+          "systems.  The results may differ from the per-object evaluation "
+          "in the last few bits."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
@@ -15,6 +15,140 @@
 #include "forceNode.h"
 #include "physicalNode.h"
 #include "config_physics.h"
+#include "cmath.h"
+
+#if !defined(STDFLOAT_DOUBLE) && (defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64))
+#include <xmmintrin.h>
+#define LEI_USE_SSE2
+#endif
+
+// The number of objects that are integrated together in one block by
+// integrate_uniform().  The block is staged on the stack.
+static const int integrate_block_size = 64;
+
+/**
+ * Integrates a block of objects that have been gathered into separate
+ * position, velocity and acceleration arrays.  The arithmetic is carried out
+ * in the same order as the per-object path in child_integrate().
+ */
+static void
+integrate_block(int count, PN_stdfloat *px, PN_stdfloat *py, PN_stdfloat *pz,
+                PN_stdfloat *vx, PN_stdfloat *vy, PN_stdfloat *vz,
+                const PN_stdfloat *ax, const PN_stdfloat *ay,
+                const PN_stdfloat *az, PN_stdfloat dt) {
+  int i = 0;
+
+#ifdef LEI_USE_SSE2
+  const __m128 step = _mm_set1_ps(dt);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  for (; i + 4 <= count; i += 4) {
+    __m128 a0 = _mm_loadu_ps(ax + i);
+    __m128 a1 = _mm_loadu_ps(ay + i);
+    __m128 a2 = _mm_loadu_ps(az + i);
+    __m128 v0 = _mm_loadu_ps(vx + i);
+    __m128 v1 = _mm_loadu_ps(vy + i);
+    __m128 v2 = _mm_loadu_ps(vz + i);
+
+    // x = x + v * t + 0.5 * a * t * t
+    __m128 dx = _mm_add_ps(_mm_mul_ps(v0, step), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, a0), step), step));
+    __m128 dy = _mm_add_ps(_mm_mul_ps(v1, step), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, a1), step), step));
+    __m128 dz = _mm_add_ps(_mm_mul_ps(v2, step), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, a2), step), step));
+    _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), dx));
+    _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), dy));
+    _mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), dz));
+
+    // v = v + a * t
+    _mm_storeu_ps(vx + i, _mm_add_ps(v0, _mm_mul_ps(a0, step)));
+    _mm_storeu_ps(vy + i, _mm_add_ps(v1, _mm_mul_ps(a1, step)));
+    _mm_storeu_ps(vz + i, _mm_add_ps(v2, _mm_mul_ps(a2, step)));
+  }
+#endif  // LEI_USE_SSE2
+
+  for (; i < count; ++i) {
+    px[i] += vx[i] * dt + (((PN_stdfloat)0.5 * ax[i]) * dt) * dt;
+    py[i] += vy[i] * dt + (((PN_stdfloat)0.5 * ay[i]) * dt) * dt;
+    pz[i] += vz[i] * dt + (((PN_stdfloat)0.5 * az[i]) * dt) * dt;
+
+    vx[i] += ax[i] * dt;
+    vy[i] += ay[i] * dt;
+    vz[i] += az[i] * dt;
+  }
+}
+
+/**
+ * Integrates all of the objects in the vector, when every force that acts on
+ * them is known to be the same for each object.  The objects are gathered in
+ * blocks into arrays of positions, velocities and accelerations, integrated
+ * together, and scattered back again.
+ */
+static void
+integrate_uniform(const PhysicsObject::Vector &objects, const LVector3 &md,
+                  const LVector3 &non_md, PN_stdfloat damper, PN_stdfloat dt) {
+  PhysicsObject *block[integrate_block_size];
+  PN_stdfloat px[integrate_block_size];
+  PN_stdfloat py[integrate_block_size];
+  PN_stdfloat pz[integrate_block_size];
+  PN_stdfloat vx[integrate_block_size];
+  PN_stdfloat vy[integrate_block_size];
+  PN_stdfloat vz[integrate_block_size];
+  PN_stdfloat ax[integrate_block_size];
+  PN_stdfloat ay[integrate_block_size];
+  PN_stdfloat az[integrate_block_size];
+
+  size_t num_objects = objects.size();
+  size_t oi = 0;
+  bool bail = false;
+  while (oi < num_objects && !bail) {
+    // Gather the next block of active objects.
+    int count = 0;
+    for (; oi < num_objects && count < integrate_block_size; ++oi) {
+      PhysicsObject *object = objects[oi];
+      if (object == nullptr || !object->get_active()) {
+        continue;
+      }
+
+      // As in child_integrate(), a massless object stops the integration,
+      // though the objects before it are still integrated.
+      PN_stdfloat mass = object->get_mass();
+      nassertd(mass != 0.0f) {
+        bail = true;
+        break;
+      }
+      LVector3 accel_vec = md / mass;
+      accel_vec += non_md;
+      accel_vec *= damper;
+
+      assert(object->get_position() == object->get_last_position());
+
+      const LPoint3 &pos = object->get_position();
+      const LVector3 &vel = object->get_velocity();
+      block[count] = object;
+      px[count] = pos[0];
+      py[count] = pos[1];
+      pz[count] = pos[2];
+      vx[count] = vel[0];
+      vy[count] = vel[1];
+      vz[count] = vel[2];
+      ax[count] = accel_vec[0];
+      ay[count] = accel_vec[1];
+      az[count] = accel_vec[2];
+      ++count;
+    }
+
+    integrate_block(count, px, py, pz, vx, vy, vz, ax, ay, az, dt);
+
+    // And store them back.
+    for (int i = 0; i < count; ++i) {
+      if (!cnan(px[i]) && !cnan(py[i]) && !cnan(pz[i])) {
+        block[i]->set_position(px[i], py[i], pz[i]);
+      }
+      if (!cnan(vx[i]) && !cnan(vy[i]) && !cnan(vz[i])) {
+        block[i]->set_velocity(vx[i], vy[i], vz[i]);
+      }
+    }
+  }
+}
 
 /**
  * constructor
@@ -59,6 +193,53 @@ child_integrate(Physical *physical,
   // Get the greater of the local or global viscosity:
   PN_stdfloat viscosityDamper=1.0f-physical->get_viscosity();
 
+  // If none of the forces depends on the object it acts on, as is the case
+  // for gravity and wind, we can sum the forces just once and integrate all
+  // of the objects together, which is much faster for large particle systems.
+  bool all_uniform = true;
+  LinearForceVector::const_iterator fi;
+  for (fi = forces.begin(); fi != forces.end() && all_uniform; ++fi) {
+    all_uniform = !(*fi)->get_active() || (*fi)->is_uniform();
+  }
+  const LinearForceVector &local_forces = physical->get_linear_forces();
+  for (fi = local_forces.begin(); fi != local_forces.end() && all_uniform; ++fi) {
+    all_uniform = !(*fi)->get_active() || (*fi)->is_uniform();
+  }
+
+  if (all_uniform && physics_batch_uniform_forces) {
+    LVector3 md_accum_vec(0.0f, 0.0f, 0.0f);
+    LVector3 non_md_accum_vec(0.0f, 0.0f, 0.0f);
+
+    // The matrices are in the same order as the active forces, global first.
+    int index = 0;
+    for (fi = forces.begin(); fi != forces.end(); ++fi) {
+      LinearForce *cur_force = *fi;
+      if (cur_force->get_active()) {
+        LVector3 f = cur_force->get_vector(nullptr) * matrices[index++];
+        if (cur_force->get_mass_dependent()) {
+          md_accum_vec += f;
+        } else {
+          non_md_accum_vec += f;
+        }
+      }
+    }
+    for (fi = local_forces.begin(); fi != local_forces.end(); ++fi) {
+      LinearForce *cur_force = *fi;
+      if (cur_force->get_active()) {
+        LVector3 f = cur_force->get_vector(nullptr) * matrices[index++];
+        if (cur_force->get_mass_dependent()) {
+          md_accum_vec += f;
+        } else {
+          non_md_accum_vec += f;
+        }
+      }
+    }
+
+    integrate_uniform(physical->get_object_vector(), md_accum_vec,
+                      non_md_accum_vec, viscosityDamper, dt);
+    return;
+  }
+
   // Loop through each object in the set.  This processing occurs in O(pf)
   // time, where p is the number of physical objects and f is the number of
   // forces.  Unfortunately, no precomputation of forces can occur, as each
@@ -78,6 +78,16 @@ is_linear() const {
   return true;
 }
 
+/**
+ * Returns true if get_vector() returns the same vector for every
+ * PhysicsObject, so that an integrator may evaluate the force only once for
+ * all of the objects of a Physical.
+ */
+bool LinearForce::
+is_uniform() const {
+  return false;
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -38,6 +38,7 @@ PUBLISHED:
   virtual LinearForce *make_copy() = 0;
 
   virtual bool is_linear() const;
+  virtual bool is_uniform() const;
 
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
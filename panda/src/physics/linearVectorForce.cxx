@@ -70,6 +70,14 @@ get_child_vector(const PhysicsObject *) {
   return _fvec;
 }
 
+/**
+ * A vector force acts the same on every object.
+ */
+bool LinearVectorForce::
+is_uniform() const {
+  return true;
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
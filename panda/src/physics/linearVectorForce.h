@@ -39,6 +39,8 @@ PUBLISHED:
 public:
   INLINE LinearVectorForce& operator += (const LinearVectorForce &other);
 
+  virtual bool is_uniform() const;
+
 private:
   LVector3 _fvec;
 
@@ -82,6 +82,27 @@ ConfigVariableBool pstats_gpu_timing
           "is not usually an accurate reflectino of how long the actual "
           "operation takes on the video card."));
 
+ConfigVariableFilename pstats_record_file
+("pstats-record-file", "",
+ PRC_DESC("The file that PStatClient::record() writes to if no filename is "
+          "given.  A recording may be converted afterwards for viewing in "
+          "other tools with pstats-convert."));
+
+ConfigVariableInt pstats_record_ring_size
+("pstats-record-ring-size", 256,
+ PRC_DESC("The number of frames of data that may be queued up for each "
+          "thread while PStatClient::record() is in effect, waiting to be "
+          "written to disk.  If the disk can't keep up, frames beyond this "
+          "are dropped from the recording."));
+
+ConfigVariableList pstats_metrics
+("pstats-metrics",
+ PRC_DESC("The full name of a collector, such as "
+          "Cull:BSP:Node_LeafBoundsIntersect, whose timing should be gathered "
+          "into a histogram even when PStats is not connected.  This may be "
+          "repeated to name several collectors.  See "
+          "PStatClient::enable_metrics()."));
+
 // The rest are different in that they directly control the server, not the
 // client.
 ConfigVariableBool pstats_scroll_mode
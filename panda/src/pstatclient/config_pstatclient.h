@@ -22,6 +22,8 @@
 #include "configVariableInt.h"
 #include "configVariableDouble.h"
 #include "configVariableBool.h"
+#include "configVariableFilename.h"
+#include "configVariableList.h"
 
 // Configure variables for pstats package.
 
@@ -39,6 +41,10 @@ extern EXPCL_PANDA_PSTATCLIENT ConfigVariableInt pstats_port;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_target_frame_rate;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableBool pstats_gpu_timing;
 
+extern EXPCL_PANDA_PSTATCLIENT ConfigVariableFilename pstats_record_file;
+extern EXPCL_PANDA_PSTATCLIENT ConfigVariableInt pstats_record_ring_size;
+extern EXPCL_PANDA_PSTATCLIENT ConfigVariableList pstats_metrics;
+
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableBool pstats_scroll_mode;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_history;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_average_time;
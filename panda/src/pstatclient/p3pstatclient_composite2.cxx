@@ -2,6 +2,8 @@
 #include "pStatCollectorDef.cxx"
 #include "pStatCollectorForward.cxx"
 #include "pStatFrameData.cxx"
+#include "pStatHistogram.cxx"
 #include "pStatProperties.cxx"
+#include "pStatRecorder.cxx"
 #include "pStatServerControlMessage.cxx"
 #include "pStatThread.cxx"
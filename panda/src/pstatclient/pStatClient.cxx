@@ -26,6 +26,7 @@
 #include "thread.h"
 #include "clockObject.h"
 #include "neverFreeMemory.h"
+#include "connection.h"
 
 using std::string;
 
@@ -45,6 +46,9 @@ PStatCollector PStatClient::_pstats_pcollector("*:PStats");
 PStatCollector PStatClient::_clock_wait_pcollector("Wait:Clock Wait:Sleep");
 PStatCollector PStatClient::_clock_busy_wait_pcollector("Wait:Clock Wait:Spin");
 PStatCollector PStatClient::_thread_block_pcollector("Wait:Thread block");
+PStatCollector PStatClient::_net_flushes_pcollector("Net flushes");
+PStatCollector PStatClient::_net_flush_syscalls_pcollector("Net syscalls per flush");
+PStatCollector PStatClient::_net_flush_bytes_pcollector("Net bytes per flush");
 
 PStatClient *PStatClient::_global_pstats = nullptr;
 
@@ -85,6 +89,8 @@ PStatClient() :
   _threads_size = 0;
   _num_threads = 0;
 
+  _num_metrics = 0;
+
   // We always have a collector at index 0 named "Frame".  This tracks the
   // total frame time and is the root of all other collectors.  We have to
   // make this one by hand since it's the root.
@@ -210,9 +216,10 @@ get_main_thread() const {
  */
 PStatThread PStatClient::
 get_current_thread() const {
-  if (!client_is_connected()) {
+  if (!client_is_connected() && AtomicAdjust::get(_num_metrics) == 0) {
     // No need to make the relatively expensive call to
-    // Thread::get_current_thread() if we're not even connected.
+    // Thread::get_current_thread() if we're not even connected, unless some
+    // collectors are gathering metrics, which are kept per thread.
     return get_main_thread();
   }
   return PStatThread(Thread::get_current_thread(), (PStatClient *)this);
@@ -378,6 +385,17 @@ main_tick() {
   }
 #endif  // DO_MEMORY_USAGE
 
+  // Report the work the network layer did to send this frame's datagrams.
+  if (is_connected()) {
+    int num_flushes, num_syscalls, num_bytes;
+    Connection::get_flush_counts(num_flushes, num_syscalls, num_bytes);
+    _net_flushes_pcollector.set_level(num_flushes);
+    if (num_flushes != 0) {
+      _net_flush_syscalls_pcollector.set_level((double)num_syscalls / num_flushes);
+      _net_flush_bytes_pcollector.set_level((double)num_bytes / num_flushes);
+    }
+  }
+
   get_global_pstats()->client_main_tick();
 }
 
@@ -450,6 +468,16 @@ client_connect(string hostname, int port) {
   return get_impl()->client_connect(hostname, port);
 }
 
+/**
+ * The nonstatic implementation of record().
+ */
+bool PStatClient::
+client_record(const Filename &filename) {
+  ReMutexHolder holder(_lock);
+  client_disconnect();
+  return get_impl()->client_record(filename);
+}
+
 /**
  * The nonstatic implementation of disconnect().
  */
@@ -491,6 +519,14 @@ client_is_connected() const {
   return has_impl() && _impl->client_is_connected();
 }
 
+/**
+ * The nonstatic implementation of is_recording().
+ */
+bool PStatClient::
+client_is_recording() const {
+  return has_impl() && _impl->client_is_recording();
+}
+
 /**
  * Resumes the PStatClient after the simulation has been paused for a while.
  * This allows the stats to continue exactly where it left off, instead of
@@ -520,6 +556,112 @@ get_global_pstats() {
   return _global_pstats;
 }
 
+/**
+ * Starts gathering metrics for the indicated collector: from now on, each
+ * time it is started and stopped, the elapsed time is counted in a histogram
+ * for the thread, whether or not the client is connected to a server.  This
+ * is much cheaper than connecting, so it may be left on in production for a
+ * handful of collectors, whose timing can be read back with get_metrics().
+ *
+ * Collectors may also be named in pstats-metrics to enable this as soon as
+ * they are created.  Only start() and stop() without an explicit time are
+ * measured.
+ */
+void PStatClient::
+enable_metrics(int collector_index) {
+  ReMutexHolder holder(_lock);
+  nassertv(collector_index >= 0 && collector_index < _num_collectors);
+
+  Collector *collector = get_collector_ptr(collector_index);
+  if (collector->_metrics_slot < 0) {
+    collector->_metrics_slot = (int)_metrics_collectors.size();
+    _metrics_collectors.push_back(collector_index);
+    AtomicAdjust::inc(_num_metrics);
+  }
+}
+
+/**
+ * Returns true if enable_metrics() has been called for the indicated
+ * collector.
+ */
+bool PStatClient::
+has_metrics(int collector_index) const {
+  nassertr(collector_index >= 0 && collector_index < AtomicAdjust::get(_num_collectors), false);
+  return get_collector_ptr(collector_index)->_metrics_slot >= 0;
+}
+
+/**
+ * Returns the number of collectors for which metrics are enabled.
+ */
+int PStatClient::
+get_num_metrics() const {
+  ReMutexHolder holder(_lock);
+  return (int)_metrics_collectors.size();
+}
+
+/**
+ * Returns the index of the nth collector for which metrics are enabled.
+ */
+int PStatClient::
+get_metrics_collector(int n) const {
+  ReMutexHolder holder(_lock);
+  nassertr(n >= 0 && n < (int)_metrics_collectors.size(), 0);
+  return _metrics_collectors[n];
+}
+
+/**
+ * Returns the timing histogram of the indicated collector, combined across
+ * all threads.  If reset is true, the histograms are emptied at the same
+ * time, so that calling this at regular intervals returns the timing for
+ * each interval.  Returns an empty histogram if metrics are not enabled for
+ * the collector.
+ */
+PT(PStatHistogram) PStatClient::
+get_metrics(int collector_index, bool reset) {
+  ReMutexHolder holder(_lock);
+  PT(PStatHistogram) result = new PStatHistogram;
+  nassertr(collector_index >= 0 && collector_index < _num_collectors, result);
+
+  int slot = get_collector_ptr(collector_index)->_metrics_slot;
+  if (slot < 0) {
+    return result;
+  }
+
+  // The histograms are only ever added to atomically, so they can be merged
+  // without stopping the threads that are recording into them.
+  ThreadPointer *threads = (ThreadPointer *)_threads;
+  for (int ti = 0; ti < _num_threads; ++ti) {
+    InternalThread *thread = threads[ti];
+    int metrics_size = AtomicAdjust::get(thread->_metrics_size);
+    if (slot < metrics_size) {
+      InternalThread::MetricsData *metrics =
+        (InternalThread::MetricsData *)AtomicAdjust::get_ptr(thread->_metrics);
+      PStatHistogram *histogram = metrics[slot]._histogram;
+      if (reset) {
+        result->take(*histogram);
+      } else {
+        result->merge(*histogram);
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * Writes a line for each of the collectors for which metrics are enabled,
+ * with the number of samples and the 50th and 99th percentile and maximum
+ * times.  If reset is true, the histograms are emptied at the same time.
+ */
+void PStatClient::
+write_metrics(std::ostream &out, bool reset) {
+  ReMutexHolder holder(_lock);
+  for (int collector_index : _metrics_collectors) {
+    PT(PStatHistogram) histogram = get_metrics(collector_index, reset);
+    out << get_collector_fullname(collector_index) << ": " << *histogram
+        << "\n";
+  }
+}
+
 /**
  * Creates the PStatClientImpl class for this PStatClient.
  */
@@ -612,6 +754,17 @@ make_collector_with_name(int parent_index, const string &name) {
   }
   add_collector(collector);
 
+  int num_metrics = pstats_metrics.get_num_unique_values();
+  if (num_metrics != 0) {
+    string fullname = get_collector_fullname(new_index);
+    for (int i = 0; i < num_metrics; ++i) {
+      if (pstats_metrics.get_unique_value(i) == fullname) {
+        enable_metrics(new_index);
+        break;
+      }
+    }
+  }
+
   return PStatCollector(this, new_index);
 }
 
@@ -753,6 +906,9 @@ is_started(int collector_index, int thread_index) const {
  */
 void PStatClient::
 start(int collector_index, int thread_index) {
+  if (AtomicAdjust::get(_num_metrics) != 0) {
+    start_metrics(collector_index, thread_index);
+  }
   if (!client_is_connected()) {
     return;
   }
@@ -815,6 +971,9 @@ start(int collector_index, int thread_index, double as_of) {
  */
 void PStatClient::
 stop(int collector_index, int thread_index) {
+  if (AtomicAdjust::get(_num_metrics) != 0) {
+    stop_metrics(collector_index, thread_index);
+  }
   if (!client_is_connected()) {
     return;
   }
@@ -1125,6 +1284,33 @@ add_thread(PStatClient::InternalThread *thread) {
   }
 }
 
+/**
+ * Makes room in the thread's _metrics for at least the indicated number of
+ * collectors.  Called only by the thread itself.
+ */
+void PStatClient::
+grow_metrics(InternalThread *thread, size_t size) {
+  int old_size = AtomicAdjust::get(thread->_metrics_size);
+  InternalThread::MetricsData *old_metrics =
+    (InternalThread::MetricsData *)AtomicAdjust::get_ptr(thread->_metrics);
+
+  InternalThread::MetricsData *new_metrics = new InternalThread::MetricsData[size];
+  for (int i = 0; i < old_size; ++i) {
+    new_metrics[i] = old_metrics[i];
+  }
+  for (size_t i = old_size; i < size; ++i) {
+    new_metrics[i]._start = 0.0;
+    new_metrics[i]._nested_count = 0;
+    new_metrics[i]._histogram = new PStatHistogram;
+  }
+
+  // The histograms stay where they are, so it doesn't matter whether another
+  // thread in get_metrics() still sees the old array.  We publish the array
+  // before the size, so that it is at least as large as the size says.
+  AtomicAdjust::set_ptr(thread->_metrics, new_metrics);
+  AtomicAdjust::set(thread->_metrics_size, (AtomicAdjust::Integer)size);
+}
+
 /**
  * Called when the thread is deactivated (swapped for another running thread).
  * This is intended to provide a callback hook for PStats to assign time to
@@ -1202,7 +1388,9 @@ InternalThread(Thread *thread) :
   _frame_number(0),
   _next_packet(0.0),
   _thread_active(true),
-  _thread_lock(string("PStatClient::InternalThread ") + thread->get_name())
+  _thread_lock(string("PStatClient::InternalThread ") + thread->get_name()),
+  _metrics(nullptr),
+  _metrics_size(0)
 {
 }
 
@@ -1218,7 +1406,9 @@ InternalThread(const string &name, const string &sync_name) :
   _frame_number(0),
   _next_packet(0.0),
   _thread_active(true),
-  _thread_lock(string("PStatClient::InternalThread ") + name)
+  _thread_lock(string("PStatClient::InternalThread ") + name),
+  _metrics(nullptr),
+  _metrics_size(0)
 {
 }
 
@@ -1308,6 +1498,11 @@ client_connect(std::string hostname, int port) {
   return false;
 }
 
+bool PStatClient::
+client_record(const Filename &filename) {
+  return false;
+}
+
 void PStatClient::
 client_disconnect() {
   return;
@@ -1318,6 +1513,11 @@ client_is_connected() const {
   return false;
 }
 
+bool PStatClient::
+client_is_recording() const {
+  return false;
+}
+
 void PStatClient::
 client_resume_after_pause() {
   return;
@@ -29,6 +29,9 @@
 #include "atomicAdjust.h"
 #include "numeric_types.h"
 #include "bitArray.h"
+#include "filename.h"
+#include "pStatHistogram.h"
+#include "trueClock.h"
 
 class PStatClientImpl;
 class PStatCollector;
@@ -89,8 +92,10 @@ PUBLISHED:
   MAKE_PROPERTY(real_time, get_real_time);
 
   INLINE static bool connect(const std::string &hostname = std::string(), int port = -1);
+  INLINE static bool record(const Filename &filename = Filename());
   INLINE static void disconnect();
   INLINE static bool is_connected();
+  INLINE static bool is_recording();
 
   INLINE static void resume_after_pause();
 
@@ -100,13 +105,25 @@ PUBLISHED:
   void client_main_tick();
   void client_thread_tick(const std::string &sync_name);
   bool client_connect(std::string hostname, int port);
+  bool client_record(const Filename &filename);
   void client_disconnect();
   bool client_is_connected() const;
+  bool client_is_recording() const;
 
   void client_resume_after_pause();
 
   static PStatClient *get_global_pstats();
 
+  void enable_metrics(int collector_index);
+  bool has_metrics(int collector_index) const;
+  int get_num_metrics() const;
+  int get_metrics_collector(int n) const;
+  MAKE_SEQ(get_metrics_collectors, get_num_metrics, get_metrics_collector);
+  PT(PStatHistogram) get_metrics(int collector_index, bool reset = false);
+  void write_metrics(std::ostream &out, bool reset = false);
+
+  MAKE_SEQ_PROPERTY(metrics_collectors, get_num_metrics, get_metrics_collector);
+
 private:
   INLINE bool has_impl() const;
   INLINE PStatClientImpl *get_impl();
@@ -128,6 +145,9 @@ private:
   void stop(int collector_index, int thread_index);
   void stop(int collector_index, int thread_index, double as_of);
 
+  INLINE void start_metrics(int collector_index, int thread_index);
+  INLINE void stop_metrics(int collector_index, int thread_index);
+
   void clear_level(int collector_index, int thread_index);
   void set_level(int collector_index, int thread_index, double level);
   void add_level(int collector_index, int thread_index, double increment);
@@ -141,6 +161,8 @@ private:
   class InternalThread;
   void add_collector(Collector *collector);
   void add_thread(InternalThread *thread);
+  void grow_metrics(InternalThread *thread, size_t size);
+  INLINE static bool is_metrics_owner(const InternalThread *thread);
 
   INLINE Collector *get_collector_ptr(int collector_index) const;
   INLINE InternalThread *get_thread_ptr(int thread_index) const;
@@ -193,6 +215,10 @@ private:
     // Relations to other collectors.
     ThingsByName _children;
     PerThread _per_thread;
+
+    // The index of this collector's entry in InternalThread::_metrics, or -1
+    // if metrics are not enabled for it.
+    int _metrics_slot;
   };
   typedef Collector *CollectorPointer;
   AtomicAdjust::Pointer _collectors;  // CollectorPointer *_collectors;
@@ -222,12 +248,33 @@ private:
     // thread, as well as writes to the _per_thread data for this particular
     // thread in the Collector class, above.
     LightMutex _thread_lock;
+
+    // The timing for the collectors that have metrics enabled, indexed by
+    // metrics slot.  Only this thread itself records the timing, so _start
+    // and _nested_count are accessed without a lock.  The histograms may be
+    // read from any thread; to allow this without a lock, the array is never
+    // changed in place when it grows, but copied to a new one, and the old
+    // one is leaked, as with _threads.
+    class MetricsData {
+    public:
+      double _start;
+      int _nested_count;
+      PT(PStatHistogram) _histogram;
+    };
+    AtomicAdjust::Pointer _metrics;  // MetricsData *_metrics;
+    AtomicAdjust::Integer _metrics_size;
   };
   typedef InternalThread *ThreadPointer;
   AtomicAdjust::Pointer _threads;  // ThreadPointer *_threads;
   AtomicAdjust::Integer _threads_size;  // size of the allocated array
   AtomicAdjust::Integer _num_threads;   // number of in-use elements within the array
 
+  // The collectors that have metrics enabled, indexed by metrics slot.  The
+  // number of them is also kept in _num_metrics, which may be checked
+  // without the lock.
+  vector_int _metrics_collectors;
+  AtomicAdjust::Integer _num_metrics;
+
   mutable PStatClientImpl *_impl;
 
   static PStatCollector _heap_total_size_pcollector;
@@ -246,6 +293,9 @@ private:
   static PStatCollector _clock_wait_pcollector;
   static PStatCollector _clock_busy_wait_pcollector;
   static PStatCollector _thread_block_pcollector;
+  static PStatCollector _net_flushes_pcollector;
+  static PStatCollector _net_flush_syscalls_pcollector;
+  static PStatCollector _net_flush_bytes_pcollector;
 
   static PStatClient *_global_pstats;
 
@@ -287,8 +337,10 @@ public:
 
 PUBLISHED:
   INLINE static bool connect(const std::string & = std::string(), int = -1) { return false; }
+  INLINE static bool record(const Filename & = Filename()) { return false; }
   INLINE static void disconnect() { }
   INLINE static bool is_connected() { return false; }
+  INLINE static bool is_recording() { return false; }
   INLINE static void resume_after_pause() { }
 
   static void main_tick();
@@ -298,8 +350,10 @@ public:
   void client_main_tick();
   void client_thread_tick(const std::string &sync_name);
   bool client_connect(std::string hostname, int port);
+  bool client_record(const Filename &filename);
   void client_disconnect();
   bool client_is_connected() const;
+  bool client_is_recording() const;
 
   void client_resume_after_pause();
 
@@ -19,6 +19,7 @@
 #include "pStatClient.h"
 #include "pStatClientControlMessage.h"
 #include "pStatServerControlMessage.h"
+#include "pStatRecorder.h"
 #include "pStatCollector.h"
 #include "pStatThread.h"
 #include "config_pstatclient.h"
@@ -48,6 +49,7 @@ PStatClientImpl(PStatClient *client) :
   _reader.set_tcp_header_size(4);
   _writer.set_tcp_header_size(4);
   _is_connected = false;
+  _recorder = nullptr;
   _got_udp_port = false;
   _collectors_reported = 0;
   _threads_reported = 0;
@@ -78,7 +80,7 @@ PStatClientImpl(PStatClient *client) :
  */
 PStatClientImpl::
 ~PStatClientImpl() {
-  nassertv(!_is_connected);
+  nassertv(!client_is_connected());
 }
 
 /**
@@ -86,7 +88,7 @@ PStatClientImpl::
  */
 bool PStatClientImpl::
 client_connect(std::string hostname, int port) {
-  nassertr(!_is_connected, true);
+  nassertr(!client_is_connected(), true);
 
   if (hostname.empty()) {
     hostname = pstats_host;
@@ -127,11 +129,51 @@ client_connect(std::string hostname, int port) {
   return _is_connected;
 }
 
+/**
+ * Called only by PStatClient::client_record().
+ */
+bool PStatClientImpl::
+client_record(const Filename &filename) {
+  nassertr(!client_is_connected(), true);
+
+  Filename fname = filename;
+  if (fname.empty()) {
+    fname = pstats_record_file;
+    if (fname.empty()) {
+      pstats_cat.error()
+        << "No filename given to record PStats to; set pstats-record-file.\n";
+      return false;
+    }
+  }
+
+  PStatRecorder *recorder = new PStatRecorder;
+  if (!recorder->open(fname)) {
+    delete recorder;
+    return false;
+  }
+  _recorder = recorder;
+
+  pstats_cat.info()
+    << "Recording PStats to " << fname << "\n";
+
+  send_hello();
+  return true;
+}
+
 /**
  * Called only by PStatClient::client_disconnect().
  */
 void PStatClientImpl::
 client_disconnect() {
+  if (_recorder != nullptr) {
+    // Make sure the file defines every collector its frames refer to.
+    report_new_collectors();
+    report_new_threads();
+
+    delete _recorder;
+    _recorder = nullptr;
+  }
+
   if (_is_connected) {
 #ifdef DEBUG_THREADS
     MutexDebug::decrement_pstats();
@@ -169,8 +211,9 @@ new_frame(int thread_index) {
   }
 
   // If we've got the UDP port by the time the frame starts, it's time to
-  // become active and start actually tracking data.
-  if (_got_udp_port) {
+  // become active and start actually tracking data.  A recording is active
+  // right away.
+  if (_got_udp_port || _recorder != nullptr) {
     pthread->_is_active = true;
   }
 
@@ -235,7 +278,7 @@ add_frame(int thread_index, const PStatFrameData &frame_data) {
 
   // If we've got the UDP port by the time the frame starts, it's time to
   // become active and start actually tracking data.
-  if (_got_udp_port) {
+  if (_got_udp_port || _recorder != nullptr) {
     pthread->_is_active = true;
   }
 
@@ -265,6 +308,16 @@ transmit_frame_data(int thread_index, int frame_number,
                     const PStatFrameData &frame_data) {
   nassertv(thread_index >= 0 && thread_index < _client->_num_threads);
   PStatClient::InternalThread *thread = _client->get_thread_ptr(thread_index);
+
+  if (_recorder != nullptr) {
+    // Every frame goes into the recording; it's the writer thread's job to
+    // keep up.
+    if (thread->_is_active) {
+      _recorder->record_frame(thread_index, frame_number, frame_data);
+    }
+    return;
+  }
+
   if (_is_connected && thread->_is_active) {
 
     // We don't want to send too many packets in a hurry and flood the server.
@@ -362,7 +415,7 @@ transmit_control_data() {
     }
   }
 
-  if (_is_connected) {
+  if (client_is_connected()) {
     report_new_collectors();
     report_new_threads();
   }
@@ -390,7 +443,7 @@ get_hostname() {
  */
 void PStatClientImpl::
 send_hello() {
-  nassertv(_is_connected);
+  nassertv(client_is_connected());
 
   PStatClientControlMessage message;
   message._type = PStatClientControlMessage::T_hello;
@@ -401,7 +454,20 @@ send_hello() {
 
   Datagram datagram;
   message.encode(datagram);
-  _writer.send(datagram, _tcp_connection, true);
+  send_control_datagram(datagram);
+}
+
+/**
+ * Sends a control message to the server over the TCP connection, or writes it
+ * to the recording.
+ */
+void PStatClientImpl::
+send_control_datagram(const Datagram &datagram) {
+  if (_recorder != nullptr) {
+    _recorder->record_control(datagram);
+  } else {
+    _writer.send(datagram, _tcp_connection, true);
+  }
 }
 
 /**
@@ -415,7 +481,7 @@ report_new_collectors() {
   // So we limit ourselves here to sending only half that many.
   static const int max_collectors_at_once = 700;
 
-  while (_is_connected && _collectors_reported < _client->_num_collectors) {
+  while (client_is_connected() && _collectors_reported < _client->_num_collectors) {
     PStatClientControlMessage message;
     message._type = PStatClientControlMessage::T_define_collectors;
     int i = 0;
@@ -428,7 +494,7 @@ report_new_collectors() {
 
     Datagram datagram;
     message.encode(datagram);
-    _writer.send(datagram, _tcp_connection, true);
+    send_control_datagram(datagram);
   }
 }
 
@@ -438,7 +504,7 @@ report_new_collectors() {
  */
 void PStatClientImpl::
 report_new_threads() {
-  while (_is_connected && _threads_reported < _client->_num_threads) {
+  while (client_is_connected() && _threads_reported < _client->_num_threads) {
     PStatClientControlMessage message;
     message._type = PStatClientControlMessage::T_define_threads;
     message._first_thread_index = _threads_reported;
@@ -451,7 +517,7 @@ report_new_threads() {
 
     Datagram datagram;
     message.encode(datagram);
-    _writer.send(datagram, _tcp_connection, true);
+    send_control_datagram(datagram);
   }
 }
 
@@ -27,12 +27,14 @@
 
 #include "trueClock.h"
 #include "pmap.h"
+#include "filename.h"
 
 class PStatClient;
 class PStatServerControlMessage;
 class PStatCollector;
 class PStatCollectorDef;
 class PStatThread;
+class PStatRecorder;
 
 /**
  * This class is the implementation of the actual PStatClient class (which is
@@ -60,8 +62,10 @@ public:
 
   INLINE void client_main_tick();
   bool client_connect(std::string hostname, int port);
+  bool client_record(const Filename &filename);
   void client_disconnect();
   INLINE bool client_is_connected() const;
+  INLINE bool client_is_recording() const;
 
   INLINE void client_resume_after_pause();
 
@@ -81,6 +85,7 @@ private:
   // Networking stuff
   std::string get_hostname();
   void send_hello();
+  void send_control_datagram(const Datagram &datagram);
   void report_new_collectors();
   void report_new_threads();
   void handle_server_control_message(const PStatServerControlMessage &message);
@@ -100,6 +105,9 @@ private:
   PT(Connection) _tcp_connection;
   PT(Connection) _udp_connection;
 
+  // This is non-NULL while the frames are being written to a file instead.
+  PStatRecorder *_recorder;
+
   int _collectors_reported;
   int _threads_reported;
 
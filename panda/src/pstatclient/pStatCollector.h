@@ -96,6 +96,9 @@ PUBLISHED:
   INLINE void sub_level(const PStatThread &thread, double decrement);
   INLINE double get_level(const PStatThread &thread);
 
+  INLINE void enable_metrics();
+  INLINE PT(PStatHistogram) get_metrics(bool reset = false);
+
   INLINE int get_index() const;
 
 private:
@@ -141,6 +144,9 @@ PUBLISHED:
   INLINE void sub_level(const PStatThread &, double) { }
   INLINE double get_level(const PStatThread &) { return 0.0; }
 
+  INLINE void enable_metrics() { }
+  INLINE PT(PStatHistogram) get_metrics(bool = false) { return nullptr; }
+
   INLINE int get_index() const { return 0; }
 
 #endif  // DO_PSTATS
@@ -0,0 +1,165 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pStatHistogram.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pStatHistogram.h"
+
+#include <math.h>
+
+/**
+ *
+ */
+PStatHistogram::
+PStatHistogram() :
+  _num_samples(0),
+  _max_ns(0)
+{
+  for (int i = 0; i < num_buckets; ++i) {
+    _buckets[i] = 0;
+  }
+}
+
+/**
+ * Makes a copy of the indicated histogram.  If samples are being added to it
+ * at the same time, the copy may include some of them but not others.
+ */
+PStatHistogram::
+PStatHistogram(const PStatHistogram &copy) :
+  ReferenceCount(),
+  _num_samples(AtomicAdjust::get(copy._num_samples)),
+  _max_ns(AtomicAdjust::get(copy._max_ns))
+{
+  for (int i = 0; i < num_buckets; ++i) {
+    _buckets[i] = AtomicAdjust::get(copy._buckets[i]);
+  }
+}
+
+/**
+ * Adds a sample to the histogram, measured in seconds.
+ */
+void PStatHistogram::
+add_sample(double elapsed) {
+  add_sample_ns((elapsed > 0.0) ? (uint64_t)(elapsed * 1.0e9 + 0.5) : 0);
+}
+
+/**
+ * Returns the average of the samples, in seconds.  Since the samples aren't
+ * stored, this is computed from the middle of each bucket, and is as precise
+ * as the buckets are.
+ */
+double PStatHistogram::
+get_mean() const {
+  double total = 0.0;
+  AtomicAdjust::Integer count = 0;
+  for (int i = 0; i < num_buckets; ++i) {
+    AtomicAdjust::Integer n = AtomicAdjust::get(_buckets[i]);
+    if (n != 0) {
+      double mid = (double)get_bucket_start(i) + (double)(get_bucket_width(i) - 1) * 0.5;
+      total += mid * (double)n;
+      count += n;
+    }
+  }
+  if (count == 0) {
+    return 0.0;
+  }
+  return std::min(total / (double)count * 1.0e-9, get_max());
+}
+
+/**
+ * Returns the elapsed time, in seconds, below which the indicated fraction of
+ * the samples fall; for instance, get_percentile(0.99) returns the 99th
+ * percentile.  Returns 0 if the histogram is empty.
+ */
+double PStatHistogram::
+get_percentile(double fraction) const {
+  nassertr(fraction >= 0.0 && fraction <= 1.0, 0.0);
+
+  AtomicAdjust::Integer count = 0;
+  for (int i = 0; i < num_buckets; ++i) {
+    count += AtomicAdjust::get(_buckets[i]);
+  }
+  if (count == 0) {
+    return 0.0;
+  }
+
+  AtomicAdjust::Integer rank = (AtomicAdjust::Integer)ceil(fraction * (double)count);
+  rank = std::max(rank, (AtomicAdjust::Integer)1);
+
+  AtomicAdjust::Integer seen = 0;
+  int i = 0;
+  for (; i < num_buckets - 1; ++i) {
+    seen += AtomicAdjust::get(_buckets[i]);
+    if (seen >= rank) {
+      break;
+    }
+  }
+
+  double mid = (double)get_bucket_start(i) + (double)(get_bucket_width(i) - 1) * 0.5;
+  return std::min(mid * 1.0e-9, get_max());
+}
+
+/**
+ * Adds all of the samples of the other histogram to this one.
+ */
+void PStatHistogram::
+merge(const PStatHistogram &other) {
+  for (int i = 0; i < num_buckets; ++i) {
+    AtomicAdjust::Integer n = AtomicAdjust::get(other._buckets[i]);
+    if (n != 0) {
+      AtomicAdjust::add(_buckets[i], n);
+    }
+  }
+  AtomicAdjust::add(_num_samples, AtomicAdjust::get(other._num_samples));
+
+  update_max(AtomicAdjust::get(other._max_ns));
+}
+
+/**
+ * Removes all of the samples.
+ */
+void PStatHistogram::
+clear() {
+  for (int i = 0; i < num_buckets; ++i) {
+    AtomicAdjust::set(_buckets[i], 0);
+  }
+  AtomicAdjust::set(_num_samples, 0);
+  AtomicAdjust::set(_max_ns, 0);
+}
+
+/**
+ * Writes the number of samples and the 50th and 99th percentile and maximum
+ * times, in milliseconds.
+ */
+void PStatHistogram::
+output(std::ostream &out) const {
+  out << get_num_samples() << " samples, p50 " << get_percentile(0.5) * 1000.0
+      << " ms, p99 " << get_percentile(0.99) * 1000.0
+      << " ms, max " << get_max() * 1000.0 << " ms";
+}
+
+/**
+ * Moves all of the samples of the other histogram into this one, leaving the
+ * other one empty.  Samples that are added to the other histogram at the same
+ * time end up in one histogram or the other, but are not lost, except that a
+ * new maximum may be lost.
+ */
+void PStatHistogram::
+take(PStatHistogram &other) {
+  AtomicAdjust::add(_num_samples, AtomicAdjust::set(other._num_samples, 0));
+  for (int i = 0; i < num_buckets; ++i) {
+    if (AtomicAdjust::get(other._buckets[i]) != 0) {
+      AtomicAdjust::add(_buckets[i], AtomicAdjust::set(other._buckets[i], 0));
+    }
+  }
+
+  update_max(AtomicAdjust::set(other._max_ns, 0));
+}
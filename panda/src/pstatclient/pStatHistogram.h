@@ -0,0 +1,90 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pStatHistogram.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef PSTATHISTOGRAM_H
+#define PSTATHISTOGRAM_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "atomicAdjust.h"
+#include "pnotify.h"
+#include "pbitops.h"
+
+/**
+ * A histogram of elapsed times, as accumulated by PStatClient for the
+ * collectors that have metrics enabled (see PStatClient::enable_metrics()).
+ *
+ * The samples are counted in buckets whose width grows with the magnitude of
+ * the sample, in the manner of an HDR histogram: each power of two is split
+ * into 32 equal buckets, so any percentile is known to within about 3%, from
+ * a nanosecond up to a minute, without storing the samples.  The counters are
+ * atomic, so one thread may add samples while another reads or drains the
+ * histogram.
+ */
+class EXPCL_PANDA_PSTATCLIENT PStatHistogram : public ReferenceCount {
+PUBLISHED:
+  PStatHistogram();
+  PStatHistogram(const PStatHistogram &copy);
+
+  void add_sample(double elapsed);
+
+  INLINE size_t get_num_samples() const;
+  INLINE bool is_empty() const;
+  INLINE double get_max() const;
+  double get_mean() const;
+  double get_percentile(double fraction) const;
+
+  void merge(const PStatHistogram &other);
+  void clear();
+
+  void output(std::ostream &out) const;
+
+  MAKE_PROPERTY(num_samples, get_num_samples);
+  MAKE_PROPERTY(max, get_max);
+  MAKE_PROPERTY(mean, get_mean);
+
+public:
+  PStatHistogram &operator = (const PStatHistogram &copy) = delete;
+
+  INLINE void add_sample_ns(uint64_t ns);
+  void take(PStatHistogram &other);
+
+private:
+  INLINE void update_max(AtomicAdjust::Integer value);
+  INLINE static int get_bucket(uint64_t ns);
+  INLINE static uint64_t get_bucket_start(int bucket);
+  INLINE static uint64_t get_bucket_width(int bucket);
+
+  enum {
+    sub_bucket_bits = 5,
+    sub_bucket_count = 1 << sub_bucket_bits,
+
+    // Enough buckets for 2^36 ns, a little over a minute; anything longer
+    // goes in the last bucket.
+    num_buckets = 32 * sub_bucket_count,
+  };
+
+  AtomicAdjust::Integer _num_samples;
+  AtomicAdjust::Integer _max_ns;
+  AtomicAdjust::Integer _buckets[num_buckets];
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const PStatHistogram &hist) {
+  hist.output(out);
+  return out;
+}
+
+#include "pStatHistogram.I"
+
+#endif
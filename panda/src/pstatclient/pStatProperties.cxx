@@ -220,6 +220,9 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Collision Volumes",                { 1.0, 0.8, 0.5 },  "", 500 },
   { 1, "Collision Tests",                  { 0.5, 0.8, 1.0 },  "", 100 },
   { 1, "Command latency",                  { 0.8, 0.2, 0.0 },  "ms", 10, 1.0 / 1000.0 },
+  { 1, "Net flushes",                      { 0.3, 0.6, 0.9 },  "", 500 },
+  { 1, "Net syscalls per flush",           { 0.9, 0.6, 0.3 },  "", 10 },
+  { 1, "Net bytes per flush",              { 0.6, 0.3, 0.9 },  "KB", 64, 1024 },
   { 0, nullptr }
 };
 
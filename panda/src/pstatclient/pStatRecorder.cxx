@@ -0,0 +1,291 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pStatRecorder.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pStatRecorder.h"
+
+// This file only defines anything if DO_PSTATS is defined.
+#ifdef DO_PSTATS
+
+#include "pStatClientControlMessage.h"
+#include "config_pstatclient.h"
+#include "mutexHolder.h"
+
+using std::string;
+
+const string PStatRecorder::_file_header = string("pstat\0\n\r", 8);
+
+/**
+ *
+ */
+PStatRecorder::
+PStatRecorder() :
+  _cvar(_lock),
+  _stop(false),
+  _is_open(false),
+  _rings(nullptr),
+  _rings_size(0),
+  _ring_size(1),
+  _num_dropped(0)
+{
+}
+
+/**
+ *
+ */
+PStatRecorder::
+~PStatRecorder() {
+  close();
+}
+
+/**
+ * Opens the indicated file for writing and starts the writer thread.  Returns
+ * true on success, false on failure.
+ */
+bool PStatRecorder::
+open(const Filename &filename) {
+  close();
+
+  Filename fname = Filename::binary_filename(filename);
+  if (!_dout.open(fname) || !_dout.write_header(_file_header)) {
+    pstats_cat.error()
+      << "Unable to open " << fname << " for recording.\n";
+    _dout.close();
+    return false;
+  }
+
+  _ring_size = (size_t)std::max((int)pstats_record_ring_size, 2);
+  _stop = false;
+  AtomicAdjust::set(_num_dropped, 0);
+
+  _is_open = true;
+
+  if (Thread::is_true_threads()) {
+    _thread = new WriterThread(this);
+    if (!_thread->start(TP_low, true)) {
+      _thread = nullptr;
+    }
+  }
+  // Without a writer thread, the frames are written whenever a ring fills
+  // up, and by close().
+  return true;
+}
+
+/**
+ * Stops the writer thread, writes out whatever frames are still queued, and
+ * closes the file.
+ */
+void PStatRecorder::
+close() {
+  if (!_is_open) {
+    return;
+  }
+
+  if (_thread != nullptr) {
+    {
+      MutexHolder holder(_lock);
+      _stop = true;
+      _cvar.notify_all();
+    }
+    _thread->join();
+    _thread = nullptr;
+  }
+  _is_open = false;
+
+  drain();
+  _dout.close();
+
+  size_t num_dropped = get_num_dropped();
+  if (num_dropped != 0) {
+    pstats_cat.warning()
+      << num_dropped << " frames were dropped from the recording; consider "
+      << "increasing pstats-record-ring-size.\n";
+  }
+
+  Ring **rings = (Ring **)AtomicAdjust::get_ptr(_rings);
+  for (AtomicAdjust::Integer i = 0; i < _rings_size; ++i) {
+    delete rings[i];
+  }
+  delete[] rings;
+  for (Ring **old_rings : _old_rings) {
+    delete[] old_rings;
+  }
+  _old_rings.clear();
+  AtomicAdjust::set_ptr(_rings, nullptr);
+  AtomicAdjust::set(_rings_size, 0);
+}
+
+/**
+ * Queues up a control message (for instance, the definition of new
+ * collectors) to be written to the file.
+ */
+void PStatRecorder::
+record_control(const Datagram &datagram) {
+  MutexHolder holder(_lock);
+  _control.push_back(datagram);
+}
+
+/**
+ * Queues up the data for one frame of the indicated thread.  Only one thread
+ * at a time may record frames for any given thread index, which is already
+ * the case for PStatThread::new_frame().
+ */
+void PStatRecorder::
+record_frame(int thread_index, int frame_number,
+             const PStatFrameData &frame_data) {
+  nassertv(thread_index >= 0);
+
+  size_t num_events = frame_data.get_num_events();
+  size_t num_levels = frame_data.get_num_levels();
+  if (num_events >= 65536 || num_levels >= 65536) {
+    AtomicAdjust::inc(_num_dropped);
+    return;
+  }
+
+  // The times are stored relative to the start of the frame, since a float32
+  // would lose precision after a few minutes of absolute time.
+  double start = frame_data.is_time_empty() ? 0.0 : frame_data.get_start();
+
+  Datagram datagram;
+  datagram.add_uint8(PStatClientControlMessage::T_datagram);
+  datagram.add_uint16(thread_index);
+  datagram.add_uint32(frame_number);
+  datagram.add_float64(start);
+
+  datagram.add_uint16(num_events);
+  for (size_t i = 0; i < num_events; ++i) {
+    int index = frame_data.get_time_collector(i);
+    datagram.add_uint16(frame_data.is_start(i) ? index : (index | 0x8000));
+    datagram.add_float32(frame_data.get_time(i) - start);
+  }
+  datagram.add_uint16(num_levels);
+  for (size_t i = 0; i < num_levels; ++i) {
+    datagram.add_uint16(frame_data.get_level_collector(i));
+    datagram.add_float32(frame_data.get_level(i));
+  }
+
+  Ring *ring = get_ring(thread_index);
+  if (ring == nullptr) {
+    ring = make_ring(thread_index);
+  }
+  if (!ring->push(std::move(datagram))) {
+    if (_thread == nullptr) {
+      // There's no writer thread, so write the frames out now.
+      drain();
+      if (ring->push(std::move(datagram))) {
+        return;
+      }
+    }
+    AtomicAdjust::inc(_num_dropped);
+  }
+}
+
+/**
+ * Creates the ring for the indicated thread, growing the array if necessary.
+ */
+PStatRecorder::Ring *PStatRecorder::
+make_ring(int thread_index) {
+  MutexHolder holder(_lock);
+
+  AtomicAdjust::Integer rings_size = AtomicAdjust::get(_rings_size);
+  Ring **rings = (Ring **)AtomicAdjust::get_ptr(_rings);
+  if (thread_index >= rings_size) {
+    AtomicAdjust::Integer new_rings_size = std::max(rings_size * 2, (AtomicAdjust::Integer)16);
+    while (thread_index >= new_rings_size) {
+      new_rings_size *= 2;
+    }
+    Ring **new_rings = new Ring *[new_rings_size];
+    std::fill(new_rings, new_rings + new_rings_size, nullptr);
+    if (rings != nullptr) {
+      std::copy(rings, rings + rings_size, new_rings);
+      _old_rings.push_back(rings);
+    }
+    AtomicAdjust::set_ptr(_rings, new_rings);
+    AtomicAdjust::set(_rings_size, new_rings_size);
+    rings = new_rings;
+  }
+
+  if (rings[thread_index] == nullptr) {
+    rings[thread_index] = new Ring(_ring_size);
+  }
+  return rings[thread_index];
+}
+
+/**
+ * Writes everything that is currently queued to the file.  Control messages
+ * are written first, since the frames may refer to the collectors they
+ * define.
+ */
+void PStatRecorder::
+drain() {
+  pdeque<Datagram> control;
+  Ring **rings;
+  AtomicAdjust::Integer rings_size;
+  {
+    MutexHolder holder(_lock);
+    control.swap(_control);
+    rings = (Ring **)AtomicAdjust::get_ptr(_rings);
+    rings_size = AtomicAdjust::get(_rings_size);
+  }
+
+  for (const Datagram &datagram : control) {
+    _dout.put_datagram(datagram);
+  }
+
+  Datagram datagram;
+  for (AtomicAdjust::Integer i = 0; i < rings_size; ++i) {
+    Ring *ring = rings[i];
+    if (ring != nullptr) {
+      while (ring->pop(datagram)) {
+        _dout.put_datagram(datagram);
+      }
+    }
+  }
+  _dout.flush();
+}
+
+/**
+ * The body of the writer thread.
+ */
+void PStatRecorder::
+thread_run() {
+  MutexHolder holder(_lock);
+  while (!_stop) {
+    _cvar.wait(0.1);
+    if (_stop) {
+      break;
+    }
+    _lock.release();
+    drain();
+    _lock.acquire();
+  }
+}
+
+/**
+ *
+ */
+PStatRecorder::WriterThread::
+WriterThread(PStatRecorder *recorder) :
+  Thread("PStatRecorder", "PStatRecorder"),
+  _recorder(recorder)
+{
+}
+
+/**
+ *
+ */
+void PStatRecorder::WriterThread::
+thread_main() {
+  _recorder->thread_run();
+}
+
+#endif  // DO_PSTATS
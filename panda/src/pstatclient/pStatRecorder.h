@@ -0,0 +1,116 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pStatRecorder.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef PSTATRECORDER_H
+#define PSTATRECORDER_H
+
+#include "pandabase.h"
+
+// This class doesn't exist at all unless DO_PSTATS is defined.
+#ifdef DO_PSTATS
+
+#include "pStatFrameData.h"
+#include "datagram.h"
+#include "datagramOutputFile.h"
+#include "atomicRingQueue.h"
+#include "atomicAdjust.h"
+#include "thread.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pdeque.h"
+#include "pvector.h"
+
+/**
+ * Writes the frame data collected by a PStatClient to a file, instead of
+ * sending it to a PStatServer, so that it can be examined after the fact
+ * with pstats-convert.  This is created by PStatClientImpl when
+ * PStatClient::record() is called.
+ *
+ * Each PStats thread hands its frames to a lock-free ring of its own; a
+ * writer thread drains the rings into the file, so the recording threads
+ * never wait for the disk.  If the writer falls behind and a ring fills up,
+ * frames for that thread are dropped.
+ *
+ * The file is a DatagramOutputFile with the header "pstat\0\n\r", followed by
+ * the same control messages that would be sent to the server, and a
+ * T_datagram record for each frame: uint16 thread index, uint32 frame
+ * number, float64 start time, and the PStatFrameData with its times measured
+ * from the start time.
+ *
+ * This class doesn't exist at all unless DO_PSTATS is defined.
+ */
+class EXPCL_PANDA_PSTATCLIENT PStatRecorder {
+public:
+  PStatRecorder();
+  PStatRecorder(const PStatRecorder &copy) = delete;
+  ~PStatRecorder();
+
+  PStatRecorder &operator = (const PStatRecorder &copy) = delete;
+
+  bool open(const Filename &filename);
+  void close();
+  INLINE bool is_open() const;
+
+  void record_control(const Datagram &datagram);
+  void record_frame(int thread_index, int frame_number,
+                    const PStatFrameData &frame_data);
+
+  INLINE size_t get_num_dropped() const;
+
+  static const std::string _file_header;
+
+private:
+  typedef AtomicRingQueue<Datagram> Ring;
+
+  INLINE Ring *get_ring(int thread_index) const;
+  Ring *make_ring(int thread_index);
+  void drain();
+  void thread_run();
+
+  class WriterThread : public Thread {
+  public:
+    WriterThread(PStatRecorder *recorder);
+    virtual void thread_main();
+
+    PStatRecorder *_recorder;
+  };
+
+  DatagramOutputFile _dout;
+  PT(WriterThread) _thread;
+
+  // This protects _control, the growing of _rings, and _stop.
+  Mutex _lock;
+  ConditionVar _cvar;
+  pdeque<Datagram> _control;
+  bool _stop;
+  bool _is_open;
+
+  // Ring *_rings[_rings_size], indexed by PStats thread index.  As with the
+  // arrays in PStatClient, a ring is looked up without the lock, so the array
+  // is replaced rather than reallocated when it grows; the old arrays are
+  // kept until close().
+  AtomicAdjust::Pointer _rings;
+  AtomicAdjust::Integer _rings_size;
+  pvector<Ring **> _old_rings;
+  size_t _ring_size;
+
+  AtomicAdjust::Integer _num_dropped;
+
+  friend class WriterThread;
+};
+
+#include "pStatRecorder.I"
+
+#endif  // DO_PSTATS
+
+#endif
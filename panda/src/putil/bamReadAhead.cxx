@@ -0,0 +1,292 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file bamReadAhead.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "bamReadAhead.h"
+#include "bamEnums.h"
+#include "datagramIterator.h"
+#include "mutexHolder.h"
+#include "config_putil.h"
+
+/**
+ * Starts reading datagrams from the indicated source, keeping up to max_bytes
+ * of datagram data queued at a time.  The source must remain valid for the
+ * lifetime of the BamReadAhead, and must not be read by anything else.
+ */
+BamReadAhead::
+BamReadAhead(DatagramGenerator *source, size_t max_bytes) :
+  _source(source),
+  _cvar(_lock),
+  _max_bytes(max_bytes),
+  _queued_bytes(0),
+  _done(false),
+  _eof(false),
+  _error(false),
+  _stop(false),
+  _file_pos(0)
+{
+  nassertv(_source != nullptr);
+
+  if (Thread::is_true_threads()) {
+    _thread = new ReaderThread(this);
+    if (!_thread->start(TP_normal, true)) {
+      _thread = nullptr;
+    }
+  }
+
+  if (_thread == nullptr && bam_cat.is_debug()) {
+    bam_cat.debug()
+      << "Unable to start bam read-ahead thread; reading synchronously.\n";
+  }
+}
+
+/**
+ * Stops the reader thread, if it is still running.
+ */
+BamReadAhead::
+~BamReadAhead() {
+  if (_thread != nullptr) {
+    {
+      MutexHolder holder(_lock);
+      _stop = true;
+      _cvar.notify_all();
+    }
+    _thread->join();
+    _thread = nullptr;
+  }
+}
+
+/**
+ * Returns the next datagram read from the source.  Returns false at the end of
+ * the stream or if there was an error.
+ */
+bool BamReadAhead::
+get_datagram(Datagram &data) {
+  if (_thread == nullptr) {
+    return _source->get_datagram(data);
+  }
+
+  Record record;
+  if (!pop_record(record)) {
+    return false;
+  }
+  if (record._saved) {
+    // The BamReader should have asked for this one with save_datagram().
+    bam_cat.error()
+      << "Bam stream out of sync with read-ahead thread.\n";
+    return false;
+  }
+  data = std::move(record._datagram);
+  return true;
+}
+
+/**
+ * Returns the location of the auxiliary file data record that the reader
+ * thread saved from the source.
+ */
+bool BamReadAhead::
+save_datagram(SubfileInfo &info) {
+  if (_thread == nullptr) {
+    return _source->save_datagram(info);
+  }
+
+  Record record;
+  if (!pop_record(record)) {
+    return false;
+  }
+  if (!record._saved) {
+    bam_cat.error()
+      << "Bam stream out of sync with read-ahead thread.\n";
+    return false;
+  }
+  info = record._info;
+  return true;
+}
+
+/**
+ * Returns true if the source has reached the end of the file, and all of the
+ * datagrams read before that point have been returned.
+ */
+bool BamReadAhead::
+is_eof() {
+  if (_thread == nullptr) {
+    return _source->is_eof();
+  }
+  MutexHolder holder(_lock);
+  return _done && _records.empty() && _eof;
+}
+
+/**
+ * Returns true if the source has reached an error condition, and all of the
+ * datagrams read before that point have been returned.
+ */
+bool BamReadAhead::
+is_error() {
+  if (_thread == nullptr) {
+    return _source->is_error();
+  }
+  MutexHolder holder(_lock);
+  return _done && _records.empty() && _error;
+}
+
+/**
+ * Returns the filename of the source.
+ */
+const Filename &BamReadAhead::
+get_filename() {
+  return _source->get_filename();
+}
+
+/**
+ * Returns the timestamp of the source.
+ */
+time_t BamReadAhead::
+get_timestamp() const {
+  return _source->get_timestamp();
+}
+
+/**
+ * Returns the FileReference of the source.
+ */
+const FileReference *BamReadAhead::
+get_file() {
+  return _source->get_file();
+}
+
+/**
+ * Returns the VirtualFile of the source.
+ */
+VirtualFile *BamReadAhead::
+get_vfile() {
+  return _source->get_vfile();
+}
+
+/**
+ * Returns the position in the source just past the datagram most recently
+ * returned, as opposed to the position the reader thread has reached.
+ */
+std::streampos BamReadAhead::
+get_file_pos() {
+  if (_thread == nullptr) {
+    return _source->get_file_pos();
+  }
+  return _file_pos;
+}
+
+/**
+ * Waits for the next record from the reader thread and removes it from the
+ * queue.  Returns false if the reader thread has stopped and there are no
+ * more records.
+ */
+bool BamReadAhead::
+pop_record(Record &record) {
+  MutexHolder holder(_lock);
+  while (_records.empty()) {
+    if (_done) {
+      return false;
+    }
+    _cvar.wait();
+  }
+
+  record = std::move(_records.front());
+  _records.pop_front();
+  _queued_bytes -= record._datagram.get_length();
+  _cvar.notify_all();
+
+  _file_pos = record._file_pos;
+  return true;
+}
+
+/**
+ * The body of the reader thread.  Reads datagrams from the source until the
+ * end of the stream, an error, or the BamReadAhead is destructed.
+ */
+void BamReadAhead::
+thread_run() {
+  // The first datagram is the bam header, which tells us whether the object
+  // records begin with a BamObjectCode.
+  bool is_header = true;
+  bool has_object_codes = false;
+  bool save_next = false;
+
+  while (true) {
+    Record record;
+    record._saved = save_next;
+
+    bool success;
+    if (save_next) {
+      success = _source->save_datagram(record._info);
+      save_next = false;
+
+    } else {
+      success = _source->get_datagram(record._datagram);
+      if (success) {
+        size_t length = record._datagram.get_length();
+        const unsigned char *data = (const unsigned char *)record._datagram.get_data();
+
+        if (is_header) {
+          is_header = false;
+          if (length >= 4) {
+            DatagramIterator scan(record._datagram);
+            scan.get_uint16();
+            has_object_codes = (scan.get_uint16() >= 21);
+          }
+
+        } else if (has_object_codes && length > 0 &&
+                   data[0] == BamEnums::BOC_file_data) {
+          // The next datagram holds the file data itself, which the BamReader
+          // will ask for with save_datagram().
+          save_next = true;
+        }
+      }
+    }
+    record._file_pos = _source->get_file_pos();
+
+    MutexHolder holder(_lock);
+    while (success && !_stop && !_records.empty() && _queued_bytes >= _max_bytes) {
+      _cvar.wait();
+    }
+    if (_stop) {
+      return;
+    }
+
+    if (!success) {
+      _eof = _source->is_eof();
+      _error = _source->is_error();
+      _done = true;
+      _cvar.notify_all();
+      return;
+    }
+
+    _queued_bytes += record._datagram.get_length();
+    _records.push_back(std::move(record));
+    _cvar.notify_all();
+  }
+}
+
+/**
+ *
+ */
+BamReadAhead::ReaderThread::
+ReaderThread(BamReadAhead *owner) :
+  Thread("BamReadAhead", "BamReadAhead"),
+  _owner(owner)
+{
+}
+
+/**
+ *
+ */
+void BamReadAhead::ReaderThread::
+thread_main() {
+  _owner->thread_run();
+}
@@ -0,0 +1,98 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file bamReadAhead.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef BAMREADAHEAD_H
+#define BAMREADAHEAD_H
+
+#include "pandabase.h"
+
+#include "datagramGenerator.h"
+#include "datagram.h"
+#include "subfileInfo.h"
+#include "thread.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pdeque.h"
+
+/**
+ * A DatagramGenerator that reads the datagrams of a bam stream from another
+ * generator on a thread of its own, keeping up to a certain number of bytes
+ * queued ahead of the BamReader.  This lets the file reads (and any
+ * decompression done by the stream) happen while the objects read so far are
+ * being constructed.
+ *
+ * The source must be positioned at the bam header datagram, that is, just
+ * after the "pbj" magic number.  The auxiliary file data records that follow
+ * a BOC_file_data code are saved with save_datagram() as they are reached, so
+ * that they are handed to the BamReader in the same order as before.
+ *
+ * If threading is not available, the datagrams are simply read from the
+ * source as they are requested.
+ */
+class EXPCL_PANDA_PUTIL BamReadAhead : public DatagramGenerator {
+public:
+  explicit BamReadAhead(DatagramGenerator *source, size_t max_bytes);
+  virtual ~BamReadAhead();
+
+  virtual bool get_datagram(Datagram &data);
+  virtual bool save_datagram(SubfileInfo &info);
+  virtual bool is_eof();
+  virtual bool is_error();
+
+  virtual const Filename &get_filename();
+  virtual time_t get_timestamp() const;
+  virtual const FileReference *get_file();
+  virtual VirtualFile *get_vfile();
+  virtual std::streampos get_file_pos();
+
+private:
+  class Record {
+  public:
+    Datagram _datagram;
+    SubfileInfo _info;
+    bool _saved;
+    std::streampos _file_pos;
+  };
+  typedef pdeque<Record> Records;
+
+  bool pop_record(Record &record);
+  void thread_run();
+
+  class ReaderThread : public Thread {
+  public:
+    ReaderThread(BamReadAhead *owner);
+    virtual void thread_main();
+
+    BamReadAhead *_owner;
+  };
+
+  DatagramGenerator *_source;
+  PT(ReaderThread) _thread;
+
+  // The following members are protected by _lock.  _cvar is signalled
+  // whenever a record is added or removed, or the reader thread finishes.
+  Mutex _lock;
+  ConditionVar _cvar;
+  Records _records;
+  size_t _max_bytes;
+  size_t _queued_bytes;
+  bool _done;
+  bool _eof;
+  bool _error;
+  bool _stop;
+
+  // This one is only touched by the thread calling get_datagram().
+  std::streampos _file_pos;
+};
+
+#endif
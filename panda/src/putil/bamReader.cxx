@@ -29,6 +29,17 @@ BamReader *const BamReader::Null = nullptr;
 WritableFactory *const BamReader::NullFactory = nullptr;
 
 BamReader::NewTypes BamReader::_new_types;
+BamReader::DirectReadTypes BamReader::_direct_read_types;
+
+// The number of bytes of each object record that is read up front when the
+// record's type has been registered with register_direct_read().  The rest is
+// left in the source for the object to read with read_bytes().
+static const size_t direct_read_head_size = 4096;
+
+// If less than this many bytes of the head remain after the type handle has
+// been read, the whole record is read anyway, so that the object can be sure
+// to find its leading fields in the datagram.
+static const size_t direct_read_min_head = 256;
 
 const int BamReader::_cur_major = _bam_major_ver;
 const int BamReader::_cur_minor = _bam_minor_ver;
@@ -42,6 +53,9 @@ BamReader(DatagramGenerator *source)
   : _source(source)
 {
   _needs_init = true;
+  _tail_size = 0;
+  _decode_runner = nullptr;
+  _decode_runner_data = nullptr;
   _num_extra_objects = 0;
   _nesting_level = 0;
   _now_creating = _created_objs.end();
@@ -57,6 +71,7 @@ BamReader(DatagramGenerator *source)
  */
 BamReader::
 ~BamReader() {
+  flush_decodes();
   nassertv(_num_extra_objects == 0);
   nassertv(_nesting_level == 0);
 }
@@ -269,6 +284,10 @@ read_object(TypedWritable *&ptr, ReferenceCount *&ref_ptr) {
     p_read_object();
   }
 
+  // Finish any work the objects we read have put off, before anyone gets to
+  // see them.
+  flush_decodes();
+
   // Now look up the pointer of the object we read first.  It should be
   // available now.
   if (object_id == 0) {
@@ -326,6 +345,8 @@ resolve() {
   bool all_completed;
   bool any_completed_this_pass;
 
+  flush_decodes();
+
   do {
     if (bam_cat.is_spam()) {
       bam_cat.spam()
@@ -586,6 +607,56 @@ read_handle(DatagramIterator &scan) {
   return type;
 }
 
+/**
+ * Returns the number of bytes of the current object's record that remain to
+ * be read, including any bytes that have not yet been read from the source.
+ * Objects of a type registered with register_direct_read() should use this
+ * instead of scan.get_remaining_size().
+ */
+size_t BamReader::
+get_remaining_size(const DatagramIterator &scan) const {
+  return scan.get_remaining_size() + _tail_size;
+}
+
+/**
+ * Reads the next size bytes of the current object's record into the
+ * indicated buffer.  Whatever part of it is not already in the datagram is
+ * read straight from the source, without being copied into the datagram
+ * first.  Returns true on success, false on failure.
+ */
+bool BamReader::
+read_bytes(DatagramIterator &scan, unsigned char *into, size_t size) {
+  size_t from_scan = std::min(size, scan.get_remaining_size());
+  scan.extract_bytes(into, from_scan);
+  size -= from_scan;
+  if (size == 0) {
+    return true;
+  }
+
+  nassertr(size <= _tail_size, false);
+  if (!_source->read_datagram_tail(into + from_scan, size)) {
+    bam_cat.error()
+      << "Unexpected end of bam stream while reading " << size << " bytes\n";
+    return false;
+  }
+  _tail_size -= size;
+  return true;
+}
+
+/**
+ * Indicates that objects of the indicated type read a large payload at the
+ * end of their record with read_bytes().  The records of such objects are not
+ * read into memory in full before the object is created, so that the payload
+ * can be read directly into its final buffer.  The object must read all of its
+ * other fields first, and they must be small.
+ *
+ * This should be called at static init time, along with register_factory().
+ */
+void BamReader::
+register_direct_read(TypeHandle type) {
+  _direct_read_types.insert(type);
+}
+
 /**
  * The interface for reading a pointer to another object from a Bam file.
  * Objects reading themselves from a Bam file should call this when they
@@ -685,6 +756,39 @@ read_file_data(SubfileInfo &info) {
   _file_data_records.pop_front();
 }
 
+/**
+ * Queues the indicated job, which finishes reading the current object, to be
+ * run before read_object() returns.  The job may not use the BamReader or
+ * any object other than the one it belongs to.  If a decode runner has been
+ * set, the jobs queued while reading an object and its nested objects are
+ * run in parallel; otherwise, the job is run immediately.
+ *
+ * The BamReader takes ownership of the job, and deletes it when it has run.
+ */
+void BamReader::
+defer_decode(DeferredDecode *job) {
+  if (_decode_runner == nullptr) {
+    job->decode();
+    delete job;
+  } else {
+    _deferred_decodes.push_back(job);
+  }
+}
+
+/**
+ * Sets the function that defer_decode() jobs are handed to.  It is called
+ * with the number of jobs, and should call the indicated function once for
+ * each job index, in any order and on any threads, before it returns.  This
+ * is normally set up by BamFile; pass NULL to run the jobs as they are
+ * queued.
+ */
+void BamReader::
+set_decode_runner(DecodeRunner *runner, void *runner_data) {
+  flush_decodes();
+  _decode_runner = runner;
+  _decode_runner_data = runner_data;
+}
+
 /**
  * Reads in the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
@@ -1045,6 +1149,64 @@ read_pta_id(DatagramIterator &scan) {
   return pta_id;
 }
 
+/**
+ * Runs all of the work queued by defer_decode(), spread over the threads of
+ * the decode runner if there is one, and waits for it to finish.
+ */
+void BamReader::
+flush_decodes() {
+  if (_deferred_decodes.empty()) {
+    return;
+  }
+
+  DeferredDecodes jobs;
+  jobs.swap(_deferred_decodes);
+
+  if (_decode_runner != nullptr && jobs.size() > 1) {
+    (*_decode_runner)(jobs.size(), &run_decode, jobs.data(), _decode_runner_data);
+  } else {
+    for (DeferredDecode *job : jobs) {
+      job->decode();
+    }
+  }
+
+  for (DeferredDecode *job : jobs) {
+    delete job;
+  }
+}
+
+/**
+ * Runs the nth job collected by flush_decodes(), on whichever thread the
+ * decode runner chooses.
+ */
+void BamReader::
+run_decode(size_t n, void *user_data) {
+  ((DeferredDecode **)user_data)[n]->decode();
+}
+
+/**
+ * Reads the part of the current object's record that has not yet been read
+ * from the source, and appends it to the datagram.  Returns true on success,
+ * false on failure.
+ */
+bool BamReader::
+read_datagram_tail(Datagram &datagram) {
+  if (_tail_size == 0) {
+    return true;
+  }
+
+  PTA_uchar buffer = datagram.modify_array();
+  size_t orig_size = buffer.size();
+  buffer.resize(orig_size + _tail_size);
+  if (!_source->read_datagram_tail(&buffer.p()[orig_size], _tail_size)) {
+    bam_cat.error()
+      << "Found truncated datagram in bam stream\n";
+    return false;
+  }
+  _tail_size = 0;
+  return true;
+}
+
 /**
  * The private implementation of read_object(); this reads an object from the
  * file and returns its object ID.
@@ -1053,8 +1215,20 @@ int BamReader::
 p_read_object() {
   Datagram dg;
 
-  // First, read a datagram for the object.
-  if (!get_datagram(dg)) {
+  // First, read a datagram for the object.  If there are types that read
+  // their payload straight from the source, we only read the beginning of
+  // the datagram for now, and read the rest once we know the type.
+  nassertr(_source != nullptr, 0);
+  _tail_size = 0;
+  bool got_datagram = false;
+  if (!_source->is_error()) {
+    if (_direct_read_types.empty()) {
+      got_datagram = _source->get_datagram(dg);
+    } else {
+      got_datagram = _source->get_datagram_head(dg, direct_read_head_size, _tail_size);
+    }
+  }
+  if (!got_datagram) {
     // When we run out of datagrams, we're at the end of the file.
     if (bam_cat.is_debug()) {
       bam_cat.debug()
@@ -1062,6 +1236,7 @@ p_read_object() {
     }
     return 0;
   }
+  dg.set_stdfloat_double(_file_stdfloat_double);
 
   // Now extract the object definition from the datagram.
   DatagramIterator scan(dg);
@@ -1088,6 +1263,10 @@ p_read_object() {
     // The BOC_remove code is a special case; it begins a record that simply
     // lists all of the object ID's that are no longer important to the file
     // and may be released.
+    if (!read_datagram_tail(dg)) {
+      return 0;
+    }
+    flush_decodes();
     free_object_ids(scan);
 
     // Now that we've freed all of the object id's indicate, read the next
@@ -1123,6 +1302,15 @@ p_read_object() {
 
   TypeHandle type = read_handle(scan);
 
+  if (_tail_size != 0 &&
+      (_direct_read_types.find(type) == _direct_read_types.end() ||
+       scan.get_remaining_size() < direct_read_min_head)) {
+    // This object expects to find its whole record in the datagram.
+    if (!read_datagram_tail(dg)) {
+      return 0;
+    }
+  }
+
   int object_id = read_object_id(scan);
 
   if (scan.get_current_index() > dg.get_length()) {
@@ -1175,6 +1363,7 @@ p_read_object() {
       // read_pointer() or register_change_this() we'll match it up properly.
       // This might recursively call back into this p_read_object(), so be
       // sure to save and restore the original value of _now_creating.
+      flush_decodes();
       CreatedObjs::iterator was_creating = _now_creating;
       _now_creating = oi;
       created_obj._ptr->fillin(scan, this);
@@ -1286,6 +1475,14 @@ p_read_object() {
       }
     }
 
+    if (_tail_size != 0) {
+      bam_cat.warning()
+        << "Skipping " << _tail_size << " unread bytes at the end of "
+        << "datagram containing type " << type << "\n";
+      _source->skip_datagram_tail(_tail_size);
+      _tail_size = 0;
+    }
+
     // Sanity check that we read the expected number of bytes.
     if (scan.get_current_index() > dg.get_length()) {
       bam_cat.error()
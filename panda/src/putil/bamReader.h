@@ -31,6 +31,7 @@
 #include "pset.h"
 #include "pmap.h"
 #include "pdeque.h"
+#include "pvector.h"
 #include "dcast.h"
 #include "pipelineCyclerBase.h"
 #include "referenceCount.h"
@@ -113,6 +114,11 @@ public:
   static BamReader *const Null;
   static WritableFactory *const NullFactory;
 
+  class DeferredDecode;
+  typedef void DecodeFunction(size_t n, void *user_data);
+  typedef void DecodeRunner(size_t count, DecodeFunction *function,
+                            void *user_data, void *runner_data);
+
 PUBLISHED:
   // The primary interface for a caller.
   explicit BamReader(DatagramGenerator *source = nullptr);
@@ -168,6 +174,9 @@ public:
 
   void read_file_data(SubfileInfo &info);
 
+  void defer_decode(DeferredDecode *job);
+  void set_decode_runner(DecodeRunner *runner, void *runner_data);
+
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler);
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler,
                   void *extra_data);
@@ -192,6 +201,9 @@ public:
 
   TypeHandle read_handle(DatagramIterator &scan);
 
+  size_t get_remaining_size(const DatagramIterator &scan) const;
+  bool read_bytes(DatagramIterator &scan, unsigned char *into, size_t size);
+
   INLINE const FileReference *get_file();
   INLINE VirtualFile *get_vfile();
   INLINE std::streampos get_file_pos();
@@ -200,6 +212,7 @@ public:
   INLINE static void register_factory(TypeHandle type, WritableFactory::CreateFunc *func,
                                       void *user_data = nullptr);
   INLINE static WritableFactory *get_factory();
+  static void register_direct_read(TypeHandle type);
 
 PUBLISHED:
   EXTENSION(static void register_factory(TypeHandle handle, PyObject *func));
@@ -218,8 +231,11 @@ private:
   bool resolve_cycler_pointers(PipelineCyclerBase *cycler, const vector_int &pointer_ids,
                                bool require_fully_complete);
   void finalize();
+  void flush_decodes();
+  static void run_decode(size_t n, void *user_data);
 
   INLINE bool get_datagram(Datagram &datagram);
+  bool read_datagram_tail(Datagram &datagram);
 
 public:
   // Inherit from this class to piggyback additional temporary data on the
@@ -231,12 +247,31 @@ public:
     virtual ~AuxData() = default;
   };
 
+  // Inherit from this class to do the part of reading an object that needs
+  // nothing more from the bamReader at a later time, possibly on another
+  // thread.  See defer_decode().
+  class DeferredDecode {
+  public:
+    virtual ~DeferredDecode() = default;
+    virtual void decode()=0;
+  };
+
 private:
   static WritableFactory *_factory;
 
   DatagramGenerator *_source;
   bool _needs_init;
 
+  // The number of bytes at the end of the current object's datagram that
+  // have not yet been read from the source.  See register_direct_read().
+  size_t _tail_size;
+
+  // The work queued by defer_decode(), and the function that runs it.
+  typedef pvector<DeferredDecode *> DeferredDecodes;
+  DeferredDecodes _deferred_decodes;
+  DecodeRunner *_decode_runner;
+  void *_decode_runner_data;
+
   bool _long_object_id;
   bool _long_pta_id;
 
@@ -327,6 +362,11 @@ private:
   typedef phash_set<TypeHandle> NewTypes;
   static NewTypes _new_types;
 
+  // The types whose records are not read into memory in full before the
+  // object is created; see register_direct_read().
+  typedef phash_set<TypeHandle> DirectReadTypes;
+  static DirectReadTypes _direct_read_types;
+
   // This is used in support of set_aux_data() and get_aux_data().
   typedef pmap<std::string, PT(AuxData)> AuxDataNames;
   typedef phash_map<TypedWritable *, AuxDataNames, pointer_hash> AuxDataTable;
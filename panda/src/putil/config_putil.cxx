@@ -89,6 +89,24 @@ ConfigVariableEnum<BamEnums::BamTextureMode> bam_texture_mode
  PRC_DESC("Set this to specify how textures should be written into Bam files."
           "See the panda source or documentation for available options."));
 
+ConfigVariableInt bam_read_ahead_size
+("bam-read-ahead-size", 0,
+ PRC_DESC("The number of bytes of datagrams that a BamFile may read ahead of "
+          "the objects being constructed from them, on a thread of its own. "
+          "This overlaps the file reads and decompression with the work of "
+          "building the objects.  A size of 1 MB or so is usually enough.  "
+          "If this is 0, the datagrams are read on the loading thread as "
+          "they are needed.  It has no effect unless Panda is compiled with "
+          "true threads."));
+
+ConfigVariableInt bam_decode_threads
+("bam-decode-threads", 0,
+ PRC_DESC("Set this nonzero to let a BamFile put off the expensive part of "
+          "decoding some objects, such as decompressing animation channels, "
+          "until the whole of the object being read has been read, and then "
+          "do it with the help of this many extra threads.  The default, 0, "
+          "decodes each object as soon as it is read."));
+
 ConfigureFn(config_putil) {
   init_libputil();
 }
@@ -91,6 +91,7 @@ close() {
 
   _read_first_datagram = false;
   _error = false;
+  _tail_size = 0;
 }
 
 /**
@@ -123,8 +124,26 @@ read_header(std::string &header, size_t num_bytes) {
  */
 bool DatagramInputFile::
 get_datagram(Datagram &data) {
+  size_t tail_size;
+  return get_datagram_head(data, (size_t)-1, tail_size);
+}
+
+/**
+ * Reads at most the first head_size bytes of the next datagram from the file,
+ * and stores in tail_size the number of bytes that remain to be read with
+ * read_datagram_tail() or skip_datagram_tail().  Any unread tail of the
+ * previous datagram is skipped first.  Returns true on success, false if
+ * there is an error or end of file.
+ */
+bool DatagramInputFile::
+get_datagram_head(Datagram &data, size_t head_size, size_t &tail_size) {
   nassertr(_in != nullptr, false);
   _read_first_datagram = true;
+  tail_size = 0;
+
+  if (_tail_size != 0 && !skip_datagram_tail(_tail_size)) {
+    return false;
+  }
 
   // First, get the size of the upcoming datagram.
   StreamReader reader(_in, false);
@@ -172,6 +191,13 @@ get_datagram(Datagram &data) {
     }
   }
 
+  if (num_bytes > head_size) {
+    // The caller will read the rest of the datagram itself.
+    tail_size = num_bytes - head_size;
+    _tail_size = tail_size;
+    num_bytes = head_size;
+  }
+
   // Now, read the datagram itself. We construct an empty datagram, use
   // pad_bytes to make it big enough, and read *directly* into the datagram's
   // internal buffer. Doing this saves us a copy operation.
@@ -210,6 +236,47 @@ get_datagram(Datagram &data) {
   return true;
 }
 
+/**
+ * Reads the next size bytes of the tail of the datagram most recently
+ * returned by get_datagram_head() directly into the indicated buffer.
+ * Returns true on success, false on failure.
+ */
+bool DatagramInputFile::
+read_datagram_tail(unsigned char *into, size_t size) {
+  nassertr(_in != nullptr, false);
+  nassertr(size <= _tail_size, false);
+
+  _in->read((char *)into, (streamsize)size);
+  if (_in->fail()) {
+    _error = true;
+    return false;
+  }
+
+  _tail_size -= size;
+  Thread::consider_yield();
+  return true;
+}
+
+/**
+ * Discards the next size bytes of the tail of the datagram most recently
+ * returned by get_datagram_head().  Returns true on success, false on
+ * failure.
+ */
+bool DatagramInputFile::
+skip_datagram_tail(size_t size) {
+  nassertr(_in != nullptr, false);
+  nassertr(size <= _tail_size, false);
+
+  _in->ignore((streamsize)size);
+  if (_in->fail() || (size_t)_in->gcount() != size) {
+    _error = true;
+    return false;
+  }
+
+  _tail_size -= size;
+  return true;
+}
+
 /**
  * Skips over the next datagram without extracting it, but saves the relevant
  * file information in the SubfileInfo object so that its data may be read
@@ -224,6 +291,10 @@ save_datagram(SubfileInfo &info) {
   nassertr(_in != nullptr, false);
   _read_first_datagram = true;
 
+  if (_tail_size != 0 && !skip_datagram_tail(_tail_size)) {
+    return false;
+  }
+
   // First, get the size of the upcoming datagram.
   StreamReader reader(_in, false);
   size_t num_bytes_32 = reader.get_uint32();
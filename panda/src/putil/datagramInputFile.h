@@ -49,6 +49,12 @@ PUBLISHED:
   virtual VirtualFile *get_vfile();
   virtual std::streampos get_file_pos();
 
+public:
+  virtual bool get_datagram_head(Datagram &data, size_t head_size,
+                                 size_t &tail_size);
+  virtual bool read_datagram_tail(unsigned char *into, size_t size);
+  virtual bool skip_datagram_tail(size_t size);
+
 private:
   bool _read_first_datagram;
   bool _error;
@@ -56,6 +62,7 @@ private:
   PT(VirtualFile) _vfile;
   std::istream *_in;
   bool _owns_in;
+  size_t _tail_size;
   Filename _filename;
   time_t _timestamp;
 };
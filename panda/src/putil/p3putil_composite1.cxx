@@ -4,6 +4,7 @@
 #include "bamCacheIndex.cxx"
 #include "bamCacheRecord.cxx"
 #include "bamEnums.cxx"
+#include "bamReadAhead.cxx"
 #include "bamReader.cxx"
 #include "bamReaderParam.cxx"
 #include "bamWriter.cxx"
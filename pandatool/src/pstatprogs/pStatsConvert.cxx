@@ -0,0 +1,447 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pStatsConvert.cxx
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#include "pStatsConvert.h"
+#include "pStatClientControlMessage.h"
+#include "datagramInputFile.h"
+#include "datagramIterator.h"
+#include "pmap.h"
+#include "string_utils.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <math.h>
+
+using std::string;
+
+// This must match PStatRecorder::_file_header.
+static const string recording_header("pstat\0\n\r", 8);
+
+/**
+ *
+ */
+PStatsConvert::
+PStatsConvert() :
+  WithOutputFile(true, true, false)
+{
+  clear_runlines();
+  add_runline("[opts] input.pstats output.json");
+  add_runline("[opts] input.pstats -o output.folded");
+  add_runline("[opts] -t folded input.pstats >output.folded");
+
+  set_program_brief("convert a PStats recording for other profiling tools");
+  set_program_description
+    ("pstats-convert reads a file of statistics that was written by "
+     "PStatClient::record() (for instance, by setting pstats-record-file), "
+     "and writes it out either as a Chrome trace, which can be loaded into "
+     "chrome://tracing or the Perfetto UI, or as folded stacks, which "
+     "flamegraph.pl and similar tools can turn into a flame graph.\n\n"
+
+     "In the Chrome trace, each thread's collectors appear as nested "
+     "spans, and level collectors appear as counters.  In the folded "
+     "stacks, the time spent in each nesting of collectors, on each thread, "
+     "is totalled over the whole recording, in microseconds.");
+
+  add_option
+    ("t", "format", 0,
+     "Specify the output format: either \"chrome\" or \"folded\".  If this "
+     "is omitted, it is chosen by the extension of the output filename: "
+     ".json for chrome, anything else for folded.",
+     &PStatsConvert::dispatch_format, nullptr, &_format);
+
+  add_option
+    ("o", "filename", 0,
+     "Specify the filename to which the output will be written.  "
+     "If this option is omitted, the last parameter name is taken to be the "
+     "name of the output file, or standard output is used if there are no "
+     "other parameters.",
+     &PStatsConvert::dispatch_filename, &_got_output_filename, &_output_filename);
+
+  _format = F_unspecified;
+  _client_name = "Panda";
+  _version = new PStatClientVersion;
+}
+
+/**
+ *
+ */
+void PStatsConvert::
+run() {
+  if (!read_recording()) {
+    exit(1);
+  }
+
+  Format format = _format;
+  if (format == F_unspecified) {
+    if (has_output_filename() &&
+        downcase(get_output_filename().get_extension()) == "json") {
+      format = F_chrome;
+    } else {
+      format = F_folded;
+    }
+  }
+
+  std::ostream &out = get_output();
+  if (format == F_chrome) {
+    write_chrome(out);
+  } else {
+    write_folded(out);
+  }
+  close_output();
+}
+
+/**
+ *
+ */
+bool PStatsConvert::
+handle_args(ProgramBase::Args &args) {
+  if (args.size() == 2 && !_got_output_filename) {
+    // The second argument, if present, is implicitly the output file.
+    _got_output_filename = true;
+    _output_filename = args[1];
+    args.pop_back();
+  }
+
+  if (args.size() != 1) {
+    nout << "You must specify exactly one recording to read on the command line.\n";
+    return false;
+  }
+
+  _input_filename = Filename::binary_filename(args[0]);
+  return true;
+}
+
+/**
+ * Dispatch function for the output format.
+ */
+bool PStatsConvert::
+dispatch_format(const string &opt, const string &arg, void *var) {
+  Format *ip = (Format *)var;
+  string name = downcase(arg);
+  if (name == "chrome" || name == "json") {
+    *ip = F_chrome;
+  } else if (name == "folded" || name == "flamegraph") {
+    *ip = F_folded;
+  } else {
+    nout << "Invalid format for -" << opt << ": " << arg << "\n"
+         << "Valid formats are chrome and folded.\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Reads the collector and thread definitions and all of the frames from the
+ * input file.  Returns true on success, false on failure.
+ */
+bool PStatsConvert::
+read_recording() {
+  DatagramInputFile din;
+  if (!din.open(_input_filename)) {
+    nout << "Unable to read " << _input_filename << ".\n";
+    return false;
+  }
+
+  string header;
+  if (!din.read_header(header, recording_header.size()) ||
+      header != recording_header) {
+    nout << _input_filename << " is not a PStats recording.\n";
+    return false;
+  }
+
+  Datagram datagram;
+  while (din.get_datagram(datagram)) {
+    if (datagram.get_length() == 0) {
+      continue;
+    }
+
+    DatagramIterator scan(datagram);
+    if (scan.get_uint8() == PStatClientControlMessage::T_datagram) {
+      Frame frame;
+      frame._thread_index = scan.get_uint16();
+      frame._frame_number = scan.get_uint32();
+      frame._start = scan.get_float64();
+      frame._data.read_datagram(scan, _version);
+      _frames.push_back(std::move(frame));
+      continue;
+    }
+
+    PStatClientControlMessage message;
+    if (!message.decode(datagram, _version)) {
+      nout << "Ignoring invalid record in " << _input_filename << ".\n";
+      continue;
+    }
+
+    switch (message._type) {
+    case PStatClientControlMessage::T_hello:
+      _client_name = message._client_progname;
+      _version->set_version(message._major_version, message._minor_version);
+      break;
+
+    case PStatClientControlMessage::T_define_collectors:
+      for (PStatCollectorDef *def : message._collectors) {
+        if (def->_index >= 0) {
+          if (def->_index >= (int)_collectors.size()) {
+            _collectors.resize(def->_index + 1);
+          }
+          _collectors[def->_index] = *def;
+        }
+        delete def;
+      }
+      break;
+
+    case PStatClientControlMessage::T_define_threads:
+      for (size_t i = 0; i < message._names.size(); ++i) {
+        size_t index = message._first_thread_index + i;
+        if (index >= _thread_names.size()) {
+          _thread_names.resize(index + 1);
+        }
+        _thread_names[index] = message._names[i];
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  if (din.is_error()) {
+    nout << "Error reading " << _input_filename
+         << "; the recording may be truncated.\n";
+  }
+
+  nout << "Read " << _frames.size() << " frames of " << _thread_names.size()
+       << " threads and " << _collectors.size() << " collectors.\n";
+  return true;
+}
+
+/**
+ * Writes the frames in the Chrome trace event format.  Each collector's time
+ * becomes a complete event on its thread's track, and each level becomes a
+ * counter.
+ */
+void PStatsConvert::
+write_chrome(std::ostream &out) {
+  // Measure the times from the first frame, so the numbers stay readable.
+  double base = 0.0;
+  if (!_frames.empty()) {
+    base = _frames[0]._start;
+    for (const Frame &frame : _frames) {
+      base = std::min(base, frame._start);
+    }
+  }
+
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+      << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":";
+  write_json_string(out, _client_name);
+  out << "}}";
+
+  for (size_t ti = 0; ti < _thread_names.size(); ++ti) {
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ti
+        << ",\"args\":{\"name\":";
+    write_json_string(out, get_thread_name(ti));
+    out << "}}";
+  }
+
+  // The start time of each collector that is currently running, or -1.
+  pvector<double> started;
+
+  for (const Frame &frame : _frames) {
+    const PStatFrameData &data = frame._data;
+    double frame_end = data.is_time_empty() ? 0.0 : data.get_end();
+
+    started.assign(_collectors.size(), -1.0);
+    size_t num_events = data.get_num_events();
+    for (size_t i = 0; i <= num_events; ++i) {
+      if (i < num_events) {
+        int index = data.get_time_collector(i);
+        if (index >= (int)started.size()) {
+          started.resize(index + 1, -1.0);
+        }
+        if (data.is_start(i)) {
+          if (started[index] < 0.0) {
+            started[index] = data.get_time(i);
+          }
+          continue;
+        }
+        if (started[index] < 0.0) {
+          // A stop without a start; the collector was running before the
+          // recording began.
+          continue;
+        }
+        double start = started[index];
+        started[index] = -1.0;
+
+        out << ",\n{\"name\":";
+        write_json_string(out, get_collector_fullname(index));
+        out << ",\"cat\":\"pstats\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << frame._thread_index
+            << ",\"ts\":" << (frame._start + start - base) * 1000000.0
+            << ",\"dur\":" << (data.get_time(i) - start) * 1000000.0;
+        if (index == 0) {
+          out << ",\"args\":{\"frame\":" << frame._frame_number << "}";
+        }
+        out << "}";
+
+      } else {
+        // Close anything still running at the end of the frame.
+        for (size_t index = 0; index < started.size(); ++index) {
+          if (started[index] >= 0.0) {
+            out << ",\n{\"name\":";
+            write_json_string(out, get_collector_fullname(index));
+            out << ",\"cat\":\"pstats\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << frame._thread_index
+                << ",\"ts\":" << (frame._start + started[index] - base) * 1000000.0
+                << ",\"dur\":" << (frame_end - started[index]) * 1000000.0
+                << "}";
+          }
+        }
+      }
+    }
+
+    size_t num_levels = data.get_num_levels();
+    for (size_t i = 0; i < num_levels; ++i) {
+      out << ",\n{\"name\":";
+      write_json_string(out, get_collector_fullname(data.get_level_collector(i)));
+      out << ",\"ph\":\"C\",\"pid\":1,\"tid\":" << frame._thread_index
+          << ",\"ts\":" << (frame._start - base) * 1000000.0
+          << ",\"args\":{\"value\":" << data.get_level(i) << "}}";
+    }
+  }
+
+  out << "\n]}\n";
+}
+
+/**
+ * Writes the frames as folded stacks: one line for each distinct nesting of
+ * collectors on each thread, followed by the total number of microseconds
+ * spent directly within the innermost collector of that nesting.
+ */
+void PStatsConvert::
+write_folded(std::ostream &out) {
+  typedef pmap<string, double> Totals;
+  Totals totals;
+
+  pvector<int> stack;
+  for (const Frame &frame : _frames) {
+    const PStatFrameData &data = frame._data;
+    string thread_name = get_thread_name(frame._thread_index);
+
+    stack.clear();
+    size_t num_events = data.get_num_events();
+    double prev_time = 0.0;
+    for (size_t i = 0; i < num_events; ++i) {
+      double time = data.get_time(i);
+      if (!stack.empty() && time > prev_time) {
+        string path = thread_name;
+        for (int index : stack) {
+          path += ';';
+          path += get_collector_fullname(index);
+        }
+        totals[path] += time - prev_time;
+      }
+      prev_time = time;
+
+      int index = data.get_time_collector(i);
+      if (data.is_start(i)) {
+        stack.push_back(index);
+      } else {
+        // Collectors are usually stopped in the reverse order they were
+        // started, but not always.
+        pvector<int>::reverse_iterator si =
+          std::find(stack.rbegin(), stack.rend(), index);
+        if (si != stack.rend()) {
+          stack.erase(std::next(si).base());
+        }
+      }
+    }
+  }
+
+  for (Totals::const_iterator ti = totals.begin(); ti != totals.end(); ++ti) {
+    long long usec = (long long)floor((*ti).second * 1000000.0 + 0.5);
+    if (usec > 0) {
+      out << (*ti).first << " " << usec << "\n";
+    }
+  }
+}
+
+/**
+ * Returns the name of the indicated collector, including the names of its
+ * parents, as in "Draw:Flip".  Collector 0 is the whole frame.
+ */
+string PStatsConvert::
+get_collector_fullname(int index) const {
+  if (index < 0 || index >= (int)_collectors.size() ||
+      _collectors[index]._name.empty()) {
+    return "Collector " + format_string(index);
+  }
+
+  const PStatCollectorDef &def = _collectors[index];
+  if (index == 0 || def._parent_index <= 0 || def._parent_index == index) {
+    return def._name;
+  }
+  return get_collector_fullname(def._parent_index) + ":" + def._name;
+}
+
+/**
+ * Returns the name of the indicated thread.
+ */
+string PStatsConvert::
+get_thread_name(int index) const {
+  if (index < 0 || index >= (int)_thread_names.size() ||
+      _thread_names[index].empty()) {
+    return "Thread " + format_string(index);
+  }
+  return _thread_names[index];
+}
+
+/**
+ * Writes the indicated string as a quoted JSON string.
+ */
+void PStatsConvert::
+write_json_string(std::ostream &out, const string &str) {
+  out << '"';
+  for (char ch : str) {
+    switch (ch) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if ((unsigned char)ch < 0x20) {
+        static const char hex[] = "0123456789abcdef";
+        out << "\\u00" << hex[(ch >> 4) & 0xf] << hex[ch & 0xf];
+      } else {
+        out << ch;
+      }
+    }
+  }
+  out << '"';
+}
+
+int main(int argc, char *argv[]) {
+  PStatsConvert prog;
+  prog.parse_command_line(argc, argv);
+  prog.run();
+  return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pStatsConvert.h
+ * @author lachbr
+ * @date 2026-10-17
+ */
+
+#ifndef PSTATSCONVERT_H
+#define PSTATSCONVERT_H
+
+#include "pandatoolbase.h"
+
+#include "programBase.h"
+#include "withOutputFile.h"
+#include "pStatCollectorDef.h"
+#include "pStatFrameData.h"
+#include "pStatClientVersion.h"
+#include "pvector.h"
+#include "vector_string.h"
+
+/**
+ * Reads a file written by PStatClient::record() and writes it out in a form
+ * that can be examined with other tools: either a Chrome trace, which can be
+ * loaded into chrome://tracing or Perfetto, or folded stacks, which can be
+ * turned into a flame graph.
+ */
+class PStatsConvert : public ProgramBase, public WithOutputFile {
+public:
+  PStatsConvert();
+
+  void run();
+
+protected:
+  virtual bool handle_args(Args &args);
+
+  static bool dispatch_format(const std::string &opt, const std::string &arg, void *var);
+
+private:
+  enum Format {
+    F_unspecified,
+    F_chrome,
+    F_folded,
+  };
+
+  bool read_recording();
+  void write_chrome(std::ostream &out);
+  void write_folded(std::ostream &out);
+
+  std::string get_collector_fullname(int index) const;
+  std::string get_thread_name(int index) const;
+
+  static void write_json_string(std::ostream &out, const std::string &str);
+
+  class Frame {
+  public:
+    int _thread_index;
+    int _frame_number;
+    double _start;
+    PStatFrameData _data;
+  };
+
+  Filename _input_filename;
+  Format _format;
+
+  std::string _client_name;
+  PT(PStatClientVersion) _version;
+  pvector<PStatCollectorDef> _collectors;
+  vector_string _thread_names;
+  pvector<Frame> _frames;
+};
+
+#endif
@@ -0,0 +1,121 @@
+from panda3d import core
+import math
+
+NUM_FRAMES = 10
+
+
+def make_character():
+    """Makes a Character with a small joint hierarchy, including a plain
+    PartGroup between two of the joints, and an AnimBundle to match it."""
+
+    character = core.Character("character")
+    bundle = character.get_bundle(0)
+
+    joints = {}
+    joints["root"] = core.CharacterJoint(character, bundle, bundle, "root", core.LMatrix4.ident_mat())
+    group = core.PartGroup(joints["root"], "group")
+    joints["child"] = core.CharacterJoint(character, bundle, group, "child", core.LMatrix4.ident_mat())
+    joints["leaf"] = core.CharacterJoint(character, bundle, joints["child"], "leaf", core.LMatrix4.ident_mat())
+    joints["other"] = core.CharacterJoint(character, bundle, joints["root"], "other", core.LMatrix4.ident_mat())
+
+    anim = core.AnimBundle("anim", 24, NUM_FRAMES)
+    channels = {}
+    channels["root"] = core.AnimChannelMatrixXfmTable(anim, "root")
+    anim_group = core.AnimGroup(channels["root"], "group")
+    channels["child"] = core.AnimChannelMatrixXfmTable(anim_group, "child")
+    channels["leaf"] = core.AnimChannelMatrixXfmTable(channels["child"], "leaf")
+    channels["other"] = core.AnimChannelMatrixXfmTable(channels["root"], "other")
+
+    for i, channel in enumerate(channels.values()):
+        channel.set_table('x', core.PTA_float([
+            (i + 1) * 0.5 + f * 0.1 for f in range(NUM_FRAMES)]))
+        channel.set_table('h', core.PTA_float([
+            30.0 * math.sin(f * 0.7 + i) for f in range(NUM_FRAMES)]))
+        channel.set_table('p', core.PTA_float([i * 10.0 + f for f in range(NUM_FRAMES)]))
+
+    control = bundle.bind_anim(anim)
+    assert control is not None
+
+    return character, bundle, joints, control
+
+
+def get_local_mat(frame, channel_index):
+    """Returns the transform the indicated channel of make_character() has at
+    the given frame, composed from its tables."""
+
+    pos = ((channel_index + 1) * 0.5 + frame * 0.1, 0, 0)
+    hpr = (30.0 * math.sin(frame * 0.7 + channel_index), channel_index * 10.0 + frame, 0)
+    return core.TransformState.make_pos_hpr(pos, hpr).get_mat()
+
+
+def get_expected_net(frame):
+    """Composes the net transforms of the joints the way a recursive update
+    of the hierarchy would."""
+
+    root = get_local_mat(frame, 0)
+    child = get_local_mat(frame, 1) * root
+    return {
+        "root": root,
+        "child": child,
+        "leaf": get_local_mat(frame, 2) * child,
+        "other": get_local_mat(frame, 3) * root,
+    }
+
+
+def get_net(joint):
+    mat = core.LMatrix4()
+    joint.get_net_transform(mat)
+    return mat
+
+
+def update(bundle):
+    # PartBundle.update() does nothing if it has already been updated this
+    # frame, so advance the clock first.
+    core.ClockObject.get_global_clock().tick()
+    return bundle.update()
+
+
+def test_part_bundle_update():
+    character, bundle, joints, control = make_character()
+
+    for frame in (0, 3, 9, 4, 4, 1):
+        control.pose(frame)
+        update(bundle)
+
+        expected = get_expected_net(frame)
+        for name, joint in joints.items():
+            assert get_net(joint).almost_equal(expected[name], 1e-4), (frame, name)
+
+
+def test_part_bundle_force_update():
+    character, bundle, joints, control = make_character()
+
+    for frame in (2, 7):
+        control.pose(frame)
+        assert bundle.force_update()
+
+        expected = get_expected_net(frame)
+        for name, joint in joints.items():
+            assert get_net(joint).almost_equal(expected[name], 1e-4), (frame, name)
+
+
+def test_part_bundle_add_joint():
+    character, bundle, joints, control = make_character()
+
+    control.pose(0)
+    update(bundle)
+
+    # Adding a joint after the bundle has been updated must not leave it out
+    # of subsequent updates, even though it has no channel of its own.
+    offset = core.LMatrix4.translate_mat(0, 2, 0)
+    added = core.CharacterJoint(character, bundle, joints["leaf"], "added", offset)
+    expected = get_expected_net(0)
+    assert get_net(added).almost_equal(offset * expected["leaf"], 1e-4)
+
+    for frame in (5, 8):
+        control.pose(frame)
+        update(bundle)
+
+        expected = get_expected_net(frame)
+        assert get_net(joints["leaf"]).almost_equal(expected["leaf"], 1e-4)
+        assert get_net(added).almost_equal(offset * expected["leaf"], 1e-4)
@@ -0,0 +1,147 @@
+from panda3d import core
+import math
+
+
+def make_channel(num_frames):
+    bundle = core.AnimBundle("anim", 24, num_frames)
+    joint = core.AnimChannelMatrixXfmTable(bundle, "joint")
+
+    joint.set_table('h', core.PTA_float([
+        45.0 * math.sin(i * 0.1) for i in range(num_frames)]))
+    joint.set_table('x', core.PTA_float([
+        i * 0.25 for i in range(num_frames)]))
+    joint.set_table('z', core.PTA_float([1.5]))
+    return bundle, joint
+
+
+def get_values(joint, num_frames):
+    return [(joint.get_table('h')[i], joint.get_table('x')[i])
+            for i in range(num_frames)]
+
+
+def test_xfm_table_compress():
+    bundle, joint = make_channel(200)
+    original = get_values(joint, 200)
+    size = joint.get_table_memory_size()
+
+    joint.compress_tables(0.001)
+    assert joint.compressed
+    assert joint.has_table('h')
+    assert joint.has_table('z')
+    assert not joint.has_table('y')
+    assert joint.get_table_memory_size() < size
+
+    assert len(joint.get_table('x')) == 200
+    assert joint.get_table('z')[0] == 1.5
+
+    for (h0, x0), (h1, x1) in zip(original, get_values(joint, 200)):
+        assert abs(h0 - h1) < 0.0015
+        assert abs(x0 - x1) < 0.0015
+
+    joint.decompress_tables()
+    assert not joint.compressed
+    assert len(joint.get_table('h')) == 200
+
+
+def test_xfm_table_compressed_bam():
+    bundle, joint = make_channel(200)
+    joint.compress_tables(0.001)
+    expected = get_values(joint, 200)
+
+    buffer = core.DatagramBuffer()
+    writer = core.BamWriter(buffer)
+    writer.set_file_minor_ver(46)
+    writer.init()
+    writer.write_object(bundle)
+    writer.flush()
+
+    reader = core.BamReader(core.DatagramBuffer(buffer.data))
+    reader.init()
+    assert reader.file_version == (6, 46)
+    bundle = reader.read_object()
+    reader.resolve()
+
+    joint = bundle.find_child("joint")
+    assert joint.compressed
+    assert get_values(joint, 200) == expected
+
+
+def test_xfm_table_compressed_bam_old():
+    # An older bam version can't store the compressed tables, so they are
+    # written in full.
+    bundle, joint = make_channel(200)
+    joint.compress_tables(0.001)
+    expected = get_values(joint, 200)
+
+    buffer = core.DatagramBuffer()
+    writer = core.BamWriter(buffer)
+    writer.set_file_minor_ver(45)
+    writer.init()
+    writer.write_object(bundle)
+    writer.flush()
+
+    reader = core.BamReader(core.DatagramBuffer(buffer.data))
+    reader.init()
+    bundle = reader.read_object()
+    reader.resolve()
+
+    joint = bundle.find_child("joint")
+    assert not joint.compressed
+    for (h0, x0), (h1, x1) in zip(expected, get_values(joint, 200)):
+        assert abs(h0 - h1) < 1e-5
+        assert abs(x0 - x1) < 1e-5
+
+
+def test_xfm_table_compress_too_long():
+    # The frame numbers of a compressed table are 16-bit, so a longer table
+    # must be left uncompressed, while the shorter ones are still compressed.
+    bundle, joint = make_channel(200)
+    joint.set_table('x', core.PTA_float([i * 0.25 for i in range(70000)]))
+
+    joint.compress_tables(0.001)
+    assert joint.compressed
+
+    x = joint.get_table('x')
+    assert len(x) == 70000
+    assert x[0] == 0.0
+    assert x[69999] == 69999 * 0.25
+    assert len(joint.get_table('h')) == 200
+
+
+def test_xfm_table_bam_decode_threads(tmp_path):
+    # With bam-decode-threads, the tables are compressed on worker threads
+    # after the whole bundle has been read; the result must be the same.
+    bundle = core.AnimBundle("anim", 24, 200)
+    for j in range(20):
+        joint = core.AnimChannelMatrixXfmTable(bundle, "joint%d" % j)
+        joint.set_table('h', core.PTA_float([
+            j + 45.0 * math.sin(i * 0.1) for i in range(200)]))
+        joint.set_table('x', core.PTA_float([
+            i * 0.25 * j for i in range(200)]))
+
+    path = core.Filename.from_os_specific(str(tmp_path / "anim.bam"))
+    bam = core.BamFile()
+    assert bam.open_write(path)
+    assert bam.write_object(bundle)
+    bam.close()
+
+    decode_threads = core.ConfigVariableInt("bam-decode-threads")
+    compress = core.ConfigVariableBool("compress-anim-tables")
+    compress.set_value(True)
+    results = []
+    try:
+        for num_threads in (0, 2):
+            decode_threads.set_value(num_threads)
+            assert bam.open_read(path)
+            result = bam.read_object()
+            assert bam.resolve()
+            bam.close()
+
+            joints = [result.find_child("joint%d" % j) for j in range(20)]
+            assert all(joint.compressed for joint in joints)
+            results.append([get_values(joint, 200) for joint in joints])
+    finally:
+        decode_threads.clear_local_value()
+        compress.clear_local_value()
+
+    assert results[0] == results[1]
@@ -29,3 +29,129 @@ def test_collision_traverser_pickle():
     # Two colliders must still be the same object; this only works with our own
     # version of the pickle module, in direct.stdpy.pickle.
     assert trav.get_handler(collider1) == trav.get_handler(collider2)
+
+
+def make_broadphase_scene():
+    from panda3d.core import CollisionSphere, CollisionRay, GeomNode, CardMaker
+    from random import Random
+
+    random = Random(1)
+    root = NodePath("root")
+
+    # A field of into-spheres, some of them nested under transformed nodes.
+    for i in range(200):
+        parent = root.attach_new_node("group%d" % (i))
+        parent.set_pos(random.uniform(-50, 50), random.uniform(-50, 50), 0)
+        parent.set_scale(random.uniform(0.5, 2))
+        into = CollisionNode("into%d" % (i))
+        into.add_solid(CollisionSphere(0, 0, 0, random.uniform(0.5, 3)))
+        into.set_from_collide_mask(0)
+        parent.attach_new_node(into)
+
+    # A floor, made of visible geometry.
+    cm = CardMaker("floor")
+    cm.set_frame(-60, 60, -60, 60)
+    floor = root.attach_new_node(cm.generate())
+    floor.set_p(-90)
+
+    colliders = []
+    for i in range(50):
+        from_node = CollisionNode("from%d" % (i))
+        from_node.add_solid(CollisionSphere(0, 0, 0, random.uniform(1, 4)))
+        from_node.set_into_collide_mask(0)
+        np = root.attach_new_node(from_node)
+        np.set_pos(random.uniform(-50, 50), random.uniform(-50, 50), 0)
+        colliders.append(np)
+
+    for i in range(10):
+        from_node = CollisionNode("ray%d" % (i))
+        from_node.add_solid(CollisionRay(0, 0, 5, 0, 0, -1))
+        from_node.set_from_collide_mask(GeomNode.get_default_collide_mask())
+        from_node.set_into_collide_mask(0)
+        np = root.attach_new_node(from_node)
+        np.set_pos(random.uniform(-50, 50), random.uniform(-50, 50), 0)
+        colliders.append(np)
+
+    return root, colliders
+
+
+def get_collisions(root, colliders, broadphase):
+    trav = CollisionTraverser()
+    trav.broadphase = broadphase
+    queue = CollisionHandlerQueue()
+    for np in colliders:
+        trav.add_collider(np, queue)
+
+    trav.traverse(root)
+    return trav, queue, sorted(
+        (entry.from_node_path.name, entry.into_node_path.name,
+         tuple(round(x, 3) for x in entry.get_surface_point(root)))
+        for entry in queue.entries)
+
+
+def test_collision_traverser_broadphase():
+    root, colliders = make_broadphase_scene()
+
+    trav = CollisionTraverser()
+    assert not trav.broadphase
+    trav.broadphase = True
+    assert trav.get_broadphase()
+
+    expected = get_collisions(root, colliders, False)[2]
+    assert len(expected) > 10
+
+    trav, queue, result = get_collisions(root, colliders, True)
+    assert result == expected
+
+    # Move some of the into-nodes, and make sure that the tree catches up.
+    for i in range(0, 200, 3):
+        root.find("group%d" % (i)).set_x(0)
+    root.find("group1").remove_node()
+
+    expected = get_collisions(root, colliders, False)[2]
+    trav.traverse(root)
+    result = sorted(
+        (entry.from_node_path.name, entry.into_node_path.name,
+         tuple(round(x, 3) for x in entry.get_surface_point(root)))
+        for entry in queue.entries)
+    assert result == expected
+
+
+def test_collision_traverser_broadphase_nested_change():
+    root, colliders = make_broadphase_scene()
+    trav, queue, result = get_collisions(root, colliders, True)
+
+    def traverse():
+        trav.traverse(root)
+        return sorted(
+            (entry.from_node_path.name, entry.into_node_path.name,
+             tuple(round(x, 3) for x in entry.get_surface_point(root)))
+            for entry in queue.entries)
+
+    # Nothing has changed, so the into-nodes are all taken over as they are.
+    assert traverse() == result
+
+    # Change the into-nodes below their groups, rather than the groups.
+    for i in range(0, 200, 4):
+        root.find("group%d/into%d" % (i, i)).set_pos(1, 1, 0)
+    for i in range(1, 200, 4):
+        root.find("group%d/into%d" % (i, i)).node().set_into_collide_mask(0)
+
+    expected = get_collisions(root, colliders, False)[2]
+    assert traverse() == expected
+
+
+def test_collision_traverser_broadphase_threads():
+    from panda3d.core import ConfigVariableInt
+
+    root, colliders = make_broadphase_scene()
+    expected = get_collisions(root, colliders, False)[2]
+
+    var = ConfigVariableInt("collision-broadphase-threads")
+    old_value = var.value
+    var.value = 3
+    try:
+        for i in range(3):
+            assert get_collisions(root, colliders, True)[2] == expected
+    finally:
+        var.value = old_value
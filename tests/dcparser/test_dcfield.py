@@ -0,0 +1,77 @@
+import pytest
+
+direct = pytest.importorskip("panda3d.direct")
+core = pytest.importorskip("panda3d.core")
+
+
+DC_SOURCE = """
+dclass DistributedThing {
+  setSmPosHpr(int16 / 10, int16 / 10, int16 / 10, int16 / 10, int16 / 10, int16 / 10, int16) broadcast;
+  setMixed(int8, uint8, int32, uint32, int64, uint64, float64) broadcast;
+  setRanged(uint8(0-10)) broadcast;
+  setName(string) broadcast;
+  setData(blob, char, uint16) broadcast;
+};
+"""
+
+
+def read_dc():
+    dc = direct.DCFile()
+    assert dc.read(core.StringStream(DC_SOURCE.encode()), "test.dc")
+    return dc.get_class_by_name("DistributedThing")
+
+
+def round_trip(field, args):
+    packer = direct.DCPacker()
+    packer.begin_pack(field)
+    assert field.pack_args(packer, args)
+    assert packer.end_pack()
+
+    unpacker = direct.DCPacker()
+    unpacker.set_unpack_data(packer.get_bytes())
+    unpacker.begin_unpack(field)
+    result = field.unpack_args(unpacker)
+    assert unpacker.end_unpack()
+    return result
+
+
+def test_pack_plan_divisor():
+    dclass = read_dc()
+    field = dclass.get_field_by_name("setSmPosHpr")
+    result = round_trip(field, (1.5, -2.0, 300.1, 0, 90, -180, 1234))
+    assert result == pytest.approx((1.5, -2.0, 300.1, 0.0, 90.0, -180.0, 1234))
+    assert isinstance(result[0], float)
+    assert isinstance(result[6], int)
+
+
+def test_pack_plan_mixed():
+    dclass = read_dc()
+    field = dclass.get_field_by_name("setMixed")
+    args = (-128, 255, -0x80000000, 0xffffffff,
+            -0x8000000000000000, 0xffffffffffffffff, 0.25)
+    assert round_trip(field, args) == args
+
+
+def test_pack_plan_variable_args():
+    dclass = read_dc()
+    assert round_trip(dclass.get_field_by_name("setRanged"), (7,)) == (7,)
+    assert round_trip(dclass.get_field_by_name("setName"), ("abc",)) == ("abc",)
+    assert round_trip(dclass.get_field_by_name("setData"), (b"\x00\xff", "x", 9)) == (b"\x00\xff", "x", 9)
+
+
+def test_pack_plan_range_error():
+    dclass = read_dc()
+    field = dclass.get_field_by_name("setRanged")
+    packer = direct.DCPacker()
+    packer.begin_pack(field)
+    with pytest.raises(ValueError):
+        field.pack_args(packer, (11,))
+
+
+def test_pack_plan_wrong_args():
+    dclass = read_dc()
+    field = dclass.get_field_by_name("setMixed")
+    packer = direct.DCPacker()
+    packer.begin_pack(field)
+    with pytest.raises(TypeError):
+        field.pack_args(packer, (1, 2, 3))
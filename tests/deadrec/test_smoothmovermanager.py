@@ -0,0 +1,93 @@
+import pytest
+
+direct = pytest.importorskip("panda3d.direct")
+core = pytest.importorskip("panda3d.core")
+
+
+def make_mover():
+    mover = direct.SmoothMover()
+    mover.set_smooth_mode(direct.SmoothMover.SM_on)
+    mover.set_prediction_mode(direct.SmoothMover.PM_on)
+    mover.set_delay(0.0)
+    for i in range(4):
+        mover.set_pos_hpr(i, i * 2, 0, i * 10, 0, 0)
+        mover.set_timestamp(i * 0.1)
+        mover.mark_position()
+    return mover
+
+
+def test_manager_matches_single_mover():
+    manager = direct.SmoothMoverManager()
+    reference = make_mover()
+    managed = make_mover()
+    node = core.NodePath("node")
+    manager.add_mover(managed, node)
+    assert manager.has_mover(managed)
+
+    for t in (0.05, 0.15, 0.25, 0.4):
+        reference.compute_smooth_position(t)
+        manager.update(t)
+        assert node.get_pos() == reference.get_smooth_pos()
+        assert node.get_hpr().almost_equal(reference.get_smooth_hpr())
+
+
+def test_manager_remove():
+    manager = direct.SmoothMoverManager()
+    movers = [make_mover() for i in range(3)]
+    for mover in movers:
+        manager.add_mover(mover, core.NodePath("node"))
+    assert manager.get_num_movers() == 3
+
+    assert manager.remove_mover(movers[0])
+    assert not manager.remove_mover(movers[0])
+    assert manager.get_num_movers() == 2
+    assert not manager.has_mover(movers[0])
+    assert manager.has_mover(movers[1]) and manager.has_mover(movers[2])
+
+    # A mover removes itself when it goes away.
+    del movers[1]
+    assert manager.get_num_movers() == 1
+    assert manager.has_mover(movers[1])
+
+
+def test_manager_threads():
+    manager = direct.SmoothMoverManager()
+    manager.set_num_threads(2)
+    movers = [make_mover() for i in range(500)]
+    nodes = [core.NodePath("node") for mover in movers]
+    for mover, node in zip(movers, nodes):
+        manager.add_mover(mover, node)
+
+    assert manager.update(0.15) == len(movers)
+    for mover, node in zip(movers, nodes):
+        assert node.get_pos() == mover.get_smooth_pos()
+    manager.set_num_threads(0)
+
+
+def test_manager_stopped():
+    manager = direct.SmoothMoverManager()
+    mover = direct.SmoothMover()
+    mover.set_smooth_mode(direct.SmoothMover.SM_on)
+    mover.set_delay(0.0)
+    node = core.NodePath("node")
+    manager.add_mover(mover, node)
+
+    # A stopped mover is still computed until its position stops changing.
+    manager.set_mover_stopped(mover, True)
+    assert manager.update(0.0) == 1
+    assert not manager.is_mover_fully_stopped(mover)
+    assert manager.update(0.1) == 0
+    assert manager.is_mover_fully_stopped(mover)
+
+    # After that, it is skipped, even when a new position arrives...
+    mover.set_pos_hpr(5, 0, 0, 0, 0, 0)
+    mover.set_timestamp(0.2)
+    mover.mark_position()
+    assert manager.update(0.3) == 0
+    assert node.get_pos() == (0, 0, 0)
+
+    # ...until it is marked moving again.
+    manager.set_mover_stopped(mover, False)
+    assert not manager.is_mover_fully_stopped(mover)
+    assert manager.update(0.3) == 1
+    assert node.get_pos() == mover.get_smooth_pos()
@@ -0,0 +1,156 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def animation_region(graphics_pipe):
+    """Creates and returns a DisplayRegion on an offscreen buffer."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.force_hardware = True
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(64, 64),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    yield buffer.make_display_region()
+
+    if buffer is not None:
+        engine.remove_window(buffer)
+
+
+@pytest.fixture
+def cpu_animation_threads():
+    hardware = core.ConfigVariableBool("hardware-animated-vertices")
+    old_hardware = hardware.value
+    hardware.value = False
+
+    var = core.ConfigVariableInt("cpu-animation-threads")
+    old_value = var.value
+    yield var
+    var.value = old_value
+    hardware.value = old_hardware
+
+
+def make_format():
+    array = core.GeomVertexArrayFormat()
+    array.add_column("vertex", 3, core.Geom.NT_float32, core.Geom.C_point)
+    array.add_column("color", 4, core.Geom.NT_uint8, core.Geom.C_color)
+
+    blend_array = core.GeomVertexArrayFormat()
+    blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+
+    format = core.GeomVertexFormat()
+    format.add_array(array)
+    format.add_array(blend_array)
+
+    spec = core.GeomVertexAnimationSpec()
+    spec.set_panda()
+    format.set_animation(spec)
+    return core.GeomVertexFormat.register_format(format)
+
+
+def make_polygon(format, num_sides, color, xforms):
+    """Makes a flat polygon around the origin, with its vertices split
+    between the indicated transforms, so that it must be animated to show up
+    in the right place."""
+
+    import math
+
+    table = core.TransformBlendTable()
+    blends = [table.add_blend(core.TransformBlend(xform, 1.0)) for xform in xforms]
+    table.set_rows(core.SparseArray.lower_on(num_sides))
+
+    vdata = core.GeomVertexData("polygon", format, core.Geom.UH_static)
+    vdata.set_num_rows(num_sides)
+    vdata.set_transform_blend_table(table)
+
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    col = core.GeomVertexWriter(vdata, "color")
+    blend = core.GeomVertexWriter(vdata, "transform_blend")
+    for i in range(num_sides):
+        angle = 2 * math.pi * i / num_sides
+        vertex.set_data3(math.cos(angle) * 0.1, 0, math.sin(angle) * 0.1)
+        col.set_data4(color)
+        blend.set_data1i(blends[(i * len(blends)) // num_sides])
+
+    prim = core.GeomTriangles(core.Geom.UH_static)
+    for i in range(1, num_sides - 1):
+        prim.add_vertices(0, i, i + 1)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(prim)
+    node = core.GeomNode("polygon")
+    node.add_geom(geom)
+    return node
+
+
+def make_scene(num_polygons):
+    """Makes a scene with a grid of animated polygons in the lower half of the
+    frame, each with a different number of vertices."""
+
+    scene = core.NodePath("root")
+
+    camera = scene.attach_new_node(core.Camera("camera"))
+    camera.node().set_lens(core.OrthographicLens())
+    camera.node().get_lens().set_film_size(2, 2)
+    camera.node().get_lens().set_near_far(-10, 10)
+
+    format = make_format()
+    for i in range(num_polygons):
+        x = (i % 8) * 0.25 - 0.875
+        z = (i // 8) * 0.25 - 0.875
+
+        xform0 = core.UserVertexTransform("xform0")
+        xform0.set_matrix(core.LMatrix4.translate_mat(x, 1, z))
+        xform1 = core.UserVertexTransform("xform1")
+        xform1.set_matrix(core.LMatrix4.scale_mat(1.5) *
+                          core.LMatrix4.translate_mat(x, 1, z))
+
+        color = core.LColor((i + 1) / 64.0, 1 - (i + 1) / 64.0, 0.5, 1)
+        node = make_polygon(format, 3 + i % 7, color, [xform0, xform1])
+        scene.attach_new_node(node)
+
+        if i % 5 == 4:
+            # Some of the geoms are instanced in the upper half of the frame,
+            # so that their vertex data must only be animated once.
+            scene.attach_new_node(node).set_z(1)
+
+    return scene, camera
+
+
+def render_image(region, scene, camera):
+    region.active = True
+    region.camera = camera
+
+    color_texture = core.Texture("color")
+    region.window.add_render_texture(color_texture,
+                                     core.GraphicsOutput.RTM_copy_ram,
+                                     core.GraphicsOutput.RTP_color)
+
+    region.window.engine.render_frame()
+    region.window.clear_render_textures()
+    return color_texture.get_ram_image()
+
+
+def test_cpu_animation_deferred(animation_region, cpu_animation_threads):
+    scene, camera = make_scene(32)
+
+    cpu_animation_threads.value = 0
+    serial = render_image(animation_region, scene, camera)
+
+    cpu_animation_threads.value = 3
+    for i in range(3):
+        assert render_image(animation_region, scene, camera) == serial
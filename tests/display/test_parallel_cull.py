@@ -0,0 +1,117 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def cull_region(graphics_pipe):
+    """Creates and returns a DisplayRegion on an offscreen buffer."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.force_hardware = True
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(32, 32),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    yield buffer.make_display_region()
+
+    if buffer is not None:
+        engine.remove_window(buffer)
+
+
+@pytest.fixture
+def parallel_cull_threads():
+    var = core.ConfigVariableInt("parallel-cull-threads")
+    old_value = var.value
+    var.value = 3
+    yield var
+    var.value = old_value
+
+
+def make_scene(num_cards):
+    """Makes a scene with a stack of full-screen cards, each a different
+    color, in the unsorted bin, so that the one recorded last by the cull
+    traversal is the one that shows up."""
+
+    scene = core.NodePath("root")
+    scene.set_depth_test(False)
+    scene.set_depth_write(False)
+    scene.set_bin("unsorted", 0)
+
+    camera = scene.attach_new_node(core.Camera("camera"))
+    camera.node().set_lens(core.OrthographicLens())
+    camera.node().get_lens().set_film_size(2, 2)
+    camera.node().get_lens().set_near_far(-10, 10)
+
+    cards = scene.attach_new_node("cards")
+    cm = core.CardMaker("card")
+    cm.set_frame(-1, 1, -1, 1)
+    for i in range(num_cards):
+        # Nest each card a few levels deep, to give each run some work.
+        parent = cards.attach_new_node("group%d" % (i))
+        card = parent.attach_new_node("inner").attach_new_node(cm.generate())
+        card.set_pos(0, 1, 0)
+        card.set_color((i + 1) / 255.0, 0, 0, 1)
+
+    return scene, camera, cards
+
+
+def render_card_color(region, scene, camera):
+    region.active = True
+    region.camera = camera
+
+    color_texture = core.Texture("color")
+    region.window.add_render_texture(color_texture,
+                                     core.GraphicsOutput.RTM_copy_ram,
+                                     core.GraphicsOutput.RTP_color)
+
+    region.window.engine.render_frame()
+    region.window.clear_render_textures()
+
+    col = core.LColor()
+    color_texture.peek().lookup(col, 0.5, 0.5)
+    return round(col[0] * 255)
+
+
+def test_parallel_cull_flag():
+    node = core.PandaNode("node")
+    assert not node.parallel_cull
+
+    node.parallel_cull = True
+    assert node.is_parallel_cull()
+    assert node.make_copy().parallel_cull
+
+    node.set_parallel_cull(False)
+    assert not node.parallel_cull
+
+
+def test_parallel_cull_order(cull_region, parallel_cull_threads):
+    scene, camera, cards = make_scene(50)
+
+    serial = render_card_color(cull_region, scene, camera)
+    assert serial == 50
+
+    cards.node().set_parallel_cull(True)
+    for i in range(5):
+        assert render_card_color(cull_region, scene, camera) == serial
+
+
+def test_parallel_cull_hidden(cull_region, parallel_cull_threads):
+    scene, camera, cards = make_scene(50)
+    cards.node().set_parallel_cull(True)
+
+    # The last card is hidden, so the one before it should show.
+    cards.get_child(49).hide()
+    assert render_card_color(cull_region, scene, camera) == 49
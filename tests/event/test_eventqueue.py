@@ -0,0 +1,104 @@
+from panda3d import core
+
+
+def drain(queue):
+    names = []
+    while not queue.is_queue_empty():
+        names.append(queue.dequeue_event().name)
+    return names
+
+
+def test_eventqueue_order():
+    queue = core.EventQueue()
+    assert queue.is_queue_empty()
+
+    for i in range(100):
+        queue.queue_event(core.Event("event-%d" % i))
+
+    # Unnamed events are ignored.
+    queue.queue_event(core.Event(""))
+
+    assert drain(queue) == ["event-%d" % i for i in range(100)]
+
+
+def test_eventqueue_same_event_twice():
+    queue = core.EventQueue()
+    event = core.Event("twice")
+    queue.queue_event(event)
+    queue.queue_event(event)
+    queue.queue_event(core.Event("after"))
+    assert drain(queue) == ["twice", "twice", "after"]
+
+    # Once it has been dequeued, it can be queued again.
+    queue.queue_event(event)
+    assert queue.dequeue_event() == event
+
+
+def test_eventqueue_clear():
+    queue = core.EventQueue()
+    queue.queue_event(core.Event("a"))
+    queue.queue_event(core.Event("b"))
+    queue.clear()
+    assert queue.is_queue_empty()
+
+
+def test_eventhandler_process_events_forward():
+    queue = core.EventQueue()
+    forward = core.EventQueue()
+    handler = core.EventHandler(queue)
+
+    fut = handler.get_future("b")
+    for name in ("a", "b", "c"):
+        queue.queue_event(core.Event(name))
+
+    assert handler.process_events(forward) == 3
+    assert queue.is_queue_empty()
+    assert fut.done()
+    assert fut.result().name == "b"
+    assert drain(forward) == ["a", "b", "c"]
+
+
+def test_eventhandler_future():
+    queue = core.EventQueue()
+    handler = core.EventHandler(queue)
+
+    fut = handler.get_future("x")
+    assert handler.get_future("x") == fut
+    queue.queue_event(core.Event("y"))
+    handler.process_events()
+    assert not fut.done()
+
+    queue.queue_event(core.Event("x"))
+    handler.process_events()
+    assert fut.done()
+
+    # A new future is made for the next time.
+    assert handler.get_future("x") != fut
+
+
+def test_eventhandler_many_futures():
+    queue = core.EventQueue()
+    handler = core.EventHandler(queue)
+
+    names = ["event-%d" % i for i in range(500)]
+    futures = [handler.get_future(name) for name in names]
+
+    # Firing an event erases its hook, which must not lose track of the
+    # others.
+    for name in names[::2]:
+        queue.queue_event(core.Event(name))
+    handler.process_events()
+    for i, fut in enumerate(futures):
+        assert fut.done() == (i % 2 == 0)
+
+    for name in names[1::2]:
+        handler.dispatch_event(core.Event(name))
+    assert all(fut.done() for fut in futures)
+
+    # New hooks can be made for the same names again.
+    for name in names:
+        fut = handler.get_future(name)
+        assert not fut.done()
+        handler.dispatch_event(core.Event(name))
+        assert fut.done()
+        assert fut.result().name == name
@@ -0,0 +1,77 @@
+from panda3d import core
+
+
+def make_manager():
+    clock = core.ClockObject(core.ClockObject.M_slave)
+    task_mgr = core.AsyncTaskManager("test")
+    task_mgr.clock = clock
+    return task_mgr, clock
+
+
+def test_task_sleep_order():
+    task_mgr, clock = make_manager()
+    ran = []
+
+    delays = [5.0, 0.001, 300.0, 0.5, 70000.0, 0.002, 10.0]
+    for delay in delays:
+        task = core.PythonTask(lambda task, delay=delay: ran.append(delay) or task.done)
+        task.delay_time = delay
+        task_mgr.add(task)
+
+    assert len(task_mgr.get_sleeping_tasks()) == len(delays)
+    assert task_mgr.next_wake_time == 0.001
+
+    # Step the clock in irregular jumps, checking that each task runs as soon
+    # as its wake time is passed.  The sleepers are woken at the end of one
+    # poll, and run during the next.
+    for time in (0.0005, 0.0015, 0.003, 4.0, 6.0, 12.0, 301.0, 70001.0):
+        clock.frame_time = time
+        task_mgr.poll()
+        task_mgr.poll()
+        assert ran == sorted(d for d in delays if d <= time)
+
+    assert task_mgr.next_wake_time == -1.0
+    task_mgr.cleanup()
+
+
+def test_task_sleep_remove():
+    task_mgr, clock = make_manager()
+    ran = []
+
+    tasks = []
+    for i in range(100):
+        task = core.PythonTask(lambda task, i=i: ran.append(i) or task.done, "sleep-%d" % (i % 10))
+        task.delay_time = 1.0 + i * 0.1
+        task_mgr.add(task)
+        tasks.append(task)
+
+    assert len(task_mgr.find_tasks("sleep-3")) == 10
+    assert task_mgr.remove(task_mgr.find_tasks("sleep-3")) == 10
+    assert len(task_mgr.find_tasks("sleep-3")) == 0
+    assert tasks[3].cancelled()
+
+    clock.frame_time = 100.0
+    task_mgr.poll()
+    task_mgr.poll()
+    assert sorted(ran) == [i for i in range(100) if i % 10 != 3]
+    task_mgr.cleanup()
+
+
+def test_task_recalc_wake_time():
+    task_mgr, clock = make_manager()
+    ran = []
+
+    task = core.PythonTask(lambda task: ran.append(task) or task.done)
+    task.delay_time = 10.0
+    task_mgr.add(task)
+
+    clock.frame_time = 5.0
+    task.delay_time = 1.0
+    task.recalc_wake_time()
+    assert task.wake_time == 6.0
+
+    clock.frame_time = 6.5
+    task_mgr.poll()
+    task_mgr.poll()
+    assert ran == [task]
+    task_mgr.cleanup()
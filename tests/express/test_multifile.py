@@ -10,3 +10,74 @@ def test_multifile_read_empty():
     assert m.is_read_valid()
     assert m.get_num_subfiles() == 0
     m.close()
+
+
+def test_multifile_block_compression():
+    import random
+    rng = random.Random(1)
+    # Compressible, but not trivially so.
+    data = bytes(rng.choice(b'abcdefgh') for i in range(100000))
+
+    stream = StringStream()
+    m = Multifile()
+    m.set_compression_block_size(4096)
+    assert m.open_write(stream)
+    m.add_subfile('data.txt', StringStream(data), 6)
+    m.close()
+
+    wrapper = IStreamWrapper(stream)
+    m = Multifile()
+    assert m.open_read(wrapper)
+    assert m.get_num_subfiles() == 1
+    assert m.is_subfile_compressed(0)
+    assert m.get_subfile_length(0) == len(data)
+    assert m.get_subfile_internal_length(0) < len(data)
+    assert bytes(m.read_subfile(0)) == data
+
+    # Seeking should land in the middle of a block.
+    subfile = m.open_read_subfile(0)
+    subfile.seekg(50001)
+    assert subfile.read(5000) == data[50001:55001]
+    subfile.seekg(10)
+    assert subfile.read(10) == data[10:20]
+    Multifile.close_read_subfile(subfile)
+    m.close()
+
+
+def get_version(path):
+    # The version numbers follow the six-byte magic number.
+    with open(path, 'rb') as fh:
+        header = fh.read(10)
+    assert header[:6] == b'pmf\x00\n\r'
+    return (header[6] | header[7] << 8, header[8] | header[9] << 8)
+
+
+def test_multifile_version(tmp_path):
+    from panda3d.core import Filename
+
+    data = b'abcdefgh' * 1000
+    path = tmp_path / 'test.mf'
+    filename = Filename.from_os_specific(str(path))
+
+    # Without block-compressed subfiles, a Multifile is still written in the
+    # older version, so that it can be read by older versions of Panda.
+    m = Multifile()
+    assert m.open_write(filename)
+    m.add_subfile('plain.txt', StringStream(data), 6)
+    m.close()
+    assert get_version(path) == (1, 1)
+
+    # Adding one rewrites the Multifile in the new version.
+    m = Multifile()
+    m.set_compression_block_size(4096)
+    assert m.open_read_write(filename)
+    m.add_subfile('blocked.txt', StringStream(data), 6)
+    m.close()
+    assert get_version(path) == (1, 2)
+
+    m = Multifile()
+    assert m.open_read(filename)
+    assert m.get_num_subfiles() == 2
+    assert bytes(m.read_subfile(m.find_subfile('plain.txt'))) == data
+    assert bytes(m.read_subfile(m.find_subfile('blocked.txt'))) == data
+    m.close()
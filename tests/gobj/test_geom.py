@@ -82,3 +82,34 @@ def test_geom_calc_box_bounds():
     assert isinstance(bounds, core.BoundingBox)
     assert bounds.get_min() == (1, 1, 1)
     assert bounds.get_max() == (1, 1, 2)
+
+
+def test_geom_vertex_array_bam_file(tmp_path):
+    # The payload of a large vertex array is read from the file directly into
+    # its buffer; make sure the objects around it are still read correctly.
+    format = core.GeomVertexFormat.get_v3()
+    datas = []
+    for num_rows in (5000, 3, 2000):
+        vdata = core.GeomVertexData("", format, core.GeomEnums.UH_static)
+        vdata.set_num_rows(num_rows)
+        writer = core.GeomVertexWriter(vdata, "vertex")
+        for i in range(num_rows):
+            writer.set_data3(i, i * 2, num_rows)
+        datas.append(vdata)
+
+    path = core.Filename.from_os_specific(str(tmp_path / "vdata.bam"))
+    bam = core.BamFile()
+    assert bam.open_write(path)
+    for vdata in datas:
+        assert bam.write_object(vdata)
+    bam.close()
+
+    assert bam.open_read(path)
+    results = [bam.read_object() for vdata in datas]
+    assert bam.resolve()
+    bam.close()
+
+    for vdata, result in zip(datas, results):
+        assert result.get_num_rows() == vdata.get_num_rows()
+        expected = vdata.get_array(0).get_handle().get_data()
+        assert result.get_array(0).get_handle().get_data() == expected
@@ -0,0 +1,138 @@
+from panda3d import core
+import pytest
+
+# Vertex counts around multiples of 4, since the float32 paths transform four
+# rows at a time and finish off the rest one at a time.
+ROW_COUNTS = [1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 64, 67]
+
+# A uniform scale, so that the normals are transformed the same way by both
+# paths, and a non-uniform one, so that they are renormalized.
+MATRICES = [
+    core.LMatrix4.scale_mat(2) *
+    core.LMatrix4.rotate_mat(30, (1, 2, 3)) *
+    core.LMatrix4.translate_mat(5, -2, 1),
+    core.LMatrix4.scale_mat(1, 3, 0.5) *
+    core.LMatrix4.rotate_mat(-75, (0, 1, 1)) *
+    core.LMatrix4.translate_mat(-1, 4, 2),
+]
+
+
+def make_format(numeric_type, animated=False):
+    """Returns a format with a vertex and a normal column of the indicated
+    type.  The float32 columns take the optimized path through
+    GeomVertexData; the float64 ones are transformed one value at a time by
+    a GeomVertexRewriter."""
+
+    array = core.GeomVertexArrayFormat()
+    array.add_column("vertex", 3, numeric_type, core.Geom.C_point)
+    array.add_column("normal", 3, numeric_type, core.Geom.C_normal)
+    array.add_column("color", 4, core.Geom.NT_uint8, core.Geom.C_color)
+
+    format = core.GeomVertexFormat()
+    format.add_array(array)
+
+    if animated:
+        blend_array = core.GeomVertexArrayFormat()
+        blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+        format.add_array(blend_array)
+
+        spec = core.GeomVertexAnimationSpec()
+        spec.set_panda()
+        format.set_animation(spec)
+
+    return core.GeomVertexFormat.register_format(format)
+
+
+def make_vdata(format, num_rows):
+    vdata = core.GeomVertexData("test", format, core.Geom.UH_static)
+    vdata.set_num_rows(num_rows)
+
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    normal = core.GeomVertexWriter(vdata, "normal")
+    for i in range(num_rows):
+        vertex.set_data3(i * 0.5 + 1, -i * 0.25, (i % 5) - 3)
+        n = core.LVector3(i % 3 - 1, 1, (i % 4) * 0.5)
+        n.normalize()
+        normal.set_data3(n)
+
+    return vdata
+
+
+def assert_same_vertices(vdata, expected):
+    assert vdata.get_num_rows() == expected.get_num_rows()
+
+    for column in ("vertex", "normal"):
+        reader = core.GeomVertexReader(vdata, column)
+        expected_reader = core.GeomVertexReader(expected, column)
+        for i in range(vdata.get_num_rows()):
+            value = reader.get_data3()
+            expected_value = expected_reader.get_data3()
+            assert value.almost_equal(expected_value, 1e-4), (column, i)
+
+
+@pytest.mark.parametrize("num_rows", ROW_COUNTS)
+@pytest.mark.parametrize("mat", MATRICES)
+def test_transform_vertices(num_rows, mat):
+    vdata = make_vdata(make_format(core.Geom.NT_float32), num_rows)
+    expected = make_vdata(make_format(core.Geom.NT_float64), num_rows)
+
+    vdata.transform_vertices(mat)
+    expected.transform_vertices(mat)
+
+    assert_same_vertices(vdata, expected)
+
+
+def make_blend_table(num_rows):
+    """Returns a TransformBlendTable with a few blends of two transforms, and
+    the blend index to use for each row.  The rows are assigned in runs of
+    different lengths, since the vertices are transformed a run at a time."""
+
+    xform0 = core.UserVertexTransform("xform0")
+    xform0.set_matrix(MATRICES[0])
+    xform1 = core.UserVertexTransform("xform1")
+    xform1.set_matrix(MATRICES[1])
+
+    table = core.TransformBlendTable()
+    blends = [
+        table.add_blend(core.TransformBlend(xform0, 1.0)),
+        table.add_blend(core.TransformBlend(xform0, 0.25, xform1, 0.75)),
+        table.add_blend(core.TransformBlend(xform1, 1.0)),
+    ]
+    table.set_rows(core.SparseArray.lower_on(num_rows))
+
+    run_lengths = [1, 3, 5, 2, 7, 4, 9, 6]
+    indices = []
+    run = 0
+    while len(indices) < num_rows:
+        length = run_lengths[run % len(run_lengths)]
+        indices += [blends[run % len(blends)]] * length
+        run += 1
+
+    return table, indices[:num_rows]
+
+
+def make_animated_vdata(numeric_type, num_rows):
+    vdata = make_vdata(make_format(numeric_type, animated=True), num_rows)
+
+    table, indices = make_blend_table(num_rows)
+    vdata.set_transform_blend_table(table)
+
+    blend = core.GeomVertexWriter(vdata, "transform_blend")
+    for index in indices:
+        blend.set_data1i(index)
+
+    return vdata
+
+
+@pytest.mark.parametrize("num_rows", ROW_COUNTS)
+def test_animate_vertices(num_rows):
+    thread = core.Thread.get_current_thread()
+
+    vdata = make_animated_vdata(core.Geom.NT_float32, num_rows)
+    expected = make_animated_vdata(core.Geom.NT_float64, num_rows)
+
+    animated = vdata.animate_vertices(True, thread)
+    expected_animated = expected.animate_vertices(True, thread)
+    assert animated != vdata
+
+    assert_same_vertices(animated, expected_animated)
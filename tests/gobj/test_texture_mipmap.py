@@ -0,0 +1,110 @@
+from panda3d import core
+import random
+import pytest
+
+# Sizes of the base level, including odd sizes, in which the last row or
+# column is dropped, and one-pixel-wide or -high images, which are filtered
+# in one direction only.
+SIZES = [
+    (64, 64),
+    (37, 23),
+    (23, 37),
+    (5, 3),
+    (1, 40),
+    (40, 1),
+    (1, 7),
+    (7, 1),
+]
+
+
+@pytest.fixture(params=[0, 3], ids=["serial", "threaded"])
+def mipmap_threads(request):
+    threads = core.ConfigVariableInt("texture-mipmap-threads")
+    min_size = core.ConfigVariableInt("texture-mipmap-threads-min-size")
+    old_threads = threads.value
+    old_min_size = min_size.value
+
+    # Make even the smallest levels be divided between the threads.
+    threads.value = request.param
+    min_size.value = 0
+    yield request.param
+
+    threads.value = old_threads
+    min_size.value = old_min_size
+
+
+def make_image(x_size, y_size, num_pages, seed):
+    rng = random.Random(seed)
+    return bytes(rng.randrange(256) for i in range(x_size * y_size * num_pages * 4))
+
+
+def filter_level(image, x_size, y_size, num_pages):
+    """Computes the next mipmap level of an RGBA8 image the way the scalar
+    filter_2d_unsigned_byte() does, one component at a time."""
+
+    to_x_size = max(x_size >> 1, 1)
+    to_y_size = max(y_size >> 1, 1)
+    row_size = x_size * 4
+    page_size = row_size * y_size
+
+    # For a one-pixel row or column, the same pixel is counted twice.
+    dx = 4 if x_size != 1 else 0
+    dy = row_size if y_size != 1 else 0
+
+    result = bytearray()
+    for z in range(num_pages):
+        for y in range(to_y_size):
+            for x in range(to_x_size):
+                q = z * page_size + (y * 2 if dy else 0) * row_size + (x * 2 if dx else 0) * 4
+                for c in range(4):
+                    result.append((image[q + c] + image[q + c + dx] +
+                                   image[q + c + dy] + image[q + c + dx + dy]) >> 2)
+
+    return bytes(result)
+
+
+def check_mipmaps(tex, x_size, y_size, num_pages, image):
+    tex.set_ram_image(image)
+    tex.generate_ram_mipmap_images()
+
+    n = 0
+    while x_size > 1 or y_size > 1:
+        image = filter_level(image, x_size, y_size, num_pages)
+        x_size = max(x_size >> 1, 1)
+        y_size = max(y_size >> 1, 1)
+        n += 1
+
+        assert tex.has_ram_mipmap_image(n)
+        assert bytes(tex.get_ram_mipmap_image(n)) == image, (n, x_size, y_size)
+
+    assert not tex.has_ram_mipmap_image(n + 1)
+
+
+@pytest.mark.parametrize("size", SIZES, ids=["%dx%d" % size for size in SIZES])
+def test_texture_mipmap_2d(size, mipmap_threads):
+    x_size, y_size = size
+    tex = core.Texture("test")
+    tex.setup_2d_texture(x_size, y_size, core.Texture.T_unsigned_byte, core.Texture.F_rgba8)
+    tex.set_minfilter(core.SamplerState.FT_linear_mipmap_linear)
+
+    check_mipmaps(tex, x_size, y_size, 1, make_image(x_size, y_size, 1, x_size * 100 + y_size))
+
+
+@pytest.mark.parametrize("size", SIZES, ids=["%dx%d" % size for size in SIZES])
+def test_texture_mipmap_2d_array(size, mipmap_threads):
+    # The rows of all of the pages are shared out between the threads
+    # together, so the bands cross page boundaries.
+    x_size, y_size = size
+    tex = core.Texture("test")
+    tex.setup_2d_texture_array(x_size, y_size, 3, core.Texture.T_unsigned_byte, core.Texture.F_rgba8)
+    tex.set_minfilter(core.SamplerState.FT_linear_mipmap_linear)
+
+    check_mipmaps(tex, x_size, y_size, 3, make_image(x_size, y_size, 3, x_size * 100 + y_size))
+
+
+def test_texture_mipmap_cube_map(mipmap_threads):
+    tex = core.Texture("test")
+    tex.setup_cube_map(18, core.Texture.T_unsigned_byte, core.Texture.F_rgba8)
+    tex.set_minfilter(core.SamplerState.FT_linear_mipmap_linear)
+
+    check_mipmaps(tex, 18, 18, 6, make_image(18, 18, 6, 18))
@@ -0,0 +1,99 @@
+import pytest
+
+direct = pytest.importorskip("panda3d.direct")
+core = pytest.importorskip("panda3d.core")
+
+
+@pytest.fixture
+def clock():
+    clock = core.ClockObject.get_global_clock()
+    mode = clock.mode
+    clock.mode = core.ClockObject.M_slave
+    clock.frame_time = 0.0
+    yield clock
+    clock.mode = mode
+
+
+@pytest.fixture(params=[False, True], ids=["unbatched", "batched"])
+def batch_lerps(request):
+    var = core.ConfigVariableBool("interval-batch-lerps")
+    old_value = var.value
+    var.value = request.param
+    yield request.param
+    var.value = old_value
+
+
+def make_lerp(name, node, duration=2.0, blend=direct.CLerpInterval.BT_no_blend):
+    ival = direct.CLerpNodePathInterval(name, duration, blend, True, False, node, core.NodePath())
+    return ival
+
+
+def play(mgr, *ivals):
+    for ival in ivals:
+        ival.setup_play(0.0, -1.0, 1.0, False)
+        mgr.add_c_interval(ival, False)
+
+
+def test_lerp_pos_hpr(clock, batch_lerps):
+    mgr = direct.CIntervalManager()
+    node = core.NodePath("node")
+
+    ival = make_lerp("a", node, blend=direct.CLerpInterval.BT_ease_in_out)
+    ival.set_start_pos((0, 0, 0))
+    ival.set_end_pos((10, 20, 30))
+    ival.set_start_hpr((0, 0, 0))
+    ival.set_end_hpr((90, 0, 0))
+    play(mgr, ival)
+
+    clock.frame_time = 1.0
+    mgr.step()
+    assert node.get_pos().almost_equal((5, 10, 15))
+    assert node.get_hpr().almost_equal((45, 0, 0))
+
+    clock.frame_time = 3.0
+    mgr.step()
+    assert node.get_pos().almost_equal((10, 20, 30))
+    assert mgr.get_num_intervals() == 0
+
+
+def test_lerp_order(clock, batch_lerps):
+    # Several lerps on the same node must be applied in the order they are
+    # stepped, which is by name, whether or not they could be batched.
+    mgr = direct.CIntervalManager()
+    node = core.NodePath("node")
+
+    a = make_lerp("a", node)
+    a.set_start_pos((0, 0, 0))
+    a.set_end_pos((10, 0, 0))
+
+    # This one picks up where the first one left the node.
+    b = make_lerp("b", node)
+    b.set_end_scale(3)
+
+    c = make_lerp("c", node)
+    c.set_start_pos((0, 0, 0))
+    c.set_end_pos((0, 10, 0))
+
+    play(mgr, c, b, a)
+
+    clock.frame_time = 1.0
+    mgr.step()
+    assert node.get_pos().almost_equal((0, 5, 0))
+    assert node.get_scale().almost_equal((2, 2, 2))
+
+
+def test_lerp_quat_scale(clock, batch_lerps):
+    mgr = direct.CIntervalManager()
+    node = core.NodePath("node")
+
+    ival = make_lerp("a", node)
+    ival.set_start_quat(core.LQuaternion.ident_quat())
+    ival.set_end_quat(core.LVecBase3(90, 0, 0))
+    ival.set_start_scale(1)
+    ival.set_end_scale(2)
+    play(mgr, ival)
+
+    clock.frame_time = 1.0
+    mgr.step()
+    assert node.get_hpr().almost_equal((45, 0, 0), 0.01)
+    assert node.get_scale().almost_equal((1.5, 1.5, 1.5))
@@ -0,0 +1,105 @@
+from panda3d import core, physics
+import pytest
+
+
+@pytest.fixture
+def batch_uniform_forces():
+    var = core.ConfigVariableBool("physics-batch-uniform-forces")
+    old_value = var.value
+    yield var
+    var.value = old_value
+
+
+def simulate(num_objects, forces, steps=10, dt=0.1):
+    """Sets up a Physical with the given number of objects under the given
+    forces, and returns the resulting positions and velocities."""
+
+    root = core.NodePath("root")
+    force_node = physics.ForceNode("forces")
+    root.attach_new_node(force_node)
+
+    node = physics.PhysicalNode("physical")
+    physical = physics.Physical(num_objects, False)
+    physical.set_viscosity(0.1)
+    node.add_physical(physical)
+    root.attach_new_node(node)
+
+    manager = physics.PhysicsManager()
+    manager.attach_linear_integrator(physics.LinearEulerIntegrator())
+    manager.attach_physical(physical)
+
+    objects = []
+    for i in range(num_objects):
+        obj = physics.PhysicsObject()
+        obj.set_mass(1.0 + i * 0.25)
+        obj.set_position((i, 0, 0))
+        obj.set_velocity((0, i * 0.5, 1))
+        # Every third object is inactive and should not move.
+        obj.set_active(i % 3 != 2)
+        physical.add_physics_object(obj)
+        objects.append(obj)
+
+    for force in forces:
+        force_node.add_force(force)
+        manager.add_linear_force(force)
+
+    for step in range(steps):
+        manager.do_physics(dt)
+
+    return [(tuple(obj.get_position()), tuple(obj.get_velocity()))
+            for obj in objects]
+
+
+def make_uniform_forces():
+    gravity = physics.LinearVectorForce((0, 0, -9.81))
+    wind = physics.LinearVectorForce((2, 0, 0), 1.0, True)
+    return [gravity, wind]
+
+
+def test_batched_matches_per_object(batch_uniform_forces):
+    batch_uniform_forces.value = False
+    expected = simulate(70, make_uniform_forces())
+
+    batch_uniform_forces.value = True
+    result = simulate(70, make_uniform_forces())
+
+    # The arithmetic is done in the same order, so the results are identical.
+    assert result == expected
+
+
+def test_batched_inactive_force(batch_uniform_forces):
+    batch_uniform_forces.value = True
+    gravity, wind = make_uniform_forces()
+    wind.set_active(False)
+    result = simulate(5, [gravity, wind])
+
+    batch_uniform_forces.value = False
+    gravity, wind = make_uniform_forces()
+    wind.set_active(False)
+    expected = simulate(5, [gravity, wind])
+
+    for (pos, vel), (exp_pos, exp_vel) in zip(result, expected):
+        assert pos == pytest.approx(exp_pos, abs=1e-4)
+        assert vel == pytest.approx(exp_vel, abs=1e-4)
+
+
+def test_inactive_object_does_not_move(batch_uniform_forces):
+    batch_uniform_forces.value = True
+    result = simulate(3, make_uniform_forces())
+    assert result[2] == ((2, 0, 0), (0, 1, 1))
+
+
+def test_non_uniform_force_falls_back(batch_uniform_forces):
+    batch_uniform_forces.value = True
+    friction = physics.LinearFrictionForce(0.5)
+    assert not friction.is_uniform()
+    assert physics.LinearVectorForce((0, 0, -1)).is_uniform()
+
+    result = simulate(4, make_uniform_forces() + [friction])
+
+    batch_uniform_forces.value = False
+    expected = simulate(4, make_uniform_forces() + [friction])
+
+    for (pos, vel), (exp_pos, exp_vel) in zip(result, expected):
+        assert pos == pytest.approx(exp_pos, abs=1e-4)
+        assert vel == pytest.approx(exp_vel, abs=1e-4)
@@ -0,0 +1,40 @@
+from panda3d.core import PStatHistogram
+import pytest
+
+
+def test_histogram_empty():
+    hist = PStatHistogram()
+    assert hist.is_empty()
+    assert hist.num_samples == 0
+    assert hist.get_percentile(0.5) == 0.0
+    assert hist.max == 0.0
+
+
+def test_histogram_percentiles():
+    hist = PStatHistogram()
+    for i in range(1, 1001):
+        hist.add_sample(i * 1e-6)
+
+    assert hist.num_samples == 1000
+    assert hist.max == pytest.approx(1000e-6)
+    assert hist.get_percentile(0.5) == pytest.approx(500e-6, rel=0.04)
+    assert hist.get_percentile(0.99) == pytest.approx(990e-6, rel=0.04)
+    assert hist.get_percentile(1.0) == pytest.approx(1000e-6, rel=0.04)
+    assert hist.mean == pytest.approx(500.5e-6, rel=0.04)
+
+
+def test_histogram_merge():
+    a = PStatHistogram()
+    b = PStatHistogram()
+    a.add_sample(1e-3)
+    b.add_sample(2e-3)
+    b.add_sample(3e-3)
+
+    a.merge(b)
+    assert a.num_samples == 3
+    assert a.max == pytest.approx(3e-3)
+    assert b.num_samples == 2
+
+    a.clear()
+    assert a.is_empty()
+    assert a.max == 0.0
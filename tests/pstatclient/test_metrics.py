@@ -0,0 +1,77 @@
+from panda3d.core import PStatClient, PStatCollector, PStatThread, Thread
+import threading
+import time
+import pytest
+
+
+@pytest.fixture
+def collector(request):
+    # Each test uses a collector of its own, since metrics can't be disabled
+    # again once they are enabled.
+    collector = PStatCollector("MetricsTest:" + request.node.name)
+    if collector.get_metrics() is None:
+        pytest.skip("PStats not available")
+
+    collector.enable_metrics()
+    return collector
+
+
+def test_metrics_enable(collector):
+    client = PStatClient.get_global_pstats()
+    index = collector.get_index()
+    assert client.has_metrics(index)
+    assert index in list(client.metrics_collectors)
+    assert collector.get_metrics().is_empty()
+
+
+def test_metrics_start_stop(collector):
+    for i in range(5):
+        collector.start()
+        time.sleep(0.002)
+        collector.stop()
+
+    hist = collector.get_metrics()
+    assert hist.num_samples == 5
+    assert hist.max >= 0.002
+    assert hist.get_percentile(0.5) >= 0.002 * 0.96
+
+    # Nested starts are counted only once, when the outermost one stops.
+    collector.start()
+    collector.start()
+    collector.stop()
+    collector.stop()
+    assert collector.get_metrics().num_samples == 6
+
+    # Resetting returns the samples so far, and empties the histogram.
+    hist = collector.get_metrics(True)
+    assert hist.num_samples == 6
+    assert collector.get_metrics().is_empty()
+
+    collector.start()
+    collector.stop()
+    assert collector.get_metrics().num_samples == 1
+
+
+def test_metrics_other_thread(collector):
+    # Metrics are only recorded by the thread that a PStatThread represents.
+    # Starting and stopping the collector for it from other threads is not
+    # timed, and does not disturb the timing of the thread itself.
+    main_thread = PStatThread(Thread.get_main_thread())
+
+    def start_stop():
+        for i in range(100):
+            collector.start(main_thread)
+            collector.stop(main_thread)
+            collector.start()
+            collector.stop()
+
+    collector.start(main_thread)
+    threads = [threading.Thread(target=start_stop) for i in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert collector.get_metrics().is_empty()
+    collector.stop(main_thread)
+
+    assert collector.get_metrics().num_samples == 1
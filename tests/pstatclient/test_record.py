@@ -0,0 +1,129 @@
+from panda3d.core import PStatClient, PStatCollector, PStatThread, Thread
+from panda3d.core import Filename, ExecutionEnvironment
+import json
+import os
+import subprocess
+import time
+import pytest
+
+NUM_FRAMES = 4
+
+# The times at which the collectors are started and stopped, in seconds after
+# the start of each frame.
+OUTER_START = 0.001
+INNER_START = 0.002
+INNER_STOP = 0.005
+OUTER_STOP = 0.010
+
+
+def find_pstats_convert():
+    """Returns the path to the pstats-convert program, which is in the bin
+    directory of the Panda build, or None if it hasn't been built."""
+
+    lib_dir = os.path.dirname(ExecutionEnvironment.get_dtool_name())
+    dirs = [lib_dir, os.path.join(lib_dir, "..", "bin")]
+    dirs += os.environ.get("PATH", "").split(os.pathsep)
+
+    for dir in dirs:
+        for name in ("pstats-convert", "pstats-convert.exe"):
+            path = os.path.join(dir, name)
+            if os.path.isfile(path):
+                return path
+
+    return None
+
+
+@pytest.fixture(scope="module")
+def recording(tmp_path_factory):
+    """Records a few frames in which two nested collectors run for known
+    lengths of time, and returns the name of the recording."""
+
+    path = str(tmp_path_factory.mktemp("pstats") / "test.pstats")
+    if not PStatClient.record(Filename.from_os_specific(path)):
+        pytest.skip("PStats not available")
+
+    try:
+        thread = PStatThread(Thread.get_main_thread())
+        outer = PStatCollector("RecordTest")
+        inner = PStatCollector("RecordTest:Inner")
+        client = PStatClient.get_global_pstats()
+
+        PStatClient.main_tick()
+        for i in range(NUM_FRAMES):
+            start = client.get_real_time()
+            outer.start(thread, start + OUTER_START)
+            inner.start(thread, start + INNER_START)
+            inner.stop(thread, start + INNER_STOP)
+            outer.stop(thread, start + OUTER_STOP)
+
+            # Make sure the frame doesn't end before the collectors stop.
+            while client.get_real_time() < start + OUTER_STOP * 1.5:
+                time.sleep(0.002)
+            PStatClient.main_tick()
+
+    finally:
+        PStatClient.disconnect()
+
+    return path
+
+
+def convert(recording, *args):
+    program = find_pstats_convert()
+    if program is None:
+        pytest.skip("pstats-convert not built")
+
+    subprocess.check_call([program] + list(args) + [recording])
+
+
+def test_record_chrome(recording, tmp_path):
+    out = str(tmp_path / "test.json")
+    convert(recording, "-o", out)
+
+    with open(out) as fh:
+        trace = json.load(fh)
+
+    events = trace["traceEvents"]
+    names = [event["args"]["name"] for event in events if event["name"] == "thread_name"]
+    assert "Main" in names
+
+    outer = [event for event in events if event["name"] == "RecordTest"]
+    inner = [event for event in events if event["name"] == "RecordTest:Inner"]
+    assert len(outer) == NUM_FRAMES
+    assert len(inner) == NUM_FRAMES
+
+    # The times are in microseconds.
+    for outer_event, inner_event in zip(outer, inner):
+        assert outer_event["ph"] == "X"
+        assert inner_event["ph"] == "X"
+        assert outer_event["tid"] == inner_event["tid"]
+        assert outer_event["dur"] == pytest.approx((OUTER_STOP - OUTER_START) * 1e6, abs=1)
+        assert inner_event["dur"] == pytest.approx((INNER_STOP - INNER_START) * 1e6, abs=1)
+        assert inner_event["ts"] - outer_event["ts"] == pytest.approx((INNER_START - OUTER_START) * 1e6, abs=1)
+
+    # The frames follow each other.
+    for a, b in zip(outer, outer[1:]):
+        assert b["ts"] - a["ts"] >= OUTER_STOP * 1e6
+
+
+def test_record_folded(recording, tmp_path):
+    out = str(tmp_path / "test.folded")
+    convert(recording, "-t", "folded", "-o", out)
+
+    totals = {}
+    with open(out) as fh:
+        for line in fh:
+            path, usec = line.rsplit(" ", 1)
+            totals[path] = int(usec)
+
+    # The time spent directly within each collector, over all the frames.
+    inner = [usec for path, usec in totals.items()
+             if path.startswith("Main;") and path.endswith(";RecordTest;RecordTest:Inner")]
+    outer = [usec for path, usec in totals.items()
+             if path.startswith("Main;") and path.endswith(";RecordTest")]
+    assert len(inner) == 1
+    assert len(outer) == 1
+
+    inner_time = (INNER_STOP - INNER_START) * NUM_FRAMES * 1e6
+    outer_time = (OUTER_STOP - OUTER_START) * NUM_FRAMES * 1e6 - inner_time
+    assert inner[0] == pytest.approx(inner_time, abs=NUM_FRAMES)
+    assert outer[0] == pytest.approx(outer_time, abs=NUM_FRAMES)